@@ -4,6 +4,7 @@
 // Qt lib import
 #include <limits>
 #include <QAction>
+#include <QCryptographicHash>
 #include <QCursor>
 #include <QDateTime>
 #include <QDebug>
@@ -58,6 +59,8 @@ namespace
 constexpr int pairingReconnectIntervalMs = 15000;
 constexpr int invokeIdempotencyCacheMaxEntries = 256;
 constexpr qint64 invokeIdempotencyCacheTtlMs = 10LL * 60LL * 1000LL;
+// file.write uploadAppend carries megabytes of base64; the request log keeps the head.
+constexpr int invokeParamsLogMaxChars = 2048;
 constexpr int invokeHistoryMaxEntries = 10;
 constexpr int screenshotUploadTimeoutMs = 30000;
 constexpr int selfUpdateExitDelayMs = 200;
@@ -303,6 +306,21 @@ QString buildInvokeIdempotencyCacheKey(
     return QStringLiteral("%1\n%2\n%3").arg(nodeId, command, idempotencyKey);
 }
 
+// Bulk data replies (transfer chunks, up to ~11 MB of base64 each) are cheap to serve
+// again and too large to keep for the cache lifetime; they are only shared with
+// duplicates that arrive while the request is still running.
+bool isInvokeResultCacheable(const QString &command, const QJsonValue &params)
+{
+    if ( command != QStringLiteral("file.read") )
+    {
+        return true;
+    }
+    const QString operation = Common::normalizeToken(
+        Common::extractStringTrimmed(params.toObject(), QStringLiteral("operation"))
+    );
+    return operation != QStringLiteral("transferread");
+}
+
 QString buildInvokeRequestFingerprint(
     const QString &command,
     const QJsonValue &params,
@@ -315,8 +333,13 @@ QString buildInvokeRequestFingerprint(
         paramsJson = QStringLiteral("null");
     }
 
-    return QStringLiteral("%1\n%2\n%3")
+    // Only compared for equality, so a digest stands in for what can be a
+    // multi-megabyte payload held by every cached entry.
+    const QString fingerprintSource = QStringLiteral("%1\n%2\n%3")
         .arg(command, QString::number(invokeTimeoutMs), paramsJson);
+    return QString::fromLatin1(
+        QCryptographicHash::hash(fingerprintSource.toUtf8(), QCryptographicHash::Sha256).toHex()
+    );
 }
 
 QString normalizeBasePath(const QString &path)
@@ -561,6 +584,12 @@ NodeApplication::NodeApplication(
         this,
         &NodeApplication::onGatewayClosed
     );
+    connect(
+        &gatewayClient_,
+        &GatewayClient::failbackRequested,
+        this,
+        &NodeApplication::onGatewayFailbackRequested
+    );
     connect(
         &pairingReconnectTimer_,
         &QTimer::timeout,
@@ -730,6 +759,7 @@ QJsonObject NodeApplication::defaultConfig()
 {
     QJsonObject config;
     config.insert(QStringLiteral("gatewayUrl"), QString::fromLatin1(defaultGatewayUrl));
+    config.insert(QStringLiteral("gatewayUrls"), QJsonArray());
     config.insert(QStringLiteral("token"), QString());
     config.insert(QStringLiteral("followSystemStartup"), false);
     config.insert(QStringLiteral("silentStartup"), false);
@@ -753,6 +783,21 @@ QJsonObject NodeApplication::normalizeConfig(const QJsonObject &config)
         normalized.insert(QStringLiteral("gatewayUrl"), gatewayUrl.toString().trimmed());
     }
 
+    const QJsonValue gatewayUrls = config.value(QStringLiteral("gatewayUrls"));
+    if ( gatewayUrls.isArray() )
+    {
+        QJsonArray normalizedGatewayUrls;
+        for ( const QJsonValue &item : gatewayUrls.toArray() )
+        {
+            const QString normalizedItem = item.toString().trimmed();
+            if ( !normalizedItem.isEmpty() )
+            {
+                normalizedGatewayUrls.append(normalizedItem);
+            }
+        }
+        normalized.insert(QStringLiteral("gatewayUrls"), normalizedGatewayUrls);
+    }
+
     const QJsonValue token = config.value(QStringLiteral("token"));
     if ( token.isString() )
     {
@@ -1149,6 +1194,31 @@ NodeOptions NodeApplication::buildNodeOptions(QString *error) const
     options.tls = ( gatewayScheme == QStringLiteral("wss") );
     options.gatewayUrl = gatewayUrl.toString(QUrl::FullyEncoded);
 
+    options.gatewayUrls.append(options.gatewayUrl);
+    const QJsonArray backupGatewayUrls = normalizedConfig.value(QStringLiteral("gatewayUrls")).toArray();
+    for ( const QJsonValue &item : backupGatewayUrls )
+    {
+        const QUrl backupUrl(item.toString().trimmed());
+        const QString backupScheme = backupUrl.scheme().trimmed().toLower();
+        if ( !backupUrl.isValid() ||
+             backupUrl.host().trimmed().isEmpty() ||
+             ( backupScheme != QStringLiteral("ws") &&
+               backupScheme != QStringLiteral("wss") ) )
+        {
+            if ( error != nullptr )
+            {
+                *error = QStringLiteral("invalid backup gateway url: %1").arg(item.toString());
+            }
+            return options;
+        }
+
+        const QString backupUrlText = backupUrl.toString(QUrl::FullyEncoded);
+        if ( !options.gatewayUrls.contains(backupUrlText) )
+        {
+            options.gatewayUrls.append(backupUrlText);
+        }
+    }
+
     if ( options.token.trimmed().isEmpty() )
     {
         if ( error != nullptr )
@@ -1537,9 +1607,15 @@ void NodeApplication::onInvokeRequestReceived(const QJsonObject &payload)
         ? paramsJsonValue.toString().trimmed()
         : QString();
 
+    QString paramsJsonForLog = paramsJson;
+    if ( paramsJsonForLog.size() > invokeParamsLogMaxChars )
+    {
+        paramsJsonForLog = QStringLiteral("%1...(%2 chars)")
+            .arg(paramsJson.left(invokeParamsLogMaxChars), QString::number(paramsJson.size()));
+    }
     qInfo().noquote() << QStringLiteral(
         "[node.invoke] request received id=%1 command=%2 paramsJSON=%3"
-    ).arg(invokeId, command, paramsJson);
+    ).arg(invokeId, command, paramsJsonForLog);
 
     if ( invokeId.isEmpty() || nodeId.isEmpty() || command.isEmpty() )
     {
@@ -1832,7 +1908,9 @@ void NodeApplication::onInvokeRequestReceived(const QJsonObject &payload)
     invokeIdempotencyCacheOrder_.append(invokeCacheKey);
     pruneInvokeIdempotencyCache(nowMs);
 
+    const bool cacheInvokeResult = isInvokeResultCacheable(command, params);
     auto finalizeInvokeResult = [this,
+                                 cacheInvokeResult,
                                  &invokeCacheKey,
                                  &invokeId,
                                  &nodeId,
@@ -1859,6 +1937,11 @@ void NodeApplication::onInvokeRequestReceived(const QJsonObject &payload)
             cacheIter->updatedAtMs = finishMs;
             waitingTargets = cacheIter->waitingTargets;
             cacheIter->waitingTargets.clear();
+            if ( !cacheInvokeResult )
+            {
+                invokeIdempotencyCache_.erase(cacheIter);
+                invokeIdempotencyCacheOrder_.removeAll(invokeCacheKey);
+            }
         }
 
         sendInvokeResultToTarget(
@@ -2047,6 +2130,23 @@ void NodeApplication::onGatewayClosed()
     qWarning().noquote() << QStringLiteral("gateway closed after registration, waiting for reconnect");
 }
 
+void NodeApplication::onGatewayFailbackRequested()
+{
+    if ( !registered_ || reconnectAfterClose_ )
+    {
+        return;
+    }
+
+    qInfo().noquote() << QStringLiteral("gateway failback to primary endpoint, reconnecting");
+    registered_ = false;
+    reconnectingFromConfigSave_ = false;
+    reconnectAfterClose_ = true;
+    setConnectionState(ConnectionState::Connecting);
+    connectionStateDetail_.clear();
+    updateConnectionStatusAction();
+    gatewayClient_.close();
+}
+
 void NodeApplication::onPairingReconnectTimeout()
 {
     if ( connectionState_ != ConnectionState::Pairing &&
@@ -2687,7 +2787,13 @@ bool NodeApplication::executeInvokeCommand(
         QJsonObject writeResult;
         QString writeError;
         bool invalidParams = false;
-        if ( !FileWriteAccess::write(params, &writeResult, &writeError, &invalidParams) )
+        if ( !FileWriteAccess::write(
+                params,
+                invokeTimeoutMs,
+                &writeResult,
+                &writeError,
+                &invalidParams
+            ) )
         {
             if ( errorCode != nullptr )
             {
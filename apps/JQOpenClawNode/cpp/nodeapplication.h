@@ -73,6 +73,7 @@ private:
     void onInvokeRequestReceived(const QJsonObject &payload);
     void onTransportError(const QString &message);
     void onGatewayClosed();
+    void onGatewayFailbackRequested();
     void onPairingReconnectTimeout();
     void startPairingReconnect();
     void stopPairingReconnect();
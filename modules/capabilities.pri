@@ -1,6 +1,24 @@
 HEADERS *= \
     $$PWD/capabilities/file/fileaccessread.h \
     $$PWD/capabilities/file/fileaccesswrite.h \
+    $$PWD/capabilities/file/filearchivewriter.h \
+    $$PWD/capabilities/file/filebatchreader.h \
+    $$PWD/capabilities/file/filecopyengine.h \
+    $$PWD/capabilities/file/filedeltaengine.h \
+    $$PWD/capabilities/file/filedurability.h \
+    $$PWD/capabilities/file/fileglobmatcher.h \
+    $$PWD/capabilities/file/filehashcache.h \
+    $$PWD/capabilities/file/filehasher.h \
+    $$PWD/capabilities/file/filelineindex.h \
+    $$PWD/capabilities/file/fileremover.h \
+    $$PWD/capabilities/file/filesearchengine.h \
+    $$PWD/capabilities/file/filetailreader.h \
+    $$PWD/capabilities/file/filetransfersession.h \
+    $$PWD/capabilities/file/filetreewalker.h \
+    $$PWD/capabilities/file/filetrigramindex.h \
+    $$PWD/capabilities/file/fileuploadsession.h \
+    $$PWD/capabilities/file/fileworkqueue.h \
+    $$PWD/capabilities/file/filewritebatch.h \
     $$PWD/capabilities/node/nodeselfupdate.h \
     $$PWD/capabilities/process/processexec.h \
     $$PWD/capabilities/process/processmanage.h \
@@ -15,6 +33,23 @@ HEADERS *= \
 SOURCES *= \
     $$PWD/capabilities/file/fileaccessread.cpp \
     $$PWD/capabilities/file/fileaccesswrite.cpp \
+    $$PWD/capabilities/file/filearchivewriter.cpp \
+    $$PWD/capabilities/file/filebatchreader.cpp \
+    $$PWD/capabilities/file/filecopyengine.cpp \
+    $$PWD/capabilities/file/filedeltaengine.cpp \
+    $$PWD/capabilities/file/filedurability.cpp \
+    $$PWD/capabilities/file/fileglobmatcher.cpp \
+    $$PWD/capabilities/file/filehashcache.cpp \
+    $$PWD/capabilities/file/filehasher.cpp \
+    $$PWD/capabilities/file/filelineindex.cpp \
+    $$PWD/capabilities/file/fileremover.cpp \
+    $$PWD/capabilities/file/filesearchengine.cpp \
+    $$PWD/capabilities/file/filetailreader.cpp \
+    $$PWD/capabilities/file/filetransfersession.cpp \
+    $$PWD/capabilities/file/filetreewalker.cpp \
+    $$PWD/capabilities/file/filetrigramindex.cpp \
+    $$PWD/capabilities/file/fileuploadsession.cpp \
+    $$PWD/capabilities/file/filewritebatch.cpp \
     $$PWD/capabilities/node/nodeselfupdate.cpp \
     $$PWD/capabilities/process/processexec.cpp \
     $$PWD/capabilities/process/processmanage.cpp \
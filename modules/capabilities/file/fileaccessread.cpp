@@ -7,27 +7,44 @@
 #include <QDebug>
 #include <QDir>
 #include <QDirIterator>
+#include <QElapsedTimer>
 #include <QFile>
 #include <QFileDevice>
 #include <QFileInfo>
 #include <QJsonArray>
 #include <QJsonDocument>
 #include <QJsonObject>
+#include <QPair>
 #include <QProcess>
-#include <QProcessEnvironment>
 #include <QSet>
+#include <QTemporaryFile>
 #include <QtGlobal>
 #include <algorithm>
 #include <limits>
 
 // JQOpenClaw import
+#include "capabilities/file/filearchivewriter.h"
+#include "capabilities/file/filebatchreader.h"
+#include "capabilities/file/filedeltaengine.h"
+#include "capabilities/file/fileglobmatcher.h"
+#include "capabilities/file/filehasher.h"
+#include "capabilities/file/filelineindex.h"
+#include "capabilities/file/filesearchengine.h"
+#include "capabilities/file/filetailreader.h"
+#include "capabilities/file/filetreewalker.h"
+#include "capabilities/file/filetransfersession.h"
+#include "capabilities/file/filetrigramindex.h"
+#include "common/base64codec.h"
 #include "common/common.h"
+#include "common/gzipcodec.h"
 
 namespace
 {
 const qint64 defaultReadMaxBytes = 1024 * 1024;
 const qint64 maxReadMaxBytes = 2 * 1024 * 1024;
 const qint64 defaultReadChunkBytes = 256 * 1024;
+// Below this the gzip header, trailer and base64 step cost more than deflate saves.
+const qint64 readCompressMinBytes = 1024;
 const qint64 maxReadLineSpan = 50000;
 const qint64 defaultReadMaxEntries = 200;
 const qint64 maxReadMaxEntries = 5000;
@@ -36,189 +53,41 @@ const qint64 maxRgMaxMatches = 5000;
 const int readRgStartTimeoutMs = 5000;
 const int readRgTimeoutMs = 60000;
 const int readRgKillWaitTimeoutMs = 3000;
-
-QDir::SortFlags entryNameSortFlags()
-{
-    QDir::SortFlags sortFlags = QDir::DirsFirst | QDir::Name;
-#if defined(Q_OS_WIN) || defined(Q_OS_MACOS)
-    sortFlags |= QDir::IgnoreCase;
-#endif
-    return sortFlags;
-}
-
-const char *readRgPowerShellFallbackScript = R"PS(
-[Console]::OutputEncoding = [System.Text.Encoding]::UTF8
-$ErrorActionPreference = 'Stop'
-
-$targetPath = $env:JQ_FILE_READ_PATH
-$pattern = $env:JQ_FILE_READ_PATTERN
-$maxMatches = [int]$env:JQ_FILE_READ_MAX_MATCHES
-$caseSensitive = $env:JQ_FILE_READ_CASE_SENSITIVE -eq '1'
-$includeHidden = $env:JQ_FILE_READ_INCLUDE_HIDDEN -eq '1'
-$literal = $env:JQ_FILE_READ_LITERAL -eq '1'
-
-$files = @()
-if (Test-Path -LiteralPath $targetPath -PathType Container)
-{
-    if ($includeHidden)
-    {
-        $files = Get-ChildItem -LiteralPath $targetPath -Recurse -File -Force -ErrorAction Stop
-    }
-    else
-    {
-        $files = Get-ChildItem -LiteralPath $targetPath -Recurse -File -ErrorAction Stop
-    }
-}
-elseif (Test-Path -LiteralPath $targetPath -PathType Leaf)
-{
-    $files = @(Get-Item -LiteralPath $targetPath -ErrorAction Stop)
-}
-else
-{
-    throw 'target path does not exist'
-}
-
-$matches = New-Object System.Collections.ArrayList
-$truncated = $false
-
-$selectArgs = @{
-    Pattern = $pattern
-    ErrorAction = 'Stop'
-    AllMatches = $true
-}
-if ($caseSensitive)
-{
-    $selectArgs.CaseSensitive = $true
-}
-if ($literal)
-{
-    $selectArgs.SimpleMatch = $true
-}
-
-foreach ($file in $files)
-{
-    $lineMatches = Select-String -LiteralPath $file.FullName @selectArgs
-    foreach ($lineMatch in $lineMatches)
-    {
-        $lineText = if ($null -eq $lineMatch.Line) { '' } else { [string]$lineMatch.Line }
-
-        if ($literal)
-        {
-            if ($caseSensitive)
-            {
-                $comparison = [System.StringComparison]::Ordinal
-            }
-            else
-            {
-                $comparison = [System.StringComparison]::OrdinalIgnoreCase
-            }
-
-            $searchOffset = 0
-            while ($true)
-            {
-                if ($matches.Count -ge $maxMatches)
-                {
-                    $truncated = $true
-                    break
-                }
-
-                $matchIndex = $lineText.IndexOf($pattern, $searchOffset, $comparison)
-                if ($matchIndex -lt 0)
-                {
-                    break
-                }
-
-                $matchLength = [Math]::Max($pattern.Length, 1)
-                $safeLength = [Math]::Min($matchLength, [Math]::Max($lineText.Length - $matchIndex, 0))
-                $matchedText = if ($safeLength -gt 0) { $lineText.Substring($matchIndex, $safeLength) } else { '' }
-                $columnStart = [int]$matchIndex + 1
-                $columnEnd = [int]$matchIndex + [int]$matchLength
-                [void]$matches.Add(
-                    [pscustomobject]@{
-                        path = $lineMatch.Path
-                        lineNumber = $lineMatch.LineNumber
-                        columnStart = $columnStart
-                        columnEnd = $columnEnd
-                        lineText = $lineText
-                        matchText = $matchedText
-                    }
-                )
-
-                $searchOffset = $matchIndex + $matchLength
-                if ($searchOffset -ge $lineText.Length)
-                {
-                    break
-                }
-            }
-
-            if ($truncated)
-            {
-                break
-            }
-
-            continue
-        }
-
-        if ($null -eq $lineMatch.Matches -or $lineMatch.Matches.Count -eq 0)
-        {
-            if ($matches.Count -ge $maxMatches)
-            {
-                $truncated = $true
-                break
-            }
-
-            [void]$matches.Add(
-                [pscustomobject]@{
-                    path = $lineMatch.Path
-                    lineNumber = $lineMatch.LineNumber
-                    columnStart = 1
-                    columnEnd = 1
-                    lineText = $lineText
-                    matchText = ''
-                }
-            )
-            continue
-        }
-
-        foreach ($subMatch in $lineMatch.Matches)
-        {
-            if ($matches.Count -ge $maxMatches)
-            {
-                $truncated = $true
-                break
-            }
-
-            $columnStart = [int]$subMatch.Index + 1
-            $columnEnd = [int]$subMatch.Index + [int]$subMatch.Length
-            [void]$matches.Add(
-                [pscustomobject]@{
-                    path = $lineMatch.Path
-                    lineNumber = $lineMatch.LineNumber
-                    columnStart = $columnStart
-                    columnEnd = $columnEnd
-                    lineText = $lineText
-                    matchText = $subMatch.Value
-                }
-            )
-        }
-
-        if ($truncated)
-        {
-            break
-        }
-    }
-
-    if ($truncated)
-    {
-        break
-    }
-}
-
-[pscustomobject]@{
-    matches = $matches
-    truncated = $truncated
-} | ConvertTo-Json -Compress -Depth 8
-)PS";
+const int readRgPollIntervalMs = 100;
+const qsizetype readRgMaxStderrBytes = 64 * 1024;
+const qint64 defaultDuTopCount = 20;
+const qint64 maxDuTopCount = 1000;
+const int readDuTimeoutMs = 120000;
+const int maxHashPaths = 10000;
+const int readHashTimeoutMs = 300000;
+const qint64 defaultTailLineCount = 100;
+const qint64 minTransferChunkBytes = 4 * 1024;
+const qint64 defaultTransferChunkBytes = 1024 * 1024;
+const qint64 maxTransferChunkBytes = 8 * 1024 * 1024;
+// Raw bytes per transferRead reply across all returned chunks.
+const qint64 maxTransferReadBytes = 8 * 1024 * 1024;
+const qint64 maxTransferReadChunks = 64;
+const qint64 defaultTransferTtlMs = 10 * 60 * 1000;
+const qint64 maxTransferTtlMs = 24 * 60 * 60 * 1000;
+const int maxReadManyItems = 200;
+// Content bytes shared by every item of one readMany call.
+const qint64 defaultReadManyTotalBytes = 4 * 1024 * 1024;
+const qint64 maxReadManyTotalBytes = 16 * 1024 * 1024;
+const int readManyTimeoutMs = 60000;
+const qint64 minDeltaBlockBytes = 512;
+const qint64 maxDeltaBlockBytes = 1024 * 1024;
+const int maxDeltaBlocks = 262144;
+// Literal (changed) bytes a delta may return before the caller is better off re-reading.
+const qint64 defaultDeltaMaxBytes = 4 * 1024 * 1024;
+const qint64 maxDeltaMaxBytes = 8 * 1024 * 1024;
+const int readDeltaTimeoutMs = 120000;
+const qint64 defaultArchiveMaxFiles = 10000;
+// zip without zip64 stops at 65535 entries; the same cap keeps tar listings sane.
+const qint64 maxArchiveMaxFiles = 65535;
+const qint64 defaultArchiveMaxTotalBytes = 1024LL * 1024 * 1024;
+const qint64 maxArchiveMaxTotalBytes = 2048LL * 1024 * 1024;
+const int readArchiveTimeoutMs = 300000;
+const int maxArchiveErrorEntries = 1000;
 
 enum class FileReadOperation
 {
@@ -228,6 +97,16 @@ enum class FileReadOperation
     Rg,
     Stat,
     Md5,
+    Du,
+    Hash,
+    Tail,
+    TransferOpen,
+    TransferRead,
+    TransferStatus,
+    TransferClose,
+    ReadMany,
+    Delta,
+    Archive,
 };
 
 QString fileReadOperationName(FileReadOperation operation)
@@ -246,6 +125,26 @@ QString fileReadOperationName(FileReadOperation operation)
         return QStringLiteral("stat");
     case FileReadOperation::Md5:
         return QStringLiteral("md5");
+    case FileReadOperation::Du:
+        return QStringLiteral("du");
+    case FileReadOperation::Hash:
+        return QStringLiteral("hash");
+    case FileReadOperation::Tail:
+        return QStringLiteral("tail");
+    case FileReadOperation::TransferOpen:
+        return QStringLiteral("transferOpen");
+    case FileReadOperation::TransferRead:
+        return QStringLiteral("transferRead");
+    case FileReadOperation::TransferStatus:
+        return QStringLiteral("transferStatus");
+    case FileReadOperation::TransferClose:
+        return QStringLiteral("transferClose");
+    case FileReadOperation::ReadMany:
+        return QStringLiteral("readMany");
+    case FileReadOperation::Delta:
+        return QStringLiteral("delta");
+    case FileReadOperation::Archive:
+        return QStringLiteral("archive");
     }
     return QStringLiteral("read");
 }
@@ -310,13 +209,100 @@ bool parseReadOperation(
         *operation = FileReadOperation::Md5;
         return true;
     }
+    if ( ( normalized == QStringLiteral("du") ) ||
+         ( normalized == QStringLiteral("tree-summary") ) ||
+         ( normalized == QStringLiteral("treesummary") ) )
+    {
+        *operation = FileReadOperation::Du;
+        return true;
+    }
+    if ( normalized == QStringLiteral("hash") )
+    {
+        *operation = FileReadOperation::Hash;
+        return true;
+    }
+    if ( normalized == QStringLiteral("tail") )
+    {
+        *operation = FileReadOperation::Tail;
+        return true;
+    }
+    if ( normalized == QStringLiteral("transferopen") )
+    {
+        *operation = FileReadOperation::TransferOpen;
+        return true;
+    }
+    if ( normalized == QStringLiteral("transferread") )
+    {
+        *operation = FileReadOperation::TransferRead;
+        return true;
+    }
+    if ( normalized == QStringLiteral("transferstatus") )
+    {
+        *operation = FileReadOperation::TransferStatus;
+        return true;
+    }
+    if ( normalized == QStringLiteral("transferclose") )
+    {
+        *operation = FileReadOperation::TransferClose;
+        return true;
+    }
+    if ( normalized == QStringLiteral("readmany") )
+    {
+        *operation = FileReadOperation::ReadMany;
+        return true;
+    }
+    if ( normalized == QStringLiteral("delta") )
+    {
+        *operation = FileReadOperation::Delta;
+        return true;
+    }
+    if ( normalized == QStringLiteral("archive") )
+    {
+        *operation = FileReadOperation::Archive;
+        return true;
+    }
 
     if ( error != nullptr )
     {
-        *error = QStringLiteral("file.read operation must be one of: read, lines, list, rg, stat, md5");
+        *error = QStringLiteral(
+            "file.read operation must be one of: read, lines, list, rg, stat, md5, du, hash, tail, "
+            "transferOpen, transferRead, transferStatus, transferClose, readMany, delta, archive"
+        );
     }
     return false;
 }
+
+bool parseReadCompression(
+    const QJsonObject &paramsObject,
+    bool *gzip,
+    QString *error
+)
+{
+    QString compression;
+    if ( !Common::parseOptionalToken(
+            paramsObject,
+            QStringLiteral("compression"),
+            QStringLiteral("none"),
+            &compression,
+            error,
+            QStringLiteral("file.read")
+        ) )
+    {
+        return false;
+    }
+    if ( ( compression != QStringLiteral("none") ) &&
+         ( compression != QStringLiteral("gzip") ) )
+    {
+        if ( error != nullptr )
+        {
+            *error = QStringLiteral("file.read compression must be one of: none, gzip");
+        }
+        return false;
+    }
+    *gzip = ( compression == QStringLiteral("gzip") );
+    return true;
+}
+
 bool parseReadOffsetBytes(
     const QJsonObject &paramsObject,
     qint64 *offsetBytes,
@@ -475,35 +461,6 @@ QString fileTargetType(const QFileInfo &fileInfo)
     return QStringLiteral("other");
 }
 
-QString normalizedRelativePath(const QDir &rootDir, const QFileInfo &entryInfo)
-{
-    QString relativePath = rootDir.relativeFilePath(entryInfo.absoluteFilePath());
-    relativePath.replace('\\', '/');
-    return relativePath;
-}
-
-bool matchesGlobPatterns(
-    const QStringList &globPatterns,
-    const QString &relativePath,
-    const QString &fileName
-)
-{
-    if ( globPatterns.isEmpty() )
-    {
-        return true;
-    }
-
-    for ( const QString &pattern : globPatterns )
-    {
-        if ( QDir::match(pattern, relativePath) ||
-             QDir::match(pattern, fileName) )
-        {
-            return true;
-        }
-    }
-    return false;
-}
-
 void appendTimestamp(
     QJsonObject *timestamps,
     const QString &key,
@@ -643,95 +600,1676 @@ QJsonObject buildListEntryObject(
     return entry;
 }
 
-bool parseReadMaxBytes(
-    const QJsonObject &paramsObject,
-    qint64 *maxBytes,
-    QString *error
+// Directories first, then by name; the exact-case tiebreak keeps the order total on
+// case-insensitive platforms so page boundaries are stable.
+bool listEntryLessThan(
+    bool leftIsDir,
+    const QString &leftName,
+    bool rightIsDir,
+    const QString &rightName
 )
 {
-    if ( maxBytes == nullptr )
+    if ( leftIsDir != rightIsDir )
     {
-        if ( error != nullptr )
+        return leftIsDir;
+    }
+    const int compared = QString::compare(leftName, rightName, Common::pathCaseSensitivity());
+    if ( compared != 0 )
+    {
+        return compared < 0;
+    }
+    return QString::compare(leftName, rightName, Qt::CaseSensitive) < 0;
+}
+
+QFileInfoList listDirectorySorted(const QString &directoryPath, QDir::Filters entryFilters)
+{
+    QFileInfoList entryInfos = QDir(directoryPath).entryInfoList(entryFilters, QDir::NoSort);
+    std::sort(
+        entryInfos.begin(),
+        entryInfos.end(),
+        [](const QFileInfo &a, const QFileInfo &b)
         {
-            *error = QStringLiteral("file capability internal error: maxBytes output pointer is null");
+            return listEntryLessThan(a.isDir(), a.fileName(), b.isDir(), b.fileName());
         }
-        return false;
-    }
+    );
+    return entryInfos;
+}
 
-    return Common::parseOptionalInt64(
-        paramsObject,
-        QStringLiteral("maxBytes"),
-        1,
-        maxReadMaxBytes,
-        defaultReadMaxBytes,
-        maxBytes,
-        error,
-        QString()
+bool shouldDescendListEntry(const QFileInfo &entryInfo)
+{
+    // Same as QDirIterator::Subdirectories without FollowSymlinks.
+    return entryInfo.isDir() && !entryInfo.isSymLink();
+}
+
+struct ListWalkFrame
+{
+    QString directoryPath;
+    QString relativePrefix;
+    QFileInfoList entries;
+    int nextIndex = 0;
+};
+
+struct ListCursor
+{
+    QString afterRelativePath;
+    bool afterIsDir = false;
+};
+
+QJsonObject listCursorScope(
+    const QString &rootPath,
+    bool recursive,
+    bool includeHidden,
+    const QStringList &globPatterns
+)
+{
+    QJsonObject scope;
+    scope.insert(QStringLiteral("root"), rootPath);
+    scope.insert(QStringLiteral("recursive"), recursive);
+    scope.insert(QStringLiteral("includeHidden"), includeHidden);
+    scope.insert(QStringLiteral("glob"), QJsonArray::fromStringList(globPatterns));
+    return scope;
+}
+
+QString encodeListCursor(const QJsonObject &scope, const ListCursor &cursor)
+{
+    QJsonObject cursorObject;
+    cursorObject.insert(QStringLiteral("v"), 1);
+    cursorObject.insert(QStringLiteral("scope"), scope);
+    cursorObject.insert(QStringLiteral("after"), cursor.afterRelativePath);
+    cursorObject.insert(QStringLiteral("afterIsDir"), cursor.afterIsDir);
+    return QString::fromLatin1(
+        QJsonDocument(cursorObject).toJson(QJsonDocument::Compact).toBase64(
+            QByteArray::Base64UrlEncoding | QByteArray::OmitTrailingEquals
+        )
     );
 }
 
-bool parseReadMaxEntries(
+bool parseListCursor(
     const QJsonObject &paramsObject,
-    qint64 *maxEntries,
+    const QJsonObject &scope,
+    bool *hasCursor,
+    ListCursor *cursor,
     QString *error
 )
 {
-    if ( maxEntries == nullptr )
+    *hasCursor = false;
+    const QJsonValue cursorValue = paramsObject.value(QStringLiteral("cursor"));
+    if ( cursorValue.isUndefined() || cursorValue.isNull() )
     {
-        if ( error != nullptr )
+        return true;
+    }
+    if ( !cursorValue.isString() )
+    {
+        *error = QStringLiteral("file.read cursor must be string");
+        return false;
+    }
+    const QString cursorText = cursorValue.toString().trimmed();
+    if ( cursorText.isEmpty() )
+    {
+        return true;
+    }
+
+    const QByteArray::FromBase64Result decoded = QByteArray::fromBase64Encoding(
+        cursorText.toLatin1(),
+        QByteArray::Base64UrlEncoding | QByteArray::AbortOnBase64DecodingErrors
+    );
+    const QJsonObject cursorObject = decoded
+        ? QJsonDocument::fromJson(decoded.decoded).object()
+        : QJsonObject();
+    const QString afterRelativePath = cursorObject.value(QStringLiteral("after")).toString();
+    if ( ( cursorObject.value(QStringLiteral("v")).toInt() != 1 ) ||
+         afterRelativePath.isEmpty() )
+    {
+        *error = QStringLiteral("file.read cursor is invalid");
+        return false;
+    }
+    for ( const QString &component : afterRelativePath.split('/') )
+    {
+        if ( component.isEmpty() ||
+             ( component == QStringLiteral(".") ) ||
+             ( component == QStringLiteral("..") ) )
         {
-            *error = QStringLiteral("file capability internal error: maxEntries output pointer is null");
+            *error = QStringLiteral("file.read cursor is invalid");
+            return false;
         }
+    }
+    if ( cursorObject.value(QStringLiteral("scope")).toObject() != scope )
+    {
+        *error = QStringLiteral("file.read cursor does not match path/recursive/includeHidden/glob");
         return false;
     }
 
-    return Common::parseOptionalInt64(
-        paramsObject,
-        QStringLiteral("maxEntries"),
-        1,
-        maxReadMaxEntries,
-        defaultReadMaxEntries,
-        maxEntries,
-        error,
-        QString()
+    cursor->afterRelativePath = afterRelativePath;
+    cursor->afterIsDir = cursorObject.value(QStringLiteral("afterIsDir")).toBool();
+    *hasCursor = true;
+    return true;
+}
+
+// 64-bit identity values do not survive JSON doubles, so they travel as strings.
+QString encodeTailCursor(const QString &path, const FileTailCursor &cursor)
+{
+    QJsonObject cursorObject;
+    cursorObject.insert(QStringLiteral("v"), 1);
+    cursorObject.insert(QStringLiteral("path"), path);
+    cursorObject.insert(QStringLiteral("dev"), QString::number(cursor.device));
+    cursorObject.insert(QStringLiteral("ino"), QString::number(cursor.inode));
+    cursorObject.insert(QStringLiteral("off"), cursor.offsetBytes);
+    cursorObject.insert(QStringLiteral("probeBytes"), cursor.probeBytes);
+    cursorObject.insert(QStringLiteral("probe"), QString::number(cursor.probeXxh3, 16));
+    return QString::fromLatin1(
+        QJsonDocument(cursorObject).toJson(QJsonDocument::Compact).toBase64(
+            QByteArray::Base64UrlEncoding | QByteArray::OmitTrailingEquals
+        )
     );
 }
 
-bool parseRgMaxMatches(
+bool parseTailCursor(
     const QJsonObject &paramsObject,
-    qint64 *maxMatches,
+    const QString &path,
+    bool *hasCursor,
+    FileTailCursor *cursor,
     QString *error
 )
 {
-    if ( maxMatches == nullptr )
+    *hasCursor = false;
+    const QJsonValue cursorValue = paramsObject.value(QStringLiteral("cursor"));
+    if ( cursorValue.isUndefined() || cursorValue.isNull() )
     {
-        if ( error != nullptr )
-        {
-            *error = QStringLiteral("file capability internal error: maxMatches output pointer is null");
-        }
+        return true;
+    }
+    if ( !cursorValue.isString() )
+    {
+        *error = QStringLiteral("file.read cursor must be string");
         return false;
     }
+    const QString cursorText = cursorValue.toString().trimmed();
+    if ( cursorText.isEmpty() )
+    {
+        return true;
+    }
 
-    return Common::parseOptionalInt64(
-        paramsObject,
-        QStringLiteral("maxMatches"),
-        1,
-        maxRgMaxMatches,
-        defaultRgMaxMatches,
-        maxMatches,
-        error,
-        QString()
+    const QByteArray::FromBase64Result decoded = QByteArray::fromBase64Encoding(
+        cursorText.toLatin1(),
+        QByteArray::Base64UrlEncoding | QByteArray::AbortOnBase64DecodingErrors
     );
+    const QJsonObject cursorObject = decoded
+        ? QJsonDocument::fromJson(decoded.decoded).object()
+        : QJsonObject();
+    bool deviceOk = false;
+    bool inodeOk = false;
+    bool probeOk = false;
+    cursor->device = cursorObject.value(QStringLiteral("dev")).toString().toULongLong(&deviceOk);
+    cursor->inode = cursorObject.value(QStringLiteral("ino")).toString().toULongLong(&inodeOk);
+    cursor->probeXxh3 = cursorObject.value(QStringLiteral("probe")).toString().toULongLong(&probeOk, 16);
+    cursor->offsetBytes = cursorObject.value(QStringLiteral("off")).toInteger(-1);
+    cursor->probeBytes = cursorObject.value(QStringLiteral("probeBytes")).toInteger(-1);
+    if ( ( cursorObject.value(QStringLiteral("v")).toInt() != 1 ) ||
+         !deviceOk ||
+         !inodeOk ||
+         !probeOk ||
+         ( cursor->offsetBytes < 0 ) ||
+         ( cursor->probeBytes < 0 ) ||
+         ( cursor->probeBytes > FileTailCursor::maxProbeBytes ) ||
+         ( cursor->probeBytes > cursor->offsetBytes ) )
+    {
+        *error = QStringLiteral("file.read cursor is invalid");
+        return false;
+    }
+    if ( QString::compare(
+             cursorObject.value(QStringLiteral("path")).toString(),
+             path,
+             Common::pathCaseSensitivity()
+         ) != 0 )
+    {
+        *error = QStringLiteral("file.read cursor does not match path");
+        return false;
+    }
+
+    *hasCursor = true;
+    return true;
 }
-QString encodeContent(const QByteArray &bytes, Common::ContentEncoding encoding)
+
+// Rebuilds the walk stack so the next emitted entry is the one following cursor in
+// pre-order. Entries deleted between pages are skipped by falling back to the sort
+// position they would have had.
+void seedListWalkStack(
+    const QString &rootPath,
+    QDir::Filters entryFilters,
+    bool recursive,
+    const FileGlobMatcher &globMatcher,
+    const ListCursor *cursor,
+    QList<ListWalkFrame> *stack
+)
 {
-    if ( encoding == Common::ContentEncoding::Base64 )
+    ListWalkFrame rootFrame;
+    rootFrame.directoryPath = rootPath;
+    rootFrame.entries = listDirectorySorted(rootPath, entryFilters);
+    if ( cursor == nullptr )
     {
-        return QString::fromLatin1(bytes.toBase64());
+        stack->append(rootFrame);
+        return;
     }
-    return QString::fromUtf8(bytes);
-}
-}
+
+    const QStringList components = cursor->afterRelativePath.split('/');
+    ListWalkFrame frame = rootFrame;
+    for ( int componentIndex = 0; componentIndex < components.size(); ++componentIndex )
+    {
+        const QString &component = components.at(componentIndex);
+        const bool isLast = ( componentIndex == ( components.size() - 1 ) );
+        const bool componentIsDir = isLast ? cursor->afterIsDir : true;
+
+        int position = 0;
+        while ( ( position < frame.entries.size() ) &&
+                listEntryLessThan(
+                    frame.entries.at(position).isDir(),
+                    frame.entries.at(position).fileName(),
+                    componentIsDir,
+                    component
+                ) )
+        {
+            ++position;
+        }
+        const bool exact = ( position < frame.entries.size() ) &&
+            ( frame.entries.at(position).isDir() == componentIsDir ) &&
+            ( frame.entries.at(position).fileName() == component );
+        frame.nextIndex = exact ? ( position + 1 ) : position;
+        stack->append(frame);
+
+        if ( !exact || !recursive )
+        {
+            return;
+        }
+        const QFileInfo entryInfo = frame.entries.at(position);
+        const QString relativePath = frame.relativePrefix + entryInfo.fileName();
+        if ( !shouldDescendListEntry(entryInfo) ||
+             !globMatcher.canMatchBelow(relativePath) )
+        {
+            return;
+        }
+
+        ListWalkFrame childFrame;
+        childFrame.directoryPath = entryInfo.absoluteFilePath();
+        childFrame.relativePrefix = relativePath + QLatin1Char('/');
+        childFrame.entries = listDirectorySorted(childFrame.directoryPath, entryFilters);
+        if ( isLast )
+        {
+            // The cursor entry itself was emitted; its subtree comes next.
+            stack->append(childFrame);
+            return;
+        }
+        frame = childFrame;
+    }
+}
+
+void countListEntries(
+    const QString &rootPath,
+    QDir::Filters entryFilters,
+    bool recursive,
+    const FileGlobMatcher &globMatcher,
+    qint64 *directoryCount,
+    qint64 *fileCount,
+    qint64 *otherCount
+)
+{
+    QList<QPair<QString, QString>> pendingDirectories;
+    pendingDirectories.append(qMakePair(rootPath, QString()));
+    while ( !pendingDirectories.isEmpty() )
+    {
+        const QPair<QString, QString> directory = pendingDirectories.takeLast();
+        QDirIterator iterator(directory.first, entryFilters);
+        while ( iterator.hasNext() )
+        {
+            iterator.next();
+            const QFileInfo entryInfo = iterator.fileInfo();
+            const QString relativePath = directory.second + entryInfo.fileName();
+            if ( recursive &&
+                 shouldDescendListEntry(entryInfo) &&
+                 globMatcher.canMatchBelow(relativePath) )
+            {
+                pendingDirectories.append(
+                    qMakePair(entryInfo.absoluteFilePath(), relativePath + QLatin1Char('/'))
+                );
+            }
+            if ( !globMatcher.matches(relativePath, entryInfo.fileName()) )
+            {
+                continue;
+            }
+
+            if ( entryInfo.isDir() )
+            {
+                ++( *directoryCount );
+            }
+            else if ( entryInfo.isFile() )
+            {
+                ++( *fileCount );
+            }
+            else
+            {
+                ++( *otherCount );
+            }
+        }
+    }
+}
+
+bool parseReadMaxBytes(
+    const QJsonObject &paramsObject,
+    qint64 *maxBytes,
+    QString *error
+)
+{
+    if ( maxBytes == nullptr )
+    {
+        if ( error != nullptr )
+        {
+            *error = QStringLiteral("file capability internal error: maxBytes output pointer is null");
+        }
+        return false;
+    }
+
+    return Common::parseOptionalInt64(
+        paramsObject,
+        QStringLiteral("maxBytes"),
+        1,
+        maxReadMaxBytes,
+        defaultReadMaxBytes,
+        maxBytes,
+        error,
+        QString()
+    );
+}
+
+bool parseReadMaxEntries(
+    const QJsonObject &paramsObject,
+    qint64 *maxEntries,
+    QString *error
+)
+{
+    if ( maxEntries == nullptr )
+    {
+        if ( error != nullptr )
+        {
+            *error = QStringLiteral("file capability internal error: maxEntries output pointer is null");
+        }
+        return false;
+    }
+
+    return Common::parseOptionalInt64(
+        paramsObject,
+        QStringLiteral("maxEntries"),
+        1,
+        maxReadMaxEntries,
+        defaultReadMaxEntries,
+        maxEntries,
+        error,
+        QString()
+    );
+}
+
+bool parseRgMaxMatches(
+    const QJsonObject &paramsObject,
+    qint64 *maxMatches,
+    QString *error
+)
+{
+    if ( maxMatches == nullptr )
+    {
+        if ( error != nullptr )
+        {
+            *error = QStringLiteral("file capability internal error: maxMatches output pointer is null");
+        }
+        return false;
+    }
+
+    return Common::parseOptionalInt64(
+        paramsObject,
+        QStringLiteral("maxMatches"),
+        1,
+        maxRgMaxMatches,
+        defaultRgMaxMatches,
+        maxMatches,
+        error,
+        QString()
+    );
+}
+
+// Appends the submatches of one rg --json line; returns false once maxMatches is exceeded.
+bool appendRgJsonMatches(
+    const QByteArray &jsonLine,
+    const QString &fallbackPath,
+    qint64 maxMatches,
+    QJsonArray *matches,
+    QSet<QString> *matchedFiles,
+    bool *truncated
+)
+{
+    const QByteArray trimmedLine = jsonLine.trimmed();
+    if ( trimmedLine.isEmpty() )
+    {
+        return true;
+    }
+
+    QJsonParseError jsonParseError;
+    const QJsonDocument jsonDocument =
+        QJsonDocument::fromJson(trimmedLine, &jsonParseError);
+    if ( jsonParseError.error != QJsonParseError::NoError )
+    {
+        return true;
+    }
+    if ( !jsonDocument.isObject() )
+    {
+        return true;
+    }
+
+    const QJsonObject envelope = jsonDocument.object();
+    if ( envelope.value(QStringLiteral("type")).toString() != QStringLiteral("match") )
+    {
+        return true;
+    }
+
+    const QJsonObject data = envelope.value(QStringLiteral("data")).toObject();
+    QString matchPath =
+        data.value(QStringLiteral("path")).toObject()
+            .value(QStringLiteral("text")).toString();
+    if ( matchPath.trimmed().isEmpty() )
+    {
+        matchPath = fallbackPath;
+    }
+    matchedFiles->insert(matchPath);
+
+    QString lineText =
+        data.value(QStringLiteral("lines")).toObject()
+            .value(QStringLiteral("text")).toString();
+    while ( lineText.endsWith(QLatin1Char('\n')) ||
+            lineText.endsWith(QLatin1Char('\r')) )
+    {
+        lineText.chop(1);
+    }
+    const int lineNumber = data.value(QStringLiteral("line_number")).toInt();
+    const QJsonArray submatches = data.value(QStringLiteral("submatches")).toArray();
+
+    if ( submatches.isEmpty() )
+    {
+        if ( matches->size() >= maxMatches )
+        {
+            *truncated = true;
+            return false;
+        }
+
+        QJsonObject matchItem;
+        matchItem.insert(QStringLiteral("path"), matchPath);
+        matchItem.insert(QStringLiteral("lineNumber"), lineNumber);
+        matchItem.insert(QStringLiteral("columnStart"), 1);
+        matchItem.insert(QStringLiteral("columnEnd"), 1);
+        matchItem.insert(QStringLiteral("lineText"), lineText);
+        matchItem.insert(QStringLiteral("matchText"), QString());
+        matches->append(matchItem);
+        return true;
+    }
+
+    for ( const QJsonValue &submatchValue : submatches )
+    {
+        if ( matches->size() >= maxMatches )
+        {
+            *truncated = true;
+            return false;
+        }
+
+        const QJsonObject submatch = submatchValue.toObject();
+        const int start = submatch.value(QStringLiteral("start")).toInt();
+        const int end = submatch.value(QStringLiteral("end")).toInt();
+        const QString matchText =
+            submatch.value(QStringLiteral("match")).toObject()
+                .value(QStringLiteral("text")).toString();
+
+        QJsonObject matchItem;
+        matchItem.insert(QStringLiteral("path"), matchPath);
+        matchItem.insert(QStringLiteral("lineNumber"), lineNumber);
+        matchItem.insert(QStringLiteral("columnStart"), start + 1);
+        matchItem.insert(QStringLiteral("columnEnd"), end);
+        matchItem.insert(QStringLiteral("lineText"), lineText);
+        matchItem.insert(QStringLiteral("matchText"), matchText);
+        matches->append(matchItem);
+    }
+    return true;
+}
+
+void appendBoundedStderr(QByteArray *stderrBytes, const QByteArray &chunk)
+{
+    const qsizetype remaining = readRgMaxStderrBytes - stderrBytes->size();
+    if ( remaining > 0 )
+    {
+        stderrBytes->append(chunk.left(remaining));
+    }
+}
+
+QJsonArray treeSizeEntriesToJson(const QList<FileTreeSizeEntry> &sizeEntries)
+{
+    QJsonArray array;
+    for ( const FileTreeSizeEntry &sizeEntry : sizeEntries )
+    {
+        QJsonObject item;
+        item.insert(QStringLiteral("name"), sizeEntry.name);
+        item.insert(QStringLiteral("path"), sizeEntry.path);
+        item.insert(QStringLiteral("type"), sizeEntry.type);
+        item.insert(QStringLiteral("sizeBytes"), sizeEntry.sizeBytes);
+        if ( sizeEntry.type == QStringLiteral("directory") )
+        {
+            item.insert(QStringLiteral("fileCount"), sizeEntry.fileCount);
+        }
+        array.append(item);
+    }
+    return array;
+}
+
+QJsonObject transferInfoToJson(const FileTransferInfo &info, FileReadOperation operation)
+{
+    QJsonObject out;
+    out.insert(QStringLiteral("path"), info.path);
+    out.insert(QStringLiteral("operation"), fileReadOperationName(operation));
+    out.insert(QStringLiteral("transferId"), info.transferId);
+    out.insert(QStringLiteral("sizeBytes"), info.sizeBytes);
+    out.insert(QStringLiteral("chunkBytes"), info.chunkBytes);
+    out.insert(QStringLiteral("chunkCount"), info.chunkCount);
+    if ( !info.sha256.isEmpty() )
+    {
+        out.insert(QStringLiteral("sha256"), info.sha256);
+    }
+    out.insert(QStringLiteral("ackedChunks"), info.ackedChunks);
+    out.insert(QStringLiteral("resumeOffsetBytes"), qMin(info.sizeBytes, info.ackedChunks * info.chunkBytes));
+    out.insert(QStringLiteral("nextSeq"), info.nextSeq);
+    out.insert(QStringLiteral("servedChunks"), info.servedChunks);
+    out.insert(QStringLiteral("servedBytes"), info.servedBytes);
+    out.insert(QStringLiteral("ttlMs"), info.ttlMs);
+    out.insert(QStringLiteral("expiresInMs"), info.expiresInMs);
+    return out;
+}
+
+// chunkBytes / ttlMs / hash, shared by transferOpen and archive. hashTimeoutMs is -1
+// when hashing was turned off.
+bool parseTransferOpenOptions(
+    const QJsonObject &paramsObject,
+    int invokeTimeoutMs,
+    qint64 *chunkBytes,
+    qint64 *ttlMs,
+    int *hashTimeoutMs,
+    QString *error
+)
+{
+    if ( !Common::parseOptionalInt64(
+            paramsObject,
+            QStringLiteral("chunkBytes"),
+            minTransferChunkBytes,
+            maxTransferChunkBytes,
+            defaultTransferChunkBytes,
+            chunkBytes,
+            error,
+            QStringLiteral("file.read")
+        ) )
+    {
+        return false;
+    }
+
+    if ( !Common::parseOptionalInt64(
+            paramsObject,
+            QStringLiteral("ttlMs"),
+            1000,
+            maxTransferTtlMs,
+            defaultTransferTtlMs,
+            ttlMs,
+            error,
+            QStringLiteral("file.read")
+        ) )
+    {
+        return false;
+    }
+
+    bool hash = true;
+    if ( !Common::parseOptionalBool(
+            paramsObject,
+            QStringLiteral("hash"),
+            true,
+            &hash,
+            error
+        ) )
+    {
+        return false;
+    }
+
+    *hashTimeoutMs = -1;
+    if ( hash )
+    {
+        *hashTimeoutMs = ( invokeTimeoutMs >= 0 )
+            ? qMin(readHashTimeoutMs, invokeTimeoutMs)
+            : readHashTimeoutMs;
+    }
+    return true;
+}
+
+bool readTransfer(
+    FileReadOperation operation,
+    const QJsonObject &paramsObject,
+    const QString &path,
+    int invokeTimeoutMs,
+    QJsonObject *result,
+    QString *error,
+    bool *invalidParams
+)
+{
+    QString parseError;
+    FileTransferInfo info;
+    QString transferError;
+
+    if ( operation == FileReadOperation::TransferOpen )
+    {
+        if ( path.isEmpty() )
+        {
+            return Common::failInvalidParams(
+                invalidParams,
+                error,
+                QStringLiteral("file.read transferOpen requires path")
+            );
+        }
+        const QFileInfo fileInfo(path);
+        if ( !fileInfo.isFile() )
+        {
+            if ( error != nullptr )
+            {
+                *error = fileInfo.exists()
+                    ? QStringLiteral("file.read transferOpen target is not a file")
+                    : QStringLiteral("file.read target does not exist");
+            }
+            return false;
+        }
+
+        qint64 chunkBytes = defaultTransferChunkBytes;
+        qint64 ttlMs = defaultTransferTtlMs;
+        int hashTimeoutMs = -1;
+        if ( !parseTransferOpenOptions(
+                paramsObject,
+                invokeTimeoutMs,
+                &chunkBytes,
+                &ttlMs,
+                &hashTimeoutMs,
+                &parseError
+            ) )
+        {
+            return Common::failInvalidParams(invalidParams, error, parseError);
+        }
+
+        if ( !FileTransferSession::open(
+                fileInfo.absoluteFilePath(),
+                chunkBytes,
+                ttlMs,
+                hashTimeoutMs,
+                &info,
+                &transferError
+            ) )
+        {
+            if ( error != nullptr )
+            {
+                *error = QStringLiteral("file.read transferOpen failed: %1").arg(transferError);
+            }
+            return false;
+        }
+
+        qInfo().noquote() << QStringLiteral(
+            "[capability.file.read] transfer open id=%1 path=%2 sizeBytes=%3 chunkBytes=%4 chunks=%5"
+        ).arg(
+            info.transferId,
+            info.path,
+            QString::number(info.sizeBytes),
+            QString::number(info.chunkBytes),
+            QString::number(info.chunkCount)
+        );
+        *result = transferInfoToJson(info, operation);
+        return true;
+    }
+
+    QString transferId;
+    if ( !Common::parseRequiredTrimmedString(
+            paramsObject,
+            QStringLiteral("transferId"),
+            &transferId,
+            &parseError,
+            QStringLiteral("file.read")
+        ) )
+    {
+        return Common::failInvalidParams(invalidParams, error, parseError);
+    }
+
+    if ( operation == FileReadOperation::TransferClose )
+    {
+        if ( !FileTransferSession::close(transferId, &info, &transferError) )
+        {
+            if ( error != nullptr )
+            {
+                *error = QStringLiteral("file.read transferClose failed: %1").arg(transferError);
+            }
+            return false;
+        }
+
+        qInfo().noquote() << QStringLiteral(
+            "[capability.file.read] transfer close id=%1 servedChunks=%2 servedBytes=%3 ackedChunks=%4/%5"
+        ).arg(
+            info.transferId,
+            QString::number(info.servedChunks),
+            QString::number(info.servedBytes),
+            QString::number(info.ackedChunks),
+            QString::number(info.chunkCount)
+        );
+        *result = transferInfoToJson(info, operation);
+        result->insert(QStringLiteral("closed"), true);
+        return true;
+    }
+
+    // ackSeq: every chunk below it has been received by the reader.
+    qint64 ackSeq = -1;
+    if ( !Common::parseOptionalInt64(
+            paramsObject,
+            QStringLiteral("ackSeq"),
+            0,
+            std::numeric_limits<qint64>::max(),
+            -1,
+            &ackSeq,
+            &parseError,
+            QStringLiteral("file.read")
+        ) )
+    {
+        return Common::failInvalidParams(invalidParams, error, parseError);
+    }
+
+    if ( operation == FileReadOperation::TransferStatus )
+    {
+        if ( !FileTransferSession::status(transferId, ackSeq, &info, &transferError) )
+        {
+            if ( error != nullptr )
+            {
+                *error = QStringLiteral("file.read transferStatus failed: %1").arg(transferError);
+            }
+            return false;
+        }
+        *result = transferInfoToJson(info, operation);
+        return true;
+    }
+
+    qint64 seq = -1;
+    if ( !Common::parseOptionalInt64(
+            paramsObject,
+            QStringLiteral("seq"),
+            0,
+            std::numeric_limits<qint64>::max(),
+            -1,
+            &seq,
+            &parseError,
+            QStringLiteral("file.read")
+        ) )
+    {
+        return Common::failInvalidParams(invalidParams, error, parseError);
+    }
+
+    qint64 count = 1;
+    if ( !Common::parseOptionalInt64(
+            paramsObject,
+            QStringLiteral("count"),
+            1,
+            maxTransferReadChunks,
+            1,
+            &count,
+            &parseError,
+            QStringLiteral("file.read")
+        ) )
+    {
+        return Common::failInvalidParams(invalidParams, error, parseError);
+    }
+
+    QList<FileTransferChunk> chunks;
+    if ( !FileTransferSession::read(
+            transferId,
+            seq,
+            count,
+            maxTransferReadBytes,
+            ackSeq,
+            &chunks,
+            &info,
+            &transferError
+        ) )
+    {
+        if ( error != nullptr )
+        {
+            *error = QStringLiteral("file.read transferRead failed: %1").arg(transferError);
+        }
+        return false;
+    }
+
+    QJsonArray chunkArray;
+    qint64 readBytes = 0;
+    for ( const FileTransferChunk &chunk : chunks )
+    {
+        QJsonObject item;
+        item.insert(QStringLiteral("seq"), chunk.seq);
+        item.insert(QStringLiteral("offsetBytes"), chunk.offsetBytes);
+        item.insert(QStringLiteral("sizeBytes"), chunk.sizeBytes);
+        item.insert(QStringLiteral("xxh3"), chunk.xxh3);
+        item.insert(QStringLiteral("content"), chunk.contentBase64);
+        chunkArray.append(item);
+        readBytes += chunk.sizeBytes;
+    }
+
+    QJsonObject out = transferInfoToJson(info, operation);
+    out.insert(QStringLiteral("encoding"), QStringLiteral("base64"));
+    out.insert(QStringLiteral("readBytes"), readBytes);
+    out.insert(
+        QStringLiteral("eof"),
+        chunks.isEmpty()
+            ? ( ( seq < 0 ? info.nextSeq : seq ) >= info.chunkCount )
+            : ( ( chunks.last().seq + 1 ) >= info.chunkCount )
+    );
+    out.insert(QStringLiteral("chunks"), chunkArray);
+    *result = out;
+    return true;
+}
+
+QString encodeContent(const char *data, qint64 size, Common::ContentEncoding encoding)
+{
+    if ( encoding == Common::ContentEncoding::Base64 )
+    {
+        return Base64Codec::toBase64String(data, size);
+    }
+    return QString::fromUtf8(data, static_cast<qsizetype>(size));
+}
+
+QString encodeContent(const QByteArray &bytes, Common::ContentEncoding encoding)
+{
+    return encodeContent(bytes.constData(), bytes.size(), encoding);
+}
+
+// With gzip requested, content becomes base64(gzip(data)) whenever that is actually the
+// shorter string; otherwise the plain encoding is kept. *compressedBytes is the gzip
+// size, or 0 when the content was not compressed.
+QString encodeContent(
+    const char *data,
+    qint64 size,
+    Common::ContentEncoding encoding,
+    bool gzip,
+    qint64 *compressedBytes
+)
+{
+    *compressedBytes = 0;
+    if ( gzip && ( size >= readCompressMinBytes ) )
+    {
+        QByteArray compressed;
+        const qint64 plainChars = ( encoding == Common::ContentEncoding::Base64 )
+            ? Base64Codec::encodedSize(size)
+            : size;
+        if ( GzipCodec::compress(data, size, -1, &compressed) &&
+             ( Base64Codec::encodedSize(compressed.size()) < plainChars ) )
+        {
+            *compressedBytes = compressed.size();
+            return Base64Codec::toBase64String(compressed.constData(), compressed.size());
+        }
+    }
+    return encodeContent(data, size, encoding);
+}
+
+void insertCompressionFields(QJsonObject *out, bool gzip, qint64 uncompressedBytes, qint64 compressedBytes)
+{
+    if ( !gzip )
+    {
+        return;
+    }
+    out->insert(QStringLiteral("compression"), ( compressedBytes > 0 ) ? QStringLiteral("gzip") : QStringLiteral("none"));
+    if ( compressedBytes > 0 )
+    {
+        // The decompressed bytes are the raw data (UTF-8 text for lines), whatever
+        // encoding was requested.
+        out->insert(QStringLiteral("encoding"), QStringLiteral("base64"));
+        out->insert(QStringLiteral("uncompressedBytes"), uncompressedBytes);
+        out->insert(QStringLiteral("compressedBytes"), compressedBytes);
+    }
+}
+
+bool readMany(
+    const QJsonObject &paramsObject,
+    int invokeTimeoutMs,
+    QJsonObject *result,
+    QString *error,
+    bool *invalidParams
+)
+{
+    QString parseError;
+    QJsonArray itemArray;
+    if ( !Common::parseRequiredObjectArray(
+            paramsObject,
+            QStringLiteral("items"),
+            1,
+            maxReadManyItems,
+            &itemArray,
+            &parseError,
+            QStringLiteral("file.read")
+        ) )
+    {
+        return Common::failInvalidParams(invalidParams, error, parseError);
+    }
+
+    qint64 totalMaxBytes = defaultReadManyTotalBytes;
+    if ( !Common::parseOptionalInt64(
+            paramsObject,
+            QStringLiteral("totalMaxBytes"),
+            1,
+            maxReadManyTotalBytes,
+            defaultReadManyTotalBytes,
+            &totalMaxBytes,
+            &parseError,
+            QStringLiteral("file.read")
+        ) )
+    {
+        return Common::failInvalidParams(invalidParams, error, parseError);
+    }
+
+    QList<FileBatchReadItem> items;
+    QList<Common::ContentEncoding> encodings;
+    for ( int index = 0; index < itemArray.size(); ++index )
+    {
+        const QJsonObject itemObject = itemArray.at(index).toObject();
+        const QString scope = QStringLiteral("file.read items[%1]").arg(index);
+
+        FileBatchReadItem item;
+        if ( !Common::parseRequiredTrimmedString(
+                itemObject,
+                QStringLiteral("path"),
+                &item.path,
+                &parseError,
+                scope
+            ) )
+        {
+            return Common::failInvalidParams(invalidParams, error, parseError);
+        }
+
+        Common::ContentEncoding encoding = Common::ContentEncoding::Utf8;
+        if ( !Common::parseEncoding(
+                itemObject,
+                QStringLiteral("encoding"),
+                &encoding,
+                &parseError,
+                scope
+            ) )
+        {
+            return Common::failInvalidParams(invalidParams, error, parseError);
+        }
+
+        item.lineMode = itemObject.contains(QStringLiteral("startLine")) ||
+                        itemObject.contains(QStringLiteral("endLine"));
+        if ( item.lineMode )
+        {
+            if ( encoding != Common::ContentEncoding::Utf8 )
+            {
+                return Common::failInvalidParams(
+                    invalidParams,
+                    error,
+                    QStringLiteral("%1 line range encoding must be utf8").arg(scope)
+                );
+            }
+            if ( !Common::parseRequiredInt64(
+                    itemObject,
+                    QStringLiteral("startLine"),
+                    1,
+                    std::numeric_limits<qint64>::max(),
+                    &item.startLine,
+                    &parseError,
+                    scope
+                ) ||
+                 !Common::parseRequiredInt64(
+                    itemObject,
+                    QStringLiteral("endLine"),
+                    1,
+                    std::numeric_limits<qint64>::max(),
+                    &item.endLine,
+                    &parseError,
+                    scope
+                ) )
+            {
+                return Common::failInvalidParams(invalidParams, error, parseError);
+            }
+            if ( item.endLine < item.startLine )
+            {
+                return Common::failInvalidParams(
+                    invalidParams,
+                    error,
+                    QStringLiteral("%1 endLine must be >= startLine").arg(scope)
+                );
+            }
+            if ( ( item.endLine - item.startLine + 1 ) > maxReadLineSpan )
+            {
+                return Common::failInvalidParams(
+                    invalidParams,
+                    error,
+                    QStringLiteral("%1 line span must be integer within [1, %2]").arg(scope).arg(maxReadLineSpan)
+                );
+            }
+        }
+        else
+        {
+            if ( !Common::parseOptionalInt64(
+                    itemObject,
+                    QStringLiteral("offsetBytes"),
+                    0,
+                    std::numeric_limits<qint64>::max(),
+                    0,
+                    &item.offsetBytes,
+                    &parseError,
+                    scope
+                ) ||
+                 !Common::parseOptionalInt64(
+                    itemObject,
+                    QStringLiteral("maxBytes"),
+                    1,
+                    maxReadMaxBytes,
+                    defaultReadMaxBytes,
+                    &item.maxBytes,
+                    &parseError,
+                    scope
+                ) )
+            {
+                return Common::failInvalidParams(invalidParams, error, parseError);
+            }
+        }
+        items.append(item);
+        encodings.append(encoding);
+    }
+
+    const int readTimeoutMs = ( invokeTimeoutMs >= 0 )
+        ? qMin(readManyTimeoutMs, invokeTimeoutMs)
+        : readManyTimeoutMs;
+
+    QElapsedTimer elapsedTimer;
+    elapsedTimer.start();
+    const QList<FileBatchReadResult> readResults = FileBatchReader::readAll(items, totalMaxBytes, readTimeoutMs);
+    const qint64 elapsedMs = elapsedTimer.elapsed();
+
+    // Items reserve from the shared budget while they read, so together they never hold
+    // more than totalMaxBytes; the budget is accounted again here in request order.
+    qint64 remainingBytes = totalMaxBytes;
+    qint64 okCount = 0;
+    QJsonArray outItems;
+    for ( int index = 0; index < readResults.size(); ++index )
+    {
+        const FileBatchReadItem &item = items.at(index);
+        const FileBatchReadResult &readResult = readResults.at(index);
+
+        QJsonObject outItem;
+        outItem.insert(QStringLiteral("index"), index);
+        outItem.insert(QStringLiteral("path"), readResult.path);
+        outItem.insert(QStringLiteral("ok"), readResult.ok);
+        if ( !readResult.ok )
+        {
+            outItem.insert(QStringLiteral("error"), readResult.error);
+            outItems.append(outItem);
+            continue;
+        }
+        ++okCount;
+        outItem.insert(QStringLiteral("sizeBytes"), readResult.sizeBytes);
+        outItem.insert(QStringLiteral("encoding"), Common::encodingName(encodings.at(index)));
+        outItem.insert(QStringLiteral("skipped"), remainingBytes == 0);
+        outItem.insert(QStringLiteral("timedOut"), readResult.timedOut);
+
+        if ( item.lineMode )
+        {
+            QJsonArray lines;
+            QStringList lineTexts;
+            bool truncated = readResult.capped || readResult.timedOut;
+            for ( int lineIndex = 0; lineIndex < readResult.lines.size(); ++lineIndex )
+            {
+                const QByteArray &rawLine = readResult.lines.at(lineIndex);
+                if ( ( rawLine.size() + 1 ) > remainingBytes )
+                {
+                    truncated = true;
+                    break;
+                }
+                remainingBytes -= rawLine.size() + 1;
+
+                const QString lineText = QString::fromUtf8(rawLine);
+                QJsonObject lineItem;
+                lineItem.insert(QStringLiteral("lineNumber"), item.startLine + lineIndex);
+                lineItem.insert(QStringLiteral("text"), lineText);
+                lines.append(lineItem);
+                lineTexts.append(lineText);
+            }
+            const bool eof = readResult.eof && !truncated;
+            outItem.insert(QStringLiteral("startLine"), item.startLine);
+            outItem.insert(QStringLiteral("endLine"), item.endLine);
+            outItem.insert(QStringLiteral("returnedLineCount"), lines.size());
+            outItem.insert(QStringLiteral("nextLine"), item.startLine + lines.size());
+            outItem.insert(QStringLiteral("truncated"), truncated);
+            outItem.insert(QStringLiteral("hasMore"), !eof);
+            outItem.insert(QStringLiteral("eof"), eof);
+            outItem.insert(QStringLiteral("content"), lineTexts.join(QLatin1Char('\n')));
+            outItem.insert(QStringLiteral("lines"), lines);
+        }
+        else
+        {
+            const qint64 readBytes = qMin<qint64>(readResult.bytes.size(), remainingBytes);
+            remainingBytes -= readBytes;
+            const bool truncated = readResult.capped || readResult.timedOut || ( readBytes < readResult.bytes.size() );
+            const qint64 nextOffsetBytes = item.offsetBytes + readBytes;
+            outItem.insert(QStringLiteral("offsetBytes"), item.offsetBytes);
+            outItem.insert(QStringLiteral("nextOffsetBytes"), nextOffsetBytes);
+            outItem.insert(QStringLiteral("readBytes"), readBytes);
+            outItem.insert(QStringLiteral("truncated"), truncated);
+            outItem.insert(QStringLiteral("hasMore"), nextOffsetBytes < readResult.sizeBytes);
+            outItem.insert(QStringLiteral("eof"), nextOffsetBytes >= readResult.sizeBytes);
+            outItem.insert(
+                QStringLiteral("content"),
+                encodeContent(readResult.bytes.constData(), readBytes, encodings.at(index))
+            );
+        }
+        outItems.append(outItem);
+    }
+    const qint64 totalBytes = totalMaxBytes - remainingBytes;
+
+    qInfo().noquote() << QStringLiteral(
+        "[capability.file.read] readMany items=%1 failed=%2 totalBytes=%3 totalMaxBytes=%4 elapsedMs=%5"
+    ).arg(
+        QString::number(readResults.size()),
+        QString::number(readResults.size() - okCount),
+        QString::number(totalBytes),
+        QString::number(totalMaxBytes),
+        QString::number(elapsedMs)
+    );
+
+    QJsonObject out;
+    out.insert(QStringLiteral("operation"), fileReadOperationName(FileReadOperation::ReadMany));
+    out.insert(QStringLiteral("itemCount"), readResults.size());
+    out.insert(QStringLiteral("okCount"), okCount);
+    out.insert(QStringLiteral("failedCount"), readResults.size() - okCount);
+    out.insert(QStringLiteral("totalMaxBytes"), totalMaxBytes);
+    out.insert(QStringLiteral("totalBytes"), totalBytes);
+    out.insert(QStringLiteral("budgetExhausted"), remainingBytes == 0);
+    out.insert(QStringLiteral("elapsedMs"), elapsedMs);
+    out.insert(QStringLiteral("items"), outItems);
+    *result = out;
+    return true;
+}
+
+bool readDelta(
+    const QJsonObject &paramsObject,
+    const QFileInfo &fileInfo,
+    int invokeTimeoutMs,
+    QJsonObject *result,
+    QString *error,
+    bool *invalidParams
+)
+{
+    QString parseError;
+    FileDeltaSignature signature;
+    if ( !Common::parseRequiredInt64(
+            paramsObject,
+            QStringLiteral("blockBytes"),
+            minDeltaBlockBytes,
+            maxDeltaBlockBytes,
+            &signature.blockBytes,
+            &parseError,
+            QStringLiteral("file.read")
+        ) )
+    {
+        return Common::failInvalidParams(invalidParams, error, parseError);
+    }
+
+    QJsonArray blockArray;
+    if ( !Common::parseRequiredObjectArray(
+            paramsObject,
+            QStringLiteral("blocks"),
+            0,
+            maxDeltaBlocks,
+            &blockArray,
+            &parseError,
+            QStringLiteral("file.read")
+        ) )
+    {
+        return Common::failInvalidParams(invalidParams, error, parseError);
+    }
+    signature.weak.reserve(blockArray.size());
+    signature.strong.reserve(blockArray.size());
+    for ( int index = 0; index < blockArray.size(); ++index )
+    {
+        const QJsonObject blockObject = blockArray.at(index).toObject();
+        const QString scope = QStringLiteral("file.read blocks[%1]").arg(index);
+        qint64 weak = 0;
+        if ( !Common::parseRequiredInt64(
+                blockObject,
+                QStringLiteral("weak"),
+                0,
+                std::numeric_limits<quint32>::max(),
+                &weak,
+                &parseError,
+                scope
+            ) )
+        {
+            return Common::failInvalidParams(invalidParams, error, parseError);
+        }
+        QString strongHex;
+        if ( !Common::parseRequiredTrimmedString(
+                blockObject,
+                QStringLiteral("xxh3"),
+                &strongHex,
+                &parseError,
+                scope
+            ) )
+        {
+            return Common::failInvalidParams(invalidParams, error, parseError);
+        }
+        bool strongOk = false;
+        const quint64 strong = strongHex.toULongLong(&strongOk, 16);
+        if ( !strongOk || ( strongHex.size() > 16 ) )
+        {
+            return Common::failInvalidParams(
+                invalidParams,
+                error,
+                QStringLiteral("%1 xxh3 must be a 64-bit hex string").arg(scope)
+            );
+        }
+        signature.weak.append(static_cast<quint32>(weak));
+        signature.strong.append(strong);
+    }
+
+    qint64 maxBytes = defaultDeltaMaxBytes;
+    if ( !Common::parseOptionalInt64(
+            paramsObject,
+            QStringLiteral("maxBytes"),
+            1,
+            maxDeltaMaxBytes,
+            defaultDeltaMaxBytes,
+            &maxBytes,
+            &parseError,
+            QStringLiteral("file.read")
+        ) )
+    {
+        return Common::failInvalidParams(invalidParams, error, parseError);
+    }
+
+    const int deltaTimeoutMs = ( invokeTimeoutMs >= 0 )
+        ? qMin(readDeltaTimeoutMs, invokeTimeoutMs)
+        : readDeltaTimeoutMs;
+
+    QElapsedTimer elapsedTimer;
+    elapsedTimer.start();
+    FileDeltaResult delta;
+    QString deltaError;
+    if ( !FileDeltaEngine::compute(
+            fileInfo.absoluteFilePath(),
+            signature,
+            maxBytes,
+            deltaTimeoutMs,
+            &delta,
+            &deltaError
+        ) )
+    {
+        if ( error != nullptr )
+        {
+            *error = QStringLiteral("file.read delta failed: %1").arg(deltaError);
+        }
+        return false;
+    }
+    const qint64 elapsedMs = elapsedTimer.elapsed();
+
+    QJsonArray ops;
+    for ( const FileDeltaOp &op : delta.ops )
+    {
+        QJsonObject opObject;
+        if ( op.copy )
+        {
+            opObject.insert(QStringLiteral("type"), QStringLiteral("copy"));
+            opObject.insert(QStringLiteral("block"), op.block);
+            opObject.insert(QStringLiteral("blockCount"), op.blockCount);
+        }
+        else
+        {
+            opObject.insert(QStringLiteral("type"), QStringLiteral("data"));
+            opObject.insert(QStringLiteral("offsetBytes"), op.offsetBytes);
+            opObject.insert(QStringLiteral("sizeBytes"), op.literal.size());
+            opObject.insert(QStringLiteral("content"), encodeContent(op.literal, Common::ContentEncoding::Base64));
+        }
+        ops.append(opObject);
+    }
+
+    qInfo().noquote() << QStringLiteral(
+        "[capability.file.read] delta path=%1 sizeBytes=%2 blockBytes=%3 blocks=%4 matchedBlocks=%5 literalBytes=%6 kernel=%7 elapsedMs=%8"
+    ).arg(
+        fileInfo.absoluteFilePath(),
+        QString::number(delta.sizeBytes),
+        QString::number(signature.blockBytes),
+        QString::number(signature.weak.size()),
+        QString::number(delta.matchedBlocks),
+        QString::number(delta.literalBytes),
+        QString::fromLatin1(FileDeltaEngine::kernelName()),
+        QString::number(elapsedMs)
+    );
+
+    QJsonObject out;
+    out.insert(QStringLiteral("path"), fileInfo.absoluteFilePath());
+    out.insert(QStringLiteral("operation"), fileReadOperationName(FileReadOperation::Delta));
+    out.insert(QStringLiteral("encoding"), QStringLiteral("base64"));
+    out.insert(QStringLiteral("sizeBytes"), delta.sizeBytes);
+    out.insert(QStringLiteral("xxh3"), QStringLiteral("%1").arg(delta.xxh3, 16, 16, QLatin1Char('0')));
+    out.insert(QStringLiteral("blockBytes"), signature.blockBytes);
+    out.insert(QStringLiteral("blockCount"), signature.weak.size());
+    out.insert(QStringLiteral("matchedBlocks"), delta.matchedBlocks);
+    out.insert(QStringLiteral("literalBytes"), delta.literalBytes);
+    out.insert(QStringLiteral("elapsedMs"), elapsedMs);
+    out.insert(QStringLiteral("ops"), ops);
+    *result = out;
+    return true;
+}
+
+struct ArchiveCollectState
+{
+    QDir::Filters entryFilters;
+    bool recursive = true;
+    qint64 maxFiles = 0;
+    QList<FileArchiveEntry> entries;
+    // Matched entries that are neither regular files nor directories (sockets, devices,
+    // dangling links).
+    qint64 skippedCount = 0;
+    bool truncated = false;
+};
+
+// Pre-order, listing order, so the archive layout matches what list returns.
+void collectArchiveEntries(
+    const QString &directoryPath,
+    const QString &relativePrefix,
+    const FileGlobMatcher &globMatcher,
+    ArchiveCollectState *state
+)
+{
+    const QFileInfoList entryInfos = listDirectorySorted(directoryPath, state->entryFilters);
+    for ( const QFileInfo &entryInfo : entryInfos )
+    {
+        if ( state->truncated )
+        {
+            return;
+        }
+        const QString relativePath = relativePrefix + entryInfo.fileName();
+        if ( entryInfo.isDir() )
+        {
+            if ( state->recursive &&
+                 shouldDescendListEntry(entryInfo) &&
+                 globMatcher.canMatchBelow(relativePath) )
+            {
+                collectArchiveEntries(
+                    entryInfo.absoluteFilePath(),
+                    relativePath + QLatin1Char('/'),
+                    globMatcher,
+                    state
+                );
+            }
+            continue;
+        }
+        if ( !globMatcher.matches(relativePath, entryInfo.fileName()) )
+        {
+            continue;
+        }
+        if ( !entryInfo.isFile() )
+        {
+            ++state->skippedCount;
+            continue;
+        }
+        if ( state->entries.size() >= state->maxFiles )
+        {
+            state->truncated = true;
+            return;
+        }
+
+        FileArchiveEntry entry;
+        entry.absolutePath = entryInfo.absoluteFilePath();
+        entry.relativePath = relativePath;
+        state->entries.append(entry);
+    }
+}
+
+bool parseArchiveFormat(const QJsonObject &paramsObject, FileArchiveFormat *format, QString *error)
+{
+    QString normalized;
+    if ( !Common::parseOptionalToken(
+            paramsObject,
+            QStringLiteral("format"),
+            QStringLiteral("tar"),
+            &normalized,
+            error,
+            QStringLiteral("file.read")
+        ) )
+    {
+        return false;
+    }
+    if ( normalized == QStringLiteral("tar") )
+    {
+        *format = FileArchiveFormat::Tar;
+        return true;
+    }
+    if ( ( normalized == QStringLiteral("tgz") ) || ( normalized == QStringLiteral("tar.gz") ) )
+    {
+        *format = FileArchiveFormat::TarGz;
+        return true;
+    }
+    if ( normalized == QStringLiteral("zip") )
+    {
+        *format = FileArchiveFormat::Zip;
+        return true;
+    }
+    *error = QStringLiteral("file.read format must be one of: tar, tgz, zip");
+    return false;
+}
+
+bool readArchive(
+    const QJsonObject &paramsObject,
+    const QFileInfo &fileInfo,
+    int invokeTimeoutMs,
+    QJsonObject *result,
+    QString *error,
+    bool *invalidParams
+)
+{
+    QString parseError;
+    FileArchiveFormat format = FileArchiveFormat::Tar;
+    if ( !parseArchiveFormat(paramsObject, &format, &parseError) )
+    {
+        return Common::failInvalidParams(invalidParams, error, parseError);
+    }
+
+    ArchiveCollectState collectState;
+    if ( !Common::parseOptionalBool(
+            paramsObject,
+            QStringLiteral("recursive"),
+            true,
+            &collectState.recursive,
+            &parseError
+        ) )
+    {
+        return Common::failInvalidParams(invalidParams, error, parseError);
+    }
+
+    bool includeHidden = true;
+    if ( !Common::parseOptionalBool(
+            paramsObject,
+            QStringLiteral("includeHidden"),
+            true,
+            &includeHidden,
+            &parseError
+        ) )
+    {
+        return Common::failInvalidParams(invalidParams, error, parseError);
+    }
+
+    QStringList globPatterns;
+    if ( !parseGlobPatterns(paramsObject, &globPatterns, &parseError) )
+    {
+        return Common::failInvalidParams(invalidParams, error, parseError);
+    }
+
+    if ( !Common::parseOptionalInt64(
+            paramsObject,
+            QStringLiteral("maxFiles"),
+            1,
+            maxArchiveMaxFiles,
+            defaultArchiveMaxFiles,
+            &collectState.maxFiles,
+            &parseError,
+            QStringLiteral("file.read")
+        ) )
+    {
+        return Common::failInvalidParams(invalidParams, error, parseError);
+    }
+
+    qint64 maxTotalBytes = defaultArchiveMaxTotalBytes;
+    if ( !Common::parseOptionalInt64(
+            paramsObject,
+            QStringLiteral("maxTotalBytes"),
+            0,
+            maxArchiveMaxTotalBytes,
+            defaultArchiveMaxTotalBytes,
+            &maxTotalBytes,
+            &parseError,
+            QStringLiteral("file.read")
+        ) )
+    {
+        return Common::failInvalidParams(invalidParams, error, parseError);
+    }
+
+    qint64 chunkBytes = defaultTransferChunkBytes;
+    qint64 ttlMs = defaultTransferTtlMs;
+    int hashTimeoutMs = -1;
+    if ( !parseTransferOpenOptions(
+            paramsObject,
+            invokeTimeoutMs,
+            &chunkBytes,
+            &ttlMs,
+            &hashTimeoutMs,
+            &parseError
+        ) )
+    {
+        return Common::failInvalidParams(invalidParams, error, parseError);
+    }
+
+    QElapsedTimer elapsedTimer;
+    elapsedTimer.start();
+
+    const QString rootPath = fileInfo.absoluteFilePath();
+    collectState.entryFilters = QDir::AllEntries | QDir::NoDotAndDotDot;
+    if ( includeHidden )
+    {
+        collectState.entryFilters |= QDir::Hidden | QDir::System;
+    }
+    const FileGlobMatcher globMatcher(globPatterns);
+    collectArchiveEntries(rootPath, QString(), globMatcher, &collectState);
+
+    // The archive is built in full before the first chunk goes out: the transfer session
+    // needs its size and hash up front, and a reader that reconnects must see the same
+    // bytes again.
+    QTemporaryFile archiveFile(
+        QDir(QDir::tempPath()).filePath(
+            QStringLiteral("jqopenclaw-archive-XXXXXX.%1").arg(FileArchiveWriter::formatName(format))
+        )
+    );
+    archiveFile.setAutoRemove(false);
+    if ( !archiveFile.open() )
+    {
+        if ( error != nullptr )
+        {
+            *error = QStringLiteral("file.read archive failed to create temporary file: %1")
+                .arg(archiveFile.errorString().trimmed());
+        }
+        return false;
+    }
+    const QString archivePath = archiveFile.fileName();
+
+    const int archiveTimeoutMs = ( invokeTimeoutMs >= 0 )
+        ? qMin(readArchiveTimeoutMs, invokeTimeoutMs)
+        : readArchiveTimeoutMs;
+    FileArchiveSummary summary;
+    QString archiveError;
+    const bool written = FileArchiveWriter::write(
+        collectState.entries,
+        format,
+        maxTotalBytes,
+        archiveTimeoutMs,
+        &archiveFile,
+        &summary,
+        &archiveError
+    );
+    archiveFile.close();
+    if ( !written )
+    {
+        QFile::remove(archivePath);
+        if ( error != nullptr )
+        {
+            *error = QStringLiteral("file.read archive failed: %1").arg(archiveError);
+        }
+        return false;
+    }
+
+    FileTransferInfo info;
+    QString transferError;
+    if ( !FileTransferSession::open(
+            archivePath,
+            chunkBytes,
+            ttlMs,
+            hashTimeoutMs,
+            &info,
+            &transferError,
+            true
+        ) )
+    {
+        if ( error != nullptr )
+        {
+            *error = QStringLiteral("file.read archive failed: %1").arg(transferError);
+        }
+        return false;
+    }
+    const qint64 elapsedMs = elapsedTimer.elapsed();
+
+    QJsonArray errorArray;
+    for ( const FileArchiveError &entryError : summary.errors )
+    {
+        if ( errorArray.size() >= maxArchiveErrorEntries )
+        {
+            break;
+        }
+        QJsonObject errorObject;
+        errorObject.insert(QStringLiteral("path"), entryError.path);
+        errorObject.insert(QStringLiteral("error"), entryError.error);
+        errorArray.append(errorObject);
+    }
+
+    qInfo().noquote() << QStringLiteral(
+        "[capability.file.read] archive id=%1 path=%2 format=%3 files=%4 contentBytes=%5 archiveBytes=%6 errors=%7 elapsedMs=%8"
+    ).arg(
+        info.transferId,
+        rootPath,
+        FileArchiveWriter::formatName(format),
+        QString::number(summary.fileCount),
+        QString::number(summary.contentBytes),
+        QString::number(summary.archiveBytes),
+        QString::number(summary.errors.size()),
+        QString::number(elapsedMs)
+    );
+
+    QJsonObject out = transferInfoToJson(info, FileReadOperation::Archive);
+    out.insert(QStringLiteral("path"), rootPath);
+    out.insert(QStringLiteral("format"), FileArchiveWriter::formatName(format));
+    out.insert(QStringLiteral("recursive"), collectState.recursive);
+    out.insert(QStringLiteral("includeHidden"), includeHidden);
+    out.insert(QStringLiteral("fileCount"), summary.fileCount);
+    out.insert(QStringLiteral("skippedCount"), collectState.skippedCount);
+    out.insert(QStringLiteral("contentBytes"), summary.contentBytes);
+    out.insert(QStringLiteral("archiveBytes"), summary.archiveBytes);
+    // maxFiles cuts the walk, maxTotalBytes the writer; either way later files are missing.
+    out.insert(QStringLiteral("truncated"), collectState.truncated || summary.truncated);
+    out.insert(QStringLiteral("timedOut"), summary.timedOut);
+    out.insert(QStringLiteral("errorCount"), summary.errors.size());
+    out.insert(QStringLiteral("errors"), errorArray);
+    out.insert(QStringLiteral("elapsedMs"), elapsedMs);
+    *result = out;
+    return true;
+}
+}
 
 bool FileReadAccess::read(
     const QJsonValue &params,
@@ -744,20 +2282,195 @@ bool FileReadAccess::read(
     Common::resetInvalidParams(invalidParams);
     if ( !Common::failIfNull(result, error, QStringLiteral("file.read output pointer is null")) )
     {
-        return false;
+        return false;
+    }
+    QString parseError;
+    QJsonObject paramsObject;
+    if ( !Common::parseParamsObject(
+            params,
+            &paramsObject,
+            &parseError,
+            QStringLiteral("file.read")
+        ) )
+    {
+        return Common::failInvalidParams(invalidParams, error, parseError);
+    }
+    const QString path = Common::extractStringTrimmed(paramsObject, QStringLiteral("path"));
+    FileReadOperation operation = FileReadOperation::Read;
+    if ( !parseReadOperation(paramsObject, &operation, &parseError) )
+    {
+        return Common::failInvalidParams(invalidParams, error, parseError);
+    }
+
+    if ( operation == FileReadOperation::Hash )
+    {
+        // hash takes a batch through paths, so path alone is not required here.
+        QStringList hashPaths;
+        if ( !Common::parseOptionalTrimmedStringArray(
+                paramsObject,
+                QStringLiteral("paths"),
+                &hashPaths,
+                &parseError,
+                QStringLiteral("file.read"),
+                true
+            ) )
+        {
+            return Common::failInvalidParams(invalidParams, error, parseError);
+        }
+        if ( !path.isEmpty() )
+        {
+            hashPaths.prepend(path);
+        }
+        if ( hashPaths.isEmpty() )
+        {
+            return Common::failInvalidParams(
+                invalidParams,
+                error,
+                QStringLiteral("file.read hash requires path or paths")
+            );
+        }
+        if ( hashPaths.size() > maxHashPaths )
+        {
+            return Common::failInvalidParams(
+                invalidParams,
+                error,
+                QStringLiteral("file.read hash accepts at most %1 paths").arg(maxHashPaths)
+            );
+        }
+
+        QString algorithmName;
+        if ( !Common::parseOptionalToken(
+                paramsObject,
+                QStringLiteral("algorithm"),
+                QStringLiteral("sha256"),
+                &algorithmName,
+                &parseError,
+                QStringLiteral("file.read")
+            ) )
+        {
+            return Common::failInvalidParams(invalidParams, error, parseError);
+        }
+        FileHashAlgorithm algorithm = FileHashAlgorithm::Sha256;
+        if ( !FileHasher::parseAlgorithm(algorithmName, &algorithm) )
+        {
+            return Common::failInvalidParams(
+                invalidParams,
+                error,
+                QStringLiteral("file.read algorithm must be one of: md5, sha1, sha256, sha512, blake3, xxh3")
+            );
+        }
+
+        bool useCache = true;
+        if ( !Common::parseOptionalBool(
+                paramsObject,
+                QStringLiteral("useCache"),
+                true,
+                &useCache,
+                &parseError
+            ) )
+        {
+            return Common::failInvalidParams(invalidParams, error, parseError);
+        }
+
+        int hashTimeoutMs = readHashTimeoutMs;
+        if ( invokeTimeoutMs >= 0 )
+        {
+            hashTimeoutMs = qMin(readHashTimeoutMs, invokeTimeoutMs);
+        }
+
+        QElapsedTimer elapsedTimer;
+        elapsedTimer.start();
+        const QList<FileHashResult> hashResults = FileHasher::hashFiles(
+            hashPaths,
+            algorithm,
+            useCache,
+            hashTimeoutMs
+        );
+        const qint64 elapsedMs = elapsedTimer.elapsed();
+
+        if ( ( hashResults.size() == 1 ) && !hashResults.first().ok )
+        {
+            if ( error != nullptr )
+            {
+                *error = QStringLiteral("file.read hash failed: %1").arg(hashResults.first().error);
+            }
+            return false;
+        }
+
+        qint64 hashedCount = 0;
+        qint64 cacheHits = 0;
+        qint64 totalBytes = 0;
+        QJsonArray files;
+        for ( const FileHashResult &hashResult : hashResults )
+        {
+            QJsonObject item;
+            item.insert(QStringLiteral("path"), hashResult.path);
+            item.insert(QStringLiteral("ok"), hashResult.ok);
+            if ( hashResult.ok )
+            {
+                ++hashedCount;
+                totalBytes += hashResult.sizeBytes;
+                if ( hashResult.cacheHit )
+                {
+                    ++cacheHits;
+                }
+                item.insert(QStringLiteral("sizeBytes"), hashResult.sizeBytes);
+                item.insert(QStringLiteral("digest"), hashResult.digestHex);
+                item.insert(QStringLiteral("cacheHit"), hashResult.cacheHit);
+            }
+            else
+            {
+                item.insert(QStringLiteral("error"), hashResult.error);
+            }
+            files.append(item);
+        }
+        qInfo().noquote() << QStringLiteral(
+            "[capability.file.read] hash algorithm=%1 files=%2 failed=%3 cacheHits=%4 bytes=%5 elapsedMs=%6"
+        ).arg(
+            FileHasher::algorithmName(algorithm),
+            QString::number(hashResults.size()),
+            QString::number(hashResults.size() - hashedCount),
+            QString::number(cacheHits),
+            QString::number(totalBytes),
+            QString::number(elapsedMs)
+        );
+
+        QJsonObject out;
+        if ( !path.isEmpty() )
+        {
+            out.insert(QStringLiteral("path"), hashResults.first().path);
+        }
+        out.insert(QStringLiteral("operation"), fileReadOperationName(operation));
+        out.insert(QStringLiteral("algorithm"), FileHasher::algorithmName(algorithm));
+        out.insert(QStringLiteral("fileCount"), hashResults.size());
+        out.insert(QStringLiteral("hashedCount"), hashedCount);
+        out.insert(QStringLiteral("failedCount"), hashResults.size() - hashedCount);
+        out.insert(QStringLiteral("totalBytes"), totalBytes);
+        out.insert(QStringLiteral("useCache"), useCache);
+        if ( useCache )
+        {
+            out.insert(QStringLiteral("cacheHits"), cacheHits);
+            out.insert(QStringLiteral("cacheMisses"), hashedCount - cacheHits);
+        }
+        out.insert(QStringLiteral("elapsedMs"), elapsedMs);
+        out.insert(QStringLiteral("files"), files);
+        *result = out;
+        return true;
+    }
+
+    if ( ( operation == FileReadOperation::TransferOpen ) ||
+         ( operation == FileReadOperation::TransferRead ) ||
+         ( operation == FileReadOperation::TransferStatus ) ||
+         ( operation == FileReadOperation::TransferClose ) )
+    {
+        return readTransfer(operation, paramsObject, path, invokeTimeoutMs, result, error, invalidParams);
     }
-    QString parseError;
-    QJsonObject paramsObject;
-    if ( !Common::parseParamsObject(
-            params,
-            &paramsObject,
-            &parseError,
-            QStringLiteral("file.read")
-        ) )
+
+    if ( operation == FileReadOperation::ReadMany )
     {
-        return Common::failInvalidParams(invalidParams, error, parseError);
+        return readMany(paramsObject, invokeTimeoutMs, result, error, invalidParams);
     }
-    const QString path = Common::extractStringTrimmed(paramsObject, QStringLiteral("path"));
+
     if ( path.isEmpty() )
     {
         return Common::failInvalidParams(
@@ -767,12 +2480,6 @@ bool FileReadAccess::read(
         );
     }
 
-    FileReadOperation operation = FileReadOperation::Read;
-    if ( !parseReadOperation(paramsObject, &operation, &parseError) )
-    {
-        return Common::failInvalidParams(invalidParams, error, parseError);
-    }
-
     const QFileInfo fileInfo(path);
     if ( !fileInfo.exists() )
     {
@@ -849,106 +2556,127 @@ bool FileReadAccess::read(
             }
         }
 
-        const QDir rootDir(fileInfo.absoluteFilePath());
+        // Counts need a full walk, so recursive pages only compute them on request.
+        bool includeCounts = !( recursive && includeEntries );
+        if ( !Common::parseOptionalBool(
+                paramsObject,
+                QStringLiteral("includeCounts"),
+                includeCounts,
+                &includeCounts,
+                &parseError
+            ) )
+        {
+            return Common::failInvalidParams(invalidParams, error, parseError);
+        }
+        if ( !includeEntries )
+        {
+            includeCounts = true;
+        }
+
+        const QString rootPath = fileInfo.absoluteFilePath();
+        const QJsonObject cursorScope = listCursorScope(
+            rootPath,
+            recursive,
+            includeHidden,
+            globPatterns
+        );
+        bool hasCursor = false;
+        ListCursor cursor;
+        if ( includeEntries &&
+             !parseListCursor(paramsObject, cursorScope, &hasCursor, &cursor, &parseError) )
+        {
+            return Common::failInvalidParams(invalidParams, error, parseError);
+        }
+
         QDir::Filters entryFilters = QDir::AllEntries | QDir::NoDotAndDotDot;
         if ( includeHidden )
         {
             entryFilters |= QDir::Hidden | QDir::System;
         }
+        const FileGlobMatcher globMatcher(globPatterns);
 
-        QFileInfoList entryInfos;
-        if ( recursive )
+        bool truncated = false;
+        QString nextCursor;
+        QJsonArray entries;
+        if ( includeEntries )
         {
-            QDirIterator iterator(
-                rootDir.absolutePath(),
+            // Pre-order walk holding only the listings along the current path; the walk
+            // stops at the first matching entry past maxEntries.
+            QList<ListWalkFrame> stack;
+            seedListWalkStack(
+                rootPath,
                 entryFilters,
-                QDirIterator::Subdirectories
+                recursive,
+                globMatcher,
+                hasCursor ? &cursor : nullptr,
+                &stack
             );
-            while ( iterator.hasNext() )
+
+            ListCursor lastEmitted;
+            while ( !stack.isEmpty() )
             {
-                iterator.next();
-                entryInfos.append(iterator.fileInfo());
-            }
+                ListWalkFrame &frame = stack.last();
+                if ( frame.nextIndex >= frame.entries.size() )
+                {
+                    stack.removeLast();
+                    continue;
+                }
 
-            std::sort(
-                entryInfos.begin(),
-                entryInfos.end(),
-                [](const QFileInfo &a, const QFileInfo &b)
+                const QFileInfo entryInfo = frame.entries.at(frame.nextIndex++);
+                const QString relativePath = frame.relativePrefix + entryInfo.fileName();
+                if ( globMatcher.matches(relativePath, entryInfo.fileName()) )
                 {
-                    if ( a.isDir() != b.isDir() )
+                    if ( entries.size() >= maxEntries )
                     {
-                        return a.isDir();
+                        truncated = true;
+                        nextCursor = encodeListCursor(cursorScope, lastEmitted);
+                        break;
                     }
-                    return QString::compare(
-                        a.absoluteFilePath(),
-                        b.absoluteFilePath(),
-                        Common::pathCaseSensitivity()
-                    ) < 0;
-                }
-            );
-        }
-        else
-        {
-            entryInfos = rootDir.entryInfoList(
-                entryFilters,
-                entryNameSortFlags()
-            );
-        }
-
-        int directoryCount = 0;
-        int fileCount = 0;
-        int otherCount = 0;
-        int totalCount = 0;
-        bool truncated = false;
-        QJsonArray entries;
-
-        for ( const QFileInfo &entryInfo : entryInfos )
-        {
-            const QString relativePath = normalizedRelativePath(rootDir, entryInfo);
-            if ( !matchesGlobPatterns(
-                    globPatterns,
-                    relativePath,
-                    entryInfo.fileName()
-                ) )
-            {
-                continue;
-            }
 
-            QString entryType = QStringLiteral("other");
-            if ( entryInfo.isDir() )
-            {
-                ++directoryCount;
-                entryType = QStringLiteral("directory");
-            }
-            else if ( entryInfo.isFile() )
-            {
-                ++fileCount;
-                entryType = QStringLiteral("file");
-            }
-            else
-            {
-                ++otherCount;
-            }
-            ++totalCount;
+                    entries.append(
+                        buildListEntryObject(
+                            entryInfo,
+                            fileTargetType(entryInfo),
+                            relativePath
+                        )
+                    );
+                    lastEmitted.afterRelativePath = relativePath;
+                    lastEmitted.afterIsDir = entryInfo.isDir();
+                }
 
-            if ( includeEntries )
-            {
-                if ( entries.size() >= maxEntries )
+                // Subtrees no pattern can reach are never listed.
+                if ( recursive &&
+                     shouldDescendListEntry(entryInfo) &&
+                     globMatcher.canMatchBelow(relativePath) )
                 {
-                    truncated = true;
-                    continue;
+                    ListWalkFrame childFrame;
+                    childFrame.directoryPath = entryInfo.absoluteFilePath();
+                    childFrame.relativePrefix = relativePath + QLatin1Char('/');
+                    childFrame.entries = listDirectorySorted(
+                        childFrame.directoryPath,
+                        entryFilters
+                    );
+                    stack.append(childFrame);
                 }
-
-                entries.append(
-                    buildListEntryObject(
-                        entryInfo,
-                        entryType,
-                        relativePath
-                    )
-                );
             }
         }
 
+        qint64 directoryCount = 0;
+        qint64 fileCount = 0;
+        qint64 otherCount = 0;
+        if ( includeCounts )
+        {
+            countListEntries(
+                rootPath,
+                entryFilters,
+                recursive,
+                globMatcher,
+                &directoryCount,
+                &fileCount,
+                &otherCount
+            );
+        }
+
         QJsonObject out;
         out.insert(QStringLiteral("path"), fileInfo.absoluteFilePath());
         out.insert(QStringLiteral("operation"), fileReadOperationName(operation));
@@ -964,15 +2692,26 @@ bool FileReadAccess::read(
             }
             out.insert(QStringLiteral("glob"), globArray);
         }
-        out.insert(QStringLiteral("directoryCount"), directoryCount);
-        out.insert(QStringLiteral("fileCount"), fileCount);
-        out.insert(QStringLiteral("otherCount"), otherCount);
-        out.insert(QStringLiteral("totalCount"), totalCount);
+        out.insert(QStringLiteral("includeCounts"), includeCounts);
+        if ( includeCounts )
+        {
+            out.insert(QStringLiteral("directoryCount"), directoryCount);
+            out.insert(QStringLiteral("fileCount"), fileCount);
+            out.insert(QStringLiteral("otherCount"), otherCount);
+            out.insert(
+                QStringLiteral("totalCount"),
+                directoryCount + fileCount + otherCount
+            );
+        }
         out.insert(QStringLiteral("includeEntries"), includeEntries);
         if ( includeEntries )
         {
             out.insert(QStringLiteral("maxEntries"), maxEntries);
             out.insert(QStringLiteral("truncated"), truncated);
+            if ( truncated )
+            {
+                out.insert(QStringLiteral("nextCursor"), nextCursor);
+            }
             out.insert(QStringLiteral("entries"), entries);
         }
 
@@ -980,37 +2719,248 @@ bool FileReadAccess::read(
         return true;
     }
 
+    if ( operation == FileReadOperation::Du )
+    {
+        if ( !fileInfo.isDir() )
+        {
+            if ( error != nullptr )
+            {
+                *error = QStringLiteral("file.read du target is not directory");
+            }
+            return false;
+        }
+
+        FileTreeSummaryOptions summaryOptions;
+        summaryOptions.timeoutMs = ( invokeTimeoutMs >= 0 )
+            ? qMin(readDuTimeoutMs, invokeTimeoutMs)
+            : readDuTimeoutMs;
+        if ( !Common::parseOptionalBool(
+                paramsObject,
+                QStringLiteral("includeHidden"),
+                true,
+                &summaryOptions.includeHidden,
+                &parseError
+            ) )
+        {
+            return Common::failInvalidParams(invalidParams, error, parseError);
+        }
+
+        qint64 topCount = defaultDuTopCount;
+        if ( !Common::parseOptionalInt64(
+                paramsObject,
+                QStringLiteral("topN"),
+                1,
+                maxDuTopCount,
+                defaultDuTopCount,
+                &topCount,
+                &parseError,
+                QStringLiteral("file.read")
+            ) )
+        {
+            return Common::failInvalidParams(invalidParams, error, parseError);
+        }
+        summaryOptions.topCount = static_cast<int>(topCount);
+
+        qint64 maxEntries = defaultReadMaxEntries;
+        if ( !parseReadMaxEntries(paramsObject, &maxEntries, &parseError) )
+        {
+            return Common::failInvalidParams(invalidParams, error, parseError);
+        }
+        summaryOptions.maxChildren = static_cast<int>(maxEntries);
+
+        QElapsedTimer elapsedTimer;
+        elapsedTimer.start();
+        FileTreeSummary summary;
+        QString summaryError;
+        if ( !FileTreeWalker::summarize(
+                fileInfo.absoluteFilePath(),
+                summaryOptions,
+                &summary,
+                &summaryError
+            ) )
+        {
+            if ( error != nullptr )
+            {
+                *error = QStringLiteral("file.read du failed: %1").arg(summaryError);
+            }
+            return false;
+        }
+        const qint64 elapsedMs = elapsedTimer.elapsed();
+        qInfo().noquote() << QStringLiteral(
+            "[capability.file.read] du path=%1 files=%2 dirs=%3 bytes=%4 workers=%5 elapsedMs=%6%7"
+        ).arg(
+            fileInfo.absoluteFilePath(),
+            QString::number(summary.fileCount),
+            QString::number(summary.directoryCount),
+            QString::number(summary.totalBytes),
+            QString::number(summary.workerCount),
+            QString::number(elapsedMs),
+            summary.timedOut ? QStringLiteral(" timedOut") : QString()
+        );
+
+        QJsonObject out;
+        out.insert(QStringLiteral("path"), fileInfo.absoluteFilePath());
+        out.insert(QStringLiteral("operation"), fileReadOperationName(operation));
+        out.insert(QStringLiteral("targetType"), QStringLiteral("directory"));
+        out.insert(QStringLiteral("includeHidden"), summaryOptions.includeHidden);
+        out.insert(QStringLiteral("walker"), FileTreeWalker::backendName());
+        out.insert(QStringLiteral("workerCount"), summary.workerCount);
+        out.insert(QStringLiteral("elapsedMs"), elapsedMs);
+        out.insert(QStringLiteral("timedOut"), summary.timedOut);
+        out.insert(QStringLiteral("totalBytes"), summary.totalBytes);
+        out.insert(QStringLiteral("fileCount"), summary.fileCount);
+        out.insert(QStringLiteral("directoryCount"), summary.directoryCount);
+        out.insert(QStringLiteral("otherCount"), summary.otherCount);
+        out.insert(QStringLiteral("unreadableDirectoryCount"), summary.unreadableDirectoryCount);
+        out.insert(QStringLiteral("topN"), topCount);
+        out.insert(QStringLiteral("maxEntries"), maxEntries);
+        out.insert(QStringLiteral("childCount"), summary.childCount);
+        out.insert(QStringLiteral("childrenTruncated"), summary.childCount > summary.children.size());
+        out.insert(QStringLiteral("children"), treeSizeEntriesToJson(summary.children));
+        out.insert(QStringLiteral("largestFiles"), treeSizeEntriesToJson(summary.largestFiles));
+        out.insert(
+            QStringLiteral("largestDirectories"),
+            treeSizeEntriesToJson(summary.largestDirectories)
+        );
+
+        *result = out;
+        return true;
+    }
+
     if ( operation == FileReadOperation::Stat )
     {
         *result = buildStatOutput(fileInfo, operation);
         return true;
     }
 
-    if ( operation == FileReadOperation::Md5 )
+    if ( operation == FileReadOperation::Md5 )
+    {
+        if ( !fileInfo.isFile() )
+        {
+            if ( error != nullptr )
+            {
+                *error = QStringLiteral("file.read md5 target is not a file");
+            }
+            return false;
+        }
+
+        bool useCache = true;
+        if ( !Common::parseOptionalBool(
+                paramsObject,
+                QStringLiteral("useCache"),
+                true,
+                &useCache,
+                &parseError
+            ) )
+        {
+            return Common::failInvalidParams(invalidParams, error, parseError);
+        }
+
+        const QList<FileHashResult> hashResults = FileHasher::hashFiles(
+            QStringList() << fileInfo.absoluteFilePath(),
+            FileHashAlgorithm::Md5,
+            useCache,
+            -1
+        );
+        const FileHashResult &md5Result = hashResults.first();
+        if ( !md5Result.ok )
+        {
+            if ( error != nullptr )
+            {
+                *error = md5Result.error.isEmpty()
+                    ? QStringLiteral("file.read md5 failed")
+                    : QStringLiteral("file.read md5 failed: %1").arg(md5Result.error);
+            }
+            return false;
+        }
+
+        QJsonObject out;
+        out.insert(QStringLiteral("path"), fileInfo.absoluteFilePath());
+        out.insert(QStringLiteral("operation"), fileReadOperationName(operation));
+        out.insert(QStringLiteral("targetType"), QStringLiteral("file"));
+        out.insert(QStringLiteral("algorithm"), QStringLiteral("md5"));
+        out.insert(QStringLiteral("sizeBytes"), md5Result.sizeBytes);
+        out.insert(QStringLiteral("md5"), md5Result.digestHex);
+        out.insert(QStringLiteral("cacheHit"), md5Result.cacheHit);
+        *result = out;
+        return true;
+    }
+
+    if ( operation == FileReadOperation::Delta )
+    {
+        if ( !fileInfo.isFile() )
+        {
+            if ( error != nullptr )
+            {
+                *error = QStringLiteral("file.read delta target is not a file");
+            }
+            return false;
+        }
+        return readDelta(paramsObject, fileInfo, invokeTimeoutMs, result, error, invalidParams);
+    }
+
+    if ( operation == FileReadOperation::Archive )
+    {
+        if ( !fileInfo.isDir() )
+        {
+            if ( error != nullptr )
+            {
+                *error = QStringLiteral("file.read archive target is not directory");
+            }
+            return false;
+        }
+        return readArchive(paramsObject, fileInfo, invokeTimeoutMs, result, error, invalidParams);
+    }
+
+    if ( operation == FileReadOperation::Tail )
     {
         if ( !fileInfo.isFile() )
         {
             if ( error != nullptr )
             {
-                *error = QStringLiteral("file.read md5 target is not a file");
+                *error = QStringLiteral("file.read tail target is not a file");
             }
             return false;
         }
 
-        QString md5Hex;
-        QString md5Error;
-        if ( !Common::calculateFileMd5Hex(
-                fileInfo.absoluteFilePath(),
-                &md5Hex,
-                &md5Error,
+        qint64 lineCount = defaultTailLineCount;
+        if ( !Common::parseOptionalInt64(
+                paramsObject,
+                QStringLiteral("lines"),
+                1,
+                maxReadLineSpan,
+                defaultTailLineCount,
+                &lineCount,
+                &parseError,
                 QStringLiteral("file.read")
             ) )
+        {
+            return Common::failInvalidParams(invalidParams, error, parseError);
+        }
+
+        qint64 maxBytes = defaultReadMaxBytes;
+        if ( !parseReadMaxBytes(paramsObject, &maxBytes, &parseError) )
+        {
+            return Common::failInvalidParams(invalidParams, error, parseError);
+        }
+
+        bool hasCursor = false;
+        FileTailCursor cursor;
+        if ( !parseTailCursor(paramsObject, fileInfo.absoluteFilePath(), &hasCursor, &cursor, &parseError) )
+        {
+            return Common::failInvalidParams(invalidParams, error, parseError);
+        }
+
+        FileTailResult tailResult;
+        QString tailError;
+        const bool tailOk = hasCursor
+            ? FileTailReader::follow(fileInfo.absoluteFilePath(), cursor, lineCount, maxBytes, &tailResult, &tailError)
+            : FileTailReader::last(fileInfo.absoluteFilePath(), lineCount, maxBytes, &tailResult, &tailError);
+        if ( !tailOk )
         {
             if ( error != nullptr )
             {
-                *error = md5Error.isEmpty()
-                    ? QStringLiteral("file.read md5 failed")
-                    : md5Error;
+                *error = QStringLiteral("file.read tail failed: %1").arg(tailError);
             }
             return false;
         }
@@ -1019,9 +2969,25 @@ bool FileReadAccess::read(
         out.insert(QStringLiteral("path"), fileInfo.absoluteFilePath());
         out.insert(QStringLiteral("operation"), fileReadOperationName(operation));
         out.insert(QStringLiteral("targetType"), QStringLiteral("file"));
-        out.insert(QStringLiteral("algorithm"), QStringLiteral("md5"));
-        out.insert(QStringLiteral("sizeBytes"), fileInfo.size());
-        out.insert(QStringLiteral("md5"), md5Hex);
+        out.insert(QStringLiteral("encoding"), QStringLiteral("utf8"));
+        out.insert(QStringLiteral("follow"), hasCursor);
+        out.insert(QStringLiteral("sizeBytes"), tailResult.sizeBytes);
+        out.insert(QStringLiteral("startOffsetBytes"), tailResult.startOffsetBytes);
+        out.insert(QStringLiteral("endOffsetBytes"), tailResult.cursor.offsetBytes);
+        out.insert(QStringLiteral("returnedLineCount"), tailResult.lines.size());
+        out.insert(QStringLiteral("truncated"), tailResult.truncated);
+        out.insert(QStringLiteral("hasMore"), tailResult.hasMore);
+        if ( !tailResult.reset.isEmpty() )
+        {
+            out.insert(QStringLiteral("reset"), tailResult.reset);
+        }
+        if ( !tailResult.partialLine.isEmpty() )
+        {
+            out.insert(QStringLiteral("partialLine"), tailResult.partialLine);
+        }
+        out.insert(QStringLiteral("content"), tailResult.lines.join(QLatin1Char('\n')));
+        out.insert(QStringLiteral("lines"), QJsonArray::fromStringList(tailResult.lines));
+        out.insert(QStringLiteral("cursor"), encodeTailCursor(fileInfo.absoluteFilePath(), tailResult.cursor));
         *result = out;
         return true;
     }
@@ -1100,12 +3066,54 @@ bool FileReadAccess::read(
             );
         }
 
+        QString format;
+        if ( !Common::parseOptionalToken(
+                paramsObject,
+                QStringLiteral("format"),
+                QStringLiteral("full"),
+                &format,
+                &parseError,
+                QStringLiteral("file.read")
+            ) )
+        {
+            return Common::failInvalidParams(invalidParams, error, parseError);
+        }
+        if ( ( format != QStringLiteral("full") ) &&
+             ( format != QStringLiteral("compact") ) )
+        {
+            return Common::failInvalidParams(
+                invalidParams,
+                error,
+                QStringLiteral("file.read lines format must be one of: full, compact")
+            );
+        }
+        const bool compact = ( format == QStringLiteral("compact") );
+
+        bool withLineOffsets = false;
+        if ( !Common::parseOptionalBool(
+                paramsObject,
+                QStringLiteral("lineOffsets"),
+                false,
+                &withLineOffsets,
+                &parseError
+            ) )
+        {
+            return Common::failInvalidParams(invalidParams, error, parseError);
+        }
+
+        bool gzip = false;
+        if ( !parseReadCompression(paramsObject, &gzip, &parseError) )
+        {
+            return Common::failInvalidParams(invalidParams, error, parseError);
+        }
+
         qInfo().noquote() << QStringLiteral(
-            "[capability.file.read] lines start path=%1 startLine=%2 endLine=%3"
+            "[capability.file.read] lines start path=%1 startLine=%2 endLine=%3 format=%4"
         ).arg(
             fileInfo.absoluteFilePath(),
             QString::number(startLine),
-            QString::number(endLine)
+            QString::number(endLine),
+            format
         );
 
         QFile file(fileInfo.absoluteFilePath());
@@ -1118,11 +3126,22 @@ bool FileReadAccess::read(
             return false;
         }
 
-        qint64 currentLine = 0;
+        qint64 lineAtOffset = 1;
+        if ( !FileLineIndex::seekToLine(&file, startLine, &lineAtOffset, error) )
+        {
+            return false;
+        }
+
+        qint64 currentLine = lineAtOffset - 1;
+        qint64 returnedLineCount = 0;
         QJsonArray lines;
         QStringList lineTexts;
+        // compact: every line goes into one UTF-8 buffer, decoded once at the end.
+        QByteArray compactContent;
+        QJsonArray lineOffsets;
         while ( !file.atEnd() && ( currentLine < endLine ) )
         {
+            const qint64 lineOffset = file.pos();
             QByteArray rawLine = file.readLine();
             if ( rawLine.isNull() )
             {
@@ -1150,6 +3169,22 @@ bool FileReadAccess::read(
                 rawLine.chop(1);
             }
 
+            ++returnedLineCount;
+            if ( withLineOffsets )
+            {
+                lineOffsets.append(lineOffset);
+            }
+            // Compressed output carries the text in content only, so no per-line objects.
+            if ( compact || gzip )
+            {
+                if ( returnedLineCount > 1 )
+                {
+                    compactContent.append('\n');
+                }
+                compactContent.append(rawLine);
+                continue;
+            }
+
             const QString lineText = QString::fromUtf8(rawLine);
             QJsonObject lineItem;
             lineItem.insert(QStringLiteral("lineNumber"), currentLine);
@@ -1166,13 +3201,48 @@ bool FileReadAccess::read(
         out.insert(QStringLiteral("operation"), fileReadOperationName(operation));
         out.insert(QStringLiteral("targetType"), QStringLiteral("file"));
         out.insert(QStringLiteral("encoding"), QStringLiteral("utf8"));
+        out.insert(QStringLiteral("format"), format);
         out.insert(QStringLiteral("startLine"), startLine);
         out.insert(QStringLiteral("endLine"), endLine);
-        out.insert(QStringLiteral("returnedLineCount"), lines.size());
+        out.insert(QStringLiteral("returnedLineCount"), returnedLineCount);
         out.insert(QStringLiteral("hasMore"), hasMore);
         out.insert(QStringLiteral("eof"), eof);
-        out.insert(QStringLiteral("content"), lineTexts.join(QLatin1Char('\n')));
-        out.insert(QStringLiteral("lines"), lines);
+        if ( compact || gzip )
+        {
+            // Line i of content is line firstLineNumber + i of the file. With gzip the
+            // full format drops lines too, or the uncompressed text would ride along.
+            out.insert(QStringLiteral("firstLineNumber"), startLine);
+        }
+        else
+        {
+            out.insert(QStringLiteral("lines"), lines);
+        }
+        if ( gzip )
+        {
+            qint64 compressedBytes = 0;
+            out.insert(
+                QStringLiteral("content"),
+                encodeContent(
+                    compactContent.constData(),
+                    compactContent.size(),
+                    Common::ContentEncoding::Utf8,
+                    true,
+                    &compressedBytes
+                )
+            );
+            insertCompressionFields(&out, true, compactContent.size(), compressedBytes);
+        }
+        else
+        {
+            out.insert(
+                QStringLiteral("content"),
+                compact ? QString::fromUtf8(compactContent) : lineTexts.join(QLatin1Char('\n'))
+            );
+        }
+        if ( withLineOffsets )
+        {
+            out.insert(QStringLiteral("lineOffsets"), lineOffsets);
+        }
         *result = out;
 
         qInfo().noquote() << QStringLiteral(
@@ -1181,7 +3251,7 @@ bool FileReadAccess::read(
             fileInfo.absoluteFilePath(),
             QString::number(startLine),
             QString::number(endLine),
-            QString::number(lines.size()),
+            QString::number(returnedLineCount),
             eof ? QStringLiteral("true") : QStringLiteral("false")
         );
         return true;
@@ -1241,6 +3311,65 @@ bool FileReadAccess::read(
             return Common::failInvalidParams(invalidParams, error, parseError);
         }
 
+        QString requestedBackend;
+        if ( !Common::parseOptionalToken(
+                paramsObject,
+                QStringLiteral("searchBackend"),
+                QStringLiteral("auto"),
+                &requestedBackend,
+                &parseError,
+                QStringLiteral("file.read")
+            ) )
+        {
+            return Common::failInvalidParams(invalidParams, error, parseError);
+        }
+        if ( ( requestedBackend != QStringLiteral("auto") ) &&
+             ( requestedBackend != QStringLiteral("rg") ) &&
+             ( requestedBackend != QStringLiteral("native") ) )
+        {
+            return Common::failInvalidParams(
+                invalidParams,
+                error,
+                QStringLiteral("file.read searchBackend must be one of: auto, rg, native")
+            );
+        }
+
+        bool useIndex = false;
+        if ( !Common::parseOptionalBool(
+                paramsObject,
+                QStringLiteral("useIndex"),
+                false,
+                &useIndex,
+                &parseError
+            ) )
+        {
+            return Common::failInvalidParams(invalidParams, error, parseError);
+        }
+        if ( useIndex && ( requestedBackend == QStringLiteral("rg") ) )
+        {
+            return Common::failInvalidParams(
+                invalidParams,
+                error,
+                QStringLiteral("file.read useIndex requires searchBackend auto or native")
+            );
+        }
+        const bool useIndexedSearch = useIndex && fileInfo.isDir();
+
+        FileSearchOptions searchOptions;
+        searchOptions.pattern = pattern;
+        searchOptions.caseSensitive = caseSensitive;
+        searchOptions.includeHidden = includeHidden;
+        searchOptions.literal = literal;
+        searchOptions.maxMatches = maxMatches;
+        if ( !FileSearchEngine::validatePattern(searchOptions, &parseError) )
+        {
+            return Common::failInvalidParams(
+                invalidParams,
+                error,
+                QStringLiteral("file.read rg %1").arg(parseError)
+            );
+        }
+
         QStringList rgArguments;
         rgArguments << QStringLiteral("--json")
                     << QStringLiteral("--line-number")
@@ -1279,331 +3408,246 @@ bool FileReadAccess::read(
             literal ? QStringLiteral("true") : QStringLiteral("false"),
             QString::number(rgTimeoutMs)
         );
+        searchOptions.timeoutMs = rgTimeoutMs;
 
         QString searchBackend = QStringLiteral("rg");
         int searchExitCode = 0;
-        QByteArray stdoutBytes;
         QByteArray stderrBytes;
-        bool usePowerShellFallback = false;
-
-        QProcess rgProcess;
-        rgProcess.start(QStringLiteral("rg"), rgArguments);
-        if ( !rgProcess.waitForStarted(readRgStartTimeoutMs) )
-        {
-            usePowerShellFallback = true;
-            const QString rgStartError = rgProcess.errorString().trimmed();
-            const QString rgStartErrorLower = rgStartError.toLower();
-            const bool rgNotFound =
-                ( rgProcess.error() == QProcess::FailedToStart ) &&
-                (
-                    rgStartError.contains(QStringLiteral("系统找不到指定的文件")) ||
-                    rgStartErrorLower.contains(QStringLiteral("not found")) ||
-                    rgStartErrorLower.contains(QStringLiteral("no such file"))
-                );
-            if ( rgNotFound )
-            {
-                qInfo().noquote() << QStringLiteral(
-                    "[capability.file.read] rg not found, using powershell select-string fallback"
-                );
-            }
-            else
-            {
-                qWarning().noquote() << QStringLiteral(
-                    "[capability.file.read] rg failed to start, fallback to powershell select-string: %1"
-                ).arg(rgStartError);
-            }
-        }
-        else
+        QJsonArray matches;
+        QSet<QString> matchedFiles;
+        bool truncated = false;
+        bool useNativeSearch = ( requestedBackend == QStringLiteral("native") );
+
+        if ( !useNativeSearch && !useIndexedSearch )
         {
-            if ( !rgProcess.waitForFinished(rgTimeoutMs) )
+            QProcess rgProcess;
+            rgProcess.start(QStringLiteral("rg"), rgArguments);
+            if ( !rgProcess.waitForStarted(readRgStartTimeoutMs) )
             {
-                rgProcess.kill();
-                rgProcess.waitForFinished(readRgKillWaitTimeoutMs);
-                if ( error != nullptr )
+                const QString rgStartError = rgProcess.errorString().trimmed();
+                if ( requestedBackend == QStringLiteral("rg") )
                 {
-                    *error = QStringLiteral("file.read rg timed out");
+                    if ( error != nullptr )
+                    {
+                        *error = rgStartError.isEmpty()
+                            ? QStringLiteral("file.read rg failed to start")
+                            : QStringLiteral("file.read rg failed to start: %1").arg(rgStartError);
+                    }
+                    return false;
                 }
-                return false;
-            }
 
-            if ( rgProcess.exitStatus() != QProcess::NormalExit )
-            {
-                if ( error != nullptr )
+                useNativeSearch = true;
+                const QString rgStartErrorLower = rgStartError.toLower();
+                const bool rgNotFound =
+                    ( rgProcess.error() == QProcess::FailedToStart ) &&
+                    (
+                        rgStartError.contains(QStringLiteral("系统找不到指定的文件")) ||
+                        rgStartErrorLower.contains(QStringLiteral("not found")) ||
+                        rgStartErrorLower.contains(QStringLiteral("no such file"))
+                    );
+                if ( rgNotFound )
                 {
-                    *error = QStringLiteral("file.read rg crashed");
+                    qInfo().noquote() << QStringLiteral(
+                        "[capability.file.read] rg not found, using native search engine"
+                    );
                 }
-                return false;
-            }
-
-            searchExitCode = rgProcess.exitCode();
-            stdoutBytes = rgProcess.readAllStandardOutput();
-            stderrBytes = rgProcess.readAllStandardError();
-            const QString rgStderrText = QString::fromLocal8Bit(stderrBytes).trimmed();
-            if ( searchExitCode == 2 )
-            {
-                if ( error != nullptr )
+                else
                 {
-                    *error = rgStderrText.isEmpty()
-                        ? QStringLiteral("file.read rg failed")
-                        : QStringLiteral("file.read rg failed: %1").arg(rgStderrText);
+                    qWarning().noquote() << QStringLiteral(
+                        "[capability.file.read] rg failed to start, fallback to native search engine: %1"
+                    ).arg(rgStartError);
                 }
-                return false;
             }
-        }
-
-        if ( usePowerShellFallback )
-        {
-            searchBackend = QStringLiteral("powershell.select-string");
-            QProcessEnvironment processEnvironment = QProcessEnvironment::systemEnvironment();
-            processEnvironment.insert(QStringLiteral("JQ_FILE_READ_PATH"), fileInfo.absoluteFilePath());
-            processEnvironment.insert(QStringLiteral("JQ_FILE_READ_PATTERN"), pattern);
-            processEnvironment.insert(QStringLiteral("JQ_FILE_READ_MAX_MATCHES"), QString::number(maxMatches));
-            processEnvironment.insert(
-                QStringLiteral("JQ_FILE_READ_CASE_SENSITIVE"),
-                caseSensitive ? QStringLiteral("1") : QStringLiteral("0")
-            );
-            processEnvironment.insert(
-                QStringLiteral("JQ_FILE_READ_INCLUDE_HIDDEN"),
-                includeHidden ? QStringLiteral("1") : QStringLiteral("0")
-            );
-            processEnvironment.insert(
-                QStringLiteral("JQ_FILE_READ_LITERAL"),
-                literal ? QStringLiteral("1") : QStringLiteral("0")
-            );
-
-            QStringList fallbackArguments;
-            fallbackArguments << QStringLiteral("-NoLogo")
-                              << QStringLiteral("-NoProfile")
-                              << QStringLiteral("-NonInteractive")
-                              << QStringLiteral("-ExecutionPolicy")
-                              << QStringLiteral("Bypass")
-                              << QStringLiteral("-Command")
-                              << QString::fromLatin1(readRgPowerShellFallbackScript);
-
-            QProcess fallbackProcess;
-            fallbackProcess.setProcessEnvironment(processEnvironment);
-            fallbackProcess.start(QStringLiteral("powershell"), fallbackArguments);
-            if ( !fallbackProcess.waitForStarted(readRgStartTimeoutMs) )
+            else
             {
-                if ( error != nullptr )
+                // Parse rg output as it arrives and stop rg once the global limit is exceeded,
+                // since --max-count only caps matches per file.
+                QByteArray pendingStdout;
+                bool stoppedEarly = false;
+                QElapsedTimer rgElapsedTimer;
+                rgElapsedTimer.start();
+                while ( true )
                 {
-                    const QString startError = fallbackProcess.errorString().trimmed();
-                    *error = startError.isEmpty()
-                        ? QStringLiteral("file.read rg fallback failed to start")
-                        : QStringLiteral("file.read rg fallback failed to start: %1").arg(startError);
-                }
-                return false;
-            }
+                    const bool rgFinished = ( rgProcess.state() == QProcess::NotRunning );
+                    pendingStdout.append(rgProcess.readAllStandardOutput());
+                    appendBoundedStderr(&stderrBytes, rgProcess.readAllStandardError());
 
-            if ( !fallbackProcess.waitForFinished(rgTimeoutMs) )
-            {
-                fallbackProcess.kill();
-                fallbackProcess.waitForFinished(readRgKillWaitTimeoutMs);
-                if ( error != nullptr )
-                {
-                    *error = QStringLiteral("file.read rg fallback timed out");
+                    qsizetype consumedBytes = 0;
+                    while ( !truncated )
+                    {
+                        const qsizetype newlineIndex = pendingStdout.indexOf('\n', consumedBytes);
+                        if ( newlineIndex < 0 )
+                        {
+                            break;
+                        }
+                        appendRgJsonMatches(
+                            pendingStdout.mid(consumedBytes, newlineIndex - consumedBytes),
+                            fileInfo.absoluteFilePath(),
+                            maxMatches,
+                            &matches,
+                            &matchedFiles,
+                            &truncated
+                        );
+                        consumedBytes = newlineIndex + 1;
+                    }
+                    pendingStdout.remove(0, consumedBytes);
+
+                    if ( truncated )
+                    {
+                        rgProcess.kill();
+                        rgProcess.waitForFinished(readRgKillWaitTimeoutMs);
+                        stoppedEarly = true;
+                        break;
+                    }
+                    if ( rgFinished )
+                    {
+                        appendRgJsonMatches(
+                            pendingStdout,
+                            fileInfo.absoluteFilePath(),
+                            maxMatches,
+                            &matches,
+                            &matchedFiles,
+                            &truncated
+                        );
+                        break;
+                    }
+
+                    const qint64 remainingMs = rgTimeoutMs - rgElapsedTimer.elapsed();
+                    if ( remainingMs <= 0 )
+                    {
+                        rgProcess.kill();
+                        rgProcess.waitForFinished(readRgKillWaitTimeoutMs);
+                        if ( error != nullptr )
+                        {
+                            *error = QStringLiteral("file.read rg timed out");
+                        }
+                        return false;
+                    }
+                    // A false return only means no stdout yet (or stderr only); the loop re-checks.
+                    rgProcess.waitForReadyRead(
+                        static_cast<int>(qMin<qint64>(remainingMs, readRgPollIntervalMs))
+                    );
                 }
-                return false;
-            }
 
-            if ( fallbackProcess.exitStatus() != QProcess::NormalExit )
-            {
-                if ( error != nullptr )
+                if ( stoppedEarly )
                 {
-                    *error = QStringLiteral("file.read rg fallback crashed");
+                    qInfo().noquote() << QStringLiteral(
+                        "[capability.file.read] rg stopped after reaching maxMatches=%1"
+                    ).arg(maxMatches);
                 }
-                return false;
-            }
-
-            searchExitCode = fallbackProcess.exitCode();
-            stdoutBytes = fallbackProcess.readAllStandardOutput();
-            stderrBytes = fallbackProcess.readAllStandardError();
-            const QString fallbackStderrText = QString::fromUtf8(stderrBytes).trimmed();
-            if ( searchExitCode != 0 )
-            {
-                if ( error != nullptr )
+                else
                 {
-                    *error = fallbackStderrText.isEmpty()
-                        ? QStringLiteral("file.read rg fallback failed")
-                        : QStringLiteral("file.read rg fallback failed: %1").arg(fallbackStderrText);
+                    if ( rgProcess.exitStatus() != QProcess::NormalExit )
+                    {
+                        if ( error != nullptr )
+                        {
+                            *error = QStringLiteral("file.read rg crashed");
+                        }
+                        return false;
+                    }
+
+                    searchExitCode = rgProcess.exitCode();
+                    const QString rgStderrText = QString::fromLocal8Bit(stderrBytes).trimmed();
+                    if ( searchExitCode == 2 )
+                    {
+                        if ( error != nullptr )
+                        {
+                            *error = rgStderrText.isEmpty()
+                                ? QStringLiteral("file.read rg failed")
+                                : QStringLiteral("file.read rg failed: %1").arg(rgStderrText);
+                        }
+                        return false;
+                    }
                 }
-                return false;
             }
         }
 
-        const QString stderrText = usePowerShellFallback
-            ? QString::fromUtf8(stderrBytes).trimmed()
-            : QString::fromLocal8Bit(stderrBytes).trimmed();
+        const QString stderrText = QString::fromLocal8Bit(stderrBytes).trimmed();
 
-        QJsonArray matches;
-        QSet<QString> matchedFiles;
-        bool truncated = false;
-        if ( usePowerShellFallback )
+        qint64 filesScanned = -1;
+        bool searchTimedOut = false;
+        QJsonObject indexObject;
+        if ( useIndexedSearch )
         {
-            QJsonParseError fallbackParseError;
-            const QJsonDocument fallbackDocument =
-                QJsonDocument::fromJson(stdoutBytes, &fallbackParseError);
-            if ( fallbackParseError.error != QJsonParseError::NoError ||
-                 !fallbackDocument.isObject() )
+            searchBackend = QStringLiteral("native.index");
+            QStringList candidateFiles;
+            FileTrigramQueryStats indexStats;
+            QString indexError;
+            if ( !FileTrigramIndex::queryCandidates(
+                    fileInfo.absoluteFilePath(),
+                    searchOptions,
+                    &candidateFiles,
+                    &indexStats,
+                    &indexError
+                ) )
             {
                 if ( error != nullptr )
                 {
-                    *error = QStringLiteral(
-                        "file.read rg fallback returned invalid JSON: %1"
-                    ).arg(fallbackParseError.errorString());
+                    *error = QStringLiteral("file.read rg index failed: %1").arg(indexError);
                 }
                 return false;
             }
 
-            const QJsonObject fallbackObject = fallbackDocument.object();
-            const QJsonArray fallbackMatches = fallbackObject.value(QStringLiteral("matches")).toArray();
-            for ( const QJsonValue &matchValue : fallbackMatches )
+            FileSearchResult searchResult;
+            QString searchError;
+            if ( !FileSearchEngine::searchFiles(
+                    candidateFiles,
+                    searchOptions,
+                    &searchResult,
+                    &searchError
+                ) )
             {
-                if ( matches.size() >= maxMatches )
-                {
-                    truncated = true;
-                    break;
-                }
-                if ( !matchValue.isObject() )
-                {
-                    continue;
-                }
-
-                const QJsonObject fallbackMatch = matchValue.toObject();
-                QString matchPath = fallbackMatch.value(QStringLiteral("path")).toString().trimmed();
-                if ( matchPath.isEmpty() )
-                {
-                    matchPath = fileInfo.absoluteFilePath();
-                }
-                matchedFiles.insert(matchPath);
-
-                QString lineText = fallbackMatch.value(QStringLiteral("lineText")).toString();
-                while ( lineText.endsWith(QLatin1Char('\n')) ||
-                        lineText.endsWith(QLatin1Char('\r')) )
-                {
-                    lineText.chop(1);
-                }
-
-                int columnStart = fallbackMatch.value(QStringLiteral("columnStart")).toInt(1);
-                if ( columnStart <= 0 )
-                {
-                    columnStart = 1;
-                }
-                int columnEnd = fallbackMatch.value(QStringLiteral("columnEnd")).toInt(columnStart);
-                if ( columnEnd < columnStart )
+                if ( error != nullptr )
                 {
-                    columnEnd = columnStart;
+                    *error = QStringLiteral("file.read rg failed: %1").arg(searchError);
                 }
-
-                QJsonObject matchItem;
-                matchItem.insert(QStringLiteral("path"), matchPath);
-                matchItem.insert(QStringLiteral("lineNumber"), fallbackMatch.value(QStringLiteral("lineNumber")).toInt());
-                matchItem.insert(QStringLiteral("columnStart"), columnStart);
-                matchItem.insert(QStringLiteral("columnEnd"), columnEnd);
-                matchItem.insert(QStringLiteral("lineText"), lineText);
-                matchItem.insert(QStringLiteral("matchText"), fallbackMatch.value(QStringLiteral("matchText")).toString());
-                matches.append(matchItem);
+                return false;
             }
 
-            if ( fallbackObject.value(QStringLiteral("truncated")).toBool() )
+            for ( const FileSearchMatch &searchMatch : searchResult.matches )
             {
-                truncated = true;
+                matchedFiles.insert(searchMatch.path);
+                matches.append(FileSearchEngine::matchToJson(searchMatch));
             }
+            truncated = searchResult.truncated;
+            filesScanned = searchResult.filesScanned;
+            searchTimedOut = searchResult.timedOut;
+            searchExitCode = matches.isEmpty() ? 1 : 0;
+
+            indexObject.insert(QStringLiteral("indexedFileCount"), indexStats.indexedFileCount);
+            indexObject.insert(QStringLiteral("updatedFileCount"), indexStats.updatedFileCount);
+            indexObject.insert(QStringLiteral("removedFileCount"), indexStats.removedFileCount);
+            indexObject.insert(QStringLiteral("candidateFileCount"), indexStats.candidateFileCount);
+            indexObject.insert(QStringLiteral("narrowed"), indexStats.narrowed);
         }
-        else
+        else if ( useNativeSearch )
         {
-            const QList<QByteArray> outputLines = stdoutBytes.split('\n');
-            for ( const QByteArray &rawLine : outputLines )
+            searchBackend = QStringLiteral("native");
+            FileSearchResult searchResult;
+            QString searchError;
+            if ( !FileSearchEngine::search(
+                    fileInfo.absoluteFilePath(),
+                    searchOptions,
+                    &searchResult,
+                    &searchError
+                ) )
             {
-                const QByteArray jsonLine = rawLine.trimmed();
-                if ( jsonLine.isEmpty() )
-                {
-                    continue;
-                }
-
-                QJsonParseError jsonParseError;
-                const QJsonDocument jsonDocument =
-                    QJsonDocument::fromJson(jsonLine, &jsonParseError);
-                if ( jsonParseError.error != QJsonParseError::NoError )
-                {
-                    continue;
-                }
-                if ( !jsonDocument.isObject() )
-                {
-                    continue;
-                }
-
-                const QJsonObject envelope = jsonDocument.object();
-                if ( envelope.value(QStringLiteral("type")).toString() != QStringLiteral("match") )
-                {
-                    continue;
-                }
-
-                const QJsonObject data = envelope.value(QStringLiteral("data")).toObject();
-                QString matchPath =
-                    data.value(QStringLiteral("path")).toObject()
-                        .value(QStringLiteral("text")).toString();
-                if ( matchPath.trimmed().isEmpty() )
-                {
-                    matchPath = fileInfo.absoluteFilePath();
-                }
-                matchedFiles.insert(matchPath);
-
-                QString lineText =
-                    data.value(QStringLiteral("lines")).toObject()
-                        .value(QStringLiteral("text")).toString();
-                while ( lineText.endsWith(QLatin1Char('\n')) ||
-                        lineText.endsWith(QLatin1Char('\r')) )
-                {
-                    lineText.chop(1);
-                }
-                const int lineNumber = data.value(QStringLiteral("line_number")).toInt();
-                const QJsonArray submatches = data.value(QStringLiteral("submatches")).toArray();
-
-                if ( submatches.isEmpty() )
+                if ( error != nullptr )
                 {
-                    if ( matches.size() >= maxMatches )
-                    {
-                        truncated = true;
-                        continue;
-                    }
-
-                    QJsonObject matchItem;
-                    matchItem.insert(QStringLiteral("path"), matchPath);
-                    matchItem.insert(QStringLiteral("lineNumber"), lineNumber);
-                    matchItem.insert(QStringLiteral("columnStart"), 1);
-                    matchItem.insert(QStringLiteral("columnEnd"), 1);
-                    matchItem.insert(QStringLiteral("lineText"), lineText);
-                    matchItem.insert(QStringLiteral("matchText"), QString());
-                    matches.append(matchItem);
-                    continue;
+                    *error = QStringLiteral("file.read rg failed: %1").arg(searchError);
                 }
+                return false;
+            }
 
-                for ( const QJsonValue &submatchValue : submatches )
-                {
-                    if ( matches.size() >= maxMatches )
-                    {
-                        truncated = true;
-                        break;
-                    }
-
-                    const QJsonObject submatch = submatchValue.toObject();
-                    const int start = submatch.value(QStringLiteral("start")).toInt();
-                    const int end = submatch.value(QStringLiteral("end")).toInt();
-                    const QString matchText =
-                        submatch.value(QStringLiteral("match")).toObject()
-                            .value(QStringLiteral("text")).toString();
-
-                    QJsonObject matchItem;
-                    matchItem.insert(QStringLiteral("path"), matchPath);
-                    matchItem.insert(QStringLiteral("lineNumber"), lineNumber);
-                    matchItem.insert(QStringLiteral("columnStart"), start + 1);
-                    matchItem.insert(QStringLiteral("columnEnd"), end);
-                    matchItem.insert(QStringLiteral("lineText"), lineText);
-                    matchItem.insert(QStringLiteral("matchText"), matchText);
-                    matches.append(matchItem);
-                }
+            for ( const FileSearchMatch &searchMatch : searchResult.matches )
+            {
+                matchedFiles.insert(searchMatch.path);
+                matches.append(FileSearchEngine::matchToJson(searchMatch));
             }
+            truncated = searchResult.truncated;
+            filesScanned = searchResult.filesScanned;
+            searchTimedOut = searchResult.timedOut;
+            searchExitCode = matches.isEmpty() ? 1 : 0;
         }
 
         QJsonObject out;
@@ -1623,6 +3667,15 @@ bool FileReadAccess::read(
         out.insert(QStringLiteral("truncated"), truncated);
         out.insert(QStringLiteral("searchBackend"), searchBackend);
         out.insert(QStringLiteral("searchExitCode"), searchExitCode);
+        if ( filesScanned >= 0 )
+        {
+            out.insert(QStringLiteral("filesScanned"), filesScanned);
+            out.insert(QStringLiteral("timedOut"), searchTimedOut);
+        }
+        if ( !indexObject.isEmpty() )
+        {
+            out.insert(QStringLiteral("index"), indexObject);
+        }
         if ( !stderrText.isEmpty() )
         {
             out.insert(QStringLiteral("stderr"), stderrText);
@@ -1674,6 +3727,12 @@ bool FileReadAccess::read(
     {
         return Common::failInvalidParams(invalidParams, error, parseError);
     }
+
+    bool gzip = false;
+    if ( !parseReadCompression(paramsObject, &gzip, &parseError) )
+    {
+        return Common::failInvalidParams(invalidParams, error, parseError);
+    }
     if ( offsetBytes > fileInfo.size() )
     {
         return Common::failInvalidParams(
@@ -1711,9 +3770,11 @@ bool FileReadAccess::read(
         return false;
     }
 
+    // The window is read in chunks rather than mapped: a file truncated by another
+    // process (copytruncate log rotation) then just reads short instead of raising SIGBUS.
+    QByteArray bytes;
     const qint64 readBudgetBytes = maxBytes + 1;
     qint64 remainingBytes = readBudgetBytes;
-    QByteArray bytes;
     bytes.reserve(static_cast<int>(qMin(readBudgetBytes, defaultReadMaxBytes)));
     while ( remainingBytes > 0 )
     {
@@ -1742,6 +3803,8 @@ bool FileReadAccess::read(
         bytes.truncate(static_cast<int>(maxBytes));
     }
     const qint64 readBytes = bytes.size();
+    qint64 compressedBytes = 0;
+    const QString content = encodeContent(bytes.constData(), bytes.size(), encoding, gzip, &compressedBytes);
     const qint64 nextOffsetBytes = offsetBytes + readBytes;
     const bool hasMore = nextOffsetBytes < fileInfo.size();
 
@@ -1757,7 +3820,8 @@ bool FileReadAccess::read(
     out.insert(QStringLiteral("hasMore"), hasMore);
     out.insert(QStringLiteral("eof"), !hasMore);
     out.insert(QStringLiteral("truncated"), truncated);
-    out.insert(QStringLiteral("content"), encodeContent(bytes, encoding));
+    out.insert(QStringLiteral("content"), content);
+    insertCompressionFields(&out, gzip, readBytes, compressedBytes);
     *result = out;
 
     qInfo().noquote() << QStringLiteral(
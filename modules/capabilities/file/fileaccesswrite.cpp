@@ -3,27 +3,53 @@
 
 // Qt lib import
 #include <QByteArray>
+#include <QCoreApplication>
 #include <QDebug>
 #include <QDir>
+#include <QElapsedTimer>
 #include <QFile>
 #include <QFileInfo>
+#include <QJsonArray>
 #include <QJsonObject>
+#include <QSaveFile>
 #include <QtGlobal>
 
 // JQOpenClaw import
+#include "capabilities/file/filecopyengine.h"
+#include "capabilities/file/filedurability.h"
+#include "capabilities/file/fileremover.h"
+#include "capabilities/file/fileuploadsession.h"
+#include "capabilities/file/filewritebatch.h"
+#include "common/base64codec.h"
 #include "common/common.h"
 
 namespace
 {
 const qint64 maxWriteBytes = 64 * 1024 * 1024;
+const qint64 maxUploadBytes = 1024LL * 1024 * 1024 * 1024;
+// Decoded size of one uploadAppend, same as one transferRead batch on the read side.
+const qint64 maxUploadChunkBytes = 8 * 1024 * 1024;
+const qint64 defaultUploadTtlMs = 10 * 60 * 1000;
+const qint64 maxUploadTtlMs = 24 * 60 * 60 * 1000;
+// copy, and permanent delete of a directory tree.
+const int writeTreeTimeoutMs = 600000;
+const int maxTreeErrorEntries = 1000;
+const int maxBatchOperations = 256;
 
 enum class FileWriteOperation
 {
     Write,
     Move,
+    Copy,
     Delete,
     MakeDir,
     RemoveDir,
+    UploadBegin,
+    UploadAppend,
+    UploadStatus,
+    UploadCommit,
+    UploadAbort,
+    Batch,
 };
 QString fileWriteOperationName(FileWriteOperation operation)
 {
@@ -33,12 +59,26 @@ QString fileWriteOperationName(FileWriteOperation operation)
         return QStringLiteral("write");
     case FileWriteOperation::Move:
         return QStringLiteral("move");
+    case FileWriteOperation::Copy:
+        return QStringLiteral("copy");
     case FileWriteOperation::Delete:
         return QStringLiteral("delete");
     case FileWriteOperation::MakeDir:
         return QStringLiteral("mkdir");
     case FileWriteOperation::RemoveDir:
         return QStringLiteral("rmdir");
+    case FileWriteOperation::UploadBegin:
+        return QStringLiteral("uploadBegin");
+    case FileWriteOperation::UploadAppend:
+        return QStringLiteral("uploadAppend");
+    case FileWriteOperation::UploadStatus:
+        return QStringLiteral("uploadStatus");
+    case FileWriteOperation::UploadCommit:
+        return QStringLiteral("uploadCommit");
+    case FileWriteOperation::UploadAbort:
+        return QStringLiteral("uploadAbort");
+    case FileWriteOperation::Batch:
+        return QStringLiteral("batch");
     }
     return QStringLiteral("write");
 }
@@ -82,6 +122,11 @@ bool parseWriteOperation(
         *operation = FileWriteOperation::Move;
         return true;
     }
+    if ( normalized == QStringLiteral("copy") )
+    {
+        *operation = FileWriteOperation::Copy;
+        return true;
+    }
     if ( ( normalized == QStringLiteral("delete") ) ||
          ( normalized == QStringLiteral("remove") ) )
     {
@@ -102,10 +147,43 @@ bool parseWriteOperation(
         *operation = FileWriteOperation::RemoveDir;
         return true;
     }
+    if ( normalized == QStringLiteral("uploadbegin") )
+    {
+        *operation = FileWriteOperation::UploadBegin;
+        return true;
+    }
+    if ( normalized == QStringLiteral("uploadappend") )
+    {
+        *operation = FileWriteOperation::UploadAppend;
+        return true;
+    }
+    if ( normalized == QStringLiteral("uploadstatus") )
+    {
+        *operation = FileWriteOperation::UploadStatus;
+        return true;
+    }
+    if ( normalized == QStringLiteral("uploadcommit") )
+    {
+        *operation = FileWriteOperation::UploadCommit;
+        return true;
+    }
+    if ( normalized == QStringLiteral("uploadabort") )
+    {
+        *operation = FileWriteOperation::UploadAbort;
+        return true;
+    }
+    if ( normalized == QStringLiteral("batch") )
+    {
+        *operation = FileWriteOperation::Batch;
+        return true;
+    }
 
     if ( error != nullptr )
     {
-        *error = QStringLiteral("file.write operation must be one of: write, move/cut, delete/remove, mkdir/createDir, rmdir/removeDir");
+        *error = QStringLiteral(
+            "file.write operation must be one of: write, move/cut, copy, delete/remove, mkdir/createDir, rmdir/removeDir, "
+            "uploadBegin, uploadAppend, uploadStatus, uploadCommit, uploadAbort, batch"
+        );
     }
     return false;
 }
@@ -137,12 +215,7 @@ bool decodeContent(
         return true;
     }
 
-    const QByteArray::FromBase64Result decodedResult =
-        QByteArray::fromBase64Encoding(
-            content.toUtf8(),
-            QByteArray::Base64Encoding | QByteArray::AbortOnBase64DecodingErrors
-        );
-    if ( decodedResult.decodingStatus != QByteArray::Base64DecodingStatus::Ok )
+    if ( !Base64Codec::fromBase64String(content, bytes) )
     {
         if ( error != nullptr )
         {
@@ -150,7 +223,6 @@ bool decodeContent(
         }
         return false;
     }
-    *bytes = decodedResult.decoded;
     return true;
 }
 
@@ -183,9 +255,21 @@ bool isSameOrChildPath(const QString &candidatePath, const QString &parentPath)
     return normalizedCandidate.startsWith(normalizedPrefix, caseSensitivity);
 }
 
+template <typename ErrorEntry>
+QString treeErrorsSummary(const QList<ErrorEntry> &errors)
+{
+    const ErrorEntry &first = errors.first();
+    if ( errors.size() == 1 )
+    {
+        return QStringLiteral("%1: %2").arg(first.path, first.error);
+    }
+    return QStringLiteral("%1: %2 (and %3 more)").arg(first.path, first.error).arg(errors.size() - 1);
+}
+
 bool removePath(
     const QString &absolutePath,
     bool recursive,
+    int timeoutMs,
     QString *error
 )
 {
@@ -217,12 +301,27 @@ bool removePath(
     {
         if ( recursive )
         {
-            QDir dir(absolutePath);
-            if ( !dir.removeRecursively() )
+            FileRemoveOptions removeOptions;
+            removeOptions.timeoutMs = timeoutMs;
+            FileRemoveSummary removeSummary;
+            QString removeError;
+            if ( !FileRemover::removeTree(absolutePath, removeOptions, &removeSummary, &removeError) )
+            {
+                if ( error != nullptr )
+                {
+                    *error = QStringLiteral("remove directory recursively failed: %1").arg(removeError);
+                }
+                return false;
+            }
+            if ( removeSummary.timedOut || !removeSummary.errors.isEmpty() )
             {
                 if ( error != nullptr )
                 {
-                    *error = QStringLiteral("remove directory recursively failed");
+                    *error = QStringLiteral("remove directory recursively failed: %1").arg(
+                        removeSummary.timedOut
+                            ? QStringLiteral("timed out")
+                            : treeErrorsSummary(removeSummary.errors)
+                    );
                 }
                 return false;
             }
@@ -248,169 +347,1229 @@ bool removePath(
     return false;
 }
 
-bool copyDirectoryRecursively(
+bool moveDirectoryWithFallback(
     const QString &sourceAbsolutePath,
     const QString &destinationAbsolutePath,
+    int timeoutMs,
     QString *error
 )
 {
-    const QDir sourceDir(sourceAbsolutePath);
-    if ( !sourceDir.exists() )
+    QDir rootDir;
+    if ( rootDir.rename(sourceAbsolutePath, destinationAbsolutePath) )
+    {
+        return true;
+    }
+
+    FileCopyOptions copyOptions;
+    copyOptions.timeoutMs = timeoutMs;
+    FileCopySummary copySummary;
+    QString copyError;
+    const bool copied = FileCopyEngine::copyTree(
+        sourceAbsolutePath,
+        destinationAbsolutePath,
+        copyOptions,
+        &copySummary,
+        &copyError
+    );
+    if ( copied && copySummary.errors.isEmpty() && !copySummary.timedOut )
+    {
+        qInfo().noquote() << QStringLiteral(
+            "[capability.file.write] move fallback copied from=%1 files=%2 bytes=%3"
+        ).arg(
+            sourceAbsolutePath,
+            QString::number(copySummary.fileCount),
+            QString::number(copySummary.copiedBytes)
+        );
+    }
+    else
     {
+        if ( copied )
+        {
+            removePath(destinationAbsolutePath, true, -1, nullptr);
+            copyError = copySummary.timedOut
+                ? QStringLiteral("timed out")
+                : treeErrorsSummary(copySummary.errors);
+        }
         if ( error != nullptr )
         {
-            *error = QStringLiteral("source directory does not exist");
+            *error = QStringLiteral("rename failed and fallback copy failed: %1").arg(copyError);
         }
         return false;
     }
 
-    QDir destinationDir(destinationAbsolutePath);
-    if ( !destinationDir.exists() )
+    QString removeError;
+    if ( !removePath(sourceAbsolutePath, true, -1, &removeError) )
     {
-        if ( !QDir().mkpath(destinationAbsolutePath) )
+        // Part of the source may already be gone, so the complete copy is kept.
+        if ( error != nullptr )
         {
-            if ( error != nullptr )
-            {
-                *error = QStringLiteral("failed to create destination directory");
-            }
-            return false;
+            *error = QStringLiteral("fallback copy succeeded but failed to remove source directory (destination kept): %1").arg(removeError);
         }
+        return false;
     }
 
-    const QFileInfoList entries = sourceDir.entryInfoList(
-        QDir::AllEntries | QDir::NoDotAndDotDot | QDir::Hidden | QDir::System,
-        QDir::DirsFirst | QDir::Name
-    );
-    for ( const QFileInfo &entryInfo : entries )
+    return true;
+}
+
+// Permanent deletes cannot be undone like a move to trash, so filesystem roots and
+// anything containing the user's home or the node itself are refused outright.
+bool isProtectedRemoveTarget(const QString &absolutePath)
+{
+    if ( QFileInfo(absolutePath).isRoot() )
     {
-        const QString sourceEntryPath = entryInfo.absoluteFilePath();
-        const QString destinationEntryPath = destinationDir.filePath(entryInfo.fileName());
+        return true;
+    }
+    return isSameOrChildPath(QDir::homePath(), absolutePath) ||
+           isSameOrChildPath(QCoreApplication::applicationDirPath(), absolutePath);
+}
 
-        if ( entryInfo.isDir() && !entryInfo.isSymLink() )
+// Fills deleted plus, for directories, the remover counts; a partially removed tree is
+// reported with deleted=false rather than as an error.
+bool removePermanently(
+    const QString &absolutePath,
+    bool isDirectory,
+    int timeoutMs,
+    QJsonObject *out,
+    QString *error
+)
+{
+    if ( !isDirectory )
+    {
+        QFile file(absolutePath);
+        if ( !file.remove() )
         {
-            QString childError;
-            if ( !copyDirectoryRecursively(sourceEntryPath, destinationEntryPath, &childError) )
-            {
-                if ( error != nullptr )
-                {
-                    *error = QStringLiteral("copy directory failed: %1").arg(childError);
-                }
-                return false;
-            }
-            continue;
+            *error = file.errorString().trimmed();
+            return false;
         }
+        out->insert(QStringLiteral("deleted"), true);
+        return true;
+    }
+
+    QElapsedTimer elapsedTimer;
+    elapsedTimer.start();
+    FileRemoveOptions removeOptions;
+    removeOptions.timeoutMs = timeoutMs;
+    FileRemoveSummary removeSummary;
+    if ( !FileRemover::removeTree(absolutePath, removeOptions, &removeSummary, error) )
+    {
+        return false;
+    }
 
-        QFile sourceFile(sourceEntryPath);
-        if ( !sourceFile.copy(destinationEntryPath) )
+    QJsonArray errorArray;
+    for ( const FileRemoveError &removeError : removeSummary.errors )
+    {
+        if ( errorArray.size() >= maxTreeErrorEntries )
         {
-            if ( error != nullptr )
-            {
-                *error = QStringLiteral("copy file failed: %1").arg(sourceFile.errorString().trimmed());
-            }
-            return false;
+            break;
         }
+        QJsonObject errorObject;
+        errorObject.insert(QStringLiteral("path"), removeError.path);
+        errorObject.insert(QStringLiteral("error"), removeError.error);
+        errorArray.append(errorObject);
     }
 
+    out->insert(QStringLiteral("deleted"), removeSummary.errors.isEmpty() && !removeSummary.timedOut);
+    out->insert(QStringLiteral("fileCount"), removeSummary.fileCount);
+    out->insert(QStringLiteral("directoryCount"), removeSummary.directoryCount);
+    out->insert(QStringLiteral("workerCount"), removeSummary.workerCount);
+    out->insert(QStringLiteral("timedOut"), removeSummary.timedOut);
+    out->insert(QStringLiteral("errorCount"), removeSummary.errors.size());
+    out->insert(QStringLiteral("errors"), errorArray);
+    out->insert(QStringLiteral("elapsedMs"), elapsedTimer.elapsed());
     return true;
 }
 
-bool moveDirectoryWithFallback(
-    const QString &sourceAbsolutePath,
-    const QString &destinationAbsolutePath,
+bool parseDurability(
+    const QJsonObject &paramsObject,
+    FileDurabilityLevel *level,
     QString *error
 )
 {
-    QDir rootDir;
-    if ( rootDir.rename(sourceAbsolutePath, destinationAbsolutePath) )
+    QString normalized;
+    if ( !Common::parseOptionalToken(
+            paramsObject,
+            QStringLiteral("durability"),
+            QStringLiteral("none"),
+            &normalized,
+            error,
+            QStringLiteral("file.write")
+        ) )
+    {
+        return false;
+    }
+    if ( normalized == QStringLiteral("none") )
     {
+        *level = FileDurabilityLevel::None;
         return true;
     }
-
-    QString copyError;
-    if ( !copyDirectoryRecursively(sourceAbsolutePath, destinationAbsolutePath, &copyError) )
+    if ( normalized == QStringLiteral("data") )
     {
-        if ( error != nullptr )
-        {
-            *error = QStringLiteral("rename failed and fallback copy failed: %1").arg(copyError);
-        }
-        return false;
+        *level = FileDurabilityLevel::Data;
+        return true;
     }
-
-    QDir sourceDir(sourceAbsolutePath);
-    if ( !sourceDir.removeRecursively() )
+    if ( normalized == QStringLiteral("full") )
     {
-        QDir(destinationAbsolutePath).removeRecursively();
-        if ( error != nullptr )
-        {
-            *error = QStringLiteral("fallback copy succeeded but failed to remove source directory");
-        }
-        return false;
+        *level = FileDurabilityLevel::Full;
+        return true;
     }
-
-    return true;
+    if ( error != nullptr )
+    {
+        *error = QStringLiteral("file.write durability must be one of: none, data, full");
+    }
+    return false;
 }
+
+QJsonObject uploadInfoToJson(const FileUploadInfo &info, FileWriteOperation operation)
+{
+    QJsonObject out;
+    out.insert(QStringLiteral("operation"), fileWriteOperationName(operation));
+    out.insert(QStringLiteral("path"), info.path);
+    out.insert(QStringLiteral("uploadId"), info.uploadId);
+    out.insert(QStringLiteral("sizeBytes"), info.sizeBytes);
+    out.insert(QStringLiteral("receivedBytes"), info.receivedBytes);
+    if ( !info.expectedSha256.isEmpty() )
+    {
+        out.insert(QStringLiteral("expectedSha256"), info.expectedSha256);
+    }
+    if ( !info.sha256.isEmpty() )
+    {
+        out.insert(QStringLiteral("sha256"), info.sha256);
+    }
+    out.insert(QStringLiteral("durability"), FileDurability::levelName(info.durability));
+    out.insert(QStringLiteral("preallocated"), info.preallocated);
+    out.insert(QStringLiteral("ttlMs"), info.ttlMs);
+    out.insert(QStringLiteral("expiresInMs"), info.expiresInMs);
+    return out;
 }
 
-bool FileWriteAccess::write(
-    const QJsonValue &params,
+bool writeUpload(
+    FileWriteOperation operation,
+    const QJsonObject &paramsObject,
+    const QString &path,
     QJsonObject *result,
     QString *error,
     bool *invalidParams
 )
 {
-    Common::resetInvalidParams(invalidParams);
-    if ( !Common::failIfNull(result, error, QStringLiteral("file.write output pointer is null")) )
-    {
-        return false;
-    }
     QString parseError;
-    QJsonObject paramsObject;
-    if ( !Common::parseParamsObject(
-            params,
-            &paramsObject,
-            &parseError,
-            QStringLiteral("file.write")
-        ) )
-    {
-        return Common::failInvalidParams(invalidParams, error, parseError);
-    }
-    const QString path = Common::extractStringTrimmed(paramsObject, QStringLiteral("path"));
-    if ( path.isEmpty() )
+    FileUploadInfo info;
+    QString uploadError;
+
+    if ( operation == FileWriteOperation::UploadBegin )
     {
-        return Common::failInvalidParams(
-            invalidParams,
-            error,
-            QStringLiteral("file.write requires path")
+        if ( path.isEmpty() )
+        {
+            return Common::failInvalidParams(
+                invalidParams,
+                error,
+                QStringLiteral("file.write uploadBegin requires path")
+            );
+        }
+
+        qint64 sizeBytes = 0;
+        if ( !Common::parseRequiredInt64(
+                paramsObject,
+                QStringLiteral("sizeBytes"),
+                0,
+                maxUploadBytes,
+                &sizeBytes,
+                &parseError,
+                QStringLiteral("file.write")
+            ) )
+        {
+            return Common::failInvalidParams(invalidParams, error, parseError);
+        }
+
+        QString sha256;
+        if ( !Common::parseOptionalTrimmedString(
+                paramsObject,
+                QStringLiteral("sha256"),
+                &sha256,
+                &parseError,
+                QStringLiteral("file.write")
+            ) )
+        {
+            return Common::failInvalidParams(invalidParams, error, parseError);
+        }
+        if ( !sha256.isEmpty() )
+        {
+            bool hexOk = ( sha256.size() == 64 );
+            for ( const QChar character : sha256 )
+            {
+                hexOk = hexOk && ( QStringLiteral("0123456789abcdefABCDEF").indexOf(character) >= 0 );
+            }
+            if ( !hexOk )
+            {
+                return Common::failInvalidParams(
+                    invalidParams,
+                    error,
+                    QStringLiteral("file.write sha256 must be a 64-character hex string")
+                );
+            }
+        }
+
+        qint64 ttlMs = defaultUploadTtlMs;
+        if ( !Common::parseOptionalInt64(
+                paramsObject,
+                QStringLiteral("ttlMs"),
+                1000,
+                maxUploadTtlMs,
+                defaultUploadTtlMs,
+                &ttlMs,
+                &parseError,
+                QStringLiteral("file.write")
+            ) )
+        {
+            return Common::failInvalidParams(invalidParams, error, parseError);
+        }
+
+        bool createDirs = true;
+        if ( !Common::parseOptionalBool(
+                paramsObject,
+                QStringLiteral("createDirs"),
+                true,
+                &createDirs,
+                &parseError
+            ) )
+        {
+            return Common::failInvalidParams(invalidParams, error, parseError);
+        }
+
+        FileDurabilityLevel durability = FileDurabilityLevel::None;
+        if ( !parseDurability(paramsObject, &durability, &parseError) )
+        {
+            return Common::failInvalidParams(invalidParams, error, parseError);
+        }
+
+        bool preallocate = false;
+        if ( !Common::parseOptionalBool(
+                paramsObject,
+                QStringLiteral("preallocate"),
+                false,
+                &preallocate,
+                &parseError
+            ) )
+        {
+            return Common::failInvalidParams(invalidParams, error, parseError);
+        }
+
+        const QFileInfo fileInfo(path);
+        if ( createDirs )
+        {
+            QDir dir = fileInfo.absoluteDir();
+            if ( !dir.exists() && !dir.mkpath(QStringLiteral(".")) )
+            {
+                if ( error != nullptr )
+                {
+                    *error = QStringLiteral("file.write failed to create parent directories");
+                }
+                return false;
+            }
+        }
+
+        if ( !FileUploadSession::begin(
+                fileInfo.absoluteFilePath(),
+                sizeBytes,
+                sha256,
+                ttlMs,
+                durability,
+                preallocate,
+                &info,
+                &uploadError
+            ) )
+        {
+            if ( error != nullptr )
+            {
+                *error = QStringLiteral("file.write uploadBegin failed: %1").arg(uploadError);
+            }
+            return false;
+        }
+
+        qInfo().noquote() << QStringLiteral(
+            "[capability.file.write] upload begin id=%1 path=%2 sizeBytes=%3"
+        ).arg(
+            info.uploadId,
+            info.path,
+            QString::number(info.sizeBytes)
         );
+        *result = uploadInfoToJson(info, operation);
+        return true;
     }
 
-    bool allowWrite = false;
-    if ( !Common::parseOptionalBool(
+    QString uploadId;
+    if ( !Common::parseRequiredTrimmedString(
             paramsObject,
-            QStringLiteral("allowWrite"),
-            false,
-            &allowWrite,
-            &parseError
+            QStringLiteral("uploadId"),
+            &uploadId,
+            &parseError,
+            QStringLiteral("file.write")
         ) )
     {
         return Common::failInvalidParams(invalidParams, error, parseError);
     }
-    if ( !allowWrite )
+
+    if ( operation == FileWriteOperation::UploadStatus )
     {
-        return Common::failInvalidParams(
+        if ( !FileUploadSession::status(uploadId, &info, &uploadError) )
+        {
+            if ( error != nullptr )
+            {
+                *error = QStringLiteral("file.write uploadStatus failed: %1").arg(uploadError);
+            }
+            return false;
+        }
+        *result = uploadInfoToJson(info, operation);
+        return true;
+    }
+
+    if ( operation == FileWriteOperation::UploadCommit )
+    {
+        if ( !FileUploadSession::commit(uploadId, &info, &uploadError) )
+        {
+            if ( error != nullptr )
+            {
+                *error = QStringLiteral("file.write uploadCommit failed: %1").arg(uploadError);
+            }
+            return false;
+        }
+
+        qInfo().noquote() << QStringLiteral(
+            "[capability.file.write] upload commit id=%1 path=%2 sizeBytes=%3 sha256=%4"
+        ).arg(
+            info.uploadId,
+            info.path,
+            QString::number(info.sizeBytes),
+            info.sha256
+        );
+        QJsonObject out = uploadInfoToJson(info, operation);
+        out.insert(QStringLiteral("committed"), true);
+        *result = out;
+        return true;
+    }
+
+    if ( operation == FileWriteOperation::UploadAbort )
+    {
+        if ( !FileUploadSession::abort(uploadId, &info, &uploadError) )
+        {
+            if ( error != nullptr )
+            {
+                *error = QStringLiteral("file.write uploadAbort failed: %1").arg(uploadError);
+            }
+            return false;
+        }
+
+        qInfo().noquote() << QStringLiteral(
+            "[capability.file.write] upload abort id=%1 path=%2 receivedBytes=%3"
+        ).arg(
+            info.uploadId,
+            info.path,
+            QString::number(info.receivedBytes)
+        );
+        QJsonObject out = uploadInfoToJson(info, operation);
+        out.insert(QStringLiteral("aborted"), true);
+        *result = out;
+        return true;
+    }
+
+    qint64 offsetBytes = 0;
+    if ( !Common::parseRequiredInt64(
+            paramsObject,
+            QStringLiteral("offsetBytes"),
+            0,
+            maxUploadBytes,
+            &offsetBytes,
+            &parseError,
+            QStringLiteral("file.write")
+        ) )
+    {
+        return Common::failInvalidParams(invalidParams, error, parseError);
+    }
+
+    QString content;
+    if ( !Common::parseRequiredString(
+            paramsObject,
+            QStringLiteral("content"),
+            &content,
+            &parseError,
+            QStringLiteral("file.write"),
+            false,
+            true,
+            true
+        ) )
+    {
+        return Common::failInvalidParams(invalidParams, error, parseError);
+    }
+    // base64 is 4 characters per 3 bytes; reject oversized chunks before decoding them.
+    if ( ( content.size() / 4 * 3 ) > maxUploadChunkBytes )
+    {
+        return Common::failInvalidParams(
+            invalidParams,
+            error,
+            QStringLiteral("file.write uploadAppend content bytes exceed limit %1").arg(maxUploadChunkBytes)
+        );
+    }
+    QByteArray chunkBytes;
+    if ( !decodeContent(content, Common::ContentEncoding::Base64, &chunkBytes, &parseError) )
+    {
+        return Common::failInvalidParams(invalidParams, error, parseError);
+    }
+    content.clear();
+
+    bool duplicate = false;
+    if ( !FileUploadSession::append(uploadId, offsetBytes, chunkBytes, &info, &duplicate, &uploadError) )
+    {
+        if ( error != nullptr )
+        {
+            *error = QStringLiteral("file.write uploadAppend failed: %1").arg(uploadError);
+        }
+        return false;
+    }
+
+    QJsonObject out = uploadInfoToJson(info, operation);
+    out.insert(QStringLiteral("offsetBytes"), offsetBytes);
+    out.insert(QStringLiteral("bytesWritten"), duplicate ? 0 : chunkBytes.size());
+    out.insert(QStringLiteral("duplicate"), duplicate);
+    *result = out;
+    return true;
+}
+
+QString batchOperationName(FileWriteBatchOperation operation)
+{
+    switch ( operation )
+    {
+    case FileWriteBatchOperation::Write:
+        return fileWriteOperationName(FileWriteOperation::Write);
+    case FileWriteBatchOperation::Move:
+        return fileWriteOperationName(FileWriteOperation::Move);
+    case FileWriteBatchOperation::Delete:
+        return fileWriteOperationName(FileWriteOperation::Delete);
+    case FileWriteBatchOperation::MakeDir:
+        return fileWriteOperationName(FileWriteOperation::MakeDir);
+    }
+    return fileWriteOperationName(FileWriteOperation::Write);
+}
+
+bool parseBatchItem(
+    const QJsonObject &itemObject,
+    int index,
+    bool defaultCreateDirs,
+    FileWriteBatchItem *item,
+    QString *error
+)
+{
+    const QString scope = QStringLiteral("file.write operations[%1]").arg(index);
+    QString normalized;
+    if ( !Common::parseOptionalToken(
+            itemObject,
+            QStringLiteral("operation"),
+            QStringLiteral("write"),
+            &normalized,
+            error,
+            scope
+        ) )
+    {
+        return false;
+    }
+    if ( normalized == QStringLiteral("write") )
+    {
+        item->operation = FileWriteBatchOperation::Write;
+    }
+    else if ( ( normalized == QStringLiteral("move") ) ||
+              ( normalized == QStringLiteral("cut") ) )
+    {
+        item->operation = FileWriteBatchOperation::Move;
+    }
+    else if ( ( normalized == QStringLiteral("delete") ) ||
+              ( normalized == QStringLiteral("remove") ) )
+    {
+        item->operation = FileWriteBatchOperation::Delete;
+    }
+    else if ( ( normalized == QStringLiteral("mkdir") ) ||
+              ( normalized == QStringLiteral("createdir") ) )
+    {
+        item->operation = FileWriteBatchOperation::MakeDir;
+    }
+    else
+    {
+        *error = QStringLiteral("%1 operation must be one of: write, move/cut, delete/remove, mkdir/createDir").arg(scope);
+        return false;
+    }
+
+    QString path;
+    if ( !Common::parseRequiredTrimmedString(
+            itemObject,
+            QStringLiteral("path"),
+            &path,
+            error,
+            scope
+        ) )
+    {
+        return false;
+    }
+    item->path = QFileInfo(path).absoluteFilePath();
+
+    if ( !Common::parseOptionalBool(
+            itemObject,
+            QStringLiteral("createDirs"),
+            defaultCreateDirs,
+            &item->createDirs,
+            error,
+            scope
+        ) )
+    {
+        return false;
+    }
+
+    if ( item->operation == FileWriteBatchOperation::Write )
+    {
+        QString content;
+        if ( !Common::parseRequiredString(
+                itemObject,
+                QStringLiteral("content"),
+                &content,
+                error,
+                scope,
+                false,
+                true,
+                true
+            ) )
+        {
+            return false;
+        }
+        Common::ContentEncoding encoding = Common::ContentEncoding::Utf8;
+        if ( !Common::parseEncoding(
+                itemObject,
+                QStringLiteral("encoding"),
+                &encoding,
+                error,
+                scope
+            ) )
+        {
+            return false;
+        }
+        bool append = false;
+        if ( !Common::parseOptionalBool(
+                itemObject,
+                QStringLiteral("append"),
+                false,
+                &append,
+                error,
+                scope
+            ) )
+        {
+            return false;
+        }
+        if ( append )
+        {
+            *error = QStringLiteral("%1 append is not supported in a batch").arg(scope);
+            return false;
+        }
+        QString decodeError;
+        if ( !decodeContent(content, encoding, &item->content, &decodeError) )
+        {
+            *error = QStringLiteral("%1 %2").arg(scope, decodeError);
+            return false;
+        }
+        return true;
+    }
+
+    if ( item->operation == FileWriteBatchOperation::Move )
+    {
+        QString destinationPath;
+        if ( !Common::parseRequiredTrimmedStringAlias(
+                itemObject,
+                QStringLiteral("destinationPath"),
+                QStringLiteral("toPath"),
+                &destinationPath,
+                error,
+                scope,
+                QStringLiteral("move requires destinationPath or toPath")
+            ) )
+        {
+            return false;
+        }
+        item->destinationPath = QFileInfo(destinationPath).absoluteFilePath();
+        if ( !Common::parseOptionalBool(
+                itemObject,
+                QStringLiteral("overwrite"),
+                false,
+                &item->overwrite,
+                error,
+                scope
+            ) )
+        {
+            return false;
+        }
+        if ( isSameOrChildPath(item->destinationPath, item->path) )
+        {
+            *error = QStringLiteral("%1 move destination must differ from source and not be inside it").arg(scope);
+            return false;
+        }
+        if ( isSameOrChildPath(item->path, item->destinationPath) )
+        {
+            *error = QStringLiteral("%1 move destination must not contain source path").arg(scope);
+            return false;
+        }
+        return true;
+    }
+
+    if ( item->operation == FileWriteBatchOperation::Delete )
+    {
+        if ( !Common::parseOptionalBool(
+                itemObject,
+                QStringLiteral("permanent"),
+                false,
+                &item->permanent,
+                error,
+                scope
+            ) )
+        {
+            return false;
+        }
+        if ( item->permanent && isProtectedRemoveTarget(item->path) )
+        {
+            *error = QStringLiteral("%1 refuses to permanently remove a filesystem root or a directory containing the home or node directory").arg(scope);
+            return false;
+        }
+    }
+    return true;
+}
+
+// Items are staged together and committed in order, so two items touching the same path
+// (other than two mkdir of one directory), or an item inside a directory another item
+// moves or deletes, would depend on each other's intermediate state; such batches are
+// rejected before anything is touched.
+bool checkBatchConflicts(const QList<FileWriteBatchItem> &items, QString *error)
+{
+    struct TouchedPath
+    {
+        int index;
+        QString path;
+        // Moved or deleted along with everything below it.
+        bool subtree;
+        bool makeDir;
+    };
+
+    QList<TouchedPath> touchedPaths;
+    for ( int index = 0; index < items.size(); ++index )
+    {
+        const FileWriteBatchItem &item = items.at(index);
+        switch ( item.operation )
+        {
+        case FileWriteBatchOperation::Write:
+            touchedPaths.append({ index, item.path, false, false });
+            break;
+        case FileWriteBatchOperation::Move:
+            touchedPaths.append({ index, item.path, true, false });
+            touchedPaths.append({ index, item.destinationPath, true, false });
+            break;
+        case FileWriteBatchOperation::Delete:
+            touchedPaths.append({ index, item.path, true, false });
+            break;
+        case FileWriteBatchOperation::MakeDir:
+            touchedPaths.append({ index, item.path, false, true });
+            break;
+        }
+    }
+
+    for ( int first = 0; first < touchedPaths.size(); ++first )
+    {
+        const TouchedPath &a = touchedPaths.at(first);
+        for ( int second = first + 1; second < touchedPaths.size(); ++second )
+        {
+            const TouchedPath &b = touchedPaths.at(second);
+            if ( a.index == b.index )
+            {
+                continue;
+            }
+            const bool aContainsB = isSameOrChildPath(b.path, a.path);
+            const bool bContainsA = isSameOrChildPath(a.path, b.path);
+            const bool samePath = aContainsB && bContainsA;
+            if ( ( samePath && !( a.makeDir && b.makeDir ) ) ||
+                 ( a.subtree && aContainsB ) ||
+                 ( b.subtree && bContainsA ) )
+            {
+                *error = QStringLiteral("file.write operations[%1] and operations[%2] touch overlapping paths: %3, %4")
+                    .arg(a.index)
+                    .arg(b.index)
+                    .arg(a.path, b.path);
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+bool writeBatch(
+    const QJsonObject &paramsObject,
+    QJsonObject *result,
+    QString *error,
+    bool *invalidParams
+)
+{
+    QString parseError;
+    QJsonArray operationArray;
+    if ( !Common::parseRequiredObjectArray(
+            paramsObject,
+            QStringLiteral("operations"),
+            1,
+            maxBatchOperations,
+            &operationArray,
+            &parseError,
+            QStringLiteral("file.write")
+        ) )
+    {
+        return Common::failInvalidParams(invalidParams, error, parseError);
+    }
+
+    bool createDirs = true;
+    if ( !Common::parseOptionalBool(
+            paramsObject,
+            QStringLiteral("createDirs"),
+            true,
+            &createDirs,
+            &parseError
+        ) )
+    {
+        return Common::failInvalidParams(invalidParams, error, parseError);
+    }
+
+    FileDurabilityLevel durability = FileDurabilityLevel::None;
+    if ( !parseDurability(paramsObject, &durability, &parseError) )
+    {
+        return Common::failInvalidParams(invalidParams, error, parseError);
+    }
+
+    QList<FileWriteBatchItem> items;
+    items.reserve(operationArray.size());
+    qint64 contentBytes = 0;
+    int writeCount = 0;
+    for ( int index = 0; index < operationArray.size(); ++index )
+    {
+        FileWriteBatchItem item;
+        if ( !parseBatchItem(operationArray.at(index).toObject(), index, createDirs, &item, &parseError) )
+        {
+            return Common::failInvalidParams(invalidParams, error, parseError);
+        }
+        if ( item.operation == FileWriteBatchOperation::Write )
+        {
+            ++writeCount;
+            contentBytes += item.content.size();
+            if ( contentBytes > maxWriteBytes )
+            {
+                return Common::failInvalidParams(
+                    invalidParams,
+                    error,
+                    QStringLiteral("file.write batch content bytes exceed limit %1").arg(maxWriteBytes)
+                );
+            }
+        }
+        items.append(item);
+    }
+    operationArray = QJsonArray();
+
+    if ( !checkBatchConflicts(items, &parseError) )
+    {
+        return Common::failInvalidParams(invalidParams, error, parseError);
+    }
+
+    qInfo().noquote() << QStringLiteral(
+        "[capability.file.write] batch start operations=%1 writes=%2 bytes=%3 durability=%4"
+    ).arg(
+        QString::number(items.size()),
+        QString::number(writeCount),
+        QString::number(contentBytes),
+        FileDurability::levelName(durability)
+    );
+
+    QElapsedTimer elapsedTimer;
+    elapsedTimer.start();
+    FileWriteBatchSummary summary;
+    QString batchError;
+    if ( !FileWriteBatch::commit(items, durability, &summary, &batchError) )
+    {
+        qInfo().noquote() << QStringLiteral(
+            "[capability.file.write] batch rolled back error=%1 rollbackErrors=%2"
+        ).arg(
+            batchError,
+            QString::number(summary.rollbackErrors.size())
+        );
+        if ( error != nullptr )
+        {
+            *error = summary.rollbackErrors.isEmpty()
+                ? QStringLiteral("file.write batch %1; rolled back").arg(batchError)
+                : QStringLiteral("file.write batch %1; rollback incomplete: %2")
+                    .arg(batchError, summary.rollbackErrors.join(QStringLiteral("; ")));
+        }
+        return false;
+    }
+    const qint64 elapsedMs = elapsedTimer.elapsed();
+
+    QJsonArray resultArray;
+    for ( int index = 0; index < items.size(); ++index )
+    {
+        const FileWriteBatchItem &item = items.at(index);
+        const FileWriteBatchItemResult &itemResult = summary.results.at(index);
+        QJsonObject itemObject;
+        itemObject.insert(QStringLiteral("index"), index);
+        itemObject.insert(QStringLiteral("operation"), batchOperationName(item.operation));
+        itemObject.insert(QStringLiteral("path"), item.path);
+        switch ( item.operation )
+        {
+        case FileWriteBatchOperation::Write:
+            itemObject.insert(QStringLiteral("bytesWritten"), itemResult.bytesWritten);
+            itemObject.insert(QStringLiteral("overwritten"), itemResult.overwritten);
+            break;
+        case FileWriteBatchOperation::Move:
+            itemObject.insert(QStringLiteral("toPath"), item.destinationPath);
+            itemObject.insert(QStringLiteral("targetType"), itemResult.targetType);
+            itemObject.insert(QStringLiteral("overwritten"), itemResult.overwritten);
+            break;
+        case FileWriteBatchOperation::Delete:
+            itemObject.insert(QStringLiteral("targetType"), itemResult.targetType);
+            itemObject.insert(
+                QStringLiteral("deleteMode"),
+                item.permanent ? QStringLiteral("permanent") : QStringLiteral("trash")
+            );
+            break;
+        case FileWriteBatchOperation::MakeDir:
+            itemObject.insert(QStringLiteral("created"), itemResult.created);
+            itemObject.insert(QStringLiteral("existed"), !itemResult.created);
+            break;
+        }
+        resultArray.append(itemObject);
+    }
+
+    QJsonObject out;
+    out.insert(QStringLiteral("operation"), fileWriteOperationName(FileWriteOperation::Batch));
+    out.insert(QStringLiteral("committed"), true);
+    out.insert(QStringLiteral("operationCount"), items.size());
+    out.insert(QStringLiteral("writeCount"), writeCount);
+    out.insert(QStringLiteral("bytesWritten"), contentBytes);
+    out.insert(QStringLiteral("durability"), FileDurability::levelName(durability));
+    out.insert(QStringLiteral("workerCount"), summary.workerCount);
+    out.insert(QStringLiteral("syncedDirectoryCount"), summary.syncedDirectoryCount);
+    out.insert(QStringLiteral("results"), resultArray);
+    out.insert(QStringLiteral("warnings"), Common::toJsonArray(summary.warnings));
+    out.insert(QStringLiteral("elapsedMs"), elapsedMs);
+    *result = out;
+
+    qInfo().noquote() << QStringLiteral(
+        "[capability.file.write] batch done operations=%1 writes=%2 bytes=%3 warnings=%4 elapsedMs=%5"
+    ).arg(
+        QString::number(items.size()),
+        QString::number(writeCount),
+        QString::number(contentBytes),
+        QString::number(summary.warnings.size()),
+        QString::number(elapsedMs)
+    );
+    return true;
+}
+}
+
+bool FileWriteAccess::write(
+    const QJsonValue &params,
+    int invokeTimeoutMs,
+    QJsonObject *result,
+    QString *error,
+    bool *invalidParams
+)
+{
+    Common::resetInvalidParams(invalidParams);
+    if ( !Common::failIfNull(result, error, QStringLiteral("file.write output pointer is null")) )
+    {
+        return false;
+    }
+    QString parseError;
+    QJsonObject paramsObject;
+    if ( !Common::parseParamsObject(
+            params,
+            &paramsObject,
+            &parseError,
+            QStringLiteral("file.write")
+        ) )
+    {
+        return Common::failInvalidParams(invalidParams, error, parseError);
+    }
+    const QString path = Common::extractStringTrimmed(paramsObject, QStringLiteral("path"));
+
+    bool allowWrite = false;
+    if ( !Common::parseOptionalBool(
+            paramsObject,
+            QStringLiteral("allowWrite"),
+            false,
+            &allowWrite,
+            &parseError
+        ) )
+    {
+        return Common::failInvalidParams(invalidParams, error, parseError);
+    }
+    if ( !allowWrite )
+    {
+        return Common::failInvalidParams(
             invalidParams,
             error,
             QStringLiteral("file.write is disabled by default; set allowWrite=true to proceed")
         );
     }
 
-    FileWriteOperation operation = FileWriteOperation::Write;
-    if ( !parseWriteOperation(paramsObject, &operation, &parseError) )
-    {
-        return Common::failInvalidParams(invalidParams, error, parseError);
+    FileWriteOperation operation = FileWriteOperation::Write;
+    if ( !parseWriteOperation(paramsObject, &operation, &parseError) )
+    {
+        return Common::failInvalidParams(invalidParams, error, parseError);
+    }
+
+    // Upload sessions other than uploadBegin are addressed by uploadId alone.
+    if ( ( operation == FileWriteOperation::UploadBegin ) ||
+         ( operation == FileWriteOperation::UploadAppend ) ||
+         ( operation == FileWriteOperation::UploadStatus ) ||
+         ( operation == FileWriteOperation::UploadCommit ) ||
+         ( operation == FileWriteOperation::UploadAbort ) )
+    {
+        return writeUpload(operation, paramsObject, path, result, error, invalidParams);
+    }
+    if ( operation == FileWriteOperation::Batch )
+    {
+        return writeBatch(paramsObject, result, error, invalidParams);
+    }
+
+    if ( path.isEmpty() )
+    {
+        return Common::failInvalidParams(
+            invalidParams,
+            error,
+            QStringLiteral("file.write requires path")
+        );
+    }
+
+    const int treeTimeoutMs = ( invokeTimeoutMs >= 0 )
+        ? qMin(writeTreeTimeoutMs, invokeTimeoutMs)
+        : writeTreeTimeoutMs;
+
+    if ( operation == FileWriteOperation::Move )
+    {
+        QString destinationPath;
+        if ( !Common::parseRequiredTrimmedStringAlias(
+                paramsObject,
+                QStringLiteral("destinationPath"),
+                QStringLiteral("toPath"),
+                &destinationPath,
+                &parseError,
+                QStringLiteral("file.write"),
+                QStringLiteral("move requires destinationPath or toPath")
+            ) )
+        {
+            return Common::failInvalidParams(invalidParams, error, parseError);
+        }
+
+        const QFileInfo sourceInfo(path);
+        if ( !sourceInfo.exists() )
+        {
+            if ( error != nullptr )
+            {
+                *error = QStringLiteral("file.write move source does not exist");
+            }
+            return false;
+        }
+
+        const QFileInfo destinationInfo(destinationPath);
+        const QString sourceAbsolutePath = sourceInfo.absoluteFilePath();
+        const QString destinationAbsolutePath = destinationInfo.absoluteFilePath();
+        if ( sourceAbsolutePath.compare(destinationAbsolutePath, Common::pathCaseSensitivity()) == 0 )
+        {
+            return Common::failInvalidParams(
+                invalidParams,
+                error,
+                QStringLiteral("file.write move source and destination must be different")
+            );
+        }
+
+        const bool sourceIsDirectory = sourceInfo.isDir() && !sourceInfo.isSymLink();
+        if ( sourceIsDirectory &&
+             isSameOrChildPath(destinationAbsolutePath, sourceAbsolutePath) )
+        {
+            return Common::failInvalidParams(
+                invalidParams,
+                error,
+                QStringLiteral("file.write move destination must not be inside source directory")
+            );
+        }
+
+        bool createDirs = true;
+        if ( !Common::parseOptionalBool(
+                paramsObject,
+                QStringLiteral("createDirs"),
+                true,
+                &createDirs,
+                &parseError
+            ) )
+        {
+            return Common::failInvalidParams(invalidParams, error, parseError);
+        }
+
+        bool overwrite = false;
+        if ( !Common::parseOptionalBool(
+                paramsObject,
+                QStringLiteral("overwrite"),
+                false,
+                &overwrite,
+                &parseError
+            ) )
+        {
+            return Common::failInvalidParams(invalidParams, error, parseError);
+        }
+
+        if ( createDirs )
+        {
+            QDir destinationDir = destinationInfo.absoluteDir();
+            if ( !destinationDir.exists() && !destinationDir.mkpath(QStringLiteral(".")) )
+            {
+                if ( error != nullptr )
+                {
+                    *error = QStringLiteral("file.write move failed to create destination parent directories");
+                }
+                return false;
+            }
+        }
+
+        const bool destinationExisted = destinationInfo.exists();
+        if ( destinationExisted )
+        {
+            if ( isSameOrChildPath(sourceAbsolutePath, destinationAbsolutePath) )
+            {
+                return Common::failInvalidParams(
+                    invalidParams,
+                    error,
+                    QStringLiteral("file.write move destination must not contain source path")
+                );
+            }
+
+            if ( !overwrite )
+            {
+                if ( error != nullptr )
+                {
+                    *error = QStringLiteral("file.write move destination already exists");
+                }
+                return false;
+            }
+
+            QString removeError;
+            if ( !removePath(destinationAbsolutePath, true, treeTimeoutMs, &removeError) )
+            {
+                if ( error != nullptr )
+                {
+                    *error = QStringLiteral("file.write move failed to remove destination: %1").arg(removeError);
+                }
+                return false;
+            }
+        }
+
+        qInfo().noquote() << QStringLiteral(
+            "[capability.file.write] move start from=%1 to=%2 overwrite=%3 createDirs=%4"
+        ).arg(
+            sourceAbsolutePath,
+            destinationAbsolutePath,
+            overwrite ? QStringLiteral("true") : QStringLiteral("false"),
+            createDirs ? QStringLiteral("true") : QStringLiteral("false")
+        );
+
+        bool moved = false;
+        QString moveError;
+        if ( sourceIsDirectory )
+        {
+            moved = moveDirectoryWithFallback(
+                sourceAbsolutePath,
+                destinationAbsolutePath,
+                treeTimeoutMs,
+                &moveError
+            );
+        }
+        else
+        {
+            QFile sourceFile(sourceAbsolutePath);
+            if ( sourceFile.rename(destinationAbsolutePath) )
+            {
+                moved = true;
+            }
+            else
+            {
+                const QString renameError = sourceFile.errorString().trimmed();
+                moveError = renameError.isEmpty()
+                    ? QStringLiteral("rename failed")
+                    : QStringLiteral("rename failed: %1").arg(renameError);
+
+                if ( sourceInfo.isFile() )
+                {
+                    FileCopyMethod copyMethod = FileCopyMethod::Buffered;
+                    qint64 copiedBytes = 0;
+                    QString copyError;
+                    if ( FileCopyEngine::copyFile(
+                            sourceAbsolutePath,
+                            destinationAbsolutePath,
+                            true,
+                            treeTimeoutMs,
+                            &copyMethod,
+                            &copiedBytes,
+                            &copyError
+                        ) )
+                    {
+                        if ( sourceFile.remove() )
+                        {
+                            moved = true;
+                        }
+                        else
+                        {
+                            const QString removeError = sourceFile.errorString().trimmed();
+                            moveError = removeError.isEmpty()
+                                ? QStringLiteral("fallback copy succeeded but failed to remove source file")
+                                : QStringLiteral("fallback copy succeeded but failed to remove source file: %1").arg(removeError);
+
+                            QFile destinationFile(destinationAbsolutePath);
+                            destinationFile.remove();
+                        }
+                    }
+                    else
+                    {
+                        moveError = QStringLiteral("%1; fallback copy failed: %2").arg(moveError, copyError);
+                    }
+                }
+            }
+        }
+
+        if ( !moved )
+        {
+            if ( error != nullptr )
+            {
+                *error = moveError.isEmpty()
+                    ? QStringLiteral("file.write move failed")
+                    : QStringLiteral("file.write move failed: %1").arg(moveError);
+            }
+            return false;
+        }
+
+        const QFileInfo movedInfo(destinationAbsolutePath);
+        QJsonObject out;
+        out.insert(QStringLiteral("operation"), fileWriteOperationName(operation));
+        out.insert(QStringLiteral("fromPath"), sourceAbsolutePath);
+        out.insert(QStringLiteral("toPath"), movedInfo.absoluteFilePath());
+        out.insert(QStringLiteral("path"), movedInfo.absoluteFilePath());
+        out.insert(QStringLiteral("targetType"), sourceIsDirectory ? QStringLiteral("directory") : QStringLiteral("file"));
+        out.insert(QStringLiteral("overwritten"), destinationExisted);
+        out.insert(QStringLiteral("moved"), true);
+        *result = out;
+
+        qInfo().noquote() << QStringLiteral(
+            "[capability.file.write] move done from=%1 to=%2 targetType=%3 overwritten=%4"
+        ).arg(
+            sourceAbsolutePath,
+            movedInfo.absoluteFilePath(),
+            sourceIsDirectory ? QStringLiteral("directory") : QStringLiteral("file"),
+            destinationExisted ? QStringLiteral("true") : QStringLiteral("false")
+        );
+        return true;
     }
 
-    if ( operation == FileWriteOperation::Move )
+    if ( operation == FileWriteOperation::Copy )
     {
         QString destinationPath;
         if ( !Common::parseRequiredTrimmedStringAlias(
@@ -420,7 +1579,7 @@ bool FileWriteAccess::write(
                 &destinationPath,
                 &parseError,
                 QStringLiteral("file.write"),
-                QStringLiteral("move requires destinationPath or toPath")
+                QStringLiteral("copy requires destinationPath or toPath")
             ) )
         {
             return Common::failInvalidParams(invalidParams, error, parseError);
@@ -431,7 +1590,7 @@ bool FileWriteAccess::write(
         {
             if ( error != nullptr )
             {
-                *error = QStringLiteral("file.write move source does not exist");
+                *error = QStringLiteral("file.write copy source does not exist");
             }
             return false;
         }
@@ -444,7 +1603,7 @@ bool FileWriteAccess::write(
             return Common::failInvalidParams(
                 invalidParams,
                 error,
-                QStringLiteral("file.write move source and destination must be different")
+                QStringLiteral("file.write copy source and destination must be different")
             );
         }
 
@@ -455,9 +1614,17 @@ bool FileWriteAccess::write(
             return Common::failInvalidParams(
                 invalidParams,
                 error,
-                QStringLiteral("file.write move destination must not be inside source directory")
+                QStringLiteral("file.write copy destination must not be inside source directory")
             );
         }
+        if ( !sourceIsDirectory && !sourceInfo.isFile() )
+        {
+            if ( error != nullptr )
+            {
+                *error = QStringLiteral("file.write copy source is neither a file nor a directory");
+            }
+            return false;
+        }
 
         bool createDirs = true;
         if ( !Common::parseOptionalBool(
@@ -483,6 +1650,19 @@ bool FileWriteAccess::write(
             return Common::failInvalidParams(invalidParams, error, parseError);
         }
 
+        FileCopyOptions copyOptions;
+        copyOptions.timeoutMs = treeTimeoutMs;
+        if ( !Common::parseOptionalBool(
+                paramsObject,
+                QStringLiteral("preserveMetadata"),
+                true,
+                &copyOptions.preserveMetadata,
+                &parseError
+            ) )
+        {
+            return Common::failInvalidParams(invalidParams, error, parseError);
+        }
+
         if ( createDirs )
         {
             QDir destinationDir = destinationInfo.absoluteDir();
@@ -490,7 +1670,7 @@ bool FileWriteAccess::write(
             {
                 if ( error != nullptr )
                 {
-                    *error = QStringLiteral("file.write move failed to create destination parent directories");
+                    *error = QStringLiteral("file.write copy failed to create destination parent directories");
                 }
                 return false;
             }
@@ -504,7 +1684,7 @@ bool FileWriteAccess::write(
                 return Common::failInvalidParams(
                     invalidParams,
                     error,
-                    QStringLiteral("file.write move destination must not contain source path")
+                    QStringLiteral("file.write copy destination must not contain source path")
                 );
             }
 
@@ -512,114 +1692,127 @@ bool FileWriteAccess::write(
             {
                 if ( error != nullptr )
                 {
-                    *error = QStringLiteral("file.write move destination already exists");
+                    *error = QStringLiteral("file.write copy destination already exists");
                 }
                 return false;
             }
 
             QString removeError;
-            if ( !removePath(destinationAbsolutePath, true, &removeError) )
+            if ( !removePath(destinationAbsolutePath, true, treeTimeoutMs, &removeError) )
             {
                 if ( error != nullptr )
                 {
-                    *error = QStringLiteral("file.write move failed to remove destination: %1").arg(removeError);
+                    *error = QStringLiteral("file.write copy failed to remove destination: %1").arg(removeError);
                 }
                 return false;
             }
         }
 
         qInfo().noquote() << QStringLiteral(
-            "[capability.file.write] move start from=%1 to=%2 overwrite=%3 createDirs=%4"
+            "[capability.file.write] copy start from=%1 to=%2 overwrite=%3 preserveMetadata=%4"
         ).arg(
             sourceAbsolutePath,
             destinationAbsolutePath,
             overwrite ? QStringLiteral("true") : QStringLiteral("false"),
-            createDirs ? QStringLiteral("true") : QStringLiteral("false")
+            copyOptions.preserveMetadata ? QStringLiteral("true") : QStringLiteral("false")
         );
 
-        bool moved = false;
-        QString moveError;
+        QElapsedTimer elapsedTimer;
+        elapsedTimer.start();
+        FileCopySummary copySummary;
+        QString copyError;
         if ( sourceIsDirectory )
         {
-            moved = moveDirectoryWithFallback(
-                sourceAbsolutePath,
-                destinationAbsolutePath,
-                &moveError
-            );
+            if ( !FileCopyEngine::copyTree(
+                    sourceAbsolutePath,
+                    destinationAbsolutePath,
+                    copyOptions,
+                    &copySummary,
+                    &copyError
+                ) )
+            {
+                if ( error != nullptr )
+                {
+                    *error = QStringLiteral("file.write copy failed: %1").arg(copyError);
+                }
+                return false;
+            }
         }
         else
         {
-            QFile sourceFile(sourceAbsolutePath);
-            if ( sourceFile.rename(destinationAbsolutePath) )
-            {
-                moved = true;
-            }
-            else
+            FileCopyMethod copyMethod = FileCopyMethod::Buffered;
+            if ( !FileCopyEngine::copyFile(
+                    sourceAbsolutePath,
+                    destinationAbsolutePath,
+                    copyOptions.preserveMetadata,
+                    copyOptions.timeoutMs,
+                    &copyMethod,
+                    &copySummary.copiedBytes,
+                    &copyError
+                ) )
             {
-                const QString renameError = sourceFile.errorString().trimmed();
-                moveError = renameError.isEmpty()
-                    ? QStringLiteral("rename failed")
-                    : QStringLiteral("rename failed: %1").arg(renameError);
-
-                if ( sourceInfo.isFile() )
+                if ( error != nullptr )
                 {
-                    if ( sourceFile.copy(destinationAbsolutePath) )
-                    {
-                        if ( sourceFile.remove() )
-                        {
-                            moved = true;
-                        }
-                        else
-                        {
-                            const QString removeError = sourceFile.errorString().trimmed();
-                            moveError = removeError.isEmpty()
-                                ? QStringLiteral("fallback copy succeeded but failed to remove source file")
-                                : QStringLiteral("fallback copy succeeded but failed to remove source file: %1").arg(removeError);
-
-                            QFile destinationFile(destinationAbsolutePath);
-                            destinationFile.remove();
-                        }
-                    }
-                    else
-                    {
-                        const QString copyError = sourceFile.errorString().trimmed();
-                        moveError = copyError.isEmpty()
-                            ? QStringLiteral("%1; fallback copy failed").arg(moveError)
-                            : QStringLiteral("%1; fallback copy failed: %2").arg(moveError, copyError);
-                    }
+                    *error = QStringLiteral("file.write copy failed: %1").arg(copyError);
                 }
+                return false;
             }
+            copySummary.fileCount = 1;
+            copySummary.clonedFileCount = ( copyMethod == FileCopyMethod::Clone ) ? 1 : 0;
+            copySummary.kernelFileCount = ( copyMethod == FileCopyMethod::Kernel ) ? 1 : 0;
+            copySummary.bufferedFileCount = ( copyMethod == FileCopyMethod::Buffered ) ? 1 : 0;
         }
+        const qint64 elapsedMs = elapsedTimer.elapsed();
+        const bool complete = copySummary.errors.isEmpty() && !copySummary.timedOut;
 
-        if ( !moved )
+        QJsonArray errorArray;
+        for ( const FileCopyError &copyEntryError : copySummary.errors )
         {
-            if ( error != nullptr )
+            if ( errorArray.size() >= maxTreeErrorEntries )
             {
-                *error = moveError.isEmpty()
-                    ? QStringLiteral("file.write move failed")
-                    : QStringLiteral("file.write move failed: %1").arg(moveError);
+                break;
             }
-            return false;
+            QJsonObject errorObject;
+            errorObject.insert(QStringLiteral("path"), copyEntryError.path);
+            errorObject.insert(QStringLiteral("error"), copyEntryError.error);
+            errorArray.append(errorObject);
         }
 
-        const QFileInfo movedInfo(destinationAbsolutePath);
         QJsonObject out;
         out.insert(QStringLiteral("operation"), fileWriteOperationName(operation));
         out.insert(QStringLiteral("fromPath"), sourceAbsolutePath);
-        out.insert(QStringLiteral("toPath"), movedInfo.absoluteFilePath());
-        out.insert(QStringLiteral("path"), movedInfo.absoluteFilePath());
+        out.insert(QStringLiteral("toPath"), destinationAbsolutePath);
+        out.insert(QStringLiteral("path"), destinationAbsolutePath);
         out.insert(QStringLiteral("targetType"), sourceIsDirectory ? QStringLiteral("directory") : QStringLiteral("file"));
         out.insert(QStringLiteral("overwritten"), destinationExisted);
-        out.insert(QStringLiteral("moved"), true);
+        out.insert(QStringLiteral("copied"), complete);
+        out.insert(QStringLiteral("fileCount"), copySummary.fileCount);
+        out.insert(QStringLiteral("directoryCount"), copySummary.directoryCount);
+        out.insert(QStringLiteral("symlinkCount"), copySummary.symlinkCount);
+        out.insert(QStringLiteral("skippedCount"), copySummary.skippedCount);
+        out.insert(QStringLiteral("copiedBytes"), copySummary.copiedBytes);
+        out.insert(QStringLiteral("clonedFileCount"), copySummary.clonedFileCount);
+        out.insert(QStringLiteral("kernelFileCount"), copySummary.kernelFileCount);
+        out.insert(QStringLiteral("bufferedFileCount"), copySummary.bufferedFileCount);
+        out.insert(QStringLiteral("workerCount"), copySummary.workerCount);
+        out.insert(QStringLiteral("timedOut"), copySummary.timedOut);
+        out.insert(QStringLiteral("errorCount"), copySummary.errors.size());
+        out.insert(QStringLiteral("errors"), errorArray);
+        out.insert(QStringLiteral("elapsedMs"), elapsedMs);
         *result = out;
 
         qInfo().noquote() << QStringLiteral(
-            "[capability.file.write] move done from=%1 to=%2 targetType=%3 overwritten=%4"
+            "[capability.file.write] copy done from=%1 to=%2 files=%3 bytes=%4 cloned=%5 kernel=%6 buffered=%7 errors=%8 elapsedMs=%9"
         ).arg(
             sourceAbsolutePath,
-            movedInfo.absoluteFilePath(),
-            sourceIsDirectory ? QStringLiteral("directory") : QStringLiteral("file"),
-            destinationExisted ? QStringLiteral("true") : QStringLiteral("false")
+            destinationAbsolutePath,
+            QString::number(copySummary.fileCount),
+            QString::number(copySummary.copiedBytes),
+            QString::number(copySummary.clonedFileCount),
+            QString::number(copySummary.kernelFileCount),
+            QString::number(copySummary.bufferedFileCount),
+            QString::number(copySummary.errors.size()),
+            QString::number(elapsedMs)
         );
         return true;
     }
@@ -636,39 +1829,77 @@ bool FileWriteAccess::write(
             return false;
         }
 
+        bool permanent = false;
+        if ( !Common::parseOptionalBool(
+                paramsObject,
+                QStringLiteral("permanent"),
+                false,
+                &permanent,
+                &parseError
+            ) )
+        {
+            return Common::failInvalidParams(invalidParams, error, parseError);
+        }
+
         const QString targetAbsolutePath = targetInfo.absoluteFilePath();
         const bool targetIsDirectory = targetInfo.isDir() && !targetInfo.isSymLink();
+        if ( permanent && isProtectedRemoveTarget(targetAbsolutePath) )
+        {
+            return Common::failInvalidParams(
+                invalidParams,
+                error,
+                QStringLiteral("file.write delete refuses to permanently remove a filesystem root or a directory containing the home or node directory")
+            );
+        }
+        const QString deleteMode = permanent ? QStringLiteral("permanent") : QStringLiteral("trash");
 
         qInfo().noquote() << QStringLiteral(
-            "[capability.file.write] delete start path=%1 mode=trash"
+            "[capability.file.write] delete start path=%1 mode=%2"
         ).arg(
-            targetAbsolutePath
+            targetAbsolutePath,
+            deleteMode
         );
 
-        QFile targetFile(targetAbsolutePath);
-        if ( !targetFile.moveToTrash() )
-        {
-            if ( error != nullptr )
-            {
-                *error = QStringLiteral("file.write delete failed to move target to trash: %1")
-                    .arg(targetFile.errorString().trimmed());
-            }
-            return false;
-        }
-
         QJsonObject out;
         out.insert(QStringLiteral("operation"), fileWriteOperationName(operation));
         out.insert(QStringLiteral("path"), targetAbsolutePath);
         out.insert(QStringLiteral("targetType"), targetIsDirectory ? QStringLiteral("directory") : QStringLiteral("file"));
-        out.insert(QStringLiteral("deleted"), true);
-        out.insert(QStringLiteral("deleteMode"), QStringLiteral("trash"));
+        if ( permanent )
+        {
+            QString removeError;
+            if ( !removePermanently(targetAbsolutePath, targetIsDirectory, treeTimeoutMs, &out, &removeError) )
+            {
+                if ( error != nullptr )
+                {
+                    *error = QStringLiteral("file.write delete failed: %1").arg(removeError);
+                }
+                return false;
+            }
+        }
+        else
+        {
+            QFile targetFile(targetAbsolutePath);
+            if ( !targetFile.moveToTrash() )
+            {
+                if ( error != nullptr )
+                {
+                    *error = QStringLiteral("file.write delete failed to move target to trash: %1")
+                        .arg(targetFile.errorString().trimmed());
+                }
+                return false;
+            }
+            out.insert(QStringLiteral("deleted"), true);
+        }
+        out.insert(QStringLiteral("deleteMode"), deleteMode);
         *result = out;
 
         qInfo().noquote() << QStringLiteral(
-            "[capability.file.write] delete done path=%1 targetType=%2 mode=trash"
+            "[capability.file.write] delete done path=%1 targetType=%2 mode=%3 deleted=%4"
         ).arg(
             targetAbsolutePath,
-            targetIsDirectory ? QStringLiteral("directory") : QStringLiteral("file")
+            targetIsDirectory ? QStringLiteral("directory") : QStringLiteral("file"),
+            deleteMode,
+            out.value(QStringLiteral("deleted")).toBool() ? QStringLiteral("true") : QStringLiteral("false")
         );
         return true;
     }
@@ -784,36 +2015,75 @@ bool FileWriteAccess::write(
             );
         }
 
+        bool permanent = false;
+        if ( !Common::parseOptionalBool(
+                paramsObject,
+                QStringLiteral("permanent"),
+                false,
+                &permanent,
+                &parseError
+            ) )
+        {
+            return Common::failInvalidParams(invalidParams, error, parseError);
+        }
+
         const QString targetAbsolutePath = targetInfo.absoluteFilePath();
+        if ( permanent && isProtectedRemoveTarget(targetAbsolutePath) )
+        {
+            return Common::failInvalidParams(
+                invalidParams,
+                error,
+                QStringLiteral("file.write rmdir refuses to permanently remove a filesystem root or a directory containing the home or node directory")
+            );
+        }
+        const QString deleteMode = permanent ? QStringLiteral("permanent") : QStringLiteral("trash");
+
         qInfo().noquote() << QStringLiteral(
-            "[capability.file.write] rmdir start path=%1 mode=trash"
+            "[capability.file.write] rmdir start path=%1 mode=%2"
         ).arg(
-            targetAbsolutePath
+            targetAbsolutePath,
+            deleteMode
         );
 
-        QFile targetFile(targetAbsolutePath);
-        if ( !targetFile.moveToTrash() )
-        {
-            if ( error != nullptr )
-            {
-                *error = QStringLiteral("file.write rmdir failed to move directory to trash: %1")
-                    .arg(targetFile.errorString().trimmed());
-            }
-            return false;
-        }
-
         QJsonObject out;
         out.insert(QStringLiteral("operation"), fileWriteOperationName(operation));
         out.insert(QStringLiteral("path"), targetAbsolutePath);
         out.insert(QStringLiteral("targetType"), QStringLiteral("directory"));
-        out.insert(QStringLiteral("deleted"), true);
-        out.insert(QStringLiteral("deleteMode"), QStringLiteral("trash"));
+        if ( permanent )
+        {
+            QString removeError;
+            if ( !removePermanently(targetAbsolutePath, true, treeTimeoutMs, &out, &removeError) )
+            {
+                if ( error != nullptr )
+                {
+                    *error = QStringLiteral("file.write rmdir failed: %1").arg(removeError);
+                }
+                return false;
+            }
+        }
+        else
+        {
+            QFile targetFile(targetAbsolutePath);
+            if ( !targetFile.moveToTrash() )
+            {
+                if ( error != nullptr )
+                {
+                    *error = QStringLiteral("file.write rmdir failed to move directory to trash: %1")
+                        .arg(targetFile.errorString().trimmed());
+                }
+                return false;
+            }
+            out.insert(QStringLiteral("deleted"), true);
+        }
+        out.insert(QStringLiteral("deleteMode"), deleteMode);
         *result = out;
 
         qInfo().noquote() << QStringLiteral(
-            "[capability.file.write] rmdir done path=%1 mode=trash"
+            "[capability.file.write] rmdir done path=%1 mode=%2 deleted=%3"
         ).arg(
-            targetAbsolutePath
+            targetAbsolutePath,
+            deleteMode,
+            out.value(QStringLiteral("deleted")).toBool() ? QStringLiteral("true") : QStringLiteral("false")
         );
         return true;
     }
@@ -869,6 +2139,44 @@ bool FileWriteAccess::write(
         return Common::failInvalidParams(invalidParams, error, parseError);
     }
 
+    bool atomic = false;
+    if ( !Common::parseOptionalBool(
+            paramsObject,
+            QStringLiteral("atomic"),
+            false,
+            &atomic,
+            &parseError
+        ) )
+    {
+        return Common::failInvalidParams(invalidParams, error, parseError);
+    }
+    if ( atomic && append )
+    {
+        return Common::failInvalidParams(
+            invalidParams,
+            error,
+            QStringLiteral("file.write atomic cannot be combined with append")
+        );
+    }
+
+    FileDurabilityLevel durability = FileDurabilityLevel::None;
+    if ( !parseDurability(paramsObject, &durability, &parseError) )
+    {
+        return Common::failInvalidParams(invalidParams, error, parseError);
+    }
+
+    bool preallocate = false;
+    if ( !Common::parseOptionalBool(
+            paramsObject,
+            QStringLiteral("preallocate"),
+            false,
+            &preallocate,
+            &parseError
+        ) )
+    {
+        return Common::failInvalidParams(invalidParams, error, parseError);
+    }
+
     QByteArray contentBytes;
     if ( !decodeContent(content, encoding, &contentBytes, &parseError) )
     {
@@ -898,36 +2206,80 @@ bool FileWriteAccess::write(
     }
 
     qInfo().noquote() << QStringLiteral(
-        "[capability.file.write] start path=%1 bytes=%2 append=%3 encoding=%4"
+        "[capability.file.write] start path=%1 bytes=%2 append=%3 encoding=%4 atomic=%5 durability=%6"
     ).arg(
         fileInfo.absoluteFilePath(),
         QString::number(contentBytes.size()),
         append ? QStringLiteral("true") : QStringLiteral("false"),
-        Common::encodingName(encoding)
+        Common::encodingName(encoding),
+        atomic ? QStringLiteral("true") : QStringLiteral("false"),
+        FileDurability::levelName(durability)
     );
 
-    QFile file(fileInfo.absoluteFilePath());
+    // atomic writes go to a temporary file beside the target that replaces it only once
+    // everything is written, so readers and crashes see either the old or the new file.
+    QFile plainFile(fileInfo.absoluteFilePath());
+    QSaveFile saveFile(fileInfo.absoluteFilePath());
+    QFileDevice *file = atomic ? static_cast<QFileDevice *>(&saveFile) : &plainFile;
     QIODevice::OpenMode mode = QIODevice::WriteOnly;
-    mode |= append ? QIODevice::Append : QIODevice::Truncate;
-    if ( !file.open(mode) )
+    if ( !atomic )
+    {
+        mode |= append ? QIODevice::Append : QIODevice::Truncate;
+    }
+    if ( !file->open(mode) )
     {
         if ( error != nullptr )
         {
-            *error = QStringLiteral("file.write open failed: %1").arg(file.errorString().trimmed());
+            *error = QStringLiteral("file.write open failed: %1").arg(file->errorString().trimmed());
         }
         return false;
     }
 
-    const qint64 written = file.write(contentBytes);
+    bool preallocated = false;
+    if ( preallocate )
+    {
+        preallocated = FileDurability::preallocate(file, file->size() + contentBytes.size());
+    }
+
+    const qint64 written = file->write(contentBytes);
     if ( written != contentBytes.size() )
     {
         if ( error != nullptr )
         {
-            *error = QStringLiteral("file.write failed: %1").arg(file.errorString().trimmed());
+            *error = QStringLiteral("file.write failed: %1").arg(file->errorString().trimmed());
+        }
+        return false;
+    }
+
+    QString syncError;
+    if ( !FileDurability::syncFile(file, durability, &syncError) )
+    {
+        if ( error != nullptr )
+        {
+            *error = QStringLiteral("file.write %1").arg(syncError);
+        }
+        return false;
+    }
+    if ( atomic && !saveFile.commit() )
+    {
+        if ( error != nullptr )
+        {
+            *error = QStringLiteral("file.write failed to replace target: %1").arg(saveFile.errorString().trimmed());
+        }
+        return false;
+    }
+    plainFile.close();
+    // The file may be new or, when atomic, renamed into place: both are directory entry
+    // changes that full durability has to cover as well.
+    if ( ( durability == FileDurabilityLevel::Full ) &&
+         !FileDurability::syncDirectory(fileInfo.absolutePath(), &syncError) )
+    {
+        if ( error != nullptr )
+        {
+            *error = QStringLiteral("file.write %1").arg(syncError);
         }
         return false;
     }
-    file.flush();
 
     const QFileInfo writtenInfo(fileInfo.absoluteFilePath());
     QJsonObject out;
@@ -935,6 +2287,9 @@ bool FileWriteAccess::write(
     out.insert(QStringLiteral("path"), writtenInfo.absoluteFilePath());
     out.insert(QStringLiteral("encoding"), Common::encodingName(encoding));
     out.insert(QStringLiteral("appended"), append);
+    out.insert(QStringLiteral("atomic"), atomic);
+    out.insert(QStringLiteral("durability"), FileDurability::levelName(durability));
+    out.insert(QStringLiteral("preallocated"), preallocated);
     out.insert(QStringLiteral("bytesWritten"), written);
     out.insert(QStringLiteral("sizeBytes"), writtenInfo.exists() ? writtenInfo.size() : written);
     *result = out;
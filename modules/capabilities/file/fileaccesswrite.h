@@ -11,6 +11,7 @@ class FileWriteAccess
 public:
     static bool write(
         const QJsonValue &params,
+        int invokeTimeoutMs,
         QJsonObject *result,
         QString *error,
         bool *invalidParams
@@ -0,0 +1,550 @@
+// .h include
+#include "capabilities/file/filearchivewriter.h"
+
+// Qt lib import
+#include <QByteArray>
+#include <QDateTime>
+#include <QDeadlineTimer>
+#include <QFile>
+#include <QFileInfo>
+
+// JQOpenClaw import
+#include "common/gzipcodec.h"
+
+// C++ lib import
+#include <cstring>
+
+namespace
+{
+const qint64 archiveReadChunkBytes = 1024 * 1024;
+const qint64 tarBlockBytes = 512;
+const qsizetype tarGzMemberBytes = 1024 * 1024;
+const qint64 zipDeflateMaxBytes = 16 * 1024 * 1024;
+const int zipDeflateLevel = 6;
+const qint64 zipMaxEntries = 0xFFFF;
+const qint64 zipMaxOffset = 0xFFFFFFFFLL;
+
+// Output that optionally gzips: tar.gz bytes are collected into members of about
+// tarGzMemberBytes, each compressed and written on its own. Concatenated members are
+// a valid gzip stream (RFC 1952 section 2.2).
+class ArchiveSink
+{
+public:
+    ArchiveSink(QFile *file, bool gzip) :
+        file_(file),
+        gzip_(gzip)
+    { }
+
+    bool write(const char *data, qint64 size)
+    {
+        if ( !gzip_ )
+        {
+            return writeFile(data, size);
+        }
+        pending_.append(data, static_cast<qsizetype>(size));
+        return ( pending_.size() < tarGzMemberBytes ) || flushMember();
+    }
+
+    bool write(const QByteArray &bytes)
+    {
+        return write(bytes.constData(), bytes.size());
+    }
+
+    bool writeZeros(qint64 size)
+    {
+        static const char zeros[tarBlockBytes] = {};
+        while ( size > 0 )
+        {
+            const qint64 part = qMin(size, tarBlockBytes);
+            if ( !write(zeros, part) )
+            {
+                return false;
+            }
+            size -= part;
+        }
+        return true;
+    }
+
+    bool finish()
+    {
+        return !gzip_ || pending_.isEmpty() || flushMember();
+    }
+
+    QString error() const
+    {
+        return error_;
+    }
+
+private:
+    bool flushMember()
+    {
+        QByteArray member;
+        if ( !GzipCodec::compress(pending_.constData(), pending_.size(), -1, &member) )
+        {
+            error_ = QStringLiteral("gzip compression failed");
+            return false;
+        }
+        pending_.clear();
+        return writeFile(member.constData(), member.size());
+    }
+
+    bool writeFile(const char *data, qint64 size)
+    {
+        if ( file_->write(data, size) != size )
+        {
+            error_ = QStringLiteral("write failed: %1").arg(file_->errorString().trimmed());
+            return false;
+        }
+        return true;
+    }
+
+    QFile *file_;
+    bool gzip_;
+    QByteArray pending_;
+    QString error_;
+};
+
+void appendError(FileArchiveSummary *summary, const QString &path, const QString &error)
+{
+    FileArchiveError archiveError;
+    archiveError.path = path;
+    archiveError.error = error;
+    summary->errors.append(archiveError);
+}
+
+void writeOctal(char *field, int fieldBytes, quint64 value)
+{
+    // fieldBytes - 1 digits, zero padded, NUL terminated.
+    field[fieldBytes - 1] = '\0';
+    for ( int index = fieldBytes - 2; index >= 0; --index )
+    {
+        field[index] = static_cast<char>('0' + ( value & 7U ));
+        value >>= 3;
+    }
+}
+
+QByteArray tarHeader(const QByteArray &name, const QByteArray &prefix, qint64 size, qint64 mtime, char type)
+{
+    QByteArray header(tarBlockBytes, '\0');
+    char *block = header.data();
+    std::memcpy(block, name.constData(), static_cast<size_t>(qMin<qsizetype>(name.size(), 100)));
+    writeOctal(block + 100, 8, 0644);
+    writeOctal(block + 108, 8, 0);
+    writeOctal(block + 116, 8, 0);
+    writeOctal(block + 124, 12, static_cast<quint64>(size));
+    writeOctal(block + 136, 12, static_cast<quint64>(qMax<qint64>(0, mtime)));
+    block[156] = type;
+    std::memcpy(block + 257, "ustar", 6);
+    std::memcpy(block + 263, "00", 2);
+    std::memcpy(block + 345, prefix.constData(), static_cast<size_t>(qMin<qsizetype>(prefix.size(), 155)));
+
+    // The checksum is computed with its own field read as spaces.
+    std::memset(block + 148, ' ', 8);
+    quint32 checksum = 0;
+    for ( int index = 0; index < tarBlockBytes; ++index )
+    {
+        checksum += static_cast<quint8>(block[index]);
+    }
+    writeOctal(block + 148, 7, checksum);
+    block[155] = ' ';
+    return header;
+}
+
+// pax record: "<length> path=<value>\n", where length counts the whole record.
+QByteArray paxRecord(const QByteArray &key, const QByteArray &value)
+{
+    const qsizetype payloadBytes = key.size() + value.size() + 3;
+    qsizetype length = payloadBytes + 1;
+    while ( ( QByteArray::number(length).size() + payloadBytes ) != length )
+    {
+        length = QByteArray::number(length).size() + payloadBytes;
+    }
+    return QByteArray::number(length) + ' ' + key + '=' + value + '\n';
+}
+
+bool writeTarHeader(ArchiveSink *sink, const QByteArray &path, qint64 size, qint64 mtime)
+{
+    if ( path.size() <= 100 )
+    {
+        return sink->write(tarHeader(path, QByteArray(), size, mtime, '0'));
+    }
+
+    // ustar splits a long name at a '/' into prefix (<= 155) and name (<= 100).
+    for ( qsizetype slash = path.indexOf('/'); slash >= 0; slash = path.indexOf('/', slash + 1) )
+    {
+        if ( ( slash <= 155 ) && ( ( path.size() - slash - 1 ) <= 100 ) && ( slash + 1 < path.size() ) )
+        {
+            return sink->write(tarHeader(path.mid(slash + 1), path.left(slash), size, mtime, '0'));
+        }
+    }
+
+    const QByteArray record = paxRecord(QByteArrayLiteral("path"), path);
+    if ( !sink->write(tarHeader(QByteArrayLiteral("././@PaxHeader"), QByteArray(), record.size(), mtime, 'x')) ||
+         !sink->write(record) ||
+         !sink->writeZeros(( tarBlockBytes - ( record.size() % tarBlockBytes ) ) % tarBlockBytes) )
+    {
+        return false;
+    }
+    return sink->write(tarHeader(path.left(100), QByteArray(), size, mtime, '0'));
+}
+
+bool appendTarEntry(
+    ArchiveSink *sink,
+    const FileArchiveEntry &entry,
+    QFile *file,
+    const QFileInfo &fileInfo,
+    FileArchiveSummary *summary,
+    QString *error
+)
+{
+    const qint64 size = file->size();
+    if ( !writeTarHeader(sink, entry.relativePath.toUtf8(), size, fileInfo.lastModified().toSecsSinceEpoch()) )
+    {
+        *error = sink->error();
+        return false;
+    }
+
+    qint64 written = 0;
+    while ( written < size )
+    {
+        const QByteArray chunk = file->read(qMin(archiveReadChunkBytes, size - written));
+        if ( chunk.isEmpty() )
+        {
+            break;
+        }
+        if ( !sink->write(chunk) )
+        {
+            *error = sink->error();
+            return false;
+        }
+        written += chunk.size();
+    }
+    if ( written < size )
+    {
+        // The header already promised size bytes.
+        appendError(
+            summary,
+            entry.relativePath,
+            QStringLiteral("read stopped after %1 of %2 bytes; rest zero-filled").arg(written).arg(size)
+        );
+        if ( !sink->writeZeros(size - written) )
+        {
+            *error = sink->error();
+            return false;
+        }
+    }
+    if ( !sink->writeZeros(( tarBlockBytes - ( size % tarBlockBytes ) ) % tarBlockBytes) )
+    {
+        *error = sink->error();
+        return false;
+    }
+    summary->contentBytes += size;
+    ++summary->fileCount;
+    return true;
+}
+
+void appendLittleEndian(QByteArray *out, quint64 value, int bytes)
+{
+    for ( int index = 0; index < bytes; ++index )
+    {
+        out->append(static_cast<char>(( value >> ( 8 * index ) ) & 0xFFU));
+    }
+}
+
+struct ZipCentralEntry
+{
+    QByteArray name;
+    quint16 method = 0;
+    quint16 dosTime = 0;
+    quint16 dosDate = 0;
+    quint32 crc = 0;
+    quint32 compressedBytes = 0;
+    quint32 uncompressedBytes = 0;
+    quint32 localHeaderOffset = 0;
+};
+
+void dosDateTime(const QDateTime &modified, quint16 *dosTime, quint16 *dosDate)
+{
+    const QDateTime local = modified.toLocalTime();
+    if ( !local.isValid() || ( local.date().year() < 1980 ) )
+    {
+        *dosTime = 0;
+        *dosDate = ( 1 << 5 ) | 1;
+        return;
+    }
+    const QTime time = local.time();
+    const QDate date = local.date();
+    *dosTime = static_cast<quint16>(( time.hour() << 11 ) | ( time.minute() << 5 ) | ( time.second() / 2 ));
+    *dosDate = static_cast<quint16>(( ( date.year() - 1980 ) << 9 ) | ( date.month() << 5 ) | date.day());
+}
+
+QByteArray zipLocalHeader(const ZipCentralEntry &entry)
+{
+    QByteArray header;
+    appendLittleEndian(&header, 0x04034B50, 4);
+    appendLittleEndian(&header, 20, 2);
+    // Bit 11: the name is UTF-8.
+    appendLittleEndian(&header, 0x0800, 2);
+    appendLittleEndian(&header, entry.method, 2);
+    appendLittleEndian(&header, entry.dosTime, 2);
+    appendLittleEndian(&header, entry.dosDate, 2);
+    appendLittleEndian(&header, entry.crc, 4);
+    appendLittleEndian(&header, entry.compressedBytes, 4);
+    appendLittleEndian(&header, entry.uncompressedBytes, 4);
+    appendLittleEndian(&header, static_cast<quint64>(entry.name.size()), 2);
+    appendLittleEndian(&header, 0, 2);
+    header.append(entry.name);
+    return header;
+}
+
+bool writeAll(QFile *out, const QByteArray &bytes, QString *error)
+{
+    if ( out->write(bytes) != bytes.size() )
+    {
+        *error = QStringLiteral("write failed: %1").arg(out->errorString().trimmed());
+        return false;
+    }
+    return true;
+}
+
+// Returns false only on output errors; an unreadable source drops the entry again.
+bool appendZipEntry(
+    QFile *out,
+    const FileArchiveEntry &entry,
+    QFile *file,
+    const QFileInfo &fileInfo,
+    QList<ZipCentralEntry> *centralEntries,
+    FileArchiveSummary *summary,
+    QString *error
+)
+{
+    const qint64 size = file->size();
+    ZipCentralEntry central;
+    central.name = entry.relativePath.toUtf8();
+    central.uncompressedBytes = static_cast<quint32>(size);
+    central.localHeaderOffset = static_cast<quint32>(out->pos());
+    dosDateTime(fileInfo.lastModified(), &central.dosTime, &central.dosDate);
+
+    if ( size <= zipDeflateMaxBytes )
+    {
+        const QByteArray content = file->read(size);
+        if ( content.size() != size )
+        {
+            appendError(
+                summary,
+                entry.relativePath,
+                QStringLiteral("read failed: %1").arg(file->errorString().trimmed())
+            );
+            return true;
+        }
+        central.crc = GzipCodec::crc32(content.constData(), content.size());
+        QByteArray deflated;
+        const bool useDeflate = GzipCodec::deflateRaw(content.constData(), content.size(), zipDeflateLevel, &deflated) &&
+            ( deflated.size() < content.size() );
+        central.method = useDeflate ? 8 : 0;
+        central.compressedBytes = static_cast<quint32>(useDeflate ? deflated.size() : content.size());
+        if ( !writeAll(out, zipLocalHeader(central), error) ||
+             !writeAll(out, useDeflate ? deflated : content, error) )
+        {
+            return false;
+        }
+    }
+    else
+    {
+        // Too big to deflate in memory: stored, streamed, and the CRC patched in after.
+        central.compressedBytes = central.uncompressedBytes;
+        if ( !writeAll(out, zipLocalHeader(central), error) )
+        {
+            return false;
+        }
+        qint64 written = 0;
+        quint32 crc = 0;
+        while ( written < size )
+        {
+            const QByteArray chunk = file->read(qMin(archiveReadChunkBytes, size - written));
+            if ( chunk.isEmpty() )
+            {
+                break;
+            }
+            crc = GzipCodec::crc32(chunk.constData(), chunk.size(), crc);
+            if ( !writeAll(out, chunk, error) )
+            {
+                return false;
+            }
+            written += chunk.size();
+        }
+        if ( written < size )
+        {
+            appendError(
+                summary,
+                entry.relativePath,
+                QStringLiteral("read stopped after %1 of %2 bytes").arg(written).arg(size)
+            );
+            if ( !out->resize(central.localHeaderOffset) || !out->seek(central.localHeaderOffset) )
+            {
+                *error = QStringLiteral("failed to drop partial entry: %1").arg(out->errorString().trimmed());
+                return false;
+            }
+            return true;
+        }
+        central.crc = crc;
+        QByteArray crcBytes;
+        appendLittleEndian(&crcBytes, crc, 4);
+        const qint64 endOffset = out->pos();
+        if ( !out->seek(central.localHeaderOffset + 14) ||
+             !writeAll(out, crcBytes, error) ||
+             !out->seek(endOffset) )
+        {
+            if ( error->isEmpty() )
+            {
+                *error = QStringLiteral("seek failed: %1").arg(out->errorString().trimmed());
+            }
+            return false;
+        }
+    }
+
+    centralEntries->append(central);
+    summary->contentBytes += size;
+    ++summary->fileCount;
+    return true;
+}
+
+bool finishZip(QFile *out, const QList<ZipCentralEntry> &centralEntries, QString *error)
+{
+    const qint64 directoryOffset = out->pos();
+    QByteArray directory;
+    for ( const ZipCentralEntry &entry : centralEntries )
+    {
+        appendLittleEndian(&directory, 0x02014B50, 4);
+        appendLittleEndian(&directory, 20, 2);
+        appendLittleEndian(&directory, 20, 2);
+        appendLittleEndian(&directory, 0x0800, 2);
+        appendLittleEndian(&directory, entry.method, 2);
+        appendLittleEndian(&directory, entry.dosTime, 2);
+        appendLittleEndian(&directory, entry.dosDate, 2);
+        appendLittleEndian(&directory, entry.crc, 4);
+        appendLittleEndian(&directory, entry.compressedBytes, 4);
+        appendLittleEndian(&directory, entry.uncompressedBytes, 4);
+        appendLittleEndian(&directory, static_cast<quint64>(entry.name.size()), 2);
+        // Extra field, comment, disk number, internal and external attributes.
+        appendLittleEndian(&directory, 0, 2);
+        appendLittleEndian(&directory, 0, 2);
+        appendLittleEndian(&directory, 0, 2);
+        appendLittleEndian(&directory, 0, 2);
+        appendLittleEndian(&directory, 0, 4);
+        appendLittleEndian(&directory, entry.localHeaderOffset, 4);
+        directory.append(entry.name);
+    }
+    const qint64 directoryBytes = directory.size();
+    if ( ( directoryOffset + directoryBytes ) > zipMaxOffset )
+    {
+        *error = QStringLiteral("zip archive exceeds 4 GiB");
+        return false;
+    }
+
+    appendLittleEndian(&directory, 0x06054B50, 4);
+    appendLittleEndian(&directory, 0, 2);
+    appendLittleEndian(&directory, 0, 2);
+    appendLittleEndian(&directory, static_cast<quint64>(centralEntries.size()), 2);
+    appendLittleEndian(&directory, static_cast<quint64>(centralEntries.size()), 2);
+    appendLittleEndian(&directory, static_cast<quint64>(directoryBytes), 4);
+    appendLittleEndian(&directory, static_cast<quint64>(directoryOffset), 4);
+    appendLittleEndian(&directory, 0, 2);
+    return writeAll(out, directory, error);
+}
+}
+
+QString FileArchiveWriter::formatName(FileArchiveFormat format)
+{
+    switch ( format )
+    {
+    case FileArchiveFormat::Tar:
+        return QStringLiteral("tar");
+    case FileArchiveFormat::TarGz:
+        return QStringLiteral("tgz");
+    case FileArchiveFormat::Zip:
+        return QStringLiteral("zip");
+    }
+    return QStringLiteral("tar");
+}
+
+bool FileArchiveWriter::write(
+    const QList<FileArchiveEntry> &entries,
+    FileArchiveFormat format,
+    qint64 maxContentBytes,
+    int timeoutMs,
+    QFile *out,
+    FileArchiveSummary *summary,
+    QString *error
+)
+{
+    *summary = FileArchiveSummary();
+    const QDeadlineTimer deadline = ( timeoutMs >= 0 )
+        ? QDeadlineTimer(timeoutMs)
+        : QDeadlineTimer(QDeadlineTimer::Forever);
+    const bool zip = ( format == FileArchiveFormat::Zip );
+    ArchiveSink sink(out, format == FileArchiveFormat::TarGz);
+    QList<ZipCentralEntry> centralEntries;
+
+    for ( const FileArchiveEntry &entry : entries )
+    {
+        if ( deadline.hasExpired() )
+        {
+            summary->timedOut = true;
+            break;
+        }
+
+        const QFileInfo fileInfo(entry.absolutePath);
+        QFile file(entry.absolutePath);
+        if ( !file.open(QIODevice::ReadOnly) )
+        {
+            appendError(
+                summary,
+                entry.relativePath,
+                QStringLiteral("open failed: %1").arg(file.errorString().trimmed())
+            );
+            continue;
+        }
+        const qint64 size = file.size();
+        if ( ( summary->contentBytes + size ) > maxContentBytes )
+        {
+            summary->truncated = true;
+            break;
+        }
+        if ( zip &&
+             ( ( centralEntries.size() >= zipMaxEntries ) ||
+               ( ( out->pos() + size + entry.relativePath.size() * 6 + 1024 ) > zipMaxOffset ) ) )
+        {
+            summary->truncated = true;
+            break;
+        }
+
+        const bool appended = zip
+            ? appendZipEntry(out, entry, &file, fileInfo, &centralEntries, summary, error)
+            : appendTarEntry(&sink, entry, &file, fileInfo, summary, error);
+        if ( !appended )
+        {
+            return false;
+        }
+    }
+
+    if ( zip )
+    {
+        if ( !finishZip(out, centralEntries, error) )
+        {
+            return false;
+        }
+    }
+    else if ( !sink.writeZeros(2 * tarBlockBytes) || !sink.finish() )
+    {
+        *error = sink.error();
+        return false;
+    }
+    if ( !out->flush() )
+    {
+        *error = QStringLiteral("flush failed: %1").arg(out->errorString().trimmed());
+        return false;
+    }
+    summary->archiveBytes = out->size();
+    return true;
+}
@@ -0,0 +1,66 @@
+#ifndef JQOPENCLAW_CAPABILITIES_FILE_FILEARCHIVEWRITER_H_
+#define JQOPENCLAW_CAPABILITIES_FILE_FILEARCHIVEWRITER_H_
+
+// Qt lib import
+#include <QList>
+#include <QString>
+
+class QFile;
+
+enum class FileArchiveFormat
+{
+    Tar,
+    TarGz,
+    Zip,
+};
+
+struct FileArchiveEntry
+{
+    QString absolutePath;
+    // Name inside the archive, '/' separated.
+    QString relativePath;
+};
+
+struct FileArchiveError
+{
+    QString path;
+    QString error;
+};
+
+struct FileArchiveSummary
+{
+    qint64 fileCount = 0;
+    qint64 contentBytes = 0;
+    qint64 archiveBytes = 0;
+    // Stopped before an entry that would have exceeded maxContentBytes.
+    bool truncated = false;
+    bool timedOut = false;
+    // Entries that could not be read. tar entries that fail part way keep their header
+    // and are zero-filled to the announced size; zip entries are dropped.
+    QList<FileArchiveError> errors;
+};
+
+// Writes regular files into a ustar (long names through pax headers), gzip-compressed
+// tar or zip archive. tar.gz output is a series of gzip members of about 1 MiB, so the
+// tar stream never has to be held in memory; zip entries up to 16 MiB are deflated,
+// larger ones stored. zip output stays within the classic (non-zip64) limits, so at most
+// 65535 entries and 4 GiB.
+class FileArchiveWriter
+{
+public:
+    static QString formatName(FileArchiveFormat format);
+
+    // out must be open for writing, empty and seekable. Per-entry problems go to
+    // summary->errors; false only when the archive itself could not be written.
+    static bool write(
+        const QList<FileArchiveEntry> &entries,
+        FileArchiveFormat format,
+        qint64 maxContentBytes,
+        int timeoutMs,
+        QFile *out,
+        FileArchiveSummary *summary,
+        QString *error
+    );
+};
+
+#endif // JQOPENCLAW_CAPABILITIES_FILE_FILEARCHIVEWRITER_H_
@@ -0,0 +1,290 @@
+// .h include
+#include "capabilities/file/filebatchreader.h"
+
+// Qt lib import
+#include <QAtomicInteger>
+#include <QDeadlineTimer>
+#include <QFile>
+#include <QFileInfo>
+#include <QThreadPool>
+
+// JQOpenClaw import
+#include "capabilities/file/filelineindex.h"
+
+// C++ lib import
+#include <vector>
+
+namespace
+{
+// Reads are mostly waiting on the disk, so run more of them than there are cores.
+const int batchReadMaxWorkers = 16;
+// Byte ranges are read in pieces of this size so a slow read still sees the deadline.
+const qint64 batchReadChunkBytes = 1024 * 1024;
+const int batchReadLinesPerDeadlineCheck = 256;
+
+// Budget shared by all items of one readAll. Every item reserves what it is about to
+// read before reading it, so the content held in memory never exceeds the budget no
+// matter how many items run at once.
+class ReadBudget
+{
+public:
+    explicit ReadBudget(qint64 totalBytes):
+        remainingBytes_(totalBytes)
+    { }
+
+    // Reserves up to wantedBytes; returns how much was granted (0 once exhausted).
+    qint64 reserve(qint64 wantedBytes)
+    {
+        qint64 current = remainingBytes_.loadRelaxed();
+        for ( ;; )
+        {
+            const qint64 granted = qMin(current, wantedBytes);
+            if ( granted <= 0 )
+            {
+                return 0;
+            }
+            if ( remainingBytes_.testAndSetOrdered(current, current - granted, current) )
+            {
+                return granted;
+            }
+        }
+    }
+
+    void release(qint64 unusedBytes)
+    {
+        if ( unusedBytes > 0 )
+        {
+            remainingBytes_.fetchAndAddOrdered(unusedBytes);
+        }
+    }
+
+    qint64 remaining() const
+    {
+        return remainingBytes_.loadRelaxed();
+    }
+
+private:
+    QAtomicInteger<qint64> remainingBytes_;
+};
+
+void readByteRange(
+    const FileBatchReadItem &item,
+    ReadBudget *budget,
+    const QDeadlineTimer &deadline,
+    QFile *file,
+    FileBatchReadResult *result
+)
+{
+    if ( item.offsetBytes > result->sizeBytes )
+    {
+        result->error = QStringLiteral("offsetBytes must be integer within [0, %1]").arg(result->sizeBytes);
+        return;
+    }
+    if ( !file->seek(item.offsetBytes) )
+    {
+        result->error = QStringLiteral("seek failed: %1").arg(file->errorString().trimmed());
+        return;
+    }
+
+    const qint64 wantedBytes = qMin(item.maxBytes, result->sizeBytes - item.offsetBytes);
+    const qint64 grantedBytes = budget->reserve(wantedBytes);
+    result->bytes.reserve(static_cast<int>(grantedBytes));
+    while ( result->bytes.size() < grantedBytes )
+    {
+        if ( deadline.hasExpired() )
+        {
+            result->timedOut = true;
+            break;
+        }
+        const QByteArray chunk = file->read(qMin(batchReadChunkBytes, grantedBytes - result->bytes.size()));
+        if ( chunk.isEmpty() )
+        {
+            if ( file->error() != QFileDevice::NoError )
+            {
+                budget->release(grantedBytes);
+                result->bytes.clear();
+                result->error = QStringLiteral("read failed: %1").arg(file->errorString().trimmed());
+                return;
+            }
+            // The file shrank after it was opened.
+            break;
+        }
+        result->bytes.append(chunk);
+    }
+    budget->release(grantedBytes - result->bytes.size());
+    result->eof = ( item.offsetBytes + result->bytes.size() ) >= result->sizeBytes;
+    result->capped = !result->eof && ( result->bytes.size() < item.maxBytes );
+    result->ok = true;
+}
+
+void readLineRange(
+    const FileBatchReadItem &item,
+    ReadBudget *budget,
+    const QDeadlineTimer &deadline,
+    QFile *file,
+    FileBatchReadResult *result
+)
+{
+    qint64 lineAtOffset = 1;
+    QString seekError;
+    if ( !FileLineIndex::seekToLine(file, item.startLine, &lineAtOffset, &seekError) )
+    {
+        result->error = seekError;
+        return;
+    }
+
+    qint64 currentLine = lineAtOffset - 1;
+    qint64 reservedBytes = 0;
+    int linesSinceDeadlineCheck = 0;
+    while ( !file->atEnd() && ( currentLine < item.endLine ) )
+    {
+        if ( ++linesSinceDeadlineCheck >= batchReadLinesPerDeadlineCheck )
+        {
+            linesSinceDeadlineCheck = 0;
+            if ( deadline.hasExpired() )
+            {
+                result->timedOut = true;
+                break;
+            }
+        }
+
+        if ( ( currentLine + 1 ) < item.startLine )
+        {
+            // Lines before the range are skipped in bounded pieces, however long they are.
+            QByteArray piece;
+            do
+            {
+                piece = file->readLine(batchReadChunkBytes);
+            }
+            while ( !piece.isEmpty() && !piece.endsWith('\n') );
+            if ( piece.isNull() && ( file->error() != QFileDevice::NoError ) )
+            {
+                result->error = QStringLiteral("read failed: %1").arg(file->errorString().trimmed());
+                return;
+            }
+            ++currentLine;
+            continue;
+        }
+
+        const qint64 remainingBytes = budget->remaining();
+        if ( remainingBytes <= 0 )
+        {
+            result->capped = true;
+            break;
+        }
+        // A line longer than what is left of the budget cannot be returned anyway, so
+        // never pull more than that into memory; the +2 leaves room for "\r\n".
+        QByteArray rawLine = file->readLine(remainingBytes + 3);
+        if ( rawLine.isNull() )
+        {
+            budget->release(reservedBytes);
+            result->lines.clear();
+            result->error = QStringLiteral("read failed: %1").arg(file->errorString().trimmed());
+            return;
+        }
+        if ( rawLine.isEmpty() && file->atEnd() )
+        {
+            break;
+        }
+        if ( !rawLine.endsWith('\n') && !file->atEnd() )
+        {
+            result->capped = true;
+            break;
+        }
+
+        ++currentLine;
+        while ( rawLine.endsWith('\n') || rawLine.endsWith('\r') )
+        {
+            rawLine.chop(1);
+        }
+        // Joined with '\n' later, so each line costs one byte more than its text.
+        const qint64 lineCost = rawLine.size() + 1;
+        const qint64 grantedBytes = budget->reserve(lineCost);
+        if ( grantedBytes < lineCost )
+        {
+            budget->release(grantedBytes);
+            result->capped = true;
+            break;
+        }
+        reservedBytes += lineCost;
+        result->lines.append(rawLine);
+    }
+    result->eof = file->atEnd();
+    result->ok = true;
+}
+
+void readItem(
+    const FileBatchReadItem &item,
+    ReadBudget *budget,
+    const QDeadlineTimer &deadline,
+    FileBatchReadResult *result
+)
+{
+    const QFileInfo fileInfo(item.path);
+    result->path = fileInfo.exists() ? fileInfo.absoluteFilePath() : item.path;
+    if ( !fileInfo.exists() )
+    {
+        result->error = QStringLiteral("target does not exist");
+        return;
+    }
+    if ( !fileInfo.isFile() )
+    {
+        result->error = QStringLiteral("target is not a file");
+        return;
+    }
+
+    QFile file(fileInfo.absoluteFilePath());
+    if ( !file.open(QIODevice::ReadOnly) )
+    {
+        result->error = QStringLiteral("open failed: %1").arg(file.errorString().trimmed());
+        return;
+    }
+    result->sizeBytes = file.size();
+
+    if ( item.lineMode )
+    {
+        readLineRange(item, budget, deadline, &file, result);
+    }
+    else
+    {
+        readByteRange(item, budget, deadline, &file, result);
+    }
+}
+}
+
+QList<FileBatchReadResult> FileBatchReader::readAll(
+    const QList<FileBatchReadItem> &items,
+    qint64 capBytes,
+    int timeoutMs
+)
+{
+    const QDeadlineTimer deadline = ( timeoutMs >= 0 )
+        ? QDeadlineTimer(timeoutMs)
+        : QDeadlineTimer(QDeadlineTimer::Forever);
+
+    ReadBudget budget(capBytes);
+    std::vector<FileBatchReadResult> results(static_cast<size_t>(items.size()));
+    {
+        QThreadPool pool;
+        pool.setMaxThreadCount(qBound(1, static_cast<int>(items.size()), batchReadMaxWorkers));
+        for ( int index = 0; index < items.size(); ++index )
+        {
+            pool.start(
+                [&items, &results, &budget, &deadline, index]()
+                {
+                    FileBatchReadResult &result = results[static_cast<size_t>(index)];
+                    if ( deadline.hasExpired() )
+                    {
+                        result.path = items.at(index).path;
+                        result.error = QStringLiteral("timed out before reading");
+                        return;
+                    }
+                    readItem(items.at(index), &budget, deadline, &result);
+                }
+            );
+        }
+        pool.waitForDone();
+    }
+
+    return QList<FileBatchReadResult>(results.begin(), results.end());
+}
@@ -0,0 +1,56 @@
+#ifndef JQOPENCLAW_CAPABILITIES_FILE_FILEBATCHREADER_H_
+#define JQOPENCLAW_CAPABILITIES_FILE_FILEBATCHREADER_H_
+
+// Qt lib import
+#include <QByteArray>
+#include <QList>
+#include <QString>
+
+struct FileBatchReadItem
+{
+    QString path;
+    // Line mode reads [startLine, endLine] (1-based, inclusive); byte mode reads up to
+    // maxBytes from offsetBytes.
+    bool lineMode = false;
+    qint64 offsetBytes = 0;
+    qint64 maxBytes = 0;
+    qint64 startLine = 0;
+    qint64 endLine = 0;
+};
+
+struct FileBatchReadResult
+{
+    bool ok = false;
+    QString error;
+    QString path;
+    qint64 sizeBytes = 0;
+    // Byte mode content.
+    QByteArray bytes;
+    // Line mode content, without line terminators.
+    QList<QByteArray> lines;
+    bool eof = false;
+    // Stopped at the shared byte budget before the requested range was complete.
+    bool capped = false;
+    // Stopped at the deadline; what was read so far is kept.
+    bool timedOut = false;
+};
+
+// Reads many small ranges concurrently. Every item runs on its own pool task, so the
+// slow part (cold opens and first reads) overlaps instead of queueing behind the
+// previous item.
+class FileBatchReader
+{
+public:
+    // capBytes is shared by all items: each reserves from it before reading, so content
+    // held at once never exceeds it, and which items get the last of it depends on
+    // which reads finish first. Results keep the order of items. Items not started
+    // before timeoutMs (< 0: no limit) fail with a timeout error; items running at that
+    // point stop with timedOut set.
+    static QList<FileBatchReadResult> readAll(
+        const QList<FileBatchReadItem> &items,
+        qint64 capBytes,
+        int timeoutMs
+    );
+};
+
+#endif // JQOPENCLAW_CAPABILITIES_FILE_FILEBATCHREADER_H_
@@ -0,0 +1,596 @@
+// .h include
+#include "capabilities/file/filecopyengine.h"
+
+// Qt lib import
+#include <QAtomicInteger>
+#include <QDeadlineTimer>
+#include <QDebug>
+#include <QDir>
+#include <QDirIterator>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QFileInfo>
+#include <QMutex>
+#include <QMutexLocker>
+#include <QPair>
+#include <QSemaphore>
+#include <QThreadPool>
+#include <QtGlobal>
+
+// C++ lib import
+#include <vector>
+
+#if defined(Q_OS_LINUX)
+#include <errno.h>
+#include <fcntl.h>
+#include <linux/fs.h>
+#include <string.h>
+#include <sys/ioctl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#elif defined(Q_OS_WIN)
+#include <windows.h>
+#elif defined(Q_OS_UNIX)
+#include <errno.h>
+#include <fcntl.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace
+{
+// Copies mostly wait on the disk; a few more workers than cores keep the queue deep.
+const int copyMaxWorkers = 8;
+// Files handed to the pool but not yet picked up; bounds memory on huge trees.
+const int copyQueueDepth = 256;
+const int copyProgressIntervalMs = 5000;
+#if defined(Q_OS_LINUX)
+const size_t copyBufferBytes = 1024 * 1024;
+// copy_file_range moves at most this much per call, so the deadline is checked at
+// least this often.
+const size_t copyKernelChunkBytes = 64 * 1024 * 1024;
+#endif
+
+QString timedOutError(qint64 copiedBytes)
+{
+    return QStringLiteral("timed out after %1 bytes").arg(copiedBytes);
+}
+
+#if defined(Q_OS_UNIX)
+QString errnoString(int errorNumber)
+{
+    return QString::fromLocal8Bit(strerror(errorNumber));
+}
+
+bool copySymlink(const QString &sourcePath, const QString &destinationPath, QString *error)
+{
+    const QByteArray encodedSource = QFile::encodeName(sourcePath);
+    std::vector<char> target(4096);
+    for ( ;; )
+    {
+        const ssize_t length = ::readlink(encodedSource.constData(), target.data(), target.size());
+        if ( length < 0 )
+        {
+            *error = QStringLiteral("readlink failed: %1").arg(errnoString(errno));
+            return false;
+        }
+        if ( static_cast<size_t>(length) < target.size() )
+        {
+            target[static_cast<size_t>(length)] = '\0';
+            break;
+        }
+        target.resize(target.size() * 2);
+    }
+    if ( ::symlink(target.data(), QFile::encodeName(destinationPath).constData()) != 0 )
+    {
+        *error = QStringLiteral("symlink failed: %1").arg(errnoString(errno));
+        return false;
+    }
+    return true;
+}
+
+void copyDirectoryMetadata(const QString &sourcePath, const QString &destinationPath)
+{
+    struct stat sourceInfo;
+    if ( ::stat(QFile::encodeName(sourcePath).constData(), &sourceInfo) != 0 )
+    {
+        return;
+    }
+    const QByteArray encodedDestination = QFile::encodeName(destinationPath);
+    ::chmod(encodedDestination.constData(), sourceInfo.st_mode & 07777);
+#if defined(Q_OS_LINUX)
+    const struct timespec times[2] = { sourceInfo.st_atim, sourceInfo.st_mtim };
+#elif defined(Q_OS_DARWIN)
+    const struct timespec times[2] = { sourceInfo.st_atimespec, sourceInfo.st_mtimespec };
+#else
+    struct timespec times[2];
+    times[0].tv_sec = sourceInfo.st_atime;
+    times[0].tv_nsec = 0;
+    times[1].tv_sec = sourceInfo.st_mtime;
+    times[1].tv_nsec = 0;
+#endif
+    ::utimensat(AT_FDCWD, encodedDestination.constData(), times, 0);
+}
+#endif
+
+#if defined(Q_OS_LINUX)
+// Kernel copy could not be used at all for this pair of files (cross-filesystem on old
+// kernels, special files, unsupported filesystems): fall back to buffered copying.
+bool isKernelCopyUnsupported(int errorNumber)
+{
+    return ( errorNumber == EXDEV ) || ( errorNumber == ENOSYS ) || ( errorNumber == EOPNOTSUPP ) ||
+        ( errorNumber == EINVAL ) || ( errorNumber == EBADF ) || ( errorNumber == EPERM );
+}
+
+bool copyBuffered(
+    int sourceFd,
+    int destinationFd,
+    const QDeadlineTimer &deadline,
+    qint64 *copiedBytes,
+    QString *error
+)
+{
+    thread_local std::vector<char> buffer(copyBufferBytes);
+    for ( ;; )
+    {
+        if ( deadline.hasExpired() )
+        {
+            *error = timedOutError(*copiedBytes);
+            return false;
+        }
+        const ssize_t readBytes = ::read(sourceFd, buffer.data(), buffer.size());
+        if ( readBytes < 0 )
+        {
+            if ( errno == EINTR )
+            {
+                continue;
+            }
+            *error = QStringLiteral("read failed: %1").arg(errnoString(errno));
+            return false;
+        }
+        if ( readBytes == 0 )
+        {
+            return true;
+        }
+        for ( ssize_t offset = 0; offset < readBytes; )
+        {
+            const ssize_t writtenBytes = ::write(destinationFd, buffer.data() + offset, readBytes - offset);
+            if ( writtenBytes < 0 )
+            {
+                if ( errno == EINTR )
+                {
+                    continue;
+                }
+                *error = QStringLiteral("write failed: %1").arg(errnoString(errno));
+                return false;
+            }
+            offset += writtenBytes;
+        }
+        *copiedBytes += readBytes;
+    }
+}
+
+bool copyFileLinux(
+    const QString &sourcePath,
+    const QString &destinationPath,
+    bool preserveMetadata,
+    const QDeadlineTimer &deadline,
+    FileCopyMethod *method,
+    qint64 *copiedBytes,
+    QString *error
+)
+{
+    const int sourceFd = ::open(QFile::encodeName(sourcePath).constData(), O_RDONLY | O_CLOEXEC);
+    if ( sourceFd < 0 )
+    {
+        *error = QStringLiteral("open source failed: %1").arg(errnoString(errno));
+        return false;
+    }
+    struct stat sourceInfo;
+    if ( ::fstat(sourceFd, &sourceInfo) != 0 )
+    {
+        *error = QStringLiteral("stat source failed: %1").arg(errnoString(errno));
+        ::close(sourceFd);
+        return false;
+    }
+
+    const QByteArray encodedDestination = QFile::encodeName(destinationPath);
+    const int destinationFd = ::open(
+        encodedDestination.constData(),
+        O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC,
+        ( sourceInfo.st_mode & 0777 ) | S_IWUSR
+    );
+    if ( destinationFd < 0 )
+    {
+        *error = QStringLiteral("open destination failed: %1").arg(errnoString(errno));
+        ::close(sourceFd);
+        return false;
+    }
+
+    bool ok = true;
+    *copiedBytes = 0;
+    if ( ::ioctl(destinationFd, FICLONE, sourceFd) == 0 )
+    {
+        *method = FileCopyMethod::Clone;
+        *copiedBytes = static_cast<qint64>(sourceInfo.st_size);
+    }
+    else
+    {
+        *method = FileCopyMethod::Kernel;
+        for ( ;; )
+        {
+            if ( deadline.hasExpired() )
+            {
+                *error = timedOutError(*copiedBytes);
+                ok = false;
+                break;
+            }
+            const ssize_t chunkBytes = ::copy_file_range(
+                sourceFd,
+                nullptr,
+                destinationFd,
+                nullptr,
+                copyKernelChunkBytes,
+                0
+            );
+            if ( chunkBytes < 0 )
+            {
+                if ( errno == EINTR )
+                {
+                    continue;
+                }
+                if ( ( *copiedBytes == 0 ) && isKernelCopyUnsupported(errno) )
+                {
+                    *method = FileCopyMethod::Buffered;
+                    break;
+                }
+                *error = QStringLiteral("copy_file_range failed: %1").arg(errnoString(errno));
+                ok = false;
+                break;
+            }
+            if ( chunkBytes == 0 )
+            {
+                // On procfs / sysfs copy_file_range can report end of file straight
+                // away although read() returns data; an empty file costs one read().
+                if ( *copiedBytes == 0 )
+                {
+                    *method = FileCopyMethod::Buffered;
+                }
+                break;
+            }
+            *copiedBytes += chunkBytes;
+        }
+        if ( ok && ( *method == FileCopyMethod::Buffered ) )
+        {
+            ok = copyBuffered(sourceFd, destinationFd, deadline, copiedBytes, error);
+        }
+    }
+
+    if ( ok && preserveMetadata )
+    {
+        ::fchmod(destinationFd, sourceInfo.st_mode & 07777);
+        const struct timespec times[2] = { sourceInfo.st_atim, sourceInfo.st_mtim };
+        ::futimens(destinationFd, times);
+    }
+    ::close(sourceFd);
+    if ( ( ::close(destinationFd) != 0 ) && ok )
+    {
+        *error = QStringLiteral("close destination failed: %1").arg(errnoString(errno));
+        ok = false;
+    }
+    if ( !ok )
+    {
+        ::unlink(encodedDestination.constData());
+    }
+    return ok;
+}
+#endif
+
+struct CopyTreeState
+{
+    QDeadlineTimer deadline;
+    bool preserveMetadata = true;
+    QAtomicInteger<qint64> fileCount;
+    QAtomicInteger<qint64> copiedBytes;
+    QAtomicInteger<qint64> clonedFileCount;
+    QAtomicInteger<qint64> kernelFileCount;
+    QAtomicInteger<qint64> bufferedFileCount;
+    QAtomicInteger<int> timedOut;
+    QMutex errorMutex;
+    QList<FileCopyError> errors;
+};
+
+void appendError(CopyTreeState *state, const QString &path, const QString &error)
+{
+    FileCopyError entry;
+    entry.path = path;
+    entry.error = error;
+    QMutexLocker locker(&state->errorMutex);
+    state->errors.append(entry);
+}
+
+void copyTreeFile(CopyTreeState *state, const QString &sourcePath, const QString &destinationPath)
+{
+    if ( state->deadline.hasExpired() )
+    {
+        state->timedOut.storeRelaxed(1);
+        return;
+    }
+
+    FileCopyMethod method = FileCopyMethod::Buffered;
+    qint64 copiedBytes = 0;
+    QString copyError;
+    if ( !FileCopyEngine::copyFile(
+            sourcePath,
+            destinationPath,
+            state->preserveMetadata,
+            static_cast<int>(state->deadline.remainingTime()),
+            &method,
+            &copiedBytes,
+            &copyError
+        ) )
+    {
+        if ( state->deadline.hasExpired() )
+        {
+            state->timedOut.storeRelaxed(1);
+        }
+        appendError(state, sourcePath, copyError);
+        return;
+    }
+
+    state->fileCount.fetchAndAddRelaxed(1);
+    state->copiedBytes.fetchAndAddRelaxed(copiedBytes);
+    switch ( method )
+    {
+    case FileCopyMethod::Clone:
+        state->clonedFileCount.fetchAndAddRelaxed(1);
+        break;
+    case FileCopyMethod::Kernel:
+        state->kernelFileCount.fetchAndAddRelaxed(1);
+        break;
+    case FileCopyMethod::Buffered:
+        state->bufferedFileCount.fetchAndAddRelaxed(1);
+        break;
+    }
+}
+
+void logProgress(const QString &sourcePath, CopyTreeState &state)
+{
+    QMutexLocker locker(&state.errorMutex);
+    qInfo().noquote() << QStringLiteral(
+        "[capability.file.write] copy progress from=%1 files=%2 bytes=%3 errors=%4"
+    ).arg(
+        sourcePath,
+        QString::number(state.fileCount.loadRelaxed()),
+        QString::number(state.copiedBytes.loadRelaxed()),
+        QString::number(state.errors.size())
+    );
+}
+}
+
+bool FileCopyEngine::copyFile(
+    const QString &sourcePath,
+    const QString &destinationPath,
+    bool preserveMetadata,
+    int timeoutMs,
+    FileCopyMethod *method,
+    qint64 *copiedBytes,
+    QString *error
+)
+{
+    const QDeadlineTimer deadline = ( timeoutMs >= 0 )
+        ? QDeadlineTimer(timeoutMs)
+        : QDeadlineTimer(QDeadlineTimer::Forever);
+#if defined(Q_OS_LINUX)
+    return copyFileLinux(sourcePath, destinationPath, preserveMetadata, deadline, method, copiedBytes, error);
+#elif defined(Q_OS_WIN)
+    // CopyFileExW copies data, attributes and timestamps inside the system (server-side on
+    // SMB, block clone on ReFS / Dev Drive) and overwrites an existing destination. The
+    // progress routine runs after every chunk and cancels once the deadline has passed;
+    // the partial destination is then deleted by the system.
+    Q_UNUSED(preserveMetadata)
+    const LPPROGRESS_ROUTINE progressRoutine = [](
+        LARGE_INTEGER,
+        LARGE_INTEGER,
+        LARGE_INTEGER,
+        LARGE_INTEGER,
+        DWORD,
+        DWORD,
+        HANDLE,
+        HANDLE,
+        LPVOID data
+    ) -> DWORD
+    {
+        return static_cast<const QDeadlineTimer *>(data)->hasExpired() ? PROGRESS_CANCEL : PROGRESS_CONTINUE;
+    };
+    if ( !CopyFileExW(
+            reinterpret_cast<const wchar_t *>(QDir::toNativeSeparators(sourcePath).utf16()),
+            reinterpret_cast<const wchar_t *>(QDir::toNativeSeparators(destinationPath).utf16()),
+            progressRoutine,
+            const_cast<QDeadlineTimer *>(&deadline),
+            nullptr,
+            0
+        ) )
+    {
+        const DWORD errorCode = GetLastError();
+        *error = ( errorCode == ERROR_REQUEST_ABORTED )
+            ? QStringLiteral("timed out")
+            : QStringLiteral("CopyFileExW failed: windows error %1").arg(errorCode);
+        return false;
+    }
+    *method = FileCopyMethod::Kernel;
+    *copiedBytes = QFileInfo(destinationPath).size();
+    return true;
+#else
+    // QFile::copy clones where the filesystem supports it and keeps permissions. It cannot
+    // be interrupted, so the deadline only applies before it starts.
+    if ( deadline.hasExpired() )
+    {
+        *error = timedOutError(0);
+        return false;
+    }
+    if ( QFileInfo::exists(destinationPath) && !QFile::remove(destinationPath) )
+    {
+        *error = QStringLiteral("failed to replace destination");
+        return false;
+    }
+    QFile sourceFile(sourcePath);
+    if ( !sourceFile.copy(destinationPath) )
+    {
+        *error = QStringLiteral("copy failed: %1").arg(sourceFile.errorString().trimmed());
+        return false;
+    }
+    if ( preserveMetadata )
+    {
+        QFile destinationFile(destinationPath);
+        if ( destinationFile.open(QIODevice::Append) )
+        {
+            destinationFile.setFileTime(
+                QFileInfo(sourcePath).lastModified(),
+                QFileDevice::FileModificationTime
+            );
+        }
+    }
+    *method = FileCopyMethod::Buffered;
+    *copiedBytes = QFileInfo(destinationPath).size();
+    return true;
+#endif
+}
+
+bool FileCopyEngine::copyTree(
+    const QString &sourcePath,
+    const QString &destinationPath,
+    const FileCopyOptions &options,
+    FileCopySummary *summary,
+    QString *error
+)
+{
+    *summary = FileCopySummary();
+    if ( !QDir().mkpath(destinationPath) )
+    {
+        *error = QStringLiteral("failed to create destination directory");
+        return false;
+    }
+
+    CopyTreeState state;
+    state.deadline = ( options.timeoutMs >= 0 )
+        ? QDeadlineTimer(options.timeoutMs)
+        : QDeadlineTimer(QDeadlineTimer::Forever);
+    state.preserveMetadata = options.preserveMetadata;
+
+    QThreadPool pool;
+    pool.setMaxThreadCount(copyMaxWorkers);
+    summary->workerCount = copyMaxWorkers;
+    QSemaphore queueSlots(copyQueueDepth);
+    QElapsedTimer progressTimer;
+    progressTimer.start();
+
+    // Directories are created here, in walk order, before any file inside them is queued.
+    QList<QPair<QString, QString>> createdDirectories;
+    createdDirectories.append(qMakePair(sourcePath, destinationPath));
+    QList<QPair<QString, QString>> pendingDirectories = createdDirectories;
+    while ( !pendingDirectories.isEmpty() && !state.timedOut.loadRelaxed() )
+    {
+        const QPair<QString, QString> directory = pendingDirectories.takeLast();
+        QDirIterator iterator(
+            directory.first,
+            QDir::AllEntries | QDir::NoDotAndDotDot | QDir::Hidden | QDir::System
+        );
+        while ( iterator.hasNext() )
+        {
+            if ( state.deadline.hasExpired() )
+            {
+                state.timedOut.storeRelaxed(1);
+                break;
+            }
+            if ( progressTimer.elapsed() >= copyProgressIntervalMs )
+            {
+                logProgress(sourcePath, state);
+                progressTimer.restart();
+            }
+
+            iterator.next();
+            const QFileInfo entryInfo = iterator.fileInfo();
+            const QString sourceEntryPath = entryInfo.absoluteFilePath();
+            const QString destinationEntryPath = directory.second + QLatin1Char('/') + entryInfo.fileName();
+
+            if ( entryInfo.isSymLink() )
+            {
+#if defined(Q_OS_UNIX)
+                QString linkError;
+                if ( copySymlink(sourceEntryPath, destinationEntryPath, &linkError) )
+                {
+                    ++summary->symlinkCount;
+                }
+                else
+                {
+                    appendError(&state, sourceEntryPath, linkError);
+                }
+                continue;
+#else
+                // Links to directories are not followed; links to files are copied as the
+                // file they point at, as CopyFileExW does.
+                if ( entryInfo.isDir() )
+                {
+                    ++summary->skippedCount;
+                    continue;
+                }
+#endif
+            }
+
+            if ( entryInfo.isDir() )
+            {
+                if ( !QDir().mkdir(destinationEntryPath) )
+                {
+                    appendError(&state, sourceEntryPath, QStringLiteral("failed to create directory"));
+                    continue;
+                }
+                ++summary->directoryCount;
+                const QPair<QString, QString> child = qMakePair(sourceEntryPath, destinationEntryPath);
+                createdDirectories.append(child);
+                pendingDirectories.append(child);
+                continue;
+            }
+            if ( !entryInfo.isFile() )
+            {
+                ++summary->skippedCount;
+                continue;
+            }
+
+            queueSlots.acquire();
+            pool.start(
+                [&state, &queueSlots, sourceEntryPath, destinationEntryPath]()
+                {
+                    copyTreeFile(&state, sourceEntryPath, destinationEntryPath);
+                    queueSlots.release();
+                }
+            );
+        }
+    }
+
+    while ( !pool.waitForDone(copyProgressIntervalMs) )
+    {
+        logProgress(sourcePath, state);
+    }
+
+#if defined(Q_OS_UNIX)
+    // Last, and children first, so creating entries does not bump the copied times again.
+    if ( options.preserveMetadata )
+    {
+        for ( int index = createdDirectories.size() - 1; index >= 0; --index )
+        {
+            copyDirectoryMetadata(createdDirectories.at(index).first, createdDirectories.at(index).second);
+        }
+    }
+#endif
+
+    summary->fileCount = state.fileCount.loadRelaxed();
+    summary->copiedBytes = state.copiedBytes.loadRelaxed();
+    summary->clonedFileCount = state.clonedFileCount.loadRelaxed();
+    summary->kernelFileCount = state.kernelFileCount.loadRelaxed();
+    summary->bufferedFileCount = state.bufferedFileCount.loadRelaxed();
+    summary->timedOut = state.timedOut.loadRelaxed() != 0;
+    summary->errors = state.errors;
+    return true;
+}
@@ -0,0 +1,80 @@
+#ifndef JQOPENCLAW_CAPABILITIES_FILE_FILECOPYENGINE_H_
+#define JQOPENCLAW_CAPABILITIES_FILE_FILECOPYENGINE_H_
+
+// Qt lib import
+#include <QList>
+#include <QString>
+
+enum class FileCopyMethod
+{
+    // Reflink (FICLONE): the copy shares extents with the source until either changes.
+    Clone,
+    // Copied inside the kernel / filesystem (copy_file_range, CopyFileExW).
+    Kernel,
+    // read/write through a userspace buffer.
+    Buffered,
+};
+
+struct FileCopyOptions
+{
+    // Permissions and access/modification times; on Windows CopyFileExW always carries
+    // attributes and timestamps.
+    bool preserveMetadata = true;
+    int timeoutMs = -1;
+};
+
+struct FileCopyError
+{
+    QString path;
+    QString error;
+};
+
+struct FileCopySummary
+{
+    qint64 fileCount = 0;
+    qint64 directoryCount = 0;
+    qint64 symlinkCount = 0;
+    // Sockets, devices and the like, which are not copied.
+    qint64 skippedCount = 0;
+    qint64 copiedBytes = 0;
+    qint64 clonedFileCount = 0;
+    qint64 kernelFileCount = 0;
+    qint64 bufferedFileCount = 0;
+    bool timedOut = false;
+    int workerCount = 0;
+    QList<FileCopyError> errors;
+};
+
+// File and directory copies that stay out of userspace where the platform allows:
+// reflink, then copy_file_range on Linux, CopyFileExW on Windows, QFile::copy elsewhere.
+// Trees are walked on the calling thread, which creates the directories and feeds files
+// through a bounded queue to a pool of copy workers. Symlinks are recreated as links on
+// Unix and never followed.
+class FileCopyEngine
+{
+public:
+    // destinationPath is created or truncated. The deadline is checked between chunks
+    // (timeoutMs < 0: no limit); a copy that runs out of time is removed again.
+    static bool copyFile(
+        const QString &sourcePath,
+        const QString &destinationPath,
+        bool preserveMetadata,
+        int timeoutMs,
+        FileCopyMethod *method,
+        qint64 *copiedBytes,
+        QString *error
+    );
+
+    // destinationPath must not exist yet or be an empty directory. Per-entry failures go
+    // to summary->errors and do not stop the copy; false only when the destination root
+    // cannot be created.
+    static bool copyTree(
+        const QString &sourcePath,
+        const QString &destinationPath,
+        const FileCopyOptions &options,
+        FileCopySummary *summary,
+        QString *error
+    );
+};
+
+#endif // JQOPENCLAW_CAPABILITIES_FILE_FILECOPYENGINE_H_
@@ -0,0 +1,497 @@
+// .h include
+#include "capabilities/file/filedeltaengine.h"
+
+// Qt lib import
+#include <QDeadlineTimer>
+#include <QFile>
+#include <QHash>
+
+// JQOpenClaw import
+#include "crypto/digest/xxh3digest.h"
+
+// C++ lib import
+#include <vector>
+
+#if defined(Q_PROCESSOR_X86)
+#define JQOPENCLAW_DELTA_X86
+#include <immintrin.h>
+#if defined(_MSC_VER) && !defined(__clang__)
+#include <intrin.h>
+#define JQOPENCLAW_DELTA_TARGET_SSSE3
+#define JQOPENCLAW_DELTA_TARGET_AVX2
+#else
+#define JQOPENCLAW_DELTA_TARGET_SSSE3 __attribute__((target("ssse3")))
+#define JQOPENCLAW_DELTA_TARGET_AVX2 __attribute__((target("avx2")))
+#endif
+#elif defined(Q_PROCESSOR_ARM_64)
+#define JQOPENCLAW_DELTA_NEON
+#include <arm_neon.h>
+#endif
+
+namespace
+{
+// Bytes of progress (slid or matched) between deadline checks.
+const qint64 deltaDeadlineCheckInterval = 64 * 1024;
+// The whole file is held in memory, as the reply carries its XXH3 and XXH3 is one-shot.
+const qint64 deltaMaxFileBytes = 512 * 1024 * 1024;
+const qint64 deltaReadChunkBytes = 1024 * 1024;
+// Blocks sharing one weak checksum that are compared at a single position. Repetitive
+// input puts many identical blocks behind one checksum; any of them is a valid match,
+// so looking further only costs time.
+const int deltaMaxCandidatesPerPosition = 16;
+
+// Adds a run of bytes to the running (s1, s2) pair and returns how many bytes it took;
+// the scalar loop finishes whatever a vector kernel leaves over. Both kernels rely on
+// s2 growing by s1 after every byte, so for a chunk of n bytes following a prefix with
+// byte sum s1: s2 += n * s1 + sum((n - i) * x[i]).
+using BlockSumsFunction = qint64 (*)(const quint8 *data, qint64 size, quint32 *s1, quint32 *s2);
+
+struct DeltaKernels
+{
+    const char *name;
+    BlockSumsFunction blockSums;
+};
+
+qint64 blockSumsScalar(const quint8 *, qint64, quint32 *, quint32 *)
+{
+    return 0;
+}
+
+void finishBlockSums(const quint8 *data, qint64 size, quint32 *s1, quint32 *s2)
+{
+    quint32 a = *s1;
+    quint32 b = *s2;
+    for ( qint64 index = 0; index < size; ++index )
+    {
+        a += data[index];
+        b += a;
+    }
+    *s1 = a;
+    *s2 = b;
+}
+
+#ifdef JQOPENCLAW_DELTA_X86
+// Per 16-byte chunk: psadbw gives the byte sum, pmaddubsw with weights 16..1 gives the
+// in-chunk weighted sum, and the running total of earlier chunk sums (times 16) supplies
+// the n * s1 term. All lanes wrap mod 2^32, which is all the checksum keeps.
+JQOPENCLAW_DELTA_TARGET_SSSE3
+qint64 blockSumsSsse3(const quint8 *data, qint64 size, quint32 *s1, quint32 *s2)
+{
+    const qint64 chunks = size / 16;
+    if ( chunks == 0 )
+    {
+        return 0;
+    }
+
+    const __m128i weights = _mm_setr_epi8(16, 15, 14, 13, 12, 11, 10, 9, 8, 7, 6, 5, 4, 3, 2, 1);
+    const __m128i ones = _mm_set1_epi16(1);
+    const __m128i zero = _mm_setzero_si128();
+    __m128i sums = zero;
+    __m128i prefix = zero;
+    __m128i weighted = zero;
+    for ( qint64 chunk = 0; chunk < chunks; ++chunk )
+    {
+        const __m128i bytes = _mm_loadu_si128(reinterpret_cast<const __m128i *>(data + ( chunk * 16 )));
+        prefix = _mm_add_epi32(prefix, sums);
+        sums = _mm_add_epi32(sums, _mm_sad_epu8(bytes, zero));
+        weighted = _mm_add_epi32(weighted, _mm_madd_epi16(_mm_maddubs_epi16(bytes, weights), ones));
+    }
+
+    quint32 lanes[3][4];
+    _mm_storeu_si128(reinterpret_cast<__m128i *>(lanes[0]), sums);
+    _mm_storeu_si128(reinterpret_cast<__m128i *>(lanes[1]), prefix);
+    _mm_storeu_si128(reinterpret_cast<__m128i *>(lanes[2]), weighted);
+    quint32 totals[3] = {};
+    for ( int vector = 0; vector < 3; ++vector )
+    {
+        for ( int lane = 0; lane < 4; ++lane )
+        {
+            totals[vector] += lanes[vector][lane];
+        }
+    }
+
+    *s2 += ( static_cast<quint32>(chunks) * 16U * *s1 ) + ( 16U * totals[1] ) + totals[2];
+    *s1 += totals[0];
+    return chunks * 16;
+}
+
+JQOPENCLAW_DELTA_TARGET_AVX2
+qint64 blockSumsAvx2(const quint8 *data, qint64 size, quint32 *s1, quint32 *s2)
+{
+    const qint64 chunks = size / 32;
+    if ( chunks == 0 )
+    {
+        return 0;
+    }
+
+    const __m256i weights = _mm256_setr_epi8(
+        32, 31, 30, 29, 28, 27, 26, 25, 24, 23, 22, 21, 20, 19, 18, 17,
+        16, 15, 14, 13, 12, 11, 10, 9, 8, 7, 6, 5, 4, 3, 2, 1
+    );
+    const __m256i ones = _mm256_set1_epi16(1);
+    const __m256i zero = _mm256_setzero_si256();
+    __m256i sums = zero;
+    __m256i prefix = zero;
+    __m256i weighted = zero;
+    for ( qint64 chunk = 0; chunk < chunks; ++chunk )
+    {
+        const __m256i bytes = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(data + ( chunk * 32 )));
+        prefix = _mm256_add_epi32(prefix, sums);
+        sums = _mm256_add_epi32(sums, _mm256_sad_epu8(bytes, zero));
+        weighted = _mm256_add_epi32(weighted, _mm256_madd_epi16(_mm256_maddubs_epi16(bytes, weights), ones));
+    }
+
+    quint32 lanes[3][8];
+    _mm256_storeu_si256(reinterpret_cast<__m256i *>(lanes[0]), sums);
+    _mm256_storeu_si256(reinterpret_cast<__m256i *>(lanes[1]), prefix);
+    _mm256_storeu_si256(reinterpret_cast<__m256i *>(lanes[2]), weighted);
+    quint32 totals[3] = {};
+    for ( int vector = 0; vector < 3; ++vector )
+    {
+        for ( int lane = 0; lane < 8; ++lane )
+        {
+            totals[vector] += lanes[vector][lane];
+        }
+    }
+
+    *s2 += ( static_cast<quint32>(chunks) * 32U * *s1 ) + ( 32U * totals[1] ) + totals[2];
+    *s1 += totals[0];
+    return chunks * 32;
+}
+
+struct X86Features
+{
+    bool ssse3 = false;
+    bool avx2 = false;
+};
+
+X86Features detectX86Features()
+{
+    X86Features features;
+#if defined(_MSC_VER) && !defined(__clang__)
+    int info[4] = {};
+    __cpuid(info, 0);
+    const int maxLeaf = info[0];
+    __cpuid(info, 1);
+    features.ssse3 = ( info[2] & ( 1 << 9 ) ) != 0;
+    const bool osSavesYmm = ( ( info[2] & ( 1 << 27 ) ) != 0 ) &&
+        ( ( info[2] & ( 1 << 28 ) ) != 0 ) &&
+        ( ( _xgetbv(0) & 0x6 ) == 0x6 );
+    if ( osSavesYmm && ( maxLeaf >= 7 ) )
+    {
+        __cpuidex(info, 7, 0);
+        features.avx2 = ( info[1] & ( 1 << 5 ) ) != 0;
+    }
+#else
+    __builtin_cpu_init();
+    features.ssse3 = __builtin_cpu_supports("ssse3") != 0;
+    features.avx2 = __builtin_cpu_supports("avx2") != 0;
+#endif
+    return features;
+}
+#endif
+
+#ifdef JQOPENCLAW_DELTA_NEON
+qint64 blockSumsNeon(const quint8 *data, qint64 size, quint32 *s1, quint32 *s2)
+{
+    const qint64 chunks = size / 16;
+    if ( chunks == 0 )
+    {
+        return 0;
+    }
+
+    static const quint8 weightBytes[16] = { 16, 15, 14, 13, 12, 11, 10, 9, 8, 7, 6, 5, 4, 3, 2, 1 };
+    const uint8x8_t lowWeights = vld1_u8(weightBytes);
+    const uint8x8_t highWeights = vld1_u8(weightBytes + 8);
+    uint32x4_t sums = vdupq_n_u32(0);
+    uint32x4_t prefix = vdupq_n_u32(0);
+    uint32x4_t weighted = vdupq_n_u32(0);
+    for ( qint64 chunk = 0; chunk < chunks; ++chunk )
+    {
+        const uint8x16_t bytes = vld1q_u8(data + ( chunk * 16 ));
+        prefix = vaddq_u32(prefix, sums);
+        sums = vpadalq_u16(sums, vpaddlq_u8(bytes));
+        weighted = vpadalq_u16(weighted, vmull_u8(vget_low_u8(bytes), lowWeights));
+        weighted = vpadalq_u16(weighted, vmull_u8(vget_high_u8(bytes), highWeights));
+    }
+
+    *s2 += ( static_cast<quint32>(chunks) * 16U * *s1 ) + ( 16U * vaddvq_u32(prefix) ) + vaddvq_u32(weighted);
+    *s1 += vaddvq_u32(sums);
+    return chunks * 16;
+}
+#endif
+
+DeltaKernels selectKernels()
+{
+#ifdef JQOPENCLAW_DELTA_X86
+    const X86Features features = detectX86Features();
+    if ( features.avx2 )
+    {
+        return { "avx2", &blockSumsAvx2 };
+    }
+    if ( features.ssse3 )
+    {
+        return { "ssse3", &blockSumsSsse3 };
+    }
+#endif
+#ifdef JQOPENCLAW_DELTA_NEON
+    return { "neon", &blockSumsNeon };
+#else
+    return { "scalar", &blockSumsScalar };
+#endif
+}
+
+const DeltaKernels &deltaKernels()
+{
+    static const DeltaKernels kernels = selectKernels();
+    return kernels;
+}
+
+void blockSums(const quint8 *data, qint64 size, quint32 *s1, quint32 *s2)
+{
+    *s1 = 0;
+    *s2 = 0;
+    const qint64 bulkBytes = deltaKernels().blockSums(data, size, s1, s2);
+    finishBlockSums(data + bulkBytes, size - bulkBytes, s1, s2);
+}
+
+inline quint32 weakChecksum(quint32 s1, quint32 s2)
+{
+    return ( s1 & 0xFFFFU ) | ( s2 << 16 );
+}
+
+// Cheap first-level filter in front of the hash lookup, as most offsets match nothing.
+inline quint32 weakTag(quint32 weak)
+{
+    return ( weak ^ ( weak >> 16 ) ) & 0xFFFFU;
+}
+
+void appendLiteral(const quint8 *data, qint64 begin, qint64 end, FileDeltaResult *result)
+{
+    if ( end <= begin )
+    {
+        return;
+    }
+    FileDeltaOp op;
+    op.offsetBytes = begin;
+    op.literal = QByteArray(reinterpret_cast<const char *>(data + begin), static_cast<qsizetype>(end - begin));
+    result->literalBytes += end - begin;
+    result->ops.append(op);
+}
+
+void appendCopy(qint64 block, FileDeltaResult *result)
+{
+    ++result->matchedBlocks;
+    if ( !result->ops.isEmpty() )
+    {
+        FileDeltaOp &last = result->ops.last();
+        if ( last.copy && ( ( last.block + last.blockCount ) == block ) )
+        {
+            ++last.blockCount;
+            return;
+        }
+    }
+    FileDeltaOp op;
+    op.copy = true;
+    op.block = block;
+    op.blockCount = 1;
+    result->ops.append(op);
+}
+}
+
+bool FileDeltaEngine::compute(
+    const QString &absolutePath,
+    const FileDeltaSignature &signature,
+    qint64 maxLiteralBytes,
+    int timeoutMs,
+    FileDeltaResult *result,
+    QString *error
+)
+{
+    if ( ( signature.blockBytes <= 0 ) || ( signature.weak.size() != signature.strong.size() ) )
+    {
+        *error = QStringLiteral("invalid signature");
+        return false;
+    }
+    const QDeadlineTimer deadline = ( timeoutMs >= 0 )
+        ? QDeadlineTimer(timeoutMs)
+        : QDeadlineTimer(QDeadlineTimer::Forever);
+
+    QFile file(absolutePath);
+    if ( !file.open(QIODevice::ReadOnly) )
+    {
+        *error = QStringLiteral("open failed: %1").arg(file.errorString().trimmed());
+        return false;
+    }
+    if ( file.size() > deltaMaxFileBytes )
+    {
+        *error = QStringLiteral("file exceeds %1 bytes").arg(deltaMaxFileBytes);
+        return false;
+    }
+
+    // Read into a buffer rather than mapped: a file truncated by another process while
+    // it is being compared just reads short instead of raising SIGBUS.
+    QByteArray buffer;
+    buffer.reserve(static_cast<qsizetype>(file.size()));
+    for ( ;; )
+    {
+        const QByteArray chunk = file.read(deltaReadChunkBytes);
+        if ( chunk.isEmpty() )
+        {
+            if ( file.error() != QFileDevice::NoError )
+            {
+                *error = QStringLiteral("read failed: %1").arg(file.errorString().trimmed());
+                return false;
+            }
+            break;
+        }
+        if ( ( buffer.size() + chunk.size() ) > deltaMaxFileBytes )
+        {
+            *error = QStringLiteral("file exceeds %1 bytes").arg(deltaMaxFileBytes);
+            return false;
+        }
+        buffer.append(chunk);
+    }
+
+    // A file that grew or shrank since it was opened is compared as read.
+    const qint64 size = buffer.size();
+    const quint8 *data = reinterpret_cast<const quint8 *>(buffer.constData());
+    *result = FileDeltaResult();
+    result->sizeBytes = size;
+    result->xxh3 = Xxh3Digest::hash64(data, size);
+
+    const qint64 blockBytes = signature.blockBytes;
+    const qint64 lastBlock = signature.weak.size() - 1;
+    std::vector<quint8> tags(0x10000, 0);
+    QHash<quint32, QList<qint64>> blocksByWeak;
+    blocksByWeak.reserve(static_cast<qsizetype>(signature.weak.size()));
+    for ( qint64 block = 0; block <= lastBlock; ++block )
+    {
+        const quint32 weak = signature.weak.at(block);
+        tags[weakTag(weak)] = 1;
+        blocksByWeak[weak].append(block);
+    }
+
+    qint64 position = 0;
+    qint64 literalStart = 0;
+    qint64 windowBytes = 0;
+    quint32 s1 = 0;
+    quint32 s2 = 0;
+    bool freshWindow = true;
+    qint64 nextDeadlineCheck = deltaDeadlineCheckInterval;
+    while ( ( position < size ) && ( lastBlock >= 0 ) )
+    {
+        if ( position >= nextDeadlineCheck )
+        {
+            if ( deadline.hasExpired() )
+            {
+                *error = QStringLiteral("timed out after %1 of %2 bytes").arg(position).arg(size);
+                return false;
+            }
+            nextDeadlineCheck = position + deltaDeadlineCheckInterval;
+        }
+
+        if ( freshWindow )
+        {
+            windowBytes = qMin(blockBytes, size - position);
+            blockSums(data + position, windowBytes, &s1, &s2);
+            freshWindow = false;
+        }
+
+        const quint32 weak = weakChecksum(s1, s2);
+        qint64 matchedBlock = -1;
+        if ( tags[weakTag(weak)] != 0 )
+        {
+            const auto candidates = blocksByWeak.constFind(weak);
+            if ( candidates != blocksByWeak.cend() )
+            {
+                // Prefer the block right after the previous copy so runs stay merged.
+                qint64 expectedBlock = -1;
+                if ( !result->ops.isEmpty() && result->ops.last().copy && ( literalStart == position ) )
+                {
+                    expectedBlock = result->ops.last().block + result->ops.last().blockCount;
+                }
+                // Only the last block may be shorter than blockBytes.
+                auto windowFits = [&](qint64 block)
+                {
+                    return ( windowBytes == blockBytes ) || ( block == lastBlock );
+                };
+                const quint64 strong = Xxh3Digest::hash64(data + position, windowBytes);
+                if ( ( expectedBlock >= 0 ) && ( expectedBlock <= lastBlock ) &&
+                     ( signature.weak.at(expectedBlock) == weak ) && windowFits(expectedBlock) &&
+                     ( signature.strong.at(expectedBlock) == strong ) )
+                {
+                    matchedBlock = expectedBlock;
+                }
+                else
+                {
+                    const QList<qint64> &blocks = candidates.value();
+                    const qsizetype scanCount = qMin<qsizetype>(blocks.size(), deltaMaxCandidatesPerPosition);
+                    for ( qsizetype index = 0; index < scanCount; ++index )
+                    {
+                        const qint64 block = blocks.at(index);
+                        if ( windowFits(block) && ( signature.strong.at(block) == strong ) )
+                        {
+                            matchedBlock = block;
+                            break;
+                        }
+                    }
+                }
+            }
+        }
+
+        if ( matchedBlock >= 0 )
+        {
+            appendLiteral(data, literalStart, position, result);
+            appendCopy(matchedBlock, result);
+            position += windowBytes;
+            literalStart = position;
+            freshWindow = true;
+            continue;
+        }
+
+        // Slide the window one byte; near EOF it shrinks instead, so the caller's short
+        // last block can still match.
+        const quint32 outByte = data[position];
+        if ( ( position + windowBytes ) < size )
+        {
+            const quint32 inByte = data[position + windowBytes];
+            s1 = s1 - outByte + inByte;
+            s2 = s2 - ( static_cast<quint32>(windowBytes) * outByte ) + s1;
+        }
+        else
+        {
+            s1 -= outByte;
+            s2 -= static_cast<quint32>(windowBytes) * outByte;
+            --windowBytes;
+        }
+        ++position;
+
+        if ( ( result->literalBytes + ( position - literalStart ) ) > maxLiteralBytes )
+        {
+            *error = QStringLiteral("changed data exceeds maxBytes (%1)").arg(maxLiteralBytes);
+            return false;
+        }
+    }
+
+    if ( ( result->literalBytes + ( size - literalStart ) ) > maxLiteralBytes )
+    {
+        *error = QStringLiteral("changed data exceeds maxBytes (%1)").arg(maxLiteralBytes);
+        return false;
+    }
+    appendLiteral(data, literalStart, size, result);
+    return true;
+}
+
+quint32 FileDeltaEngine::blockChecksum(const void *data, qint64 size)
+{
+    quint32 s1 = 0;
+    quint32 s2 = 0;
+    blockSums(static_cast<const quint8 *>(data), qMax<qint64>(0, size), &s1, &s2);
+    return weakChecksum(s1, s2);
+}
+
+const char *FileDeltaEngine::kernelName()
+{
+    return deltaKernels().name;
+}
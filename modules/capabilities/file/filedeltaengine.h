@@ -0,0 +1,62 @@
+#ifndef JQOPENCLAW_CAPABILITIES_FILE_FILEDELTAENGINE_H_
+#define JQOPENCLAW_CAPABILITIES_FILE_FILEDELTAENGINE_H_
+
+// Qt lib import
+#include <QByteArray>
+#include <QList>
+#include <QString>
+
+// Signature of the caller's copy: one entry per blockBytes-sized block, the last block
+// possibly shorter. weak is the rsync rolling checksum (s1 | s2 << 16, where over the n
+// bytes of a block s1 = sum(x[i]) and s2 = sum((n - i) * x[i]), both mod 2^16); strong is
+// the XXH3-64 of the block.
+struct FileDeltaSignature
+{
+    qint64 blockBytes = 0;
+    QList<quint32> weak;
+    QList<quint64> strong;
+};
+
+// Either a run of the caller's blocks [block, block + blockCount) to copy, or literal
+// bytes of the current file.
+struct FileDeltaOp
+{
+    bool copy = false;
+    qint64 block = 0;
+    qint64 blockCount = 0;
+    qint64 offsetBytes = 0;
+    QByteArray literal;
+};
+
+struct FileDeltaResult
+{
+    qint64 sizeBytes = 0;
+    quint64 xxh3 = 0;
+    qint64 matchedBlocks = 0;
+    qint64 literalBytes = 0;
+    QList<FileDeltaOp> ops;
+};
+
+class FileDeltaEngine
+{
+public:
+    // Matches the current file against signature at every byte offset and returns the
+    // copy / literal sequence that rebuilds it. Fails rather than returning more than
+    // maxLiteralBytes of literal data, or when timeoutMs (< 0: no limit) runs out.
+    static bool compute(
+        const QString &absolutePath,
+        const FileDeltaSignature &signature,
+        qint64 maxLiteralBytes,
+        int timeoutMs,
+        FileDeltaResult *result,
+        QString *error
+    );
+
+    // The weak checksum of one block, as described on FileDeltaSignature.
+    static quint32 blockChecksum(const void *data, qint64 size);
+
+    // "avx2", "ssse3", "neon" or "scalar".
+    static const char *kernelName();
+};
+
+#endif // JQOPENCLAW_CAPABILITIES_FILE_FILEDELTAENGINE_H_
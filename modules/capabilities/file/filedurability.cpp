@@ -0,0 +1,173 @@
+// .h include
+#include "capabilities/file/filedurability.h"
+
+// Qt lib import
+#include <QDir>
+#include <QFile>
+#include <QFileDevice>
+#include <QtGlobal>
+
+#if defined(Q_OS_WIN)
+#include <io.h>
+#include <windows.h>
+#elif defined(Q_OS_UNIX)
+#include <errno.h>
+#include <fcntl.h>
+#include <string.h>
+#include <unistd.h>
+#if defined(Q_OS_LINUX)
+#include <linux/falloc.h>
+#endif
+#endif
+
+namespace
+{
+#if defined(Q_OS_WIN)
+HANDLE nativeHandle(QFileDevice *file)
+{
+    const int fd = file->handle();
+    if ( fd < 0 )
+    {
+        return INVALID_HANDLE_VALUE;
+    }
+    return reinterpret_cast<HANDLE>(_get_osfhandle(fd));
+}
+
+QString lastErrorString()
+{
+    return QStringLiteral("windows error %1").arg(GetLastError());
+}
+#elif defined(Q_OS_UNIX)
+QString errnoString(int errorNumber)
+{
+    return QString::fromLocal8Bit(strerror(errorNumber));
+}
+#endif
+}
+
+QString FileDurability::levelName(FileDurabilityLevel level)
+{
+    switch ( level )
+    {
+    case FileDurabilityLevel::None:
+        return QStringLiteral("none");
+    case FileDurabilityLevel::Data:
+        return QStringLiteral("data");
+    case FileDurabilityLevel::Full:
+        return QStringLiteral("full");
+    }
+    return QStringLiteral("none");
+}
+
+bool FileDurability::syncFile(QFileDevice *file, FileDurabilityLevel level, QString *error)
+{
+    if ( !file->flush() )
+    {
+        *error = QStringLiteral("flush failed: %1").arg(file->errorString().trimmed());
+        return false;
+    }
+    if ( level == FileDurabilityLevel::None )
+    {
+        return true;
+    }
+
+#if defined(Q_OS_WIN)
+    // Windows has no data-only variant; FlushFileBuffers writes data and metadata.
+    const HANDLE handle = nativeHandle(file);
+    if ( ( handle == INVALID_HANDLE_VALUE ) || !FlushFileBuffers(handle) )
+    {
+        *error = QStringLiteral("FlushFileBuffers failed: %1").arg(lastErrorString());
+        return false;
+    }
+    return true;
+#elif defined(Q_OS_UNIX)
+    const int fd = file->handle();
+    int result = 0;
+#if defined(Q_OS_LINUX)
+    result = ( level == FileDurabilityLevel::Data ) ? ::fdatasync(fd) : ::fsync(fd);
+#elif defined(Q_OS_DARWIN)
+    // fsync on Darwin stops at the drive cache; F_FULLFSYNC also flushes that. Not every
+    // filesystem supports it, so fall back to fsync.
+    result = ::fcntl(fd, F_FULLFSYNC);
+    if ( result != 0 )
+    {
+        result = ::fsync(fd);
+    }
+#else
+    result = ::fsync(fd);
+#endif
+    if ( result != 0 )
+    {
+        *error = QStringLiteral("sync failed: %1").arg(errnoString(errno));
+        return false;
+    }
+    return true;
+#else
+    Q_UNUSED(error)
+    return true;
+#endif
+}
+
+bool FileDurability::syncDirectory(const QString &directoryPath, QString *error)
+{
+#if defined(Q_OS_UNIX)
+    const int fd = ::open(QFile::encodeName(directoryPath).constData(), O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+    if ( fd < 0 )
+    {
+        *error = QStringLiteral("open directory %1 failed: %2").arg(directoryPath, errnoString(errno));
+        return false;
+    }
+    const int result = ::fsync(fd);
+    const int syncErrno = errno;
+    ::close(fd);
+    // Some filesystems refuse fsync on directories; nothing more can be done there.
+    if ( ( result != 0 ) && ( syncErrno != EINVAL ) )
+    {
+        *error = QStringLiteral("sync directory %1 failed: %2").arg(directoryPath, errnoString(syncErrno));
+        return false;
+    }
+    return true;
+#else
+    Q_UNUSED(directoryPath)
+    Q_UNUSED(error)
+    return true;
+#endif
+}
+
+bool FileDurability::preallocate(QFileDevice *file, qint64 sizeBytes)
+{
+    if ( sizeBytes <= 0 )
+    {
+        return false;
+    }
+
+#if defined(Q_OS_WIN)
+    const HANDLE handle = nativeHandle(file);
+    if ( handle == INVALID_HANDLE_VALUE )
+    {
+        return false;
+    }
+    FILE_ALLOCATION_INFO allocation;
+    allocation.AllocationSize.QuadPart = sizeBytes;
+    return SetFileInformationByHandle(handle, FileAllocationInfo, &allocation, sizeof(allocation)) != FALSE;
+#elif defined(Q_OS_LINUX)
+    // KEEP_SIZE: a write that ends early must not leave a zero-filled tail.
+    return ::fallocate(file->handle(), FALLOC_FL_KEEP_SIZE, 0, static_cast<off_t>(sizeBytes)) == 0;
+#elif defined(Q_OS_DARWIN)
+    fstore_t store;
+    store.fst_flags = F_ALLOCATECONTIG | F_ALLOCATEALL;
+    store.fst_posmode = F_PEOFPOSMODE;
+    store.fst_offset = 0;
+    store.fst_length = static_cast<off_t>(sizeBytes);
+    store.fst_bytesalloc = 0;
+    if ( ::fcntl(file->handle(), F_PREALLOCATE, &store) == 0 )
+    {
+        return true;
+    }
+    store.fst_flags = F_ALLOCATEALL;
+    return ::fcntl(file->handle(), F_PREALLOCATE, &store) == 0;
+#else
+    Q_UNUSED(file)
+    return false;
+#endif
+}
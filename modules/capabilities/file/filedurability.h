@@ -0,0 +1,40 @@
+#ifndef JQOPENCLAW_CAPABILITIES_FILE_FILEDURABILITY_H_
+#define JQOPENCLAW_CAPABILITIES_FILE_FILEDURABILITY_H_
+
+// Qt lib import
+#include <QString>
+
+class QFileDevice;
+
+// How far a write is pushed towards the disk before it is reported done.
+//   None: left in the OS cache (flush() only).
+//   Data: file contents synced (fdatasync; FlushFileBuffers on Windows).
+//   Full: contents and metadata synced (fsync), plus the parent directory so a newly
+//         created or renamed entry survives a crash too.
+enum class FileDurabilityLevel
+{
+    None,
+    Data,
+    Full,
+};
+
+class FileDurability
+{
+public:
+    static QString levelName(FileDurabilityLevel level);
+
+    // file must be open.
+    static bool syncFile(QFileDevice *file, FileDurabilityLevel level, QString *error);
+
+    // Makes directory entry changes (create, rename, unlink) durable. No-op on Windows,
+    // where NTFS journals them and directory handles cannot be flushed without admin
+    // rights.
+    static bool syncDirectory(const QString &directoryPath, QString *error);
+
+    // Reserves space for sizeBytes without changing the file size, so a large write gets
+    // contiguous extents and fails early on a full disk. Only a hint: returns false when
+    // the platform or filesystem does not support it.
+    static bool preallocate(QFileDevice *file, qint64 sizeBytes);
+};
+
+#endif // JQOPENCLAW_CAPABILITIES_FILE_FILEDURABILITY_H_
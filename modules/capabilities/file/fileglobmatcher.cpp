@@ -0,0 +1,209 @@
+// .h include
+#include "capabilities/file/fileglobmatcher.h"
+
+// Qt lib import
+#include <QtGlobal>
+
+namespace
+{
+// Qt versions differ on whether a wildcard '*' may span a path separator; ask the same
+// conversion QDir::match relies on instead of hard-coding either behavior.
+bool wildcardStarSpansSeparator()
+{
+    static const bool value = QRegularExpression(
+        QRegularExpression::wildcardToRegularExpression(QStringLiteral("a*"))
+    ).match(QStringLiteral("a/b")).hasMatch();
+    return value;
+}
+
+QStringList splitNameFilters(const QString &pattern)
+{
+    // Mirrors QDir::nameFiltersFromString, which QDir::match applies to its filter.
+    const QChar separator = pattern.contains(QLatin1Char(';'))
+        ? QLatin1Char(';')
+        : QLatin1Char(' ');
+    QStringList filters;
+    for ( const QString &part : pattern.split(separator, Qt::SkipEmptyParts) )
+    {
+        const QString filter = part.trimmed();
+        if ( !filter.isEmpty() )
+        {
+            filters.append(filter);
+        }
+    }
+    return filters;
+}
+
+bool hasWildcardOrSeparator(QStringView text)
+{
+    for ( const QChar character : text )
+    {
+        if ( ( character == QLatin1Char('*') ) ||
+             ( character == QLatin1Char('?') ) ||
+             ( character == QLatin1Char('[') ) ||
+             ( character == QLatin1Char('/') ) ||
+             ( character == QLatin1Char('\\') ) )
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+QRegularExpression compileWildcard(const QString &pattern)
+{
+    QRegularExpression expression(
+        QRegularExpression::wildcardToRegularExpression(pattern),
+        QRegularExpression::CaseInsensitiveOption
+    );
+    expression.optimize();
+    return expression;
+}
+}
+
+FileGlobMatcher::FileGlobMatcher(const QStringList &patterns)
+{
+    QStringList regexPatterns;
+    bool allPathPatterns = true;
+    for ( const QString &pattern : patterns )
+    {
+        for ( const QString &filter : splitNameFilters(pattern) )
+        {
+            empty_ = false;
+
+            const QStringView body(filter);
+            if ( !hasWildcardOrSeparator(body) )
+            {
+                literals_.append(filter);
+            }
+            else if ( ( filter.size() > 1 ) &&
+                      filter.startsWith(QLatin1Char('*')) &&
+                      !hasWildcardOrSeparator(body.mid(1)) )
+            {
+                suffixes_.append(filter.mid(1));
+            }
+            else if ( ( filter.size() > 1 ) &&
+                      filter.endsWith(QLatin1Char('*')) &&
+                      !hasWildcardOrSeparator(body.chopped(1)) )
+            {
+                prefixes_.append(filter.chopped(1));
+            }
+            else
+            {
+                regexPatterns.append(QRegularExpression::wildcardToRegularExpression(filter));
+            }
+
+            if ( !filter.contains(QLatin1Char('/')) )
+            {
+                allPathPatterns = false;
+                continue;
+            }
+
+            PathPattern pathPattern;
+            const QStringList segments = filter.split(QLatin1Char('/'));
+            pathPattern.unboundedFrom = segments.size();
+            for ( int index = 0; index < segments.size(); ++index )
+            {
+                if ( wildcardStarSpansSeparator() &&
+                     segments.at(index).contains(QLatin1Char('*')) &&
+                     ( pathPattern.unboundedFrom == segments.size() ) )
+                {
+                    pathPattern.unboundedFrom = index;
+                }
+                pathPattern.segments.append(compileWildcard(segments.at(index)));
+            }
+            pathPatterns_.append(pathPattern);
+        }
+    }
+
+    prunable_ = !empty_ && allPathPatterns;
+    if ( !regexPatterns.isEmpty() )
+    {
+        // Each converted pattern is already anchored, so plain alternation keeps them independent.
+        combined_ = QRegularExpression(
+            regexPatterns.join(QLatin1Char('|')),
+            QRegularExpression::CaseInsensitiveOption
+        );
+        combined_.optimize();
+        hasCombined_ = true;
+    }
+}
+
+bool FileGlobMatcher::isEmpty() const
+{
+    return empty_;
+}
+
+bool FileGlobMatcher::matches(const QString &relativePath, const QString &fileName) const
+{
+    if ( empty_ )
+    {
+        return true;
+    }
+
+    for ( const QString &literal : literals_ )
+    {
+        if ( ( fileName.compare(literal, Qt::CaseInsensitive) == 0 ) ||
+             ( relativePath.compare(literal, Qt::CaseInsensitive) == 0 ) )
+        {
+            return true;
+        }
+    }
+    // The suffix holds no '/', so the name ends with it exactly when the path does.
+    for ( const QString &suffix : suffixes_ )
+    {
+        if ( fileName.endsWith(suffix, Qt::CaseInsensitive) )
+        {
+            return true;
+        }
+    }
+    for ( const QString &prefix : prefixes_ )
+    {
+        if ( fileName.startsWith(prefix, Qt::CaseInsensitive) ||
+             ( wildcardStarSpansSeparator() &&
+               relativePath.startsWith(prefix, Qt::CaseInsensitive) ) )
+        {
+            return true;
+        }
+    }
+
+    if ( hasCombined_ )
+    {
+        return combined_.match(relativePath).hasMatch() ||
+            combined_.match(fileName).hasMatch();
+    }
+    return false;
+}
+
+bool FileGlobMatcher::canMatchBelow(const QString &relativeDirectoryPath) const
+{
+    if ( !prunable_ )
+    {
+        return true;
+    }
+
+    const QStringList components = relativeDirectoryPath.split(QLatin1Char('/'));
+    for ( const PathPattern &pathPattern : pathPatterns_ )
+    {
+        bool possible = true;
+        for ( int index = 0; index < components.size(); ++index )
+        {
+            if ( index >= pathPattern.unboundedFrom )
+            {
+                return true;
+            }
+            // A descendant has at least one more component than this directory.
+            if ( index >= ( pathPattern.segments.size() - 1 ) ||
+                 !pathPattern.segments.at(index).match(components.at(index)).hasMatch() )
+            {
+                possible = false;
+                break;
+            }
+        }
+        if ( possible )
+        {
+            return true;
+        }
+    }
+    return false;
+}
@@ -0,0 +1,48 @@
+#ifndef JQOPENCLAW_CAPABILITIES_FILE_FILEGLOBMATCHER_H_
+#define JQOPENCLAW_CAPABILITIES_FILE_FILEGLOBMATCHER_H_
+
+// Qt lib import
+#include <QList>
+#include <QRegularExpression>
+#include <QString>
+#include <QStringList>
+
+// Glob filter compiled once per request. Matching keeps QDir::match semantics (case
+// insensitive, filters split on ';' or ' ', tested against the relative path and the
+// file name), but literal, "prefix*" and "*suffix" patterns skip the regex engine and
+// all remaining patterns share a single combined expression.
+class FileGlobMatcher
+{
+public:
+    FileGlobMatcher() = default;
+
+    explicit FileGlobMatcher(const QStringList &patterns);
+
+    bool isEmpty() const;
+
+    bool matches(const QString &relativePath, const QString &fileName) const;
+
+    // false only when no entry below relativeDirectoryPath can match; this is decidable
+    // only when every pattern contains '/', otherwise a bare name pattern may match at
+    // any depth and the answer is always true.
+    bool canMatchBelow(const QString &relativeDirectoryPath) const;
+
+private:
+    struct PathPattern
+    {
+        QList<QRegularExpression> segments;
+        // Index of the first segment whose '*' may span '/', or segments.size().
+        int unboundedFrom = 0;
+    };
+
+    bool empty_ = true;
+    QStringList literals_;
+    QStringList prefixes_;
+    QStringList suffixes_;
+    QRegularExpression combined_;
+    bool hasCombined_ = false;
+    bool prunable_ = false;
+    QList<PathPattern> pathPatterns_;
+};
+
+#endif // JQOPENCLAW_CAPABILITIES_FILE_FILEGLOBMATCHER_H_
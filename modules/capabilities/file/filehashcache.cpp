@@ -0,0 +1,328 @@
+// .h include
+#include "capabilities/file/filehashcache.h"
+
+// Qt lib import
+#include <QDataStream>
+#include <QDateTime>
+#include <QDebug>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QHash>
+#include <QMutex>
+#include <QMutexLocker>
+#include <QSaveFile>
+#include <QStandardPaths>
+#include <QtGlobal>
+
+// JQOpenClaw import
+#include "common/common.h"
+
+// C++ lib import
+#include <algorithm>
+#include <vector>
+
+#if defined(Q_OS_WIN)
+#include <windows.h>
+#elif defined(Q_OS_UNIX)
+#include <sys/stat.h>
+#endif
+
+namespace
+{
+const quint32 hashCacheMagic = 0x4A514843; // "JQHC"
+const quint32 hashCacheVersion = 1;
+const int hashCacheMaxEntries = 100000;
+// A file modified this close to hashing may change again within the same mtime tick,
+// so its digest is not cached (same reasoning as git's racy-clean check).
+const qint64 hashCacheRacyWindowMs = 2000;
+
+struct CacheEntry
+{
+    FileIdentity identity;
+    QString digestHex;
+    qint64 lastUsedMs = 0;
+};
+
+struct CacheState
+{
+    QMutex mutex;
+    bool loaded = false;
+    bool dirty = false;
+    QHash<QString, CacheEntry> entries;
+};
+
+CacheState &cacheState()
+{
+    static CacheState value;
+    return value;
+}
+
+QString cacheFilePath()
+{
+    QString baseDirectory = QStandardPaths::writableLocation(QStandardPaths::AppDataLocation).trimmed();
+    if ( baseDirectory.isEmpty() )
+    {
+        baseDirectory = QDir::tempPath();
+    }
+    return QDir(baseDirectory).filePath(QStringLiteral("file-hash-cache/digests.dat"));
+}
+
+QString cacheKey(const QString &algorithm, const QString &absolutePath)
+{
+    const QString normalizedPath = ( Common::pathCaseSensitivity() == Qt::CaseInsensitive )
+        ? absolutePath.toLower()
+        : absolutePath;
+    return algorithm + QLatin1Char('|') + normalizedPath;
+}
+
+QDataStream &operator<<(QDataStream &stream, const FileIdentity &identity)
+{
+    return stream << identity.sizeBytes << identity.modifiedNs << identity.device << identity.inode;
+}
+
+QDataStream &operator>>(QDataStream &stream, FileIdentity &identity)
+{
+    return stream >> identity.sizeBytes >> identity.modifiedNs >> identity.device >> identity.inode;
+}
+
+// Caller holds state.mutex.
+void ensureLoaded(CacheState &state)
+{
+    if ( state.loaded )
+    {
+        return;
+    }
+    state.loaded = true;
+
+    QFile file(cacheFilePath());
+    if ( !file.open(QIODevice::ReadOnly) )
+    {
+        return;
+    }
+
+    QDataStream stream(&file);
+    stream.setVersion(QDataStream::Qt_6_0);
+    quint32 magic = 0;
+    quint32 version = 0;
+    quint32 entryCount = 0;
+    stream >> magic >> version >> entryCount;
+    if ( ( magic != hashCacheMagic ) || ( version != hashCacheVersion ) )
+    {
+        return;
+    }
+
+    QHash<QString, CacheEntry> loaded;
+    loaded.reserve(static_cast<qsizetype>(qMin<quint32>(entryCount, hashCacheMaxEntries)));
+    for ( quint32 index = 0; ( index < entryCount ) && ( stream.status() == QDataStream::Ok ); ++index )
+    {
+        QString key;
+        CacheEntry entry;
+        stream >> key >> entry.identity >> entry.digestHex >> entry.lastUsedMs;
+        loaded.insert(key, entry);
+    }
+    if ( stream.status() != QDataStream::Ok )
+    {
+        qWarning().noquote() << QStringLiteral("[capability.file.hash] ignoring corrupt hash cache");
+        return;
+    }
+    state.entries = loaded;
+}
+
+// Caller holds state.mutex. Drops the least recently used tenth once over the cap.
+void evictIfNeeded(CacheState &state)
+{
+    if ( state.entries.size() <= hashCacheMaxEntries )
+    {
+        return;
+    }
+
+    std::vector<qint64> lastUsed;
+    lastUsed.reserve(static_cast<size_t>(state.entries.size()));
+    for ( auto it = state.entries.cbegin(); it != state.entries.cend(); ++it )
+    {
+        lastUsed.push_back(it->lastUsedMs);
+    }
+    const size_t dropCount = lastUsed.size() / 10;
+    std::nth_element(lastUsed.begin(), lastUsed.begin() + dropCount, lastUsed.end());
+    const qint64 threshold = lastUsed.at(dropCount);
+    for ( auto it = state.entries.begin(); it != state.entries.end(); )
+    {
+        if ( it->lastUsedMs < threshold )
+        {
+            it = state.entries.erase(it);
+        }
+        else
+        {
+            ++it;
+        }
+    }
+}
+}
+
+bool FileHashCache::readIdentity(const QString &absolutePath, FileIdentity *identity)
+{
+    if ( identity == nullptr )
+    {
+        return false;
+    }
+
+#if defined(Q_OS_WIN)
+    const HANDLE handle = CreateFileW(
+        reinterpret_cast<const wchar_t *>(QDir::toNativeSeparators(absolutePath).utf16()),
+        FILE_READ_ATTRIBUTES,
+        FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE,
+        nullptr,
+        OPEN_EXISTING,
+        FILE_FLAG_BACKUP_SEMANTICS,
+        nullptr
+    );
+    if ( handle == INVALID_HANDLE_VALUE )
+    {
+        return false;
+    }
+    BY_HANDLE_FILE_INFORMATION information;
+    const bool ok = GetFileInformationByHandle(handle, &information) != FALSE;
+    CloseHandle(handle);
+    if ( !ok )
+    {
+        return false;
+    }
+    identity->sizeBytes = static_cast<qint64>(
+        ( static_cast<quint64>(information.nFileSizeHigh) << 32 ) | information.nFileSizeLow
+    );
+    // FILETIME ticks are 100ns; only equality matters, so the 1601 epoch is kept.
+    identity->modifiedNs = static_cast<qint64>(
+        ( static_cast<quint64>(information.ftLastWriteTime.dwHighDateTime) << 32 ) |
+        information.ftLastWriteTime.dwLowDateTime
+    ) * 100;
+    identity->device = information.dwVolumeSerialNumber;
+    identity->inode = ( static_cast<quint64>(information.nFileIndexHigh) << 32 ) | information.nFileIndexLow;
+    return true;
+#elif defined(Q_OS_UNIX)
+    struct stat information;
+    if ( ::stat(QFile::encodeName(absolutePath).constData(), &information) != 0 )
+    {
+        return false;
+    }
+    identity->sizeBytes = static_cast<qint64>(information.st_size);
+#if defined(Q_OS_LINUX)
+    identity->modifiedNs = static_cast<qint64>(information.st_mtim.tv_sec) * 1000000000LL +
+        information.st_mtim.tv_nsec;
+#elif defined(Q_OS_DARWIN)
+    identity->modifiedNs = static_cast<qint64>(information.st_mtimespec.tv_sec) * 1000000000LL +
+        information.st_mtimespec.tv_nsec;
+#else
+    identity->modifiedNs = static_cast<qint64>(information.st_mtime) * 1000000000LL;
+#endif
+    identity->device = static_cast<quint64>(information.st_dev);
+    identity->inode = static_cast<quint64>(information.st_ino);
+    return true;
+#else
+    const QFileInfo fileInfo(absolutePath);
+    if ( !fileInfo.exists() )
+    {
+        return false;
+    }
+    identity->sizeBytes = fileInfo.size();
+    identity->modifiedNs = fileInfo.lastModified().toMSecsSinceEpoch() * 1000000LL;
+    identity->device = 0;
+    identity->inode = 0;
+    return true;
+#endif
+}
+
+bool FileHashCache::lookup(
+    const QString &algorithm,
+    const QString &absolutePath,
+    const FileIdentity &identity,
+    QString *digestHex
+)
+{
+    CacheState &state = cacheState();
+    QMutexLocker locker(&state.mutex);
+    ensureLoaded(state);
+
+    const QString key = cacheKey(algorithm, absolutePath);
+    auto it = state.entries.find(key);
+    if ( it == state.entries.end() )
+    {
+        return false;
+    }
+    if ( it->identity != identity )
+    {
+        state.entries.erase(it);
+        state.dirty = true;
+        return false;
+    }
+
+    // Recency is only persisted along with the next real change.
+    it->lastUsedMs = QDateTime::currentMSecsSinceEpoch();
+    if ( digestHex != nullptr )
+    {
+        *digestHex = it->digestHex;
+    }
+    return true;
+}
+
+void FileHashCache::store(
+    const QString &algorithm,
+    const QString &absolutePath,
+    const FileIdentity &identity,
+    const QString &digestHex
+)
+{
+    const qint64 nowMs = QDateTime::currentMSecsSinceEpoch();
+    const qint64 modifiedMs = QFileInfo(absolutePath).lastModified().toMSecsSinceEpoch();
+    if ( qAbs(nowMs - modifiedMs) < hashCacheRacyWindowMs )
+    {
+        return;
+    }
+
+    CacheState &state = cacheState();
+    QMutexLocker locker(&state.mutex);
+    ensureLoaded(state);
+
+    CacheEntry entry;
+    entry.identity = identity;
+    entry.digestHex = digestHex;
+    entry.lastUsedMs = nowMs;
+    state.entries.insert(cacheKey(algorithm, absolutePath), entry);
+    state.dirty = true;
+    evictIfNeeded(state);
+}
+
+void FileHashCache::flush()
+{
+    CacheState &state = cacheState();
+    QMutexLocker locker(&state.mutex);
+    if ( !state.dirty )
+    {
+        return;
+    }
+
+    const QString path = cacheFilePath();
+    QDir().mkpath(QFileInfo(path).absolutePath());
+    QSaveFile file(path);
+    if ( !file.open(QIODevice::WriteOnly) )
+    {
+        qWarning().noquote() << QStringLiteral("[capability.file.hash] failed to write hash cache: %1")
+            .arg(file.errorString());
+        return;
+    }
+
+    QDataStream stream(&file);
+    stream.setVersion(QDataStream::Qt_6_0);
+    stream << hashCacheMagic << hashCacheVersion << static_cast<quint32>(state.entries.size());
+    for ( auto it = state.entries.cbegin(); it != state.entries.cend(); ++it )
+    {
+        stream << it.key() << it->identity << it->digestHex << it->lastUsedMs;
+    }
+    if ( ( stream.status() != QDataStream::Ok ) || !file.commit() )
+    {
+        qWarning().noquote() << QStringLiteral("[capability.file.hash] failed to write hash cache: %1")
+            .arg(file.errorString());
+        return;
+    }
+    state.dirty = false;
+}
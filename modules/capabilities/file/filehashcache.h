@@ -0,0 +1,55 @@
+#ifndef JQOPENCLAW_CAPABILITIES_FILE_FILEHASHCACHE_H_
+#define JQOPENCLAW_CAPABILITIES_FILE_FILEHASHCACHE_H_
+
+// Qt lib import
+#include <QString>
+
+struct FileIdentity
+{
+    qint64 sizeBytes = -1;
+    qint64 modifiedNs = 0;
+    quint64 device = 0;
+    // inode on Unix, file index on Windows; 0 where the platform gives neither.
+    quint64 inode = 0;
+
+    bool operator==(const FileIdentity &other) const
+    {
+        return ( sizeBytes == other.sizeBytes ) &&
+            ( modifiedNs == other.modifiedNs ) &&
+            ( device == other.device ) &&
+            ( inode == other.inode );
+    }
+
+    bool operator!=(const FileIdentity &other) const
+    {
+        return !( *this == other );
+    }
+};
+
+// Process-wide digest cache persisted under AppDataLocation. An entry is only served
+// while the file's (size, mtime, device, inode) tuple is unchanged, so a replaced,
+// truncated or rewritten file always misses.
+class FileHashCache
+{
+public:
+    static bool readIdentity(const QString &absolutePath, FileIdentity *identity);
+
+    static bool lookup(
+        const QString &algorithm,
+        const QString &absolutePath,
+        const FileIdentity &identity,
+        QString *digestHex
+    );
+
+    static void store(
+        const QString &algorithm,
+        const QString &absolutePath,
+        const FileIdentity &identity,
+        const QString &digestHex
+    );
+
+    // Writes pending entries to disk; cheap when nothing changed.
+    static void flush();
+};
+
+#endif // JQOPENCLAW_CAPABILITIES_FILE_FILEHASHCACHE_H_
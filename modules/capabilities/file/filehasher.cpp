@@ -0,0 +1,381 @@
+// .h include
+#include "capabilities/file/filehasher.h"
+
+// Qt lib import
+#include <QByteArray>
+#include <QDeadlineTimer>
+#include <QFile>
+#include <QFileInfo>
+#include <QThread>
+#include <QThreadPool>
+#include <QtGlobal>
+
+// OpenSSL lib import
+#include <openssl/evp.h>
+
+// JQOpenClaw import
+#include "capabilities/file/filehashcache.h"
+#include "common/common.h"
+#include "crypto/digest/blake3digest.h"
+#include "crypto/digest/xxh3digest.h"
+
+// C++ lib import
+#include <vector>
+
+namespace
+{
+// EVP digests are streamed; blake3/xxh3 need the whole input, which is read into memory
+// up to this size and only mapped above it.
+const qint64 hashBufferedMaxBytes = 512 * 1024 * 1024;
+const qint64 hashStreamBlockBytes = 1024 * 1024;
+const qint64 hashParallelBlake3MinBytes = 8 * 1024 * 1024;
+const int hashMaxWorkers = 16;
+
+const EVP_MD *evpDigestFor(FileHashAlgorithm algorithm)
+{
+    switch ( algorithm )
+    {
+    case FileHashAlgorithm::Md5:
+        return EVP_md5();
+    case FileHashAlgorithm::Sha1:
+        return EVP_sha1();
+    case FileHashAlgorithm::Sha256:
+        return EVP_sha256();
+    case FileHashAlgorithm::Sha512:
+        return EVP_sha512();
+    case FileHashAlgorithm::Blake3:
+    case FileHashAlgorithm::Xxh3:
+        break;
+    }
+    return nullptr;
+}
+
+class EvpHasher
+{
+public:
+    explicit EvpHasher(const EVP_MD *digest) :
+        context_(EVP_MD_CTX_new())
+    {
+        ok_ = ( context_ != nullptr ) &&
+            ( EVP_DigestInit_ex(context_, digest, nullptr) == 1 );
+    }
+
+    ~EvpHasher()
+    {
+        EVP_MD_CTX_free(context_);
+    }
+
+    EvpHasher(const EvpHasher &) = delete;
+    EvpHasher &operator=(const EvpHasher &) = delete;
+
+    void addData(const void *data, qint64 size)
+    {
+        if ( ok_ && ( size > 0 ) )
+        {
+            ok_ = ( EVP_DigestUpdate(context_, data, static_cast<size_t>(size)) == 1 );
+        }
+    }
+
+    bool finish(QString *digestHex, QString *error)
+    {
+        unsigned char digest[EVP_MAX_MD_SIZE];
+        unsigned int digestSize = 0;
+        if ( !ok_ || ( EVP_DigestFinal_ex(context_, digest, &digestSize) != 1 ) )
+        {
+            *error = QStringLiteral("digest failed: %1").arg(Common::lastOpenSslError());
+            return false;
+        }
+        *digestHex = QString::fromLatin1(
+            QByteArray(reinterpret_cast<const char *>(digest), static_cast<int>(digestSize)).toHex()
+        );
+        return true;
+    }
+
+private:
+    EVP_MD_CTX *context_ = nullptr;
+    bool ok_ = false;
+};
+
+bool digestBuffer(
+    FileHashAlgorithm algorithm,
+    const uchar *data,
+    qint64 size,
+    int maxThreads,
+    QString *digestHex,
+    QString *error
+)
+{
+    if ( algorithm == FileHashAlgorithm::Blake3 )
+    {
+        *digestHex = QString::fromLatin1(Blake3Digest::hash(data, size, maxThreads).toHex());
+        return true;
+    }
+    if ( algorithm == FileHashAlgorithm::Xxh3 )
+    {
+        // Canonical (big-endian) form, as printed by xxhsum.
+        *digestHex = QStringLiteral("%1").arg(Xxh3Digest::hash64(data, size), 16, 16, QLatin1Char('0'));
+        return true;
+    }
+
+    EvpHasher hasher(evpDigestFor(algorithm));
+    hasher.addData(data, size);
+    return hasher.finish(digestHex, error);
+}
+
+bool digestStream(
+    FileHashAlgorithm algorithm,
+    QFile *file,
+    QString *digestHex,
+    QString *error
+)
+{
+    EvpHasher hasher(evpDigestFor(algorithm));
+    QByteArray block;
+    while ( !file->atEnd() )
+    {
+        block = file->read(hashStreamBlockBytes);
+        if ( block.isEmpty() && ( file->error() != QFile::NoError ) )
+        {
+            *error = QStringLiteral("failed to read file: %1").arg(file->errorString().trimmed());
+            return false;
+        }
+        hasher.addData(block.constData(), block.size());
+    }
+    return hasher.finish(digestHex, error);
+}
+}
+
+bool FileHasher::parseAlgorithm(const QString &name, FileHashAlgorithm *algorithm)
+{
+    const QString normalized = name.trimmed().toLower().remove(QLatin1Char('-'));
+    if ( normalized == QStringLiteral("md5") )
+    {
+        *algorithm = FileHashAlgorithm::Md5;
+    }
+    else if ( normalized == QStringLiteral("sha1") )
+    {
+        *algorithm = FileHashAlgorithm::Sha1;
+    }
+    else if ( normalized == QStringLiteral("sha256") )
+    {
+        *algorithm = FileHashAlgorithm::Sha256;
+    }
+    else if ( normalized == QStringLiteral("sha512") )
+    {
+        *algorithm = FileHashAlgorithm::Sha512;
+    }
+    else if ( normalized == QStringLiteral("blake3") )
+    {
+        *algorithm = FileHashAlgorithm::Blake3;
+    }
+    else if ( ( normalized == QStringLiteral("xxh3") ) ||
+              ( normalized == QStringLiteral("xxh364") ) )
+    {
+        *algorithm = FileHashAlgorithm::Xxh3;
+    }
+    else
+    {
+        return false;
+    }
+    return true;
+}
+
+QString FileHasher::algorithmName(FileHashAlgorithm algorithm)
+{
+    switch ( algorithm )
+    {
+    case FileHashAlgorithm::Md5:
+        return QStringLiteral("md5");
+    case FileHashAlgorithm::Sha1:
+        return QStringLiteral("sha1");
+    case FileHashAlgorithm::Sha256:
+        return QStringLiteral("sha256");
+    case FileHashAlgorithm::Sha512:
+        return QStringLiteral("sha512");
+    case FileHashAlgorithm::Blake3:
+        return QStringLiteral("blake3");
+    case FileHashAlgorithm::Xxh3:
+        return QStringLiteral("xxh3");
+    }
+    return QStringLiteral("sha256");
+}
+
+bool FileHasher::hashFile(
+    const QString &path,
+    FileHashAlgorithm algorithm,
+    int maxThreads,
+    bool useCache,
+    FileHashResult *result
+)
+{
+    if ( result == nullptr )
+    {
+        return false;
+    }
+
+    const QFileInfo fileInfo(path);
+    result->path = fileInfo.exists() ? fileInfo.absoluteFilePath() : path;
+    result->ok = false;
+    result->cacheHit = false;
+    if ( !fileInfo.exists() )
+    {
+        result->error = QStringLiteral("file does not exist");
+        return false;
+    }
+    if ( !fileInfo.isFile() )
+    {
+        result->error = QStringLiteral("target is not a file");
+        return false;
+    }
+
+    FileIdentity identityBefore;
+    const bool identityKnown = useCache &&
+        FileHashCache::readIdentity(fileInfo.absoluteFilePath(), &identityBefore);
+    if ( identityKnown &&
+         FileHashCache::lookup(
+             algorithmName(algorithm),
+             fileInfo.absoluteFilePath(),
+             identityBefore,
+             &result->digestHex
+         ) )
+    {
+        result->sizeBytes = identityBefore.sizeBytes;
+        result->cacheHit = true;
+        result->ok = true;
+        return true;
+    }
+
+    QFile file(fileInfo.absoluteFilePath());
+    if ( !file.open(QIODevice::ReadOnly) )
+    {
+        result->error = QStringLiteral("failed to open file: %1").arg(file.errorString().trimmed());
+        return false;
+    }
+    const qint64 size = file.size();
+    result->sizeBytes = size;
+
+    QString hashError;
+    bool hashed = false;
+    // Reads are preferred over a mapping, which raises SIGBUS if another process
+    // truncates the file while it is being hashed.
+    if ( evpDigestFor(algorithm) != nullptr )
+    {
+        hashed = digestStream(algorithm, &file, &result->digestHex, &hashError);
+    }
+    else if ( size <= hashBufferedMaxBytes )
+    {
+        const QByteArray content = file.readAll();
+        if ( file.error() != QFile::NoError )
+        {
+            hashError = QStringLiteral("failed to read file: %1").arg(file.errorString().trimmed());
+        }
+        else
+        {
+            // A file that grew or shrank since size() is hashed as read.
+            result->sizeBytes = content.size();
+            hashed = digestBuffer(
+                algorithm,
+                reinterpret_cast<const uchar *>(content.constData()),
+                content.size(),
+                maxThreads,
+                &result->digestHex,
+                &hashError
+            );
+        }
+    }
+    else
+    {
+        uchar *mapped = file.map(0, size);
+        if ( mapped != nullptr )
+        {
+            hashed = digestBuffer(algorithm, mapped, size, maxThreads, &result->digestHex, &hashError);
+            file.unmap(mapped);
+        }
+        else
+        {
+            hashError = QStringLiteral("file could not be mapped for %1").arg(algorithmName(algorithm));
+        }
+    }
+
+    if ( !hashed )
+    {
+        result->digestHex.clear();
+        result->error = hashError;
+        return false;
+    }
+    result->ok = true;
+
+    // Only cache when nothing about the file moved while it was being read.
+    FileIdentity identityAfter;
+    if ( identityKnown &&
+         FileHashCache::readIdentity(fileInfo.absoluteFilePath(), &identityAfter) &&
+         ( identityAfter == identityBefore ) &&
+         ( identityAfter.sizeBytes == result->sizeBytes ) )
+    {
+        FileHashCache::store(
+            algorithmName(algorithm),
+            fileInfo.absoluteFilePath(),
+            identityAfter,
+            result->digestHex
+        );
+    }
+    return true;
+}
+
+QList<FileHashResult> FileHasher::hashFiles(
+    const QStringList &paths,
+    FileHashAlgorithm algorithm,
+    bool useCache,
+    int timeoutMs
+)
+{
+    const QDeadlineTimer deadline = ( timeoutMs >= 0 )
+        ? QDeadlineTimer(timeoutMs)
+        : QDeadlineTimer(QDeadlineTimer::Forever);
+    const int workerCount = qBound(1, QThread::idealThreadCount(), hashMaxWorkers);
+
+    std::vector<FileHashResult> results(static_cast<size_t>(paths.size()));
+    const auto hashAt = [&paths, &results, &deadline, algorithm, useCache](int index, int maxThreads)
+    {
+        FileHashResult &result = results[static_cast<size_t>(index)];
+        if ( deadline.hasExpired() )
+        {
+            result.path = paths.at(index);
+            result.error = QStringLiteral("timed out before hashing");
+            return;
+        }
+        FileHasher::hashFile(paths.at(index), algorithm, maxThreads, useCache, &result);
+    };
+
+    QList<int> largeTreeIndexes;
+    {
+        QThreadPool pool;
+        pool.setMaxThreadCount(workerCount);
+        for ( int index = 0; index < paths.size(); ++index )
+        {
+            if ( ( algorithm == FileHashAlgorithm::Blake3 ) &&
+                 ( QFileInfo(paths.at(index)).size() >= hashParallelBlake3MinBytes ) )
+            {
+                largeTreeIndexes.append(index);
+                continue;
+            }
+            pool.start(
+                [&hashAt, index]()
+                {
+                    hashAt(index, 1);
+                }
+            );
+        }
+        pool.waitForDone();
+    }
+    for ( const int index : largeTreeIndexes )
+    {
+        hashAt(index, workerCount);
+    }
+    if ( useCache )
+    {
+        FileHashCache::flush();
+    }
+
+    return QList<FileHashResult>(results.begin(), results.end());
+}
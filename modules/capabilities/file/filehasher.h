@@ -0,0 +1,59 @@
+#ifndef JQOPENCLAW_CAPABILITIES_FILE_FILEHASHER_H_
+#define JQOPENCLAW_CAPABILITIES_FILE_FILEHASHER_H_
+
+// Qt lib import
+#include <QList>
+#include <QString>
+#include <QStringList>
+
+enum class FileHashAlgorithm
+{
+    Md5,
+    Sha1,
+    Sha256,
+    Sha512,
+    Blake3,
+    Xxh3,
+};
+
+struct FileHashResult
+{
+    QString path;
+    bool ok = false;
+    qint64 sizeBytes = 0;
+    QString digestHex;
+    QString error;
+    bool cacheHit = false;
+};
+
+// Hashes regular files from a read-only mapping (small files are read in one call).
+// md5/sha* go through OpenSSL EVP so hardware SHA extensions are used where present.
+class FileHasher
+{
+public:
+    static bool parseAlgorithm(const QString &name, FileHashAlgorithm *algorithm);
+
+    static QString algorithmName(FileHashAlgorithm algorithm);
+
+    // maxThreads only matters for blake3, whose subtrees can be hashed concurrently.
+    // With useCache the digest is served from / recorded in FileHashCache; call
+    // FileHashCache::flush() afterwards to persist new entries.
+    static bool hashFile(
+        const QString &path,
+        FileHashAlgorithm algorithm,
+        int maxThreads,
+        bool useCache,
+        FileHashResult *result
+    );
+
+    // Results keep the order of paths. Small files are spread over a thread pool; large
+    // blake3 inputs run one at a time with all threads working on their subtrees.
+    static QList<FileHashResult> hashFiles(
+        const QStringList &paths,
+        FileHashAlgorithm algorithm,
+        bool useCache,
+        int timeoutMs
+    );
+};
+
+#endif // JQOPENCLAW_CAPABILITIES_FILE_FILEHASHER_H_
@@ -0,0 +1,275 @@
+// .h include
+#include "capabilities/file/filelineindex.h"
+
+// Qt lib import
+#include <QByteArray>
+#include <QFileInfo>
+#include <QHash>
+#include <QMutex>
+#include <QMutexLocker>
+#include <QVector>
+#include <QtGlobal>
+#include <cstring>
+
+// JQOpenClaw import
+#include "capabilities/file/filehashcache.h"
+
+namespace
+{
+const qint64 lineIndexCheckpointInterval = 4096;
+const qint64 lineIndexMinFileBytes = 1024 * 1024;
+const qint64 lineIndexScanBlockBytes = 4 * 1024 * 1024;
+const int lineIndexMaxEntries = 32;
+const qint64 lineIndexMaxCheckpointBytes = 16 * 1024 * 1024;
+
+struct LineIndexEntry
+{
+    qint64 sizeBytes = 0;
+    FileIdentity identity;
+    // checkpoints[i] is the byte offset of line ( i * interval + 1 ).
+    QVector<qint64> checkpoints;
+    qint64 scannedBytes = 0;
+    qint64 scannedNewlines = 0;
+    quint64 lastUsed = 0;
+};
+
+struct LineIndexCache
+{
+    QHash<QString, LineIndexEntry> entries;
+    qint64 checkpointBytes = 0;
+    quint64 useCounter = 0;
+};
+
+QMutex &lineIndexMutex()
+{
+    static QMutex value;
+    return value;
+}
+
+LineIndexCache &lineIndexCache()
+{
+    static LineIndexCache value;
+    return value;
+}
+
+qint64 entryCheckpointBytes(const LineIndexEntry &entry)
+{
+    return static_cast<qint64>(entry.checkpoints.size()) * static_cast<qint64>(sizeof(qint64));
+}
+
+void evictLineIndexEntries(LineIndexCache *cache, const QString &keepPath)
+{
+    while ( ( cache->entries.size() > lineIndexMaxEntries ) ||
+            ( cache->checkpointBytes > lineIndexMaxCheckpointBytes ) )
+    {
+        QString oldestPath;
+        quint64 oldestUse = 0;
+        for ( auto it = cache->entries.cbegin(); it != cache->entries.cend(); ++it )
+        {
+            if ( it.key() == keepPath )
+            {
+                continue;
+            }
+            if ( oldestPath.isEmpty() || ( it.value().lastUsed < oldestUse ) )
+            {
+                oldestPath = it.key();
+                oldestUse = it.value().lastUsed;
+            }
+        }
+        if ( oldestPath.isEmpty() )
+        {
+            return;
+        }
+        cache->checkpointBytes -= entryCheckpointBytes(cache->entries.value(oldestPath));
+        cache->entries.remove(oldestPath);
+    }
+}
+
+// True when the line before the last checkpoint still ends there, i.e. the indexed
+// prefix was not rewritten in place when the file grew.
+bool lastCheckpointStillValid(QFile *file, const LineIndexEntry &entry)
+{
+    const qint64 lastCheckpoint = entry.checkpoints.last();
+    if ( lastCheckpoint == 0 )
+    {
+        return true;
+    }
+    char previous = 0;
+    return file->seek(lastCheckpoint - 1) && file->getChar(&previous) && ( previous == '\n' );
+}
+
+// Scans forward from entry->scannedBytes until the checkpoint for targetIndex exists or EOF.
+bool extendLineIndex(
+    QFile *file,
+    LineIndexEntry *entry,
+    qint64 targetCheckpointIndex,
+    QString *error
+)
+{
+    if ( !file->seek(entry->scannedBytes) )
+    {
+        if ( error != nullptr )
+        {
+            *error = QStringLiteral("file.read seek failed: %1").arg(file->errorString().trimmed());
+        }
+        return false;
+    }
+
+    QByteArray buffer;
+    buffer.resize(static_cast<int>(lineIndexScanBlockBytes));
+    while ( ( entry->checkpoints.size() <= targetCheckpointIndex ) &&
+            ( entry->scannedBytes < entry->sizeBytes ) )
+    {
+        const qint64 readBytes = file->read(buffer.data(), buffer.size());
+        if ( readBytes < 0 )
+        {
+            if ( error != nullptr )
+            {
+                *error = QStringLiteral("file.read read failed: %1").arg(file->errorString().trimmed());
+            }
+            return false;
+        }
+        if ( readBytes == 0 )
+        {
+            break;
+        }
+
+        const char *begin = buffer.constData();
+        const char *end = begin + readBytes;
+        const char *cursor = begin;
+        while ( cursor < end )
+        {
+            const void *found = std::memchr(cursor, '\n', static_cast<size_t>(end - cursor));
+            if ( found == nullptr )
+            {
+                break;
+            }
+            const char *newline = static_cast<const char *>(found);
+            ++entry->scannedNewlines;
+            if ( ( entry->scannedNewlines % lineIndexCheckpointInterval ) == 0 )
+            {
+                entry->checkpoints.append(entry->scannedBytes + ( newline - begin ) + 1);
+            }
+            cursor = newline + 1;
+        }
+        entry->scannedBytes += readBytes;
+    }
+    return true;
+}
+}
+
+bool FileLineIndex::seekToLine(
+    QFile *file,
+    qint64 targetLine,
+    qint64 *lineAtOffset,
+    QString *error
+)
+{
+    if ( ( file == nullptr ) || ( lineAtOffset == nullptr ) )
+    {
+        if ( error != nullptr )
+        {
+            *error = QStringLiteral("line index output pointer is null");
+        }
+        return false;
+    }
+
+    *lineAtOffset = 1;
+    const qint64 sizeBytes = file->size();
+    if ( ( targetLine <= 1 ) || ( sizeBytes < lineIndexMinFileBytes ) )
+    {
+        return file->seek(0);
+    }
+
+    const QString path = QFileInfo(file->fileName()).absoluteFilePath();
+    FileIdentity identity;
+    const bool identityKnown = FileHashCache::readIdentity(path, &identity);
+    const qint64 targetCheckpointIndex = ( targetLine - 1 ) / lineIndexCheckpointInterval;
+
+    LineIndexEntry entry;
+    {
+        QMutexLocker locker(&lineIndexMutex());
+        LineIndexCache &cache = lineIndexCache();
+        const auto it = cache.entries.constFind(path);
+        if ( it != cache.entries.cend() )
+        {
+            entry = it.value();
+        }
+    }
+
+    // Unchanged files keep their index, and so do appended ones: same device and inode,
+    // larger, and the last checkpoint still starts a line. Anything else is rebuilt.
+    bool reusable = false;
+    if ( identityKnown && !entry.checkpoints.isEmpty() )
+    {
+        if ( identity == entry.identity )
+        {
+            reusable = ( sizeBytes == entry.sizeBytes );
+        }
+        else if ( ( identity.device == entry.identity.device ) &&
+                  ( identity.inode == entry.identity.inode ) &&
+                  ( sizeBytes > entry.sizeBytes ) )
+        {
+            reusable = lastCheckpointStillValid(file, entry);
+        }
+    }
+    if ( !reusable )
+    {
+        entry = LineIndexEntry();
+        entry.checkpoints.append(0);
+    }
+    entry.sizeBytes = sizeBytes;
+    entry.identity = identity;
+
+    if ( entry.checkpoints.size() <= targetCheckpointIndex )
+    {
+        if ( !extendLineIndex(file, &entry, targetCheckpointIndex, error) )
+        {
+            return false;
+        }
+    }
+
+    const qint64 checkpointIndex = qMin(
+        targetCheckpointIndex,
+        static_cast<qint64>(entry.checkpoints.size() - 1)
+    );
+    const qint64 offset = entry.checkpoints.at(static_cast<int>(checkpointIndex));
+
+    {
+        QMutexLocker locker(&lineIndexMutex());
+        LineIndexCache &cache = lineIndexCache();
+        const auto it = cache.entries.constFind(path);
+        if ( it != cache.entries.cend() )
+        {
+            cache.checkpointBytes -= entryCheckpointBytes(it.value());
+        }
+        entry.lastUsed = ++cache.useCounter;
+        cache.checkpointBytes += entryCheckpointBytes(entry);
+        cache.entries.insert(path, entry);
+        evictLineIndexEntries(&cache, path);
+    }
+
+    if ( !file->seek(offset) )
+    {
+        if ( error != nullptr )
+        {
+            *error = QStringLiteral("file.read seek failed: %1").arg(file->errorString().trimmed());
+        }
+        return false;
+    }
+    *lineAtOffset = checkpointIndex * lineIndexCheckpointInterval + 1;
+    return true;
+}
+
+qint64 FileLineIndex::checkpointInterval()
+{
+    return lineIndexCheckpointInterval;
+}
+
+void FileLineIndex::clear()
+{
+    QMutexLocker locker(&lineIndexMutex());
+    LineIndexCache &cache = lineIndexCache();
+    cache.entries.clear();
+    cache.checkpointBytes = 0;
+}
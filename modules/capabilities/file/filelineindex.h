@@ -0,0 +1,27 @@
+#ifndef JQOPENCLAW_CAPABILITIES_FILE_FILELINEINDEX_H_
+#define JQOPENCLAW_CAPABILITIES_FILE_FILELINEINDEX_H_
+
+// Qt lib import
+#include <QFile>
+#include <QString>
+
+// Sparse line-offset index shared by file.read line based operations.
+// One checkpoint is kept every checkpointInterval() lines, keyed by path + device/inode/mtime,
+// extended lazily as callers ask for later lines and kept in a bounded LRU.
+class FileLineIndex
+{
+public:
+    // Positions file at the closest indexed line start at or before targetLine (1-based).
+    // lineAtOffset receives the 1-based number of the line that begins at the new position.
+    static bool seekToLine(
+        QFile *file,
+        qint64 targetLine,
+        qint64 *lineAtOffset,
+        QString *error
+    );
+
+    static qint64 checkpointInterval();
+    static void clear();
+};
+
+#endif // JQOPENCLAW_CAPABILITIES_FILE_FILELINEINDEX_H_
@@ -0,0 +1,544 @@
+// .h include
+#include "capabilities/file/fileremover.h"
+
+// Qt lib import
+#include <QAtomicInteger>
+#include <QByteArray>
+#include <QDeadlineTimer>
+#include <QDebug>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QMutex>
+#include <QMutexLocker>
+#include <QSharedPointer>
+#include <QThreadPool>
+#include <QWaitCondition>
+#include <QtGlobal>
+
+#if defined(Q_OS_UNIX)
+#include <dirent.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#if defined(Q_OS_LINUX)
+#include <sys/syscall.h>
+#endif
+#endif
+
+namespace
+{
+const int removeMaxWorkers = 8;
+const int removeProgressIntervalMs = 5000;
+#if defined(Q_OS_LINUX)
+const int direntBufferBytes = 32 * 1024;
+
+// Layout returned by getdents64; glibc only exposes a wrapper since 2.30.
+struct LinuxDirent64
+{
+    quint64 d_ino;
+    qint64 d_off;
+    unsigned short d_reclen;
+    unsigned char d_type;
+    char d_name[1];
+};
+#endif
+
+struct RemoveDirectoryNode
+{
+    QSharedPointer<RemoveDirectoryNode> parent;
+    QString path;
+#if defined(Q_OS_UNIX)
+    int fd = -1;
+    QByteArray name;
+#endif
+    // One for the node's own listing plus one per subdirectory not finished yet.
+    QAtomicInteger<int> pending;
+    // Something below could not be removed; the directory is then left in place instead
+    // of failing a second time with "directory not empty".
+    QAtomicInteger<int> incomplete;
+};
+
+struct RemoveTreeState
+{
+    QThreadPool pool;
+    QDeadlineTimer deadline;
+#if defined(Q_OS_UNIX)
+    int rootParentFd = -1;
+    dev_t rootDevice = 0;
+#endif
+    QAtomicInteger<qint64> fileCount;
+    QAtomicInteger<qint64> directoryCount;
+    QAtomicInteger<int> queuedCount;
+    QAtomicInteger<int> timedOut;
+
+    // Guards errors and finished.
+    QMutex mutex;
+    QWaitCondition finishedCondition;
+    QList<FileRemoveError> errors;
+    bool finished = false;
+};
+
+void processDirectory(RemoveTreeState *state, const QSharedPointer<RemoveDirectoryNode> &node);
+
+#if defined(Q_OS_UNIX)
+QString errnoString(int errorNumber)
+{
+    return QString::fromLocal8Bit(strerror(errorNumber));
+}
+#endif
+
+QString childPath(const QString &parentPath, const QString &name)
+{
+    if ( parentPath.endsWith(QLatin1Char('/')) )
+    {
+        return parentPath + name;
+    }
+    return parentPath + QLatin1Char('/') + name;
+}
+
+void appendError(
+    RemoveTreeState *state,
+    const QSharedPointer<RemoveDirectoryNode> &node,
+    const QString &path,
+    const QString &error
+)
+{
+    node->incomplete.storeRelaxed(1);
+
+    FileRemoveError entry;
+    entry.path = path;
+    entry.error = error;
+    QMutexLocker locker(&state->mutex);
+    state->errors.append(entry);
+}
+
+bool shouldStop(RemoveTreeState *state)
+{
+    if ( state->timedOut.loadRelaxed() )
+    {
+        return true;
+    }
+    if ( state->deadline.hasExpired() )
+    {
+        state->timedOut.storeRelaxed(1);
+        return true;
+    }
+    return false;
+}
+
+// Drops one pending reference and, for every directory that becomes empty of work on
+// the way up, removes it from its parent.
+void releaseDirectory(RemoveTreeState *state, QSharedPointer<RemoveDirectoryNode> node)
+{
+    while ( !node.isNull() )
+    {
+        if ( node->pending.deref() )
+        {
+            return;
+        }
+
+        const QSharedPointer<RemoveDirectoryNode> parent = node->parent;
+        const bool complete = !node->incomplete.loadRelaxed() && !state->timedOut.loadRelaxed();
+        bool removed = false;
+#if defined(Q_OS_UNIX)
+        ::close(node->fd);
+        node->fd = -1;
+        if ( complete )
+        {
+            const int parentFd = parent.isNull() ? state->rootParentFd : parent->fd;
+            removed = ::unlinkat(parentFd, node->name.constData(), AT_REMOVEDIR) == 0;
+            if ( !removed )
+            {
+                const int removeErrno = errno;
+                appendError(
+                    state,
+                    node,
+                    node->path,
+                    QStringLiteral("remove directory failed: %1").arg(errnoString(removeErrno))
+                );
+            }
+        }
+#else
+        if ( complete )
+        {
+            removed = QDir().rmdir(node->path);
+            if ( !removed )
+            {
+                appendError(state, node, node->path, QStringLiteral("remove directory failed"));
+            }
+        }
+#endif
+        if ( removed )
+        {
+            state->directoryCount.fetchAndAddRelaxed(1);
+        }
+
+        if ( parent.isNull() )
+        {
+            QMutexLocker locker(&state->mutex);
+            state->finished = true;
+            state->finishedCondition.wakeAll();
+            return;
+        }
+        if ( !removed )
+        {
+            parent->incomplete.storeRelaxed(1);
+        }
+        node = parent;
+    }
+}
+
+void scheduleDirectory(RemoveTreeState *state, const QSharedPointer<RemoveDirectoryNode> &node)
+{
+    // Queue only while a worker is likely to pick it up right away; a deep queue would
+    // only hold directory fds open.
+    if ( state->queuedCount.loadRelaxed() < state->pool.maxThreadCount() )
+    {
+        state->queuedCount.ref();
+        state->pool.start(
+            [state, node]()
+            {
+                state->queuedCount.deref();
+                processDirectory(state, node);
+            }
+        );
+        return;
+    }
+    processDirectory(state, node);
+}
+
+#if defined(Q_OS_UNIX)
+void removeEntry(
+    RemoveTreeState *state,
+    const QSharedPointer<RemoveDirectoryNode> &node,
+    const char *name,
+    unsigned char type
+)
+{
+    if ( ( strcmp(name, ".") == 0 ) || ( strcmp(name, "..") == 0 ) )
+    {
+        return;
+    }
+
+    if ( type == DT_UNKNOWN )
+    {
+        struct stat entryStat;
+        if ( ::fstatat(node->fd, name, &entryStat, AT_SYMLINK_NOFOLLOW) != 0 )
+        {
+            const int statErrno = errno;
+            if ( statErrno != ENOENT )
+            {
+                appendError(
+                    state,
+                    node,
+                    childPath(node->path, QFile::decodeName(name)),
+                    QStringLiteral("stat failed: %1").arg(errnoString(statErrno))
+                );
+            }
+            return;
+        }
+        type = S_ISDIR(entryStat.st_mode) ? DT_DIR : DT_REG;
+    }
+
+    if ( type != DT_DIR )
+    {
+        if ( ::unlinkat(node->fd, name, 0) == 0 )
+        {
+            state->fileCount.fetchAndAddRelaxed(1);
+            return;
+        }
+        const int unlinkErrno = errno;
+        if ( unlinkErrno != ENOENT )
+        {
+            appendError(
+                state,
+                node,
+                childPath(node->path, QFile::decodeName(name)),
+                QStringLiteral("remove failed: %1").arg(errnoString(unlinkErrno))
+            );
+        }
+        return;
+    }
+
+    const QString entryPath = childPath(node->path, QFile::decodeName(name));
+    const int childFd = ::openat(node->fd, name, O_RDONLY | O_DIRECTORY | O_NOFOLLOW | O_CLOEXEC);
+    if ( childFd < 0 )
+    {
+        const int openErrno = errno;
+        if ( openErrno != ENOENT )
+        {
+            appendError(
+                state,
+                node,
+                entryPath,
+                QStringLiteral("open directory failed: %1").arg(errnoString(openErrno))
+            );
+        }
+        return;
+    }
+
+    struct stat childStat;
+    if ( ::fstat(childFd, &childStat) != 0 )
+    {
+        const int statErrno = errno;
+        ::close(childFd);
+        appendError(state, node, entryPath, QStringLiteral("stat failed: %1").arg(errnoString(statErrno)));
+        return;
+    }
+    if ( childStat.st_dev != state->rootDevice )
+    {
+        ::close(childFd);
+        appendError(state, node, entryPath, QStringLiteral("mount point of another filesystem, not descended into"));
+        return;
+    }
+
+    QSharedPointer<RemoveDirectoryNode> child(new RemoveDirectoryNode);
+    child->parent = node;
+    child->path = entryPath;
+    child->fd = childFd;
+    child->name = QByteArray(name);
+    child->pending.storeRelaxed(1);
+    node->pending.ref();
+    scheduleDirectory(state, child);
+}
+#else
+void removeEntry(
+    RemoveTreeState *state,
+    const QSharedPointer<RemoveDirectoryNode> &node,
+    const QFileInfo &entryInfo
+)
+{
+    const QString entryPath = entryInfo.absoluteFilePath();
+    const bool isLink = entryInfo.isSymbolicLink() || entryInfo.isJunction();
+    if ( entryInfo.isDir() && !isLink )
+    {
+        QSharedPointer<RemoveDirectoryNode> child(new RemoveDirectoryNode);
+        child->parent = node;
+        child->path = entryPath;
+        child->pending.storeRelaxed(1);
+        node->pending.ref();
+        scheduleDirectory(state, child);
+        return;
+    }
+
+    bool removed = false;
+    if ( entryInfo.isDir() )
+    {
+        // Directory link or junction: remove the link, never its target.
+        removed = QDir().rmdir(entryPath);
+    }
+    else
+    {
+        QFile file(entryPath);
+        removed = file.remove();
+        if ( !removed )
+        {
+            // Read-only files cannot be deleted on Windows until the attribute is cleared.
+            file.setPermissions(file.permissions() | QFileDevice::WriteUser);
+            removed = file.remove();
+        }
+    }
+
+    if ( removed )
+    {
+        state->fileCount.fetchAndAddRelaxed(1);
+        return;
+    }
+    appendError(state, node, entryPath, QStringLiteral("remove failed"));
+}
+#endif
+
+void processDirectory(RemoveTreeState *state, const QSharedPointer<RemoveDirectoryNode> &node)
+{
+#if defined(Q_OS_LINUX)
+    QByteArray buffer(direntBufferBytes, Qt::Uninitialized);
+    while ( !shouldStop(state) )
+    {
+        const long readBytes = ::syscall(SYS_getdents64, node->fd, buffer.data(), buffer.size());
+        if ( readBytes == 0 )
+        {
+            break;
+        }
+        if ( readBytes < 0 )
+        {
+            const int readErrno = errno;
+            if ( readErrno == EINTR )
+            {
+                continue;
+            }
+            appendError(
+                state,
+                node,
+                node->path,
+                QStringLiteral("read directory failed: %1").arg(errnoString(readErrno))
+            );
+            break;
+        }
+
+        for ( long offset = 0; offset < readBytes; )
+        {
+            const LinuxDirent64 *entry = reinterpret_cast<const LinuxDirent64 *>(buffer.constData() + offset);
+            offset += entry->d_reclen;
+            removeEntry(state, node, entry->d_name, entry->d_type);
+        }
+    }
+#elif defined(Q_OS_UNIX)
+    // fdopendir takes ownership of the fd it is given; the node keeps its own for unlinkat.
+    const int listFd = ::dup(node->fd);
+    DIR *directory = ( listFd >= 0 ) ? ::fdopendir(listFd) : nullptr;
+    if ( directory == nullptr )
+    {
+        const int openErrno = errno;
+        if ( listFd >= 0 )
+        {
+            ::close(listFd);
+        }
+        appendError(
+            state,
+            node,
+            node->path,
+            QStringLiteral("read directory failed: %1").arg(errnoString(openErrno))
+        );
+    }
+    else
+    {
+        while ( !shouldStop(state) )
+        {
+            errno = 0;
+            const struct dirent *entry = ::readdir(directory);
+            if ( entry == nullptr )
+            {
+                const int readErrno = errno;
+                if ( readErrno != 0 )
+                {
+                    appendError(
+                        state,
+                        node,
+                        node->path,
+                        QStringLiteral("read directory failed: %1").arg(errnoString(readErrno))
+                    );
+                }
+                break;
+            }
+            removeEntry(state, node, entry->d_name, entry->d_type);
+        }
+        ::closedir(directory);
+    }
+#else
+    const QFileInfoList entries = QDir(node->path).entryInfoList(
+        QDir::AllEntries | QDir::NoDotAndDotDot | QDir::Hidden | QDir::System
+    );
+    for ( const QFileInfo &entryInfo : entries )
+    {
+        if ( shouldStop(state) )
+        {
+            break;
+        }
+        removeEntry(state, node, entryInfo);
+    }
+#endif
+
+    releaseDirectory(state, node);
+}
+
+void logProgress(const QString &directoryPath, RemoveTreeState &state)
+{
+    qInfo().noquote() << QStringLiteral(
+        "[capability.file.write] remove progress path=%1 files=%2 directories=%3 errors=%4"
+    ).arg(
+        directoryPath,
+        QString::number(state.fileCount.loadRelaxed()),
+        QString::number(state.directoryCount.loadRelaxed()),
+        QString::number(state.errors.size())
+    );
+}
+}
+
+bool FileRemover::removeTree(
+    const QString &directoryPath,
+    const FileRemoveOptions &options,
+    FileRemoveSummary *summary,
+    QString *error
+)
+{
+    *summary = FileRemoveSummary();
+    const QFileInfo rootInfo(directoryPath);
+    const QString rootPath = rootInfo.absoluteFilePath();
+
+    RemoveTreeState state;
+    state.deadline = ( options.timeoutMs >= 0 )
+        ? QDeadlineTimer(options.timeoutMs)
+        : QDeadlineTimer(QDeadlineTimer::Forever);
+    state.pool.setMaxThreadCount(removeMaxWorkers);
+
+    QSharedPointer<RemoveDirectoryNode> root(new RemoveDirectoryNode);
+    root->path = rootPath;
+    root->pending.storeRelaxed(1);
+
+#if defined(Q_OS_UNIX)
+    state.rootParentFd = ::open(
+        QFile::encodeName(rootInfo.absolutePath()).constData(),
+        O_RDONLY | O_DIRECTORY | O_CLOEXEC
+    );
+    if ( state.rootParentFd < 0 )
+    {
+        *error = QStringLiteral("open parent directory failed: %1").arg(errnoString(errno));
+        return false;
+    }
+    root->name = QFile::encodeName(rootInfo.fileName());
+    root->fd = ::openat(state.rootParentFd, root->name.constData(), O_RDONLY | O_DIRECTORY | O_NOFOLLOW | O_CLOEXEC);
+    struct stat rootStat;
+    if ( ( root->fd < 0 ) || ( ::fstat(root->fd, &rootStat) != 0 ) )
+    {
+        *error = QStringLiteral("open directory failed: %1").arg(errnoString(errno));
+        if ( root->fd >= 0 )
+        {
+            ::close(root->fd);
+        }
+        ::close(state.rootParentFd);
+        return false;
+    }
+    state.rootDevice = rootStat.st_dev;
+#else
+    if ( !rootInfo.isDir() || rootInfo.isSymbolicLink() || rootInfo.isJunction() )
+    {
+        *error = QStringLiteral("target is not a directory");
+        return false;
+    }
+#endif
+
+    summary->workerCount = removeMaxWorkers;
+    state.queuedCount.ref();
+    state.pool.start(
+        [&state, root]()
+        {
+            state.queuedCount.deref();
+            processDirectory(&state, root);
+        }
+    );
+
+    {
+        QMutexLocker locker(&state.mutex);
+        while ( !state.finished )
+        {
+            if ( !state.finishedCondition.wait(&state.mutex, removeProgressIntervalMs) )
+            {
+                logProgress(rootPath, state);
+            }
+        }
+    }
+    state.pool.waitForDone();
+
+#if defined(Q_OS_UNIX)
+    ::close(state.rootParentFd);
+#endif
+
+    summary->fileCount = state.fileCount.loadRelaxed();
+    summary->directoryCount = state.directoryCount.loadRelaxed();
+    summary->timedOut = state.timedOut.loadRelaxed() != 0;
+    summary->errors = state.errors;
+    return true;
+}
@@ -0,0 +1,50 @@
+#ifndef JQOPENCLAW_CAPABILITIES_FILE_FILEREMOVER_H_
+#define JQOPENCLAW_CAPABILITIES_FILE_FILEREMOVER_H_
+
+// Qt lib import
+#include <QList>
+#include <QString>
+
+struct FileRemoveOptions
+{
+    int timeoutMs = -1;
+};
+
+struct FileRemoveError
+{
+    QString path;
+    QString error;
+};
+
+struct FileRemoveSummary
+{
+    // Non-directory entries (files, symlinks, special files) unlinked.
+    qint64 fileCount = 0;
+    // Including the root once it is gone.
+    qint64 directoryCount = 0;
+    bool timedOut = false;
+    int workerCount = 0;
+    QList<FileRemoveError> errors;
+};
+
+// Permanent recursive delete. On Unix every entry is read (getdents64 on Linux) and
+// unlinked relative to its parent's directory fd, so there is no per-entry path lookup
+// and a directory swapped for a symlink mid-walk is never followed; other filesystems
+// mounted below the root are not descended into. Subdirectories are handed to a worker
+// pool while it has idle threads and removed depth-first on the current thread
+// otherwise, which keeps the number of open fds bounded by the tree depth.
+class FileRemover
+{
+public:
+    // directoryPath must be a directory, not a link to one. Entries that cannot be
+    // removed go to summary->errors and their ancestors are left in place; false only
+    // when the root cannot be opened.
+    static bool removeTree(
+        const QString &directoryPath,
+        const FileRemoveOptions &options,
+        FileRemoveSummary *summary,
+        QString *error
+    );
+};
+
+#endif // JQOPENCLAW_CAPABILITIES_FILE_FILEREMOVER_H_
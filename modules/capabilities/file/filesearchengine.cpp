@@ -0,0 +1,978 @@
+// .h include
+#include "capabilities/file/filesearchengine.h"
+
+// Qt lib import
+#include <QAtomicInteger>
+#include <QByteArray>
+#include <QDateTime>
+#include <QDeadlineTimer>
+#include <QDir>
+#include <QDirIterator>
+#include <QFile>
+#include <QFileInfo>
+#include <QMutex>
+#include <QMutexLocker>
+#include <QRegularExpression>
+#include <QStringView>
+#include <QThread>
+#include <QThreadPool>
+#include <QtAlgorithms>
+#include <QtGlobal>
+
+// JQOpenClaw import
+#include "capabilities/file/fileworkqueue.h"
+
+// C++ lib import
+#include <algorithm>
+#include <cstring>
+#include <memory>
+#include <vector>
+
+#if defined(__SSE2__) || defined(_M_X64) || defined(_M_AMD64) || ( defined(_M_IX86_FP) && ( _M_IX86_FP >= 2 ) )
+#define JQOPENCLAW_FILESEARCH_SSE2
+#include <emmintrin.h>
+#endif
+
+namespace
+{
+const qint64 searchBinaryProbeBytes = 8192;
+// Files are read and matched in windows of whole lines of about this size, so memory
+// stays bounded whatever the file size; a single line longer than the cap is split.
+const qint64 searchWindowBytes = 1024 * 1024;
+const qint64 searchMaxLineBytes = 16 * 1024 * 1024;
+const int searchMaxWorkers = 16;
+
+char asciiLower(char value)
+{
+    return ( ( value >= 'A' ) && ( value <= 'Z' ) ) ? static_cast<char>( value - 'A' + 'a' ) : value;
+}
+
+char asciiUpper(char value)
+{
+    return ( ( value >= 'a' ) && ( value <= 'z' ) ) ? static_cast<char>( value - 'a' + 'A' ) : value;
+}
+
+bool isAsciiOnly(const QByteArray &bytes)
+{
+    for ( const char value : bytes )
+    {
+        if ( static_cast<uchar>(value) >= 0x80 )
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool hasRegexMetaCharacters(const QString &pattern)
+{
+    static const QString metaCharacters = QStringLiteral("\\.^$|?*+()[]{}");
+    for ( const QChar ch : pattern )
+    {
+        if ( metaCharacters.contains(ch) )
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+bool equalsAt(const char *data, const QByteArray &needle, bool foldCase)
+{
+    if ( !foldCase )
+    {
+        return std::memcmp(data, needle.constData(), static_cast<size_t>(needle.size())) == 0;
+    }
+    for ( qsizetype index = 0; index < needle.size(); ++index )
+    {
+        if ( asciiLower(data[index]) != needle.at(index) )
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+// Finds needle in data[from, size). With foldCase the needle must already be ASCII lower case.
+qint64 findLiteral(
+    const char *data,
+    qint64 size,
+    qint64 from,
+    const QByteArray &needle,
+    bool foldCase
+)
+{
+    const qint64 needleSize = needle.size();
+    if ( ( needleSize <= 0 ) || ( ( size - from ) < needleSize ) )
+    {
+        return -1;
+    }
+
+    const qint64 lastStart = size - needleSize;
+    qint64 position = from;
+
+#ifdef JQOPENCLAW_FILESEARCH_SSE2
+    // Compare the first and last needle byte across 16 candidate positions at once and
+    // only verify positions where both agree.
+    const char firstByte = needle.at(0);
+    const char lastByte = needle.at(needleSize - 1);
+    const __m128i firstLower = _mm_set1_epi8(firstByte);
+    const __m128i firstUpper = _mm_set1_epi8(foldCase ? asciiUpper(firstByte) : firstByte);
+    const __m128i lastLower = _mm_set1_epi8(lastByte);
+    const __m128i lastUpper = _mm_set1_epi8(foldCase ? asciiUpper(lastByte) : lastByte);
+    while ( ( position + 15 ) <= lastStart )
+    {
+        const __m128i blockFirst = _mm_loadu_si128(reinterpret_cast<const __m128i *>(data + position));
+        const __m128i blockLast = _mm_loadu_si128(
+            reinterpret_cast<const __m128i *>(data + position + needleSize - 1)
+        );
+        const __m128i firstHit = _mm_or_si128(
+            _mm_cmpeq_epi8(blockFirst, firstLower),
+            _mm_cmpeq_epi8(blockFirst, firstUpper)
+        );
+        const __m128i lastHit = _mm_or_si128(
+            _mm_cmpeq_epi8(blockLast, lastLower),
+            _mm_cmpeq_epi8(blockLast, lastUpper)
+        );
+        quint32 mask = static_cast<quint32>(_mm_movemask_epi8(_mm_and_si128(firstHit, lastHit)));
+        while ( mask != 0 )
+        {
+            const qint64 candidate = position + qCountTrailingZeroBits(mask);
+            if ( equalsAt(data + candidate, needle, foldCase) )
+            {
+                return candidate;
+            }
+            mask &= ( mask - 1 );
+        }
+        position += 16;
+    }
+#endif
+
+    if ( !foldCase )
+    {
+        while ( position <= lastStart )
+        {
+            const void *found = std::memchr(
+                data + position,
+                needle.at(0),
+                static_cast<size_t>(lastStart - position + 1)
+            );
+            if ( found == nullptr )
+            {
+                return -1;
+            }
+            const qint64 candidate = static_cast<const char *>(found) - data;
+            if ( equalsAt(data + candidate, needle, false) )
+            {
+                return candidate;
+            }
+            position = candidate + 1;
+        }
+        return -1;
+    }
+
+    for ( ; position <= lastStart; ++position )
+    {
+        if ( equalsAt(data + position, needle, true) )
+        {
+            return position;
+        }
+    }
+    return -1;
+}
+
+qint64 utf8LengthOf(QStringView text)
+{
+    qint64 length = 0;
+    for ( qsizetype index = 0; index < text.size(); ++index )
+    {
+        const char16_t ch = text.at(index).unicode();
+        if ( ch < 0x80 )
+        {
+            length += 1;
+        }
+        else if ( ch < 0x800 )
+        {
+            length += 2;
+        }
+        else if ( QChar::isHighSurrogate(ch) &&
+                  ( ( index + 1 ) < text.size() ) &&
+                  text.at(index + 1).isLowSurrogate() )
+        {
+            length += 4;
+            ++index;
+        }
+        else
+        {
+            length += 3;
+        }
+    }
+    return length;
+}
+
+qint64 countNewlines(const char *data, qint64 size)
+{
+    qint64 count = 0;
+    const char *cursor = data;
+    const char *end = data + size;
+    while ( cursor < end )
+    {
+        const void *found = std::memchr(cursor, '\n', static_cast<size_t>(end - cursor));
+        if ( found == nullptr )
+        {
+            break;
+        }
+        ++count;
+        cursor = static_cast<const char *>(found) + 1;
+    }
+    return count;
+}
+
+class ContentMatcher
+{
+public:
+    bool prepare(const FileSearchOptions &options, QString *error)
+    {
+        const QByteArray patternBytes = options.pattern.toUtf8();
+        const bool plainText = options.literal || !hasRegexMetaCharacters(options.pattern);
+        if ( plainText && ( options.caseSensitive || isAsciiOnly(patternBytes) ) )
+        {
+            useLiteral_ = true;
+            foldCase_ = !options.caseSensitive;
+            needle_ = patternBytes;
+            if ( foldCase_ )
+            {
+                for ( char &value : needle_ )
+                {
+                    value = asciiLower(value);
+                }
+            }
+            return true;
+        }
+
+        QRegularExpression::PatternOptions patternOptions =
+            QRegularExpression::MultilineOption |
+            QRegularExpression::UseUnicodePropertiesOption;
+        if ( !options.caseSensitive )
+        {
+            patternOptions |= QRegularExpression::CaseInsensitiveOption;
+        }
+        regex_ = QRegularExpression(
+            options.literal ? QRegularExpression::escape(options.pattern) : options.pattern,
+            patternOptions
+        );
+        if ( !regex_.isValid() )
+        {
+            if ( error != nullptr )
+            {
+                *error = QStringLiteral("invalid search pattern: %1").arg(regex_.errorString());
+            }
+            return false;
+        }
+        regex_.optimize();
+        return true;
+    }
+
+    // Invokes onMatch(byteStart, byteEnd) for every match in one window of whole lines;
+    // onMatch returns false to stop. A regex match spanning two windows is not found.
+    template <typename Callback>
+    void scan(const char *data, qint64 size, Callback &&onMatch) const
+    {
+        if ( useLiteral_ )
+        {
+            qint64 position = 0;
+            while ( true )
+            {
+                const qint64 found = findLiteral(data, size, position, needle_, foldCase_);
+                if ( found < 0 )
+                {
+                    return;
+                }
+                if ( !onMatch(found, found + needle_.size()) )
+                {
+                    return;
+                }
+                position = found + needle_.size();
+            }
+        }
+
+        scanRegex(data, size, onMatch);
+    }
+
+private:
+    // Offsets are mapped back to bytes incrementally; invalid UTF-8 sequences can shift
+    // columns slightly because they decode to U+FFFD.
+    template <typename Callback>
+    void scanRegex(const char *data, qint64 size, Callback &onMatch) const
+    {
+        const QString text = QString::fromUtf8(data, static_cast<qsizetype>(size));
+        const QStringView textView(text);
+        QRegularExpressionMatchIterator iterator = regex_.globalMatch(text);
+        qsizetype mappedUtf16 = 0;
+        qint64 mappedBytes = 0;
+        while ( iterator.hasNext() )
+        {
+            const QRegularExpressionMatch match = iterator.next();
+            const qsizetype start = match.capturedStart();
+            const qsizetype end = match.capturedEnd();
+            mappedBytes += utf8LengthOf(textView.mid(mappedUtf16, start - mappedUtf16));
+            mappedUtf16 = start;
+            const qint64 byteEnd = mappedBytes + utf8LengthOf(textView.mid(start, end - start));
+            if ( !onMatch(mappedBytes, byteEnd) )
+            {
+                return;
+            }
+        }
+    }
+
+    bool useLiteral_ = false;
+    bool foldCase_ = false;
+    QByteArray needle_;
+    QRegularExpression regex_;
+};
+
+QString gitIgnoreGlobToRegex(const QString &glob)
+{
+    QString regex = QStringLiteral("^");
+    qsizetype index = 0;
+    while ( index < glob.size() )
+    {
+        const QChar ch = glob.at(index);
+        if ( glob.mid(index, 3) == QStringLiteral("**/") )
+        {
+            regex += QStringLiteral("(?:.*/)?");
+            index += 3;
+            continue;
+        }
+        if ( glob.mid(index, 2) == QStringLiteral("**") )
+        {
+            regex += QStringLiteral(".*");
+            index += 2;
+            continue;
+        }
+        if ( ch == QLatin1Char('*') )
+        {
+            regex += QStringLiteral("[^/]*");
+        }
+        else if ( ch == QLatin1Char('?') )
+        {
+            regex += QStringLiteral("[^/]");
+        }
+        else if ( ch == QLatin1Char('[') )
+        {
+            const qsizetype close = glob.indexOf(QLatin1Char(']'), index + 1);
+            if ( close < 0 )
+            {
+                regex += QStringLiteral("\\[");
+            }
+            else
+            {
+                QString charClass = glob.mid(index + 1, close - index - 1);
+                if ( charClass.startsWith(QLatin1Char('!')) )
+                {
+                    charClass[0] = QLatin1Char('^');
+                }
+                charClass.replace(QStringLiteral("\\"), QStringLiteral("\\\\"));
+                regex += QLatin1Char('[') + charClass + QLatin1Char(']');
+                index = close;
+            }
+        }
+        else if ( ( ch == QLatin1Char('\\') ) && ( ( index + 1 ) < glob.size() ) )
+        {
+            ++index;
+            regex += QRegularExpression::escape(glob.mid(index, 1));
+        }
+        else
+        {
+            regex += QRegularExpression::escape(QString(ch));
+        }
+        ++index;
+    }
+    regex += QLatin1Char('$');
+    return regex;
+}
+
+struct IgnoreRule
+{
+    QRegularExpression regex;
+    bool negated = false;
+    bool directoryOnly = false;
+    bool matchRelativePath = false;
+};
+
+struct IgnoreRuleSet
+{
+    std::shared_ptr<const IgnoreRuleSet> parent;
+    QString baseDirectory;
+    QList<IgnoreRule> rules;
+
+    // 1 = ignored, -1 = re-included by a negated rule, 0 = no rule applies.
+    int decide(const QString &path, const QString &name, bool isDirectory) const
+    {
+        const QString relativePath = path.mid(baseDirectory.size() + 1);
+        for ( qsizetype index = rules.size() - 1; index >= 0; --index )
+        {
+            const IgnoreRule &rule = rules.at(index);
+            if ( rule.directoryOnly && !isDirectory )
+            {
+                continue;
+            }
+            if ( rule.regex.match(rule.matchRelativePath ? relativePath : name).hasMatch() )
+            {
+                return rule.negated ? -1 : 1;
+            }
+        }
+        return 0;
+    }
+};
+
+std::shared_ptr<const IgnoreRuleSet> loadGitIgnore(
+    const QString &directoryPath,
+    const std::shared_ptr<const IgnoreRuleSet> &parent
+)
+{
+    QFile file(directoryPath + QStringLiteral("/.gitignore"));
+    if ( !file.open(QIODevice::ReadOnly) )
+    {
+        return parent;
+    }
+
+    QRegularExpression::PatternOptions patternOptions = QRegularExpression::NoPatternOption;
+#if defined(Q_OS_WIN) || defined(Q_OS_MACOS)
+    patternOptions |= QRegularExpression::CaseInsensitiveOption;
+#endif
+
+    auto ruleSet = std::make_shared<IgnoreRuleSet>();
+    ruleSet->parent = parent;
+    ruleSet->baseDirectory = directoryPath;
+    const QList<QByteArray> rawLines = file.readAll().split('\n');
+    for ( const QByteArray &rawLine : rawLines )
+    {
+        QString line = QString::fromUtf8(rawLine);
+        while ( line.endsWith(QLatin1Char('\r')) ||
+                ( line.endsWith(QLatin1Char(' ')) && !line.endsWith(QStringLiteral("\\ ")) ) )
+        {
+            line.chop(1);
+        }
+        if ( line.isEmpty() || line.startsWith(QLatin1Char('#')) )
+        {
+            continue;
+        }
+
+        IgnoreRule rule;
+        if ( line.startsWith(QLatin1Char('!')) )
+        {
+            rule.negated = true;
+            line.remove(0, 1);
+        }
+        else if ( line.startsWith(QStringLiteral("\\!")) || line.startsWith(QStringLiteral("\\#")) )
+        {
+            line.remove(0, 1);
+        }
+        if ( line.endsWith(QLatin1Char('/')) )
+        {
+            rule.directoryOnly = true;
+            line.chop(1);
+        }
+        rule.matchRelativePath = line.contains(QLatin1Char('/'));
+        if ( line.startsWith(QLatin1Char('/')) )
+        {
+            line.remove(0, 1);
+        }
+        if ( line.isEmpty() )
+        {
+            continue;
+        }
+
+        rule.regex = QRegularExpression(gitIgnoreGlobToRegex(line), patternOptions);
+        if ( rule.regex.isValid() )
+        {
+            ruleSet->rules.append(rule);
+        }
+    }
+
+    if ( ruleSet->rules.isEmpty() )
+    {
+        return parent;
+    }
+    return ruleSet;
+}
+
+bool isIgnoredPath(
+    const std::shared_ptr<const IgnoreRuleSet> &ruleSet,
+    const QString &path,
+    const QString &name,
+    bool isDirectory
+)
+{
+    // Deeper .gitignore files take precedence over their parents.
+    for ( const IgnoreRuleSet *current = ruleSet.get(); current != nullptr; current = current->parent.get() )
+    {
+        const int decision = current->decide(path, name, isDirectory);
+        if ( decision != 0 )
+        {
+            return decision > 0;
+        }
+    }
+    return false;
+}
+
+struct SearchTask
+{
+    QString path;
+    bool isDirectory = false;
+    qint64 sizeBytes = 0;
+    qint64 modifiedMs = 0;
+    std::shared_ptr<const IgnoreRuleSet> ignoreRules;
+};
+
+struct SearchState
+{
+    const FileSearchOptions *options = nullptr;
+    bool collectOnly = false;
+    ContentMatcher matcher;
+    std::unique_ptr<FileWorkQueue<SearchTask>> queue;
+    QAtomicInteger<qint64> reservedMatches = 0;
+    QAtomicInteger<qint64> filesScanned = 0;
+    QAtomicInteger<qint64> bytesScanned = 0;
+    QAtomicInteger<qint64> binaryFilesSkipped = 0;
+    // Checked between the windows and matches of a file scan; the queue is stopped at the same time.
+    QAtomicInt stopRequested = 0;
+    QAtomicInt truncated = 0;
+    QAtomicInt timedOut = 0;
+    QDeadlineTimer deadline;
+    QMutex resultMutex;
+    QList<FileSearchMatch> matches;
+    QList<FileSearchEntry> files;
+};
+
+void requestStop(SearchState *state)
+{
+    state->stopRequested.storeRelaxed(1);
+    state->queue->stop();
+}
+
+// Also turns an expired deadline into a stop, so a long file scan ends promptly.
+bool shouldStopSearch(SearchState *state)
+{
+    if ( state->stopRequested.loadRelaxed() != 0 )
+    {
+        return true;
+    }
+    if ( state->deadline.hasExpired() )
+    {
+        state->timedOut.storeRelaxed(1);
+        requestStop(state);
+        return true;
+    }
+    return false;
+}
+
+// Matches one window of whole lines; *lineNumber is the number of its first line on entry
+// and of the line after it on return. Returns false once the search has to stop.
+bool searchWindow(
+    SearchState *state,
+    const QString &displayPath,
+    const char *data,
+    qint64 size,
+    qint64 *lineNumber,
+    QList<FileSearchMatch> *fileMatches
+)
+{
+    bool keepGoing = true;
+    qint64 countedUpTo = 0;
+    state->matcher.scan(
+        data,
+        size,
+        [&](qint64 byteStart, qint64 byteEnd) -> bool
+        {
+            if ( shouldStopSearch(state) )
+            {
+                keepGoing = false;
+                return false;
+            }
+            if ( state->reservedMatches.fetchAndAddRelaxed(1) >= state->options->maxMatches )
+            {
+                state->truncated.storeRelaxed(1);
+                requestStop(state);
+                keepGoing = false;
+                return false;
+            }
+
+            *lineNumber += countNewlines(data + countedUpTo, byteStart - countedUpTo);
+            countedUpTo = byteStart;
+
+            qint64 lineStart = byteStart;
+            while ( ( lineStart > 0 ) && ( data[lineStart - 1] != '\n' ) )
+            {
+                --lineStart;
+            }
+            const void *newline = std::memchr(
+                data + byteStart,
+                '\n',
+                static_cast<size_t>(size - byteStart)
+            );
+            const qint64 lineEnd = ( newline != nullptr )
+                ? ( static_cast<const char *>(newline) - data )
+                : size;
+            qint64 lineTextEnd = lineEnd;
+            while ( ( lineTextEnd > lineStart ) && ( data[lineTextEnd - 1] == '\r' ) )
+            {
+                --lineTextEnd;
+            }
+            const qint64 clippedEnd = qMin(byteEnd, lineEnd);
+
+            FileSearchMatch match;
+            match.path = displayPath;
+            match.lineNumber = *lineNumber;
+            match.columnStart = byteStart - lineStart + 1;
+            match.columnEnd = qMax(clippedEnd - lineStart, match.columnStart - 1);
+            match.lineText = QString::fromUtf8(data + lineStart, static_cast<qsizetype>(lineTextEnd - lineStart));
+            match.matchText = QString::fromUtf8(
+                data + byteStart,
+                static_cast<qsizetype>(qMax<qint64>(clippedEnd - byteStart, 0))
+            );
+            fileMatches->append(match);
+            return true;
+        }
+    );
+    *lineNumber += countNewlines(data + countedUpTo, size - countedUpTo);
+    return keepGoing;
+}
+
+// The file is read rather than mapped, so one truncated by another process while it is
+// being searched just reads short instead of raising SIGBUS.
+void searchFileContent(SearchState *state, const QString &path)
+{
+    QFile file(path);
+    if ( !file.open(QIODevice::ReadOnly) || ( file.size() <= 0 ) )
+    {
+        return;
+    }
+
+    const QString displayPath = QDir::toNativeSeparators(path);
+    QList<FileSearchMatch> fileMatches;
+    QByteArray pending;
+    qint64 lineNumber = 1;
+    bool firstChunk = true;
+    while ( !shouldStopSearch(state) )
+    {
+        const QByteArray chunk = file.read(searchWindowBytes);
+        const bool atEnd = chunk.isEmpty();
+        if ( firstChunk )
+        {
+            if ( atEnd )
+            {
+                return;
+            }
+            firstChunk = false;
+            state->filesScanned.fetchAndAddRelaxed(1);
+            const size_t probeBytes = static_cast<size_t>(qMin<qint64>(chunk.size(), searchBinaryProbeBytes));
+            if ( std::memchr(chunk.constData(), '\0', probeBytes) != nullptr )
+            {
+                state->bytesScanned.fetchAndAddRelaxed(chunk.size());
+                state->binaryFilesSkipped.fetchAndAddRelaxed(1);
+                return;
+            }
+        }
+        state->bytesScanned.fetchAndAddRelaxed(chunk.size());
+        pending.append(chunk);
+
+        // Hold back an unfinished last line until the rest of it has been read.
+        qint64 windowSize = pending.size();
+        if ( !atEnd )
+        {
+            const qsizetype lastNewline = pending.lastIndexOf('\n');
+            if ( lastNewline >= 0 )
+            {
+                windowSize = lastNewline + 1;
+            }
+            else if ( pending.size() < searchMaxLineBytes )
+            {
+                continue;
+            }
+        }
+
+        if ( ( windowSize > 0 ) &&
+             !searchWindow(state, displayPath, pending.constData(), windowSize, &lineNumber, &fileMatches) )
+        {
+            break;
+        }
+        if ( atEnd )
+        {
+            break;
+        }
+        pending.remove(0, static_cast<qsizetype>(windowSize));
+    }
+
+    if ( !fileMatches.isEmpty() )
+    {
+        QMutexLocker locker(&state->resultMutex);
+        state->matches.append(fileMatches);
+    }
+}
+
+void expandDirectory(SearchState *state, int workerIndex, const SearchTask &task)
+{
+    std::shared_ptr<const IgnoreRuleSet> ignoreRules = task.ignoreRules;
+    if ( state->options->respectGitIgnore )
+    {
+        ignoreRules = loadGitIgnore(task.path, ignoreRules);
+    }
+
+    QDir::Filters filters = QDir::Dirs | QDir::Files | QDir::NoDotAndDotDot | QDir::NoSymLinks;
+    if ( state->options->includeHidden )
+    {
+        filters |= QDir::Hidden | QDir::System;
+    }
+
+    QDirIterator iterator(task.path, filters);
+    while ( iterator.hasNext() )
+    {
+        iterator.next();
+        const QFileInfo entryInfo = iterator.fileInfo();
+        const QString name = entryInfo.fileName();
+        if ( name == QStringLiteral(".git") )
+        {
+            continue;
+        }
+        if ( !state->options->includeHidden && name.startsWith(QLatin1Char('.')) )
+        {
+            continue;
+        }
+
+        const bool isDirectory = entryInfo.isDir();
+        const QString path = entryInfo.absoluteFilePath();
+        if ( ignoreRules && isIgnoredPath(ignoreRules, path, name, isDirectory) )
+        {
+            continue;
+        }
+
+        SearchTask child;
+        child.path = path;
+        child.isDirectory = isDirectory;
+        child.ignoreRules = ignoreRules;
+        if ( state->collectOnly && !isDirectory )
+        {
+            child.sizeBytes = entryInfo.size();
+            child.modifiedMs = entryInfo.lastModified().toMSecsSinceEpoch();
+        }
+        state->queue->push(workerIndex, std::move(child));
+    }
+}
+
+void runSearchWorker(SearchState *state, int workerIndex)
+{
+    SearchTask task;
+    while ( state->queue->take(workerIndex, &task) )
+    {
+        if ( task.isDirectory )
+        {
+            expandDirectory(state, workerIndex, task);
+        }
+        else if ( state->collectOnly )
+        {
+            FileSearchEntry entry;
+            entry.path = task.path;
+            entry.sizeBytes = task.sizeBytes;
+            entry.modifiedMs = task.modifiedMs;
+            QMutexLocker locker(&state->resultMutex);
+            state->files.append(entry);
+        }
+        else
+        {
+            searchFileContent(state, task.path);
+        }
+        state->queue->finish();
+        shouldStopSearch(state);
+    }
+}
+
+void runWorkers(
+    SearchState &state,
+    const QList<SearchTask> &seedTasks,
+    const FileSearchOptions &options
+)
+{
+    state.options = &options;
+    state.deadline = ( options.timeoutMs >= 0 )
+        ? QDeadlineTimer(options.timeoutMs)
+        : QDeadlineTimer(QDeadlineTimer::Forever);
+
+    const int workerCount = qBound(1, QThread::idealThreadCount(), searchMaxWorkers);
+    state.queue = std::make_unique<FileWorkQueue<SearchTask>>(workerCount);
+    for ( int index = 0; index < seedTasks.size(); ++index )
+    {
+        state.queue->push(index % workerCount, seedTasks.at(index));
+    }
+
+    QThreadPool pool;
+    pool.setMaxThreadCount(workerCount);
+    for ( int index = 0; index < workerCount; ++index )
+    {
+        pool.start(
+            [&state, index]()
+            {
+                runSearchWorker(&state, index);
+            }
+        );
+    }
+    pool.waitForDone();
+}
+
+bool runSearch(
+    const QList<SearchTask> &seedTasks,
+    const FileSearchOptions &options,
+    FileSearchResult *result,
+    QString *error
+)
+{
+    if ( result == nullptr )
+    {
+        if ( error != nullptr )
+        {
+            *error = QStringLiteral("search result output pointer is null");
+        }
+        return false;
+    }
+
+    SearchState state;
+    if ( !state.matcher.prepare(options, error) )
+    {
+        return false;
+    }
+    runWorkers(state, seedTasks, options);
+
+    // Workers finish in arbitrary order; sort so identical queries give identical output.
+    std::sort(
+        state.matches.begin(),
+        state.matches.end(),
+        [](const FileSearchMatch &left, const FileSearchMatch &right)
+        {
+            if ( left.path != right.path )
+            {
+                return left.path < right.path;
+            }
+            if ( left.lineNumber != right.lineNumber )
+            {
+                return left.lineNumber < right.lineNumber;
+            }
+            return left.columnStart < right.columnStart;
+        }
+    );
+
+    result->matches = state.matches;
+    result->truncated = ( state.truncated.loadRelaxed() != 0 );
+    result->filesScanned = state.filesScanned.loadRelaxed();
+    result->bytesScanned = state.bytesScanned.loadRelaxed();
+    result->binaryFilesSkipped = state.binaryFilesSkipped.loadRelaxed();
+    result->timedOut = ( state.timedOut.loadRelaxed() != 0 );
+    return true;
+}
+}
+
+bool FileSearchEngine::validatePattern(const FileSearchOptions &options, QString *error)
+{
+    ContentMatcher matcher;
+    return matcher.prepare(options, error);
+}
+
+bool FileSearchEngine::search(
+    const QString &rootPath,
+    const FileSearchOptions &options,
+    FileSearchResult *result,
+    QString *error
+)
+{
+    const QFileInfo rootInfo(rootPath);
+    if ( !rootInfo.exists() )
+    {
+        if ( error != nullptr )
+        {
+            *error = QStringLiteral("search path does not exist");
+        }
+        return false;
+    }
+
+    SearchTask rootTask;
+    rootTask.path = rootInfo.absoluteFilePath();
+    rootTask.isDirectory = rootInfo.isDir();
+    return runSearch(QList<SearchTask>() << rootTask, options, result, error);
+}
+
+bool FileSearchEngine::searchFiles(
+    const QStringList &filePaths,
+    const FileSearchOptions &options,
+    FileSearchResult *result,
+    QString *error
+)
+{
+    QList<SearchTask> tasks;
+    tasks.reserve(filePaths.size());
+    for ( const QString &filePath : filePaths )
+    {
+        SearchTask task;
+        task.path = filePath;
+        task.isDirectory = false;
+        tasks.append(task);
+    }
+    return runSearch(tasks, options, result, error);
+}
+
+bool FileSearchEngine::collectFiles(
+    const QString &rootPath,
+    const FileSearchOptions &options,
+    QList<FileSearchEntry> *files,
+    QString *error
+)
+{
+    if ( files == nullptr )
+    {
+        if ( error != nullptr )
+        {
+            *error = QStringLiteral("search file list output pointer is null");
+        }
+        return false;
+    }
+
+    const QFileInfo rootInfo(rootPath);
+    if ( !rootInfo.isDir() )
+    {
+        if ( error != nullptr )
+        {
+            *error = QStringLiteral("search root is not a directory");
+        }
+        return false;
+    }
+
+    SearchTask rootTask;
+    rootTask.path = rootInfo.absoluteFilePath();
+    rootTask.isDirectory = true;
+
+    SearchState state;
+    state.collectOnly = true;
+    runWorkers(state, QList<SearchTask>() << rootTask, options);
+    if ( state.timedOut.loadRelaxed() != 0 )
+    {
+        // A partial file list would silently drop files from the index.
+        if ( error != nullptr )
+        {
+            *error = QStringLiteral("search timed out");
+        }
+        return false;
+    }
+    *files = state.files;
+    return true;
+}
+
+QJsonObject FileSearchEngine::matchToJson(const FileSearchMatch &match)
+{
+    QJsonObject matchItem;
+    matchItem.insert(QStringLiteral("path"), match.path);
+    matchItem.insert(QStringLiteral("lineNumber"), match.lineNumber);
+    matchItem.insert(QStringLiteral("columnStart"), match.columnStart);
+    matchItem.insert(QStringLiteral("columnEnd"), match.columnEnd);
+    matchItem.insert(QStringLiteral("lineText"), match.lineText);
+    matchItem.insert(QStringLiteral("matchText"), match.matchText);
+    return matchItem;
+}
@@ -0,0 +1,85 @@
+#ifndef JQOPENCLAW_CAPABILITIES_FILE_FILESEARCHENGINE_H_
+#define JQOPENCLAW_CAPABILITIES_FILE_FILESEARCHENGINE_H_
+
+// Qt lib import
+#include <QJsonObject>
+#include <QList>
+#include <QString>
+#include <QStringList>
+
+struct FileSearchOptions
+{
+    QString pattern;
+    bool caseSensitive = false;
+    bool includeHidden = false;
+    bool literal = false;
+    bool respectGitIgnore = true;
+    qint64 maxMatches = 200;
+    int timeoutMs = -1;
+};
+
+// Columns are 1-based byte offsets within the line, matching rg --json submatches.
+struct FileSearchMatch
+{
+    QString path;
+    qint64 lineNumber = 0;
+    qint64 columnStart = 1;
+    qint64 columnEnd = 1;
+    QString lineText;
+    QString matchText;
+};
+
+struct FileSearchEntry
+{
+    QString path;
+    qint64 sizeBytes = 0;
+    qint64 modifiedMs = 0;
+};
+
+struct FileSearchResult
+{
+    QList<FileSearchMatch> matches;
+    bool truncated = false;
+    qint64 filesScanned = 0;
+    qint64 bytesScanned = 0;
+    qint64 binaryFilesSkipped = 0;
+    // The deadline expired; matches holds what was found up to then.
+    bool timedOut = false;
+};
+
+// In-process replacement for rg: a parallel work-stealing walker reading files in line windows,
+// an SSE2 literal scanner and JIT compiled QRegularExpression for everything else.
+class FileSearchEngine
+{
+public:
+    static bool validatePattern(const FileSearchOptions &options, QString *error);
+
+    // rootPath may be a directory (walked, honoring hidden/.gitignore rules) or a single file.
+    static bool search(
+        const QString &rootPath,
+        const FileSearchOptions &options,
+        FileSearchResult *result,
+        QString *error
+    );
+
+    // Searches exactly the given files, without hidden or ignore filtering.
+    static bool searchFiles(
+        const QStringList &filePaths,
+        const FileSearchOptions &options,
+        FileSearchResult *result,
+        QString *error
+    );
+
+    // Walks rootPath with the same hidden/.gitignore rules as search() and returns the files
+    // that would be searched, without reading their content.
+    static bool collectFiles(
+        const QString &rootPath,
+        const FileSearchOptions &options,
+        QList<FileSearchEntry> *files,
+        QString *error
+    );
+
+    static QJsonObject matchToJson(const FileSearchMatch &match);
+};
+
+#endif // JQOPENCLAW_CAPABILITIES_FILE_FILESEARCHENGINE_H_
@@ -0,0 +1,273 @@
+// .h include
+#include "capabilities/file/filetailreader.h"
+
+// Qt lib import
+#include <QByteArray>
+#include <QFile>
+#include <QList>
+
+// JQOpenClaw import
+#include "capabilities/file/filehashcache.h"
+#include "crypto/digest/xxh3digest.h"
+
+// C++ lib import
+#include <algorithm>
+
+namespace
+{
+const qint64 tailBlockBytes = 64 * 1024;
+const qint64 tailProbeBytes = FileTailCursor::maxProbeBytes;
+
+QString lineText(const char *data, qint64 size)
+{
+    if ( ( size > 0 ) && ( data[size - 1] == '\r' ) )
+    {
+        --size;
+    }
+    return QString::fromUtf8(data, static_cast<qsizetype>(size));
+}
+
+bool readRange(QFile *file, qint64 offset, qint64 size, QByteArray *bytes, QString *error)
+{
+    if ( !file->seek(offset) )
+    {
+        *error = QStringLiteral("seek failed: %1").arg(file->errorString().trimmed());
+        return false;
+    }
+    *bytes = file->read(size);
+    if ( ( bytes->size() < size ) && ( file->error() != QFileDevice::NoError ) )
+    {
+        *error = QStringLiteral("read failed: %1").arg(file->errorString().trimmed());
+        return false;
+    }
+    return true;
+}
+
+bool probeChecksum(QFile *file, qint64 offset, qint64 probeBytes, quint64 *checksum, QString *error)
+{
+    QByteArray probe;
+    if ( !readRange(file, offset - probeBytes, probeBytes, &probe, error) )
+    {
+        return false;
+    }
+    *checksum = Xxh3Digest::hash64(probe.constData(), probe.size());
+    return true;
+}
+
+bool fillCursor(
+    QFile *file,
+    const FileIdentity &identity,
+    qint64 offset,
+    FileTailCursor *cursor,
+    QString *error
+)
+{
+    cursor->device = identity.device;
+    cursor->inode = identity.inode;
+    cursor->offsetBytes = offset;
+    cursor->probeBytes = qMin(offset, tailProbeBytes);
+    cursor->probeXxh3 = 0;
+    if ( cursor->probeBytes == 0 )
+    {
+        return true;
+    }
+    return probeChecksum(file, offset, cursor->probeBytes, &cursor->probeXxh3, error);
+}
+
+bool openForTail(
+    const QString &absolutePath,
+    QFile *file,
+    FileIdentity *identity,
+    QString *error
+)
+{
+    file->setFileName(absolutePath);
+    if ( !file->open(QIODevice::ReadOnly) )
+    {
+        *error = QStringLiteral("open failed: %1").arg(file->errorString().trimmed());
+        return false;
+    }
+    if ( !FileHashCache::readIdentity(absolutePath, identity) )
+    {
+        *error = QStringLiteral("failed to stat file");
+        return false;
+    }
+    return true;
+}
+}
+
+bool FileTailReader::last(
+    const QString &absolutePath,
+    qint64 lineCount,
+    qint64 maxBytes,
+    FileTailResult *result,
+    QString *error
+)
+{
+    QFile file;
+    FileIdentity identity;
+    if ( !openForTail(absolutePath, &file, &identity, error) )
+    {
+        return false;
+    }
+    const qint64 size = file.size();
+    *result = FileTailResult();
+    result->sizeBytes = size;
+
+    // Pull blocks backwards until lineCount + 1 newlines (the last line's terminator plus
+    // one boundary per line) are in hand, or the byte budget or file start is reached.
+    QList<QByteArray> blocks;
+    qint64 windowStart = size;
+    qint64 newlineCount = 0;
+    while ( ( windowStart > 0 ) &&
+            ( newlineCount <= lineCount ) &&
+            ( ( size - windowStart ) < maxBytes ) )
+    {
+        const qint64 blockStart = qMax<qint64>(0, qMax(windowStart - tailBlockBytes, size - maxBytes));
+        QByteArray block;
+        if ( !readRange(&file, blockStart, windowStart - blockStart, &block, error) )
+        {
+            return false;
+        }
+        if ( block.isEmpty() )
+        {
+            break;
+        }
+        newlineCount += std::count(block.cbegin(), block.cend(), '\n');
+        windowStart -= block.size();
+        blocks.prepend(block);
+    }
+
+    QByteArray window;
+    window.reserve(static_cast<qsizetype>(size - windowStart));
+    for ( const QByteArray &block : blocks )
+    {
+        window.append(block);
+    }
+
+    const qsizetype lastNewline = window.lastIndexOf('\n');
+    if ( lastNewline < 0 )
+    {
+        // No line ends inside the budget; whatever is there is still being written.
+        result->partialLine = lineText(window.constData(), window.size());
+        result->truncated = windowStart > 0;
+        result->startOffsetBytes = windowStart;
+        return fillCursor(&file, identity, windowStart, &result->cursor, error);
+    }
+
+    result->partialLine = lineText(window.constData() + lastNewline + 1, window.size() - lastNewline - 1);
+
+    QStringList reversedLines;
+    qsizetype lineEnd = lastNewline;
+    qsizetype firstLineStart = lastNewline;
+    while ( reversedLines.size() < lineCount )
+    {
+        const qsizetype previousNewline = ( lineEnd > 0 ) ? window.lastIndexOf('\n', lineEnd - 1) : -1;
+        if ( previousNewline < 0 )
+        {
+            // The first line in the window only counts when it really starts the file;
+            // otherwise it was cut by the budget and is kept only if nothing else fits.
+            if ( ( windowStart == 0 ) || reversedLines.isEmpty() )
+            {
+                reversedLines.append(lineText(window.constData(), lineEnd));
+                firstLineStart = 0;
+            }
+            result->truncated = windowStart > 0;
+            break;
+        }
+        reversedLines.append(lineText(window.constData() + previousNewline + 1, lineEnd - previousNewline - 1));
+        firstLineStart = previousNewline + 1;
+        lineEnd = previousNewline;
+    }
+    std::reverse(reversedLines.begin(), reversedLines.end());
+    result->lines = reversedLines;
+    result->startOffsetBytes = windowStart + firstLineStart;
+    return fillCursor(&file, identity, windowStart + lastNewline + 1, &result->cursor, error);
+}
+
+bool FileTailReader::follow(
+    const QString &absolutePath,
+    const FileTailCursor &cursor,
+    qint64 lineCount,
+    qint64 maxBytes,
+    FileTailResult *result,
+    QString *error
+)
+{
+    QFile file;
+    FileIdentity identity;
+    if ( !openForTail(absolutePath, &file, &identity, error) )
+    {
+        return false;
+    }
+    const qint64 size = file.size();
+    *result = FileTailResult();
+    result->sizeBytes = size;
+
+    qint64 offset = cursor.offsetBytes;
+    if ( ( identity.device != cursor.device ) || ( identity.inode != cursor.inode ) )
+    {
+        result->reset = QStringLiteral("rotated");
+    }
+    else if ( size < offset )
+    {
+        result->reset = QStringLiteral("truncated");
+    }
+    else if ( cursor.probeBytes > 0 )
+    {
+        quint64 probe = 0;
+        if ( !probeChecksum(&file, offset, cursor.probeBytes, &probe, error) )
+        {
+            return false;
+        }
+        if ( probe != cursor.probeXxh3 )
+        {
+            result->reset = QStringLiteral("truncated");
+        }
+    }
+    if ( !result->reset.isEmpty() )
+    {
+        offset = 0;
+    }
+
+    QByteArray window;
+    if ( !readRange(&file, offset, qMin(maxBytes, size - offset), &window, error) )
+    {
+        return false;
+    }
+    const bool windowReachesEof = ( offset + window.size() ) >= size;
+
+    qsizetype consumed = 0;
+    while ( result->lines.size() < lineCount )
+    {
+        const qsizetype newline = window.indexOf('\n', consumed);
+        if ( newline < 0 )
+        {
+            break;
+        }
+        result->lines.append(lineText(window.constData() + consumed, newline - consumed));
+        consumed = newline + 1;
+    }
+
+    if ( result->lines.size() < lineCount )
+    {
+        if ( windowReachesEof )
+        {
+            result->partialLine = lineText(window.constData() + consumed, window.size() - consumed);
+        }
+        else
+        {
+            result->truncated = true;
+            if ( result->lines.isEmpty() )
+            {
+                // A single line longer than the budget: hand it out in budget-sized pieces
+                // rather than stalling the follower forever.
+                result->lines.append(lineText(window.constData(), window.size()));
+                consumed = window.size();
+            }
+        }
+    }
+    result->hasMore = result->partialLine.isEmpty() && ( ( offset + consumed ) < size );
+    result->startOffsetBytes = offset;
+    return fillCursor(&file, identity, offset + consumed, &result->cursor, error);
+}
@@ -0,0 +1,65 @@
+#ifndef JQOPENCLAW_CAPABILITIES_FILE_FILETAILREADER_H_
+#define JQOPENCLAW_CAPABILITIES_FILE_FILETAILREADER_H_
+
+// Qt lib import
+#include <QString>
+#include <QStringList>
+
+// Where a follower stopped: the file it was reading and the offset just past the last
+// line it returned, plus a checksum of the bytes before that offset so a file that was
+// truncated and then grew back past the offset is still noticed.
+struct FileTailCursor
+{
+    // probeBytes is never more than this; a decoded cursor claiming more is invalid.
+    static constexpr qint64 maxProbeBytes = 64;
+
+    quint64 device = 0;
+    quint64 inode = 0;
+    qint64 offsetBytes = 0;
+    qint64 probeBytes = 0;
+    quint64 probeXxh3 = 0;
+};
+
+struct FileTailResult
+{
+    qint64 sizeBytes = 0;
+    qint64 startOffsetBytes = 0;
+    // Complete lines without their line terminators ("\n" or "\r\n").
+    QStringList lines;
+    // Bytes after the last newline; not consumed, so they come back once completed.
+    QString partialLine;
+    // Fewer lines than requested because of the byte budget.
+    bool truncated = false;
+    bool hasMore = false;
+    // Set by follow() when the cursor no longer applied: "rotated" or "truncated".
+    QString reset;
+    FileTailCursor cursor;
+};
+
+class FileTailReader
+{
+public:
+    // The last lineCount lines, found by scanning backwards from EOF in blocks, so the
+    // cost is bounded by the bytes returned rather than the file size.
+    static bool last(
+        const QString &absolutePath,
+        qint64 lineCount,
+        qint64 maxBytes,
+        FileTailResult *result,
+        QString *error
+    );
+
+    // Lines appended since cursor. A different file at the path (rotation), or a file
+    // now shorter than the cursor or with different bytes before it (truncation),
+    // restarts from offset 0 and sets result->reset.
+    static bool follow(
+        const QString &absolutePath,
+        const FileTailCursor &cursor,
+        qint64 lineCount,
+        qint64 maxBytes,
+        FileTailResult *result,
+        QString *error
+    );
+};
+
+#endif // JQOPENCLAW_CAPABILITIES_FILE_FILETAILREADER_H_
@@ -0,0 +1,322 @@
+// .h include
+#include "capabilities/file/filetransfersession.h"
+
+// Qt lib import
+#include <QByteArray>
+#include <QDateTime>
+#include <QFile>
+#include <QHash>
+#include <QMutex>
+#include <QMutexLocker>
+#include <QSharedPointer>
+#include <QStringList>
+#include <QUuid>
+
+// JQOpenClaw import
+#include "capabilities/file/filehashcache.h"
+#include "capabilities/file/filehasher.h"
+#include "common/base64codec.h"
+#include "crypto/digest/xxh3digest.h"
+
+namespace
+{
+const int transferMaxSessions = 32;
+
+struct TransferSession
+{
+    FileTransferInfo info;
+    FileIdentity identity;
+    // Chunks are read on demand rather than through a long-lived mapping, so a source
+    // truncated behind our back shows up as a short read instead of a SIGBUS.
+    QFile file;
+    // Guards the seek + read pair on file; everything else in a chunk is done outside it.
+    QMutex fileMutex;
+    qint64 expiresAtMs = 0;
+    // Set for files the session generated itself; removed with the session.
+    QString ownedPath;
+
+    ~TransferSession()
+    {
+        file.close();
+        if ( !ownedPath.isEmpty() )
+        {
+            QFile::remove(ownedPath);
+        }
+    }
+};
+
+struct TransferState
+{
+    QMutex mutex;
+    QHash<QString, QSharedPointer<TransferSession>> sessions;
+};
+
+TransferState &transferState()
+{
+    static TransferState value;
+    return value;
+}
+
+// Caller holds state.mutex.
+void pruneExpired(TransferState &state, qint64 nowMs)
+{
+    for ( auto it = state.sessions.begin(); it != state.sessions.end(); )
+    {
+        if ( ( *it )->expiresAtMs <= nowMs )
+        {
+            it = state.sessions.erase(it);
+        }
+        else
+        {
+            ++it;
+        }
+    }
+}
+
+// Caller holds state.mutex. info.path, sizeBytes, chunkBytes and chunkCount never
+// change after open, so they may be read without it. Looks the session up and extends its lifetime.
+QSharedPointer<TransferSession> touchSession(
+    TransferState &state,
+    const QString &transferId,
+    qint64 nowMs,
+    QString *error
+)
+{
+    pruneExpired(state, nowMs);
+    const QSharedPointer<TransferSession> session = state.sessions.value(transferId);
+    if ( session.isNull() )
+    {
+        *error = QStringLiteral("transfer %1 does not exist or has expired").arg(transferId);
+        return session;
+    }
+    session->expiresAtMs = nowMs + session->info.ttlMs;
+    return session;
+}
+
+bool applyAck(TransferSession *session, qint64 ackedChunks, QString *error)
+{
+    if ( ackedChunks < 0 )
+    {
+        return true;
+    }
+    if ( ackedChunks > session->info.chunkCount )
+    {
+        *error = QStringLiteral("ackSeq must be within [0, %1]").arg(session->info.chunkCount);
+        return false;
+    }
+    session->info.ackedChunks = qMax(session->info.ackedChunks, ackedChunks);
+    return true;
+}
+
+FileTransferInfo snapshotInfo(const TransferSession &session, qint64 nowMs)
+{
+    FileTransferInfo info = session.info;
+    info.expiresInMs = qMax<qint64>(0, session.expiresAtMs - nowMs);
+    return info;
+}
+}
+
+bool FileTransferSession::open(
+    const QString &absolutePath,
+    qint64 chunkBytes,
+    qint64 ttlMs,
+    int hashTimeoutMs,
+    FileTransferInfo *info,
+    QString *error,
+    bool deleteOnClose
+)
+{
+    QSharedPointer<TransferSession> session(new TransferSession);
+    if ( deleteOnClose )
+    {
+        session->ownedPath = absolutePath;
+    }
+    if ( !FileHashCache::readIdentity(absolutePath, &session->identity) )
+    {
+        *error = QStringLiteral("failed to stat file");
+        return false;
+    }
+
+    // Hashing can take a while on a cold cache, so it runs before the session is
+    // registered; the identity check below catches a file that changed meanwhile.
+    QString sha256;
+    if ( hashTimeoutMs >= 0 )
+    {
+        const FileHashResult hashResult = FileHasher::hashFiles(
+            QStringList() << absolutePath,
+            FileHashAlgorithm::Sha256,
+            // A generated file is hashed once and deleted afterwards; no point caching it.
+            !deleteOnClose,
+            hashTimeoutMs
+        ).first();
+        if ( !hashResult.ok )
+        {
+            *error = QStringLiteral("failed to hash file: %1").arg(hashResult.error);
+            return false;
+        }
+        sha256 = hashResult.digestHex;
+    }
+
+    session->file.setFileName(absolutePath);
+    if ( !session->file.open(QIODevice::ReadOnly) )
+    {
+        *error = QStringLiteral("failed to open file: %1").arg(session->file.errorString().trimmed());
+        return false;
+    }
+    FileIdentity identityAfter;
+    if ( !FileHashCache::readIdentity(absolutePath, &identityAfter) ||
+         ( identityAfter != session->identity ) )
+    {
+        *error = QStringLiteral("file changed while the transfer was being opened");
+        return false;
+    }
+
+    const qint64 sizeBytes = session->identity.sizeBytes;
+    const qint64 nowMs = QDateTime::currentMSecsSinceEpoch();
+    session->info.transferId = QUuid::createUuid().toString(QUuid::WithoutBraces);
+    session->info.path = absolutePath;
+    session->info.sizeBytes = sizeBytes;
+    session->info.chunkBytes = chunkBytes;
+    session->info.chunkCount = ( sizeBytes + chunkBytes - 1 ) / chunkBytes;
+    session->info.sha256 = sha256;
+    session->info.ttlMs = ttlMs;
+    session->expiresAtMs = nowMs + ttlMs;
+
+    TransferState &state = transferState();
+    QMutexLocker locker(&state.mutex);
+    pruneExpired(state, nowMs);
+    if ( state.sessions.size() >= transferMaxSessions )
+    {
+        *error = QStringLiteral("too many open transfers (max %1); close finished ones first")
+            .arg(transferMaxSessions);
+        return false;
+    }
+    state.sessions.insert(session->info.transferId, session);
+    *info = snapshotInfo(*session, nowMs);
+    return true;
+}
+
+bool FileTransferSession::read(
+    const QString &transferId,
+    qint64 firstSeq,
+    qint64 count,
+    qint64 maxBytes,
+    qint64 ackedChunks,
+    QList<FileTransferChunk> *chunks,
+    FileTransferInfo *info,
+    QString *error
+)
+{
+    const qint64 nowMs = QDateTime::currentMSecsSinceEpoch();
+    TransferState &state = transferState();
+
+    // The process-wide lock only covers the bookkeeping; reading, hashing and encoding
+    // run on the session's own reference so other transfers are not held up.
+    QSharedPointer<TransferSession> session;
+    qint64 startSeq = 0;
+    {
+        QMutexLocker locker(&state.mutex);
+        session = touchSession(state, transferId, nowMs, error);
+        if ( session.isNull() || !applyAck(session.data(), ackedChunks, error) )
+        {
+            return false;
+        }
+        startSeq = ( firstSeq < 0 ) ? session->info.nextSeq : firstSeq;
+    }
+
+    FileIdentity identity;
+    if ( !FileHashCache::readIdentity(session->info.path, &identity) ||
+         ( identity != session->identity ) )
+    {
+        *error = QStringLiteral("source file changed since the transfer was opened");
+        return false;
+    }
+    if ( startSeq > session->info.chunkCount )
+    {
+        *error = QStringLiteral("seq must be within [0, %1]").arg(session->info.chunkCount);
+        return false;
+    }
+
+    chunks->clear();
+    const qint64 lastSeq = qMin(session->info.chunkCount, startSeq + count);
+    qint64 endSeq = startSeq;
+    qint64 batchBytes = 0;
+    for ( ; endSeq < lastSeq; ++endSeq )
+    {
+        FileTransferChunk chunk;
+        chunk.seq = endSeq;
+        chunk.offsetBytes = endSeq * session->info.chunkBytes;
+        chunk.sizeBytes = qMin(session->info.chunkBytes, session->info.sizeBytes - chunk.offsetBytes);
+        if ( !chunks->isEmpty() && ( ( batchBytes + chunk.sizeBytes ) > maxBytes ) )
+        {
+            break;
+        }
+        batchBytes += chunk.sizeBytes;
+
+        QByteArray buffer;
+        {
+            QMutexLocker fileLocker(&session->fileMutex);
+            if ( !session->file.seek(chunk.offsetBytes) )
+            {
+                *error = QStringLiteral("seek failed: %1").arg(session->file.errorString().trimmed());
+                return false;
+            }
+            buffer = session->file.read(chunk.sizeBytes);
+        }
+        if ( buffer.size() != chunk.sizeBytes )
+        {
+            *error = QStringLiteral("short read at offset %1; source file changed since the transfer was opened")
+                .arg(chunk.offsetBytes);
+            return false;
+        }
+
+        const uchar *data = reinterpret_cast<const uchar *>(buffer.constData());
+        chunk.xxh3 = QStringLiteral("%1").arg(Xxh3Digest::hash64(data, chunk.sizeBytes), 16, 16, QLatin1Char('0'));
+        chunk.contentBase64 = Base64Codec::toBase64String(data, chunk.sizeBytes);
+        chunks->append(chunk);
+    }
+
+    QMutexLocker locker(&state.mutex);
+    session->info.servedChunks += chunks->size();
+    session->info.servedBytes += batchBytes;
+    session->info.nextSeq = qMax(session->info.nextSeq, endSeq);
+
+    *info = snapshotInfo(*session, nowMs);
+    return true;
+}
+
+bool FileTransferSession::status(
+    const QString &transferId,
+    qint64 ackedChunks,
+    FileTransferInfo *info,
+    QString *error
+)
+{
+    const qint64 nowMs = QDateTime::currentMSecsSinceEpoch();
+    TransferState &state = transferState();
+    QMutexLocker locker(&state.mutex);
+    const QSharedPointer<TransferSession> session = touchSession(state, transferId, nowMs, error);
+    if ( session.isNull() || !applyAck(session.data(), ackedChunks, error) )
+    {
+        return false;
+    }
+    *info = snapshotInfo(*session, nowMs);
+    return true;
+}
+
+bool FileTransferSession::close(const QString &transferId, FileTransferInfo *info, QString *error)
+{
+    const qint64 nowMs = QDateTime::currentMSecsSinceEpoch();
+    TransferState &state = transferState();
+    QMutexLocker locker(&state.mutex);
+    pruneExpired(state, nowMs);
+    const QSharedPointer<TransferSession> session = state.sessions.take(transferId);
+    if ( session.isNull() )
+    {
+        *error = QStringLiteral("transfer %1 does not exist or has expired").arg(transferId);
+        return false;
+    }
+    *info = snapshotInfo(*session, nowMs);
+    info->expiresInMs = 0;
+    return true;
+}
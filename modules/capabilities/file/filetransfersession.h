@@ -0,0 +1,81 @@
+#ifndef JQOPENCLAW_CAPABILITIES_FILE_FILETRANSFERSESSION_H_
+#define JQOPENCLAW_CAPABILITIES_FILE_FILETRANSFERSESSION_H_
+
+// Qt lib import
+#include <QList>
+#include <QString>
+
+struct FileTransferInfo
+{
+    QString transferId;
+    QString path;
+    qint64 sizeBytes = 0;
+    qint64 chunkBytes = 0;
+    qint64 chunkCount = 0;
+    // Empty when the transfer was opened without hashing.
+    QString sha256;
+    // Chunks [0, ackedChunks) were confirmed by the reader; a resumed pull starts there.
+    qint64 ackedChunks = 0;
+    // One past the highest chunk served so far.
+    qint64 nextSeq = 0;
+    qint64 servedChunks = 0;
+    qint64 servedBytes = 0;
+    qint64 ttlMs = 0;
+    qint64 expiresInMs = 0;
+};
+
+struct FileTransferChunk
+{
+    qint64 seq = 0;
+    qint64 offsetBytes = 0;
+    qint64 sizeBytes = 0;
+    QString xxh3;
+    QString contentBase64;
+};
+
+// Read-side transfer sessions: the source file is opened once and then served as
+// numbered fixed-size chunks read on demand, so a reader can keep several chunk requests
+// in flight and pick up again from its last acknowledged chunk after a reconnect.
+// Sessions live in the node process and expire after ttlMs without any call.
+class FileTransferSession
+{
+public:
+    // hashTimeoutMs < 0 skips the end-to-end sha256. With deleteOnClose the session owns
+    // absolutePath (a generated file such as an archive) and removes it once closed or
+    // expired, including when open itself fails.
+    static bool open(
+        const QString &absolutePath,
+        qint64 chunkBytes,
+        qint64 ttlMs,
+        int hashTimeoutMs,
+        FileTransferInfo *info,
+        QString *error,
+        bool deleteOnClose = false
+    );
+
+    // Serves up to count chunks from firstSeq (< 0 continues at info.nextSeq), stopping
+    // early rather than exceeding maxBytes unless a single chunk already does.
+    // ackedChunks < 0 leaves the acknowledgement unchanged. Fails once the source file
+    // no longer matches what was opened.
+    static bool read(
+        const QString &transferId,
+        qint64 firstSeq,
+        qint64 count,
+        qint64 maxBytes,
+        qint64 ackedChunks,
+        QList<FileTransferChunk> *chunks,
+        FileTransferInfo *info,
+        QString *error
+    );
+
+    static bool status(
+        const QString &transferId,
+        qint64 ackedChunks,
+        FileTransferInfo *info,
+        QString *error
+    );
+
+    static bool close(const QString &transferId, FileTransferInfo *info, QString *error);
+};
+
+#endif // JQOPENCLAW_CAPABILITIES_FILE_FILETRANSFERSESSION_H_
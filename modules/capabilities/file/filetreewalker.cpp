@@ -0,0 +1,617 @@
+// .h include
+#include "capabilities/file/filetreewalker.h"
+
+// Qt lib import
+#include <QAtomicInteger>
+#include <QDeadlineTimer>
+#include <QDir>
+#include <QDirIterator>
+#include <QFile>
+#include <QFileInfo>
+#include <QThread>
+#include <QThreadPool>
+#include <QtGlobal>
+
+// JQOpenClaw import
+#include "capabilities/file/fileworkqueue.h"
+
+// C++ lib import
+#include <algorithm>
+#include <memory>
+#include <vector>
+
+#if defined(Q_OS_LINUX)
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#elif defined(Q_OS_WIN)
+#include <windows.h>
+#endif
+
+namespace
+{
+const int treeWalkMaxWorkers = 16;
+#if defined(Q_OS_LINUX)
+const size_t treeWalkDirentBufferBytes = 64 * 1024;
+#endif
+
+enum class TreeEntryKind
+{
+    File,
+    Directory,
+    Other,
+};
+
+struct TreeEntry
+{
+    QString name;
+    TreeEntryKind kind = TreeEntryKind::Other;
+    qint64 sizeBytes = 0;
+};
+
+#if defined(Q_OS_LINUX)
+struct LinuxDirent64
+{
+    quint64 d_ino;
+    qint64 d_off;
+    unsigned short d_reclen;
+    unsigned char d_type;
+    char d_name[1];
+};
+
+bool statTreeEntry(int directoryFd, const char *name, TreeEntryKind *kind, qint64 *sizeBytes)
+{
+    mode_t mode = 0;
+#if defined(STATX_BASIC_STATS)
+    struct statx info;
+    if ( statx(
+            directoryFd,
+            name,
+            AT_SYMLINK_NOFOLLOW | AT_STATX_DONT_SYNC,
+            STATX_TYPE | STATX_SIZE,
+            &info
+        ) != 0 )
+    {
+        return false;
+    }
+    mode = info.stx_mode;
+    *sizeBytes = static_cast<qint64>(info.stx_size);
+#else
+    struct stat info;
+    if ( fstatat(directoryFd, name, &info, AT_SYMLINK_NOFOLLOW) != 0 )
+    {
+        return false;
+    }
+    mode = info.st_mode;
+    *sizeBytes = static_cast<qint64>(info.st_size);
+#endif
+
+    if ( S_ISREG(mode) )
+    {
+        *kind = TreeEntryKind::File;
+    }
+    else if ( S_ISDIR(mode) )
+    {
+        *kind = TreeEntryKind::Directory;
+    }
+    else
+    {
+        *kind = TreeEntryKind::Other;
+    }
+    return true;
+}
+
+template <typename Callback>
+bool listTreeDirectory(const QString &directoryPath, bool includeHidden, Callback &&callback)
+{
+    const int directoryFd = ::open(
+        QFile::encodeName(directoryPath).constData(),
+        O_RDONLY | O_DIRECTORY | O_CLOEXEC
+    );
+    if ( directoryFd < 0 )
+    {
+        return false;
+    }
+
+    thread_local std::vector<char> buffer(treeWalkDirentBufferBytes);
+    for ( ;; )
+    {
+        const long readBytes = syscall(SYS_getdents64, directoryFd, buffer.data(), buffer.size());
+        if ( readBytes <= 0 )
+        {
+            break;
+        }
+
+        for ( long offset = 0; offset < readBytes; )
+        {
+            const auto *dirent = reinterpret_cast<const LinuxDirent64 *>(buffer.data() + offset);
+            offset += dirent->d_reclen;
+
+            const char *name = dirent->d_name;
+            if ( ( name[0] == '.' ) &&
+                 ( ( name[1] == '\0' ) || ( ( name[1] == '.' ) && ( name[2] == '\0' ) ) ) )
+            {
+                continue;
+            }
+            if ( !includeHidden && ( name[0] == '.' ) )
+            {
+                continue;
+            }
+
+            TreeEntry entry;
+            entry.name = QFile::decodeName(name);
+            switch ( dirent->d_type )
+            {
+            case DT_DIR:
+                // d_type is authoritative here; directories need no stat.
+                entry.kind = TreeEntryKind::Directory;
+                break;
+            case DT_REG:
+                entry.kind = TreeEntryKind::File;
+                statTreeEntry(directoryFd, name, &entry.kind, &entry.sizeBytes);
+                break;
+            case DT_UNKNOWN:
+                // Some filesystems (older XFS, network mounts) do not fill d_type.
+                statTreeEntry(directoryFd, name, &entry.kind, &entry.sizeBytes);
+                break;
+            default:
+                entry.kind = TreeEntryKind::Other;
+                break;
+            }
+            callback(entry);
+        }
+    }
+
+    ::close(directoryFd);
+    return true;
+}
+#elif defined(Q_OS_WIN)
+template <typename Callback>
+bool listTreeDirectory(const QString &directoryPath, bool includeHidden, Callback &&callback)
+{
+    QString pattern = QDir::toNativeSeparators(directoryPath);
+    if ( !pattern.endsWith(QLatin1Char('\\')) )
+    {
+        pattern += QLatin1Char('\\');
+    }
+    pattern += QLatin1Char('*');
+
+    WIN32_FIND_DATAW findData;
+    const HANDLE findHandle = FindFirstFileExW(
+        reinterpret_cast<const wchar_t *>(pattern.utf16()),
+        FindExInfoBasic,
+        &findData,
+        FindExSearchNameMatch,
+        nullptr,
+        FIND_FIRST_EX_LARGE_FETCH
+    );
+    if ( findHandle == INVALID_HANDLE_VALUE )
+    {
+        return false;
+    }
+
+    do
+    {
+        const QString name = QString::fromWCharArray(findData.cFileName);
+        if ( ( name == QStringLiteral(".") ) || ( name == QStringLiteral("..") ) )
+        {
+            continue;
+        }
+        const DWORD attributes = findData.dwFileAttributes;
+        if ( !includeHidden &&
+             ( ( attributes & ( FILE_ATTRIBUTE_HIDDEN | FILE_ATTRIBUTE_SYSTEM ) ) != 0 ) )
+        {
+            continue;
+        }
+
+        TreeEntry entry;
+        entry.name = name;
+        if ( ( attributes & FILE_ATTRIBUTE_REPARSE_POINT ) != 0 )
+        {
+            entry.kind = TreeEntryKind::Other;
+        }
+        else if ( ( attributes & FILE_ATTRIBUTE_DIRECTORY ) != 0 )
+        {
+            entry.kind = TreeEntryKind::Directory;
+        }
+        else
+        {
+            entry.kind = TreeEntryKind::File;
+            entry.sizeBytes = static_cast<qint64>(
+                ( static_cast<quint64>(findData.nFileSizeHigh) << 32 ) | findData.nFileSizeLow
+            );
+        }
+        callback(entry);
+    }
+    while ( FindNextFileW(findHandle, &findData) );
+
+    FindClose(findHandle);
+    return true;
+}
+#else
+template <typename Callback>
+bool listTreeDirectory(const QString &directoryPath, bool includeHidden, Callback &&callback)
+{
+    if ( !QFileInfo(directoryPath).isReadable() )
+    {
+        return false;
+    }
+
+    QDir::Filters filters = QDir::AllEntries | QDir::NoDotAndDotDot | QDir::System;
+    if ( includeHidden )
+    {
+        filters |= QDir::Hidden;
+    }
+
+    QDirIterator iterator(directoryPath, filters);
+    while ( iterator.hasNext() )
+    {
+        iterator.next();
+        const QFileInfo entryInfo = iterator.fileInfo();
+
+        TreeEntry entry;
+        entry.name = entryInfo.fileName();
+        if ( entryInfo.isSymLink() )
+        {
+            entry.kind = TreeEntryKind::Other;
+        }
+        else if ( entryInfo.isDir() )
+        {
+            entry.kind = TreeEntryKind::Directory;
+        }
+        else if ( entryInfo.isFile() )
+        {
+            entry.kind = TreeEntryKind::File;
+            entry.sizeBytes = entryInfo.size();
+        }
+        callback(entry);
+    }
+    return true;
+}
+#endif
+
+// Keeps the N largest entries in a min-heap so the smallest kept entry is at front().
+class TopEntries
+{
+public:
+    explicit TopEntries(int capacity = 0) :
+        capacity_(qMax(0, capacity))
+    {
+    }
+
+    bool accepts(qint64 sizeBytes) const
+    {
+        if ( capacity_ == 0 )
+        {
+            return false;
+        }
+        if ( static_cast<int>(entries_.size()) < capacity_ )
+        {
+            return true;
+        }
+        return sizeBytes > entries_.front().sizeBytes;
+    }
+
+    void insert(const FileTreeSizeEntry &entry)
+    {
+        if ( !accepts(entry.sizeBytes) )
+        {
+            return;
+        }
+        if ( static_cast<int>(entries_.size()) >= capacity_ )
+        {
+            std::pop_heap(entries_.begin(), entries_.end(), &TopEntries::greater);
+            entries_.pop_back();
+        }
+        entries_.push_back(entry);
+        std::push_heap(entries_.begin(), entries_.end(), &TopEntries::greater);
+    }
+
+    void merge(const TopEntries &other)
+    {
+        for ( const FileTreeSizeEntry &entry : other.entries_ )
+        {
+            insert(entry);
+        }
+    }
+
+    QList<FileTreeSizeEntry> sorted() const
+    {
+        QList<FileTreeSizeEntry> out(entries_.begin(), entries_.end());
+        std::sort(
+            out.begin(),
+            out.end(),
+            [](const FileTreeSizeEntry &left, const FileTreeSizeEntry &right)
+            {
+                if ( left.sizeBytes != right.sizeBytes )
+                {
+                    return left.sizeBytes > right.sizeBytes;
+                }
+                return left.path < right.path;
+            }
+        );
+        return out;
+    }
+
+private:
+    static bool greater(const FileTreeSizeEntry &left, const FileTreeSizeEntry &right)
+    {
+        return left.sizeBytes > right.sizeBytes;
+    }
+
+    int capacity_ = 0;
+    std::vector<FileTreeSizeEntry> entries_;
+};
+
+struct DirectoryNode
+{
+    std::shared_ptr<DirectoryNode> parent;
+    QString path;
+    QString name;
+    QAtomicInteger<qint64> subtreeBytes = 0;
+    QAtomicInteger<qint64> subtreeFiles = 0;
+    // One reference for the node's own listing plus one per unfinished child directory.
+    QAtomicInt pending = 1;
+};
+
+// Per-worker accumulators, merged once the pool is done, so the hot path takes no locks.
+struct WorkerTotals
+{
+    qint64 totalBytes = 0;
+    qint64 fileCount = 0;
+    qint64 directoryCount = 0;
+    qint64 otherCount = 0;
+    qint64 unreadableDirectoryCount = 0;
+    qint64 childCount = 0;
+    TopEntries largestFiles;
+    TopEntries largestDirectories;
+    TopEntries children;
+};
+
+struct WalkState
+{
+    explicit WalkState(int workerCount):
+        queue(workerCount)
+    { }
+
+    const FileTreeSummaryOptions *options = nullptr;
+    std::shared_ptr<DirectoryNode> root;
+    FileWorkQueue<std::shared_ptr<DirectoryNode>> queue;
+    std::vector<std::unique_ptr<WorkerTotals>> totals;
+    QAtomicInt timedOut = 0;
+    QDeadlineTimer deadline;
+};
+
+// Drops one reference from node; whichever worker drops the last one publishes the
+// subtree totals to the parent and continues upward.
+void releaseDirectory(WalkState *state, WorkerTotals *totals, std::shared_ptr<DirectoryNode> node)
+{
+    while ( node && ( node->pending.fetchAndSubOrdered(1) == 1 ) )
+    {
+        const std::shared_ptr<DirectoryNode> parent = node->parent;
+        if ( !parent )
+        {
+            return;
+        }
+
+        FileTreeSizeEntry entry;
+        entry.sizeBytes = node->subtreeBytes.loadAcquire();
+        entry.fileCount = node->subtreeFiles.loadAcquire();
+        const bool isRootChild = ( parent == state->root );
+        if ( totals->largestDirectories.accepts(entry.sizeBytes) ||
+             ( isRootChild && totals->children.accepts(entry.sizeBytes) ) )
+        {
+            entry.name = node->name;
+            entry.path = node->path;
+            entry.type = QStringLiteral("directory");
+            totals->largestDirectories.insert(entry);
+            if ( isRootChild )
+            {
+                totals->children.insert(entry);
+            }
+        }
+
+        parent->subtreeBytes.fetchAndAddOrdered(entry.sizeBytes);
+        parent->subtreeFiles.fetchAndAddOrdered(entry.fileCount);
+        node = parent;
+    }
+}
+
+void expandDirectory(WalkState *state, int workerIndex, const std::shared_ptr<DirectoryNode> &node)
+{
+    WorkerTotals *totals = state->totals.at(static_cast<size_t>(workerIndex)).get();
+    const bool isRoot = ( node == state->root );
+    const QString childPrefix = node->path.endsWith(QLatin1Char('/'))
+        ? node->path
+        : ( node->path + QLatin1Char('/') );
+
+    qint64 ownBytes = 0;
+    qint64 ownFiles = 0;
+    const bool listed = listTreeDirectory(
+        node->path,
+        state->options->includeHidden,
+        [&](const TreeEntry &treeEntry)
+        {
+            if ( isRoot )
+            {
+                ++totals->childCount;
+            }
+
+            if ( treeEntry.kind == TreeEntryKind::Directory )
+            {
+                ++totals->directoryCount;
+                auto child = std::make_shared<DirectoryNode>();
+                child->parent = node;
+                child->path = childPrefix + treeEntry.name;
+                child->name = treeEntry.name;
+                node->pending.fetchAndAddOrdered(1);
+                state->queue.push(workerIndex, std::move(child));
+                return;
+            }
+
+            if ( treeEntry.kind == TreeEntryKind::File )
+            {
+                ++totals->fileCount;
+                ++ownFiles;
+                totals->totalBytes += treeEntry.sizeBytes;
+                ownBytes += treeEntry.sizeBytes;
+            }
+            else
+            {
+                ++totals->otherCount;
+            }
+
+            const bool keepAsFile = ( treeEntry.kind == TreeEntryKind::File ) &&
+                totals->largestFiles.accepts(treeEntry.sizeBytes);
+            const bool keepAsChild = isRoot && totals->children.accepts(treeEntry.sizeBytes);
+            if ( !keepAsFile && !keepAsChild )
+            {
+                return;
+            }
+
+            FileTreeSizeEntry entry;
+            entry.name = treeEntry.name;
+            entry.path = childPrefix + treeEntry.name;
+            entry.sizeBytes = treeEntry.sizeBytes;
+            if ( treeEntry.kind == TreeEntryKind::File )
+            {
+                entry.type = QStringLiteral("file");
+                entry.fileCount = 1;
+            }
+            else
+            {
+                entry.type = QStringLiteral("other");
+            }
+            if ( keepAsFile )
+            {
+                totals->largestFiles.insert(entry);
+            }
+            if ( keepAsChild )
+            {
+                totals->children.insert(entry);
+            }
+        }
+    );
+    if ( !listed )
+    {
+        ++totals->unreadableDirectoryCount;
+    }
+
+    node->subtreeBytes.fetchAndAddOrdered(ownBytes);
+    node->subtreeFiles.fetchAndAddOrdered(ownFiles);
+    releaseDirectory(state, totals, node);
+}
+
+void runWalkWorker(WalkState *state, int workerIndex)
+{
+    std::shared_ptr<DirectoryNode> node;
+    while ( state->queue.take(workerIndex, &node) )
+    {
+        expandDirectory(state, workerIndex, node);
+        state->queue.finish();
+
+        if ( state->deadline.hasExpired() )
+        {
+            state->timedOut.storeRelaxed(1);
+            state->queue.stop();
+        }
+    }
+}
+}
+
+QString FileTreeWalker::backendName()
+{
+#if defined(Q_OS_LINUX)
+    return QStringLiteral("getdents64");
+#elif defined(Q_OS_WIN)
+    return QStringLiteral("FindFirstFileExW");
+#else
+    return QStringLiteral("qt");
+#endif
+}
+
+bool FileTreeWalker::summarize(
+    const QString &rootPath,
+    const FileTreeSummaryOptions &options,
+    FileTreeSummary *summary,
+    QString *error
+)
+{
+    if ( summary == nullptr )
+    {
+        if ( error != nullptr )
+        {
+            *error = QStringLiteral("tree summary output pointer is null");
+        }
+        return false;
+    }
+
+    const QFileInfo rootInfo(rootPath);
+    if ( !rootInfo.isDir() )
+    {
+        if ( error != nullptr )
+        {
+            *error = QStringLiteral("tree root is not a directory");
+        }
+        return false;
+    }
+
+    const int workerCount = qBound(1, QThread::idealThreadCount(), treeWalkMaxWorkers);
+    WalkState state(workerCount);
+    state.options = &options;
+    state.deadline = ( options.timeoutMs >= 0 )
+        ? QDeadlineTimer(options.timeoutMs)
+        : QDeadlineTimer(QDeadlineTimer::Forever);
+    state.root = std::make_shared<DirectoryNode>();
+    state.root->path = rootInfo.absoluteFilePath();
+    state.root->name = rootInfo.fileName();
+
+    for ( int index = 0; index < workerCount; ++index )
+    {
+        auto totals = std::make_unique<WorkerTotals>();
+        totals->largestFiles = TopEntries(options.topCount);
+        totals->largestDirectories = TopEntries(options.topCount);
+        totals->children = TopEntries(options.maxChildren);
+        state.totals.push_back(std::move(totals));
+    }
+    state.queue.push(0, state.root);
+
+    QThreadPool pool;
+    pool.setMaxThreadCount(workerCount);
+    for ( int index = 0; index < workerCount; ++index )
+    {
+        pool.start(
+            [&state, index]()
+            {
+                runWalkWorker(&state, index);
+            }
+        );
+    }
+    pool.waitForDone();
+
+    FileTreeSummary out;
+    TopEntries largestFiles(options.topCount);
+    TopEntries largestDirectories(options.topCount);
+    TopEntries children(options.maxChildren);
+    for ( const std::unique_ptr<WorkerTotals> &totals : state.totals )
+    {
+        out.totalBytes += totals->totalBytes;
+        out.fileCount += totals->fileCount;
+        out.directoryCount += totals->directoryCount;
+        out.otherCount += totals->otherCount;
+        out.unreadableDirectoryCount += totals->unreadableDirectoryCount;
+        out.childCount += totals->childCount;
+        largestFiles.merge(totals->largestFiles);
+        largestDirectories.merge(totals->largestDirectories);
+        children.merge(totals->children);
+    }
+    out.timedOut = ( state.timedOut.loadRelaxed() != 0 );
+    out.workerCount = workerCount;
+    out.children = children.sorted();
+    out.largestFiles = largestFiles.sorted();
+    out.largestDirectories = largestDirectories.sorted();
+
+    *summary = out;
+    return true;
+}
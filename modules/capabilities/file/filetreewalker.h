@@ -0,0 +1,59 @@
+#ifndef JQOPENCLAW_CAPABILITIES_FILE_FILETREEWALKER_H_
+#define JQOPENCLAW_CAPABILITIES_FILE_FILETREEWALKER_H_
+
+// Qt lib import
+#include <QList>
+#include <QString>
+
+struct FileTreeSummaryOptions
+{
+    bool includeHidden = true;
+    int topCount = 20;
+    int maxChildren = 200;
+    int timeoutMs = -1;
+};
+
+struct FileTreeSizeEntry
+{
+    QString name;
+    QString path;
+    QString type;
+    qint64 sizeBytes = 0;
+    // Files in the subtree for directories, 1 for files, 0 otherwise.
+    qint64 fileCount = 0;
+};
+
+struct FileTreeSummary
+{
+    qint64 totalBytes = 0;
+    qint64 fileCount = 0;
+    qint64 directoryCount = 0;
+    qint64 otherCount = 0;
+    qint64 unreadableDirectoryCount = 0;
+    qint64 childCount = 0;
+    // Directory sizes are only complete for subtrees that finished before the deadline.
+    bool timedOut = false;
+    int workerCount = 0;
+    QList<FileTreeSizeEntry> children;
+    QList<FileTreeSizeEntry> largestFiles;
+    QList<FileTreeSizeEntry> largestDirectories;
+};
+
+// du-style aggregation over a directory tree. Directories are listed in parallel with
+// work stealing; on Linux through getdents64 + statx, on Windows through
+// FindFirstFileExW with large fetch, elsewhere through QDirIterator.
+// Symlinks and reparse points are counted as entries but never followed.
+class FileTreeWalker
+{
+public:
+    static QString backendName();
+
+    static bool summarize(
+        const QString &rootPath,
+        const FileTreeSummaryOptions &options,
+        FileTreeSummary *summary,
+        QString *error
+    );
+};
+
+#endif // JQOPENCLAW_CAPABILITIES_FILE_FILETREEWALKER_H_
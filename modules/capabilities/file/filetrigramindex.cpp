@@ -0,0 +1,920 @@
+// .h include
+#include "capabilities/file/filetrigramindex.h"
+
+// Qt lib import
+#include <QAtomicInteger>
+#include <QByteArray>
+#include <QCryptographicHash>
+#include <QDataStream>
+#include <QDateTime>
+#include <QDebug>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QHash>
+#include <QList>
+#include <QMutex>
+#include <QMutexLocker>
+#include <QSaveFile>
+#include <QSet>
+#include <QStandardPaths>
+#include <QThread>
+#include <QThreadPool>
+#include <QVector>
+#include <QtGlobal>
+#include <algorithm>
+#include <cstring>
+#include <iterator>
+#include <memory>
+#include <vector>
+
+namespace
+{
+const quint32 trigramIndexMagic = 0x4A515449; // "JQTI"
+const quint32 trigramIndexVersion = 1;
+const qint64 trigramIndexMaxFileBytes = 64 * 1024 * 1024;
+const qint64 trigramIndexBinaryProbeBytes = 8192;
+const qint64 trigramIndexReadChunkBytes = 1024 * 1024;
+const int trigramIndexMaxCachedRoots = 4;
+const int trigramIndexMaxWorkers = 16;
+
+struct IndexedFile
+{
+    QString relativePath;
+    qint64 sizeBytes = 0;
+    qint64 modifiedMs = 0;
+    bool alive = true;
+    // Files over the size cap are not tokenized and always stay candidates.
+    bool contentIndexed = true;
+};
+
+struct TrigramIndexData
+{
+    QString rootPath;
+    QVector<IndexedFile> files;
+    QHash<QString, quint32> fileIdByPath;
+    QHash<quint32, QVector<quint32>> postings;
+    qint64 deadFileCount = 0;
+};
+
+// One cached root. The cache mutex only guards the map and lastUsed; loading and
+// refreshing a root hold its own mutex, so queries on other roots are not held up.
+// Queries copy the refreshed index (the containers are implicitly shared, so the copy is
+// cheap) and work on that copy without any lock.
+struct TrigramIndexRoot
+{
+    QMutex mutex;
+    bool loaded = false;
+    TrigramIndexData index;
+    // Bumped by every refresh that changed the index; saves of older generations are
+    // dropped so a slow writer cannot replace a newer file.
+    quint64 generation = 0;
+    QMutex saveMutex;
+    quint64 savedGeneration = 0;
+    quint64 lastUsed = 0;
+};
+
+struct TrigramIndexCache
+{
+    QHash<QString, std::shared_ptr<TrigramIndexRoot>> roots;
+    // Every root that is still referenced, including ones evicted from roots while a
+    // query was using them, so one path never has two roots saving to the same file.
+    QHash<QString, std::weak_ptr<TrigramIndexRoot>> liveRoots;
+    quint64 useCounter = 0;
+};
+
+QMutex &trigramIndexMutex()
+{
+    static QMutex value;
+    return value;
+}
+
+TrigramIndexCache &trigramIndexCache()
+{
+    static TrigramIndexCache value;
+    return value;
+}
+
+char asciiLower(char value)
+{
+    return ( ( value >= 'A' ) && ( value <= 'Z' ) ) ? static_cast<char>( value - 'A' + 'a' ) : value;
+}
+
+quint32 makeTrigram(uchar first, uchar second, uchar third)
+{
+    return ( static_cast<quint32>(first) << 16 ) |
+        ( static_cast<quint32>(second) << 8 ) |
+        static_cast<quint32>(third);
+}
+
+QString indexFilePath(const QString &rootPath)
+{
+    QString baseDirectory = QStandardPaths::writableLocation(QStandardPaths::AppDataLocation).trimmed();
+    if ( baseDirectory.isEmpty() )
+    {
+        baseDirectory = QDir::tempPath();
+    }
+    const QByteArray rootHash = QCryptographicHash::hash(
+        rootPath.toUtf8(),
+        QCryptographicHash::Sha1
+    ).toHex();
+    return QDir(baseDirectory).filePath(
+        QStringLiteral("file-trigram-index/%1.idx").arg(QString::fromLatin1(rootHash))
+    );
+}
+
+bool loadIndexFromDisk(const QString &rootPath, TrigramIndexData *index)
+{
+    QFile file(indexFilePath(rootPath));
+    if ( !file.open(QIODevice::ReadOnly) )
+    {
+        return false;
+    }
+
+    QDataStream stream(&file);
+    stream.setVersion(QDataStream::Qt_6_0);
+    quint32 magic = 0;
+    quint32 version = 0;
+    QString storedRootPath;
+    stream >> magic >> version >> storedRootPath;
+    if ( ( magic != trigramIndexMagic ) ||
+         ( version != trigramIndexVersion ) ||
+         ( storedRootPath != rootPath ) )
+    {
+        return false;
+    }
+
+    TrigramIndexData loaded;
+    loaded.rootPath = rootPath;
+    quint32 fileCount = 0;
+    stream >> fileCount;
+    loaded.files.reserve(static_cast<int>(fileCount));
+    for ( quint32 index = 0; ( index < fileCount ) && ( stream.status() == QDataStream::Ok ); ++index )
+    {
+        IndexedFile indexedFile;
+        quint8 flags = 0;
+        stream >> indexedFile.relativePath >> indexedFile.sizeBytes >> indexedFile.modifiedMs >> flags;
+        indexedFile.alive = ( flags & 0x1 ) != 0;
+        indexedFile.contentIndexed = ( flags & 0x2 ) != 0;
+        if ( indexedFile.alive )
+        {
+            loaded.fileIdByPath.insert(indexedFile.relativePath, index);
+        }
+        else
+        {
+            ++loaded.deadFileCount;
+        }
+        loaded.files.append(indexedFile);
+    }
+
+    quint32 postingCount = 0;
+    stream >> postingCount;
+    loaded.postings.reserve(static_cast<int>(postingCount));
+    for ( quint32 index = 0; ( index < postingCount ) && ( stream.status() == QDataStream::Ok ); ++index )
+    {
+        quint32 trigram = 0;
+        QVector<quint32> fileIds;
+        stream >> trigram >> fileIds;
+        loaded.postings.insert(trigram, fileIds);
+    }
+
+    if ( stream.status() != QDataStream::Ok )
+    {
+        return false;
+    }
+    *index = loaded;
+    return true;
+}
+
+bool saveIndexToDisk(const TrigramIndexData &index, QString *error)
+{
+    const QString path = indexFilePath(index.rootPath);
+    if ( !QDir().mkpath(QFileInfo(path).absolutePath()) )
+    {
+        if ( error != nullptr )
+        {
+            *error = QStringLiteral("create index directory failed");
+        }
+        return false;
+    }
+
+    QSaveFile file(path);
+    if ( !file.open(QIODevice::WriteOnly) )
+    {
+        if ( error != nullptr )
+        {
+            *error = QStringLiteral("open index file failed: %1").arg(file.errorString().trimmed());
+        }
+        return false;
+    }
+
+    QDataStream stream(&file);
+    stream.setVersion(QDataStream::Qt_6_0);
+    stream << trigramIndexMagic << trigramIndexVersion << index.rootPath;
+    stream << static_cast<quint32>(index.files.size());
+    for ( const IndexedFile &indexedFile : index.files )
+    {
+        const quint8 flags = static_cast<quint8>(
+            ( indexedFile.alive ? 0x1 : 0 ) | ( indexedFile.contentIndexed ? 0x2 : 0 )
+        );
+        stream << indexedFile.relativePath << indexedFile.sizeBytes << indexedFile.modifiedMs << flags;
+    }
+    stream << static_cast<quint32>(index.postings.size());
+    for ( auto it = index.postings.cbegin(); it != index.postings.cend(); ++it )
+    {
+        stream << it.key() << it.value();
+    }
+
+    if ( ( stream.status() != QDataStream::Ok ) || !file.commit() )
+    {
+        if ( error != nullptr )
+        {
+            *error = QStringLiteral("write index file failed: %1").arg(file.errorString().trimmed());
+        }
+        return false;
+    }
+    return true;
+}
+
+// Lower-cased (ASCII only) unique trigrams of one file; newline-spanning trigrams are skipped
+// because matches never cross lines.
+bool tokenizeFile(
+    const QString &path,
+    std::vector<quint64> *seenBits,
+    QVector<quint32> *trigrams,
+    bool *contentIndexed
+)
+{
+    trigrams->clear();
+    *contentIndexed = true;
+
+    QFile file(path);
+    if ( !file.open(QIODevice::ReadOnly) )
+    {
+        return false;
+    }
+    const qint64 size = file.size();
+    if ( size > trigramIndexMaxFileBytes )
+    {
+        *contentIndexed = false;
+        return true;
+    }
+    if ( size < 3 )
+    {
+        return true;
+    }
+
+    // Read in chunks rather than mapped, so a file truncated underneath just tokenizes
+    // short instead of raising SIGBUS; the last two bytes carry over between chunks.
+    uchar first = 0;
+    uchar second = 0;
+    qint64 consumedBytes = 0;
+    for ( ;; )
+    {
+        const QByteArray chunk = file.read(trigramIndexReadChunkBytes);
+        if ( chunk.isEmpty() )
+        {
+            if ( file.error() != QFileDevice::NoError )
+            {
+                // A partial trigram set would hide the file from queries; leave it unindexed.
+                for ( const quint32 trigram : *trigrams )
+                {
+                    ( *seenBits )[trigram >> 6] = 0;
+                }
+                trigrams->clear();
+                return false;
+            }
+            break;
+        }
+        const char *data = chunk.constData();
+        const qint64 chunkSize = chunk.size();
+        if ( ( consumedBytes == 0 ) &&
+             ( std::memchr(data, '\0', static_cast<size_t>(qMin(chunkSize, trigramIndexBinaryProbeBytes))) != nullptr ) )
+        {
+            return true;
+        }
+
+        for ( qint64 position = 0; position < chunkSize; ++position, ++consumedBytes )
+        {
+            const uchar third = static_cast<uchar>(asciiLower(data[position]));
+            if ( ( consumedBytes >= 2 ) && ( first != '\n' ) && ( second != '\n' ) && ( third != '\n' ) )
+            {
+                const quint32 trigram = makeTrigram(first, second, third);
+                quint64 &word = ( *seenBits )[trigram >> 6];
+                const quint64 bit = quint64(1) << ( trigram & 63 );
+                if ( ( word & bit ) == 0 )
+                {
+                    word |= bit;
+                    trigrams->append(trigram);
+                }
+            }
+            first = second;
+            second = third;
+        }
+    }
+
+    for ( const quint32 trigram : *trigrams )
+    {
+        ( *seenBits )[trigram >> 6] = 0;
+    }
+    std::sort(trigrams->begin(), trigrams->end());
+    return true;
+}
+
+void tombstoneFile(TrigramIndexData *index, quint32 fileId)
+{
+    IndexedFile &indexedFile = index->files[static_cast<int>(fileId)];
+    if ( !indexedFile.alive )
+    {
+        return;
+    }
+    indexedFile.alive = false;
+    index->fileIdByPath.remove(indexedFile.relativePath);
+    ++index->deadFileCount;
+}
+
+void compactIndex(TrigramIndexData *index)
+{
+    QVector<qint64> remap(index->files.size(), -1);
+    QVector<IndexedFile> aliveFiles;
+    aliveFiles.reserve(index->files.size() - static_cast<int>(index->deadFileCount));
+    for ( int fileId = 0; fileId < index->files.size(); ++fileId )
+    {
+        if ( index->files.at(fileId).alive )
+        {
+            remap[fileId] = aliveFiles.size();
+            aliveFiles.append(index->files.at(fileId));
+        }
+    }
+
+    QHash<quint32, QVector<quint32>> postings;
+    postings.reserve(index->postings.size());
+    for ( auto it = index->postings.cbegin(); it != index->postings.cend(); ++it )
+    {
+        QVector<quint32> fileIds;
+        for ( const quint32 fileId : it.value() )
+        {
+            const qint64 mapped = remap.at(static_cast<int>(fileId));
+            if ( mapped >= 0 )
+            {
+                fileIds.append(static_cast<quint32>(mapped));
+            }
+        }
+        if ( !fileIds.isEmpty() )
+        {
+            postings.insert(it.key(), fileIds);
+        }
+    }
+
+    index->files = aliveFiles;
+    index->postings = postings;
+    index->fileIdByPath.clear();
+    for ( int fileId = 0; fileId < index->files.size(); ++fileId )
+    {
+        index->fileIdByPath.insert(index->files.at(fileId).relativePath, static_cast<quint32>(fileId));
+    }
+    index->deadFileCount = 0;
+}
+
+bool refreshIndex(
+    TrigramIndexData *index,
+    const FileSearchOptions &options,
+    FileTrigramQueryStats *stats,
+    bool *changed,
+    QString *error
+)
+{
+    FileSearchOptions walkOptions;
+    walkOptions.includeHidden = true;
+    walkOptions.respectGitIgnore = true;
+    walkOptions.timeoutMs = options.timeoutMs;
+
+    QList<FileSearchEntry> entries;
+    if ( !FileSearchEngine::collectFiles(index->rootPath, walkOptions, &entries, error) )
+    {
+        return false;
+    }
+
+    const qsizetype rootPrefixLength = index->rootPath.endsWith(QLatin1Char('/'))
+        ? index->rootPath.size()
+        : ( index->rootPath.size() + 1 );
+    QSet<quint32> seenFileIds;
+    QList<FileSearchEntry> pendingEntries;
+    for ( const FileSearchEntry &entry : entries )
+    {
+        const QString relativePath = entry.path.mid(rootPrefixLength);
+        const auto it = index->fileIdByPath.constFind(relativePath);
+        if ( it != index->fileIdByPath.cend() )
+        {
+            const IndexedFile &indexedFile = index->files.at(static_cast<int>(it.value()));
+            if ( ( indexedFile.sizeBytes == entry.sizeBytes ) &&
+                 ( indexedFile.modifiedMs == entry.modifiedMs ) )
+            {
+                seenFileIds.insert(it.value());
+                continue;
+            }
+            tombstoneFile(index, it.value());
+        }
+        pendingEntries.append(entry);
+    }
+
+    const QList<quint32> aliveFileIds = index->fileIdByPath.values();
+    for ( const quint32 fileId : aliveFileIds )
+    {
+        if ( !seenFileIds.contains(fileId) )
+        {
+            tombstoneFile(index, fileId);
+            ++stats->removedFileCount;
+        }
+    }
+
+    // Tokenize in parallel into per-entry slots; merging into postings stays single threaded.
+    std::vector<QVector<quint32>> tokenized(static_cast<size_t>(pendingEntries.size()));
+    std::vector<char> tokenizedContent(static_cast<size_t>(pendingEntries.size()), 1);
+    std::vector<char> tokenizedOk(static_cast<size_t>(pendingEntries.size()), 0);
+    QAtomicInteger<qint64> nextEntry = 0;
+    const int workerCount = qBound(1, QThread::idealThreadCount(), trigramIndexMaxWorkers);
+    QThreadPool pool;
+    pool.setMaxThreadCount(workerCount);
+    for ( int worker = 0; worker < workerCount; ++worker )
+    {
+        pool.start(
+            [&]()
+            {
+                std::vector<quint64> seenBits(static_cast<size_t>(1) << 18, 0);
+                while ( true )
+                {
+                    const qint64 entryIndex = nextEntry.fetchAndAddRelaxed(1);
+                    if ( entryIndex >= pendingEntries.size() )
+                    {
+                        return;
+                    }
+                    bool contentIndexed = true;
+                    const bool ok = tokenizeFile(
+                        pendingEntries.at(entryIndex).path,
+                        &seenBits,
+                        &tokenized[static_cast<size_t>(entryIndex)],
+                        &contentIndexed
+                    );
+                    tokenizedOk[static_cast<size_t>(entryIndex)] = ok ? 1 : 0;
+                    tokenizedContent[static_cast<size_t>(entryIndex)] = contentIndexed ? 1 : 0;
+                }
+            }
+        );
+    }
+    pool.waitForDone();
+
+    for ( qsizetype entryIndex = 0; entryIndex < pendingEntries.size(); ++entryIndex )
+    {
+        if ( tokenizedOk[static_cast<size_t>(entryIndex)] == 0 )
+        {
+            continue;
+        }
+
+        const FileSearchEntry &entry = pendingEntries.at(entryIndex);
+        IndexedFile indexedFile;
+        indexedFile.relativePath = entry.path.mid(rootPrefixLength);
+        indexedFile.sizeBytes = entry.sizeBytes;
+        indexedFile.modifiedMs = entry.modifiedMs;
+        indexedFile.contentIndexed = ( tokenizedContent[static_cast<size_t>(entryIndex)] != 0 );
+
+        const quint32 fileId = static_cast<quint32>(index->files.size());
+        index->files.append(indexedFile);
+        index->fileIdByPath.insert(indexedFile.relativePath, fileId);
+        for ( const quint32 trigram : tokenized[static_cast<size_t>(entryIndex)] )
+        {
+            index->postings[trigram].append(fileId);
+        }
+        ++stats->updatedFileCount;
+    }
+
+    if ( ( index->deadFileCount > 1024 ) &&
+         ( ( index->deadFileCount * 2 ) > index->files.size() ) )
+    {
+        compactIndex(index);
+    }
+
+    *changed = !pendingEntries.isEmpty() || ( stats->removedFileCount > 0 );
+    stats->indexedFileCount = index->fileIdByPath.size();
+    return true;
+}
+
+// Appends the literal runs every match of one alternative branch must contain.
+// Returns false when the branch uses constructs that make literal extraction unsafe.
+bool extractBranchLiterals(const QString &branch, QStringList *literals)
+{
+    QString current;
+    auto flush = [&]()
+    {
+        if ( !current.isEmpty() )
+        {
+            literals->append(current);
+            current.clear();
+        }
+    };
+    auto skipBracketed = [&](qsizetype start, QChar open, QChar close) -> qsizetype
+    {
+        int depth = 0;
+        for ( qsizetype index = start; index < branch.size(); ++index )
+        {
+            const QChar ch = branch.at(index);
+            if ( ch == QLatin1Char('\\') )
+            {
+                ++index;
+                continue;
+            }
+            if ( ( open == QLatin1Char('[') ) && ( index > start + 1 ) && ( ch == close ) )
+            {
+                return index;
+            }
+            if ( open != QLatin1Char('[') )
+            {
+                if ( ch == open )
+                {
+                    ++depth;
+                }
+                else if ( ch == close )
+                {
+                    --depth;
+                    if ( depth == 0 )
+                    {
+                        return index;
+                    }
+                }
+            }
+        }
+        return branch.size();
+    };
+
+    for ( qsizetype index = 0; index < branch.size(); ++index )
+    {
+        const QChar ch = branch.at(index);
+        if ( ch == QLatin1Char('\\') )
+        {
+            if ( ( index + 1 ) >= branch.size() )
+            {
+                return false;
+            }
+            const QChar escaped = branch.at(index + 1);
+            ++index;
+            if ( escaped.isLetterOrNumber() )
+            {
+                static const QString unsafeEscapes = QStringLiteral("xpPuckgoNQE");
+                if ( unsafeEscapes.contains(escaped) )
+                {
+                    return false;
+                }
+                flush();
+                continue;
+            }
+            current.append(escaped);
+            continue;
+        }
+        if ( ( ch == QLatin1Char('?') ) || ( ch == QLatin1Char('*') ) )
+        {
+            current.chop(1);
+            flush();
+            continue;
+        }
+        if ( ch == QLatin1Char('+') )
+        {
+            flush();
+            continue;
+        }
+        if ( ch == QLatin1Char('{') )
+        {
+            const qsizetype close = branch.indexOf(QLatin1Char('}'), index);
+            bool minimumOk = false;
+            const int minimum = ( close > index )
+                ? branch.mid(index + 1, close - index - 1).section(QLatin1Char(','), 0, 0).toInt(&minimumOk)
+                : 0;
+            if ( !minimumOk )
+            {
+                current.append(ch);
+                continue;
+            }
+            if ( minimum == 0 )
+            {
+                current.chop(1);
+            }
+            flush();
+            index = close;
+            continue;
+        }
+        if ( ch == QLatin1Char('[') )
+        {
+            flush();
+            index = skipBracketed(index, QLatin1Char('['), QLatin1Char(']'));
+            continue;
+        }
+        if ( ch == QLatin1Char('(') )
+        {
+            flush();
+            index = skipBracketed(index, QLatin1Char('('), QLatin1Char(')'));
+            continue;
+        }
+        if ( ( ch == QLatin1Char('.') ) || ( ch == QLatin1Char('^') ) || ( ch == QLatin1Char('$') ) )
+        {
+            flush();
+            continue;
+        }
+        current.append(ch);
+    }
+    flush();
+    return true;
+}
+
+// Splits the pattern on top-level '|' and returns, per branch, the trigrams it requires.
+// An empty result means the pattern cannot be narrowed. Patterns with "(?" / "(*"
+// constructs (inline flags such as (?i) or (?x), lookarounds, verbs) or with a character
+// class inside a group are not narrowed: the literal extraction below does not model
+// them and could require trigrams that a matching file does not contain.
+QList<QSet<quint32>> queryTrigramsPerBranch(const FileSearchOptions &options)
+{
+    QStringList branches;
+    if ( options.literal )
+    {
+        branches.append(QString());
+    }
+    else
+    {
+        QString current;
+        int depth = 0;
+        bool inClass = false;
+        for ( qsizetype index = 0; index < options.pattern.size(); ++index )
+        {
+            const QChar ch = options.pattern.at(index);
+            if ( ch == QLatin1Char('\\') && ( ( index + 1 ) < options.pattern.size() ) )
+            {
+                current.append(ch);
+                current.append(options.pattern.at(++index));
+                continue;
+            }
+            if ( inClass )
+            {
+                inClass = ( ch != QLatin1Char(']') );
+            }
+            else if ( ch == QLatin1Char('[') )
+            {
+                if ( depth > 0 )
+                {
+                    return QList<QSet<quint32>>();
+                }
+                inClass = true;
+            }
+            else if ( ch == QLatin1Char('(') )
+            {
+                const QChar next = ( ( index + 1 ) < options.pattern.size() ) ? options.pattern.at(index + 1) : QChar();
+                if ( ( next == QLatin1Char('?') ) || ( next == QLatin1Char('*') ) )
+                {
+                    return QList<QSet<quint32>>();
+                }
+                ++depth;
+            }
+            else if ( ch == QLatin1Char(')') )
+            {
+                --depth;
+            }
+            else if ( ( ch == QLatin1Char('|') ) && ( depth == 0 ) )
+            {
+                branches.append(current);
+                current.clear();
+                continue;
+            }
+            current.append(ch);
+        }
+        branches.append(current);
+    }
+
+    QList<QSet<quint32>> result;
+    for ( const QString &branch : branches )
+    {
+        QStringList literals;
+        if ( options.literal )
+        {
+            literals.append(options.pattern);
+        }
+        else if ( !extractBranchLiterals(branch, &literals) )
+        {
+            return QList<QSet<quint32>>();
+        }
+
+        QSet<quint32> trigrams;
+        for ( const QString &literal : literals )
+        {
+            const QByteArray bytes = literal.toUtf8();
+            for ( qsizetype index = 0; ( index + 2 ) < bytes.size(); ++index )
+            {
+                const uchar first = static_cast<uchar>(asciiLower(bytes.at(index)));
+                const uchar second = static_cast<uchar>(asciiLower(bytes.at(index + 1)));
+                const uchar third = static_cast<uchar>(asciiLower(bytes.at(index + 2)));
+                // Non-ASCII bytes are indexed verbatim, so they are unusable when folding case.
+                if ( !options.caseSensitive && ( ( first | second | third ) & 0x80 ) )
+                {
+                    continue;
+                }
+                if ( ( first == '\n' ) || ( second == '\n' ) || ( third == '\n' ) )
+                {
+                    continue;
+                }
+                trigrams.insert(makeTrigram(first, second, third));
+            }
+        }
+        if ( trigrams.isEmpty() )
+        {
+            return QList<QSet<quint32>>();
+        }
+        result.append(trigrams);
+    }
+    return result;
+}
+
+QVector<quint32> intersectPostings(const TrigramIndexData &index, const QSet<quint32> &trigrams)
+{
+    QList<const QVector<quint32> *> lists;
+    for ( const quint32 trigram : trigrams )
+    {
+        const auto it = index.postings.constFind(trigram);
+        if ( it == index.postings.cend() )
+        {
+            return QVector<quint32>();
+        }
+        lists.append(&it.value());
+    }
+    std::sort(
+        lists.begin(),
+        lists.end(),
+        [](const QVector<quint32> *left, const QVector<quint32> *right)
+        {
+            return left->size() < right->size();
+        }
+    );
+
+    QVector<quint32> result = *lists.first();
+    for ( qsizetype listIndex = 1; ( listIndex < lists.size() ) && !result.isEmpty(); ++listIndex )
+    {
+        QVector<quint32> next;
+        std::set_intersection(
+            result.cbegin(),
+            result.cend(),
+            lists.at(listIndex)->cbegin(),
+            lists.at(listIndex)->cend(),
+            std::back_inserter(next)
+        );
+        result = next;
+    }
+    return result;
+}
+
+bool isHiddenRelativePath(const QString &relativePath)
+{
+    return relativePath.startsWith(QLatin1Char('.')) ||
+        relativePath.contains(QStringLiteral("/."));
+}
+}
+
+bool FileTrigramIndex::queryCandidates(
+    const QString &rootPath,
+    const FileSearchOptions &options,
+    QStringList *candidateFiles,
+    FileTrigramQueryStats *stats,
+    QString *error
+)
+{
+    if ( ( candidateFiles == nullptr ) || ( stats == nullptr ) )
+    {
+        if ( error != nullptr )
+        {
+            *error = QStringLiteral("index query output pointer is null");
+        }
+        return false;
+    }
+
+    *stats = FileTrigramQueryStats();
+    candidateFiles->clear();
+    const QString normalizedRootPath = QDir::cleanPath(QFileInfo(rootPath).absoluteFilePath());
+
+    std::shared_ptr<TrigramIndexRoot> root;
+    {
+        QMutexLocker cacheLocker(&trigramIndexMutex());
+        TrigramIndexCache &cache = trigramIndexCache();
+        root = cache.roots.value(normalizedRootPath);
+        if ( !root )
+        {
+            root = cache.liveRoots.value(normalizedRootPath).lock();
+            if ( !root )
+            {
+                root = std::make_shared<TrigramIndexRoot>();
+                cache.liveRoots.insert(normalizedRootPath, root);
+            }
+            cache.roots.insert(normalizedRootPath, root);
+        }
+        root->lastUsed = ++cache.useCounter;
+        while ( cache.roots.size() > trigramIndexMaxCachedRoots )
+        {
+            QString oldestRoot;
+            quint64 oldestUse = 0;
+            for ( auto it = cache.roots.cbegin(); it != cache.roots.cend(); ++it )
+            {
+                if ( oldestRoot.isEmpty() || ( it.value()->lastUsed < oldestUse ) )
+                {
+                    oldestRoot = it.key();
+                    oldestUse = it.value()->lastUsed;
+                }
+            }
+            cache.roots.remove(oldestRoot);
+        }
+        for ( auto it = cache.liveRoots.begin(); it != cache.liveRoots.end(); )
+        {
+            if ( it.value().expired() )
+            {
+                it = cache.liveRoots.erase(it);
+            }
+            else
+            {
+                ++it;
+            }
+        }
+    }
+
+    TrigramIndexData index;
+    quint64 generation = 0;
+    bool changed = false;
+    {
+        // Concurrent queries on the same root would race on postings; refresh one at a time.
+        QMutexLocker rootLocker(&root->mutex);
+        if ( !root->loaded )
+        {
+            if ( !loadIndexFromDisk(normalizedRootPath, &root->index) )
+            {
+                root->index = TrigramIndexData();
+            }
+            root->index.rootPath = normalizedRootPath;
+            root->loaded = true;
+        }
+        if ( !refreshIndex(&root->index, options, stats, &changed, error) )
+        {
+            return false;
+        }
+        if ( changed )
+        {
+            ++root->generation;
+        }
+        index = root->index;
+        generation = root->generation;
+    }
+
+    if ( changed )
+    {
+        QMutexLocker saveLocker(&root->saveMutex);
+        if ( generation > root->savedGeneration )
+        {
+            QString saveError;
+            if ( saveIndexToDisk(index, &saveError) )
+            {
+                root->savedGeneration = generation;
+            }
+            else
+            {
+                qWarning().noquote() << QStringLiteral("[capability.file.read] trigram index save failed root=%1 error=%2")
+                                            .arg(normalizedRootPath, saveError);
+            }
+        }
+    }
+
+    QSet<quint32> candidateIds;
+    const QList<QSet<quint32>> branchTrigrams = queryTrigramsPerBranch(options);
+    stats->narrowed = !branchTrigrams.isEmpty();
+    if ( stats->narrowed )
+    {
+        for ( const QSet<quint32> &trigrams : branchTrigrams )
+        {
+            for ( const quint32 fileId : intersectPostings(index, trigrams) )
+            {
+                candidateIds.insert(fileId);
+            }
+        }
+    }
+
+    for ( int fileId = 0; fileId < index.files.size(); ++fileId )
+    {
+        const IndexedFile &indexedFile = index.files.at(fileId);
+        if ( !indexedFile.alive )
+        {
+            continue;
+        }
+        if ( stats->narrowed &&
+             indexedFile.contentIndexed &&
+             !candidateIds.contains(static_cast<quint32>(fileId)) )
+        {
+            continue;
+        }
+        if ( !options.includeHidden && isHiddenRelativePath(indexedFile.relativePath) )
+        {
+            continue;
+        }
+        candidateFiles->append(QDir(normalizedRootPath).filePath(indexedFile.relativePath));
+    }
+    stats->candidateFileCount = candidateFiles->size();
+    return true;
+}
@@ -0,0 +1,37 @@
+#ifndef JQOPENCLAW_CAPABILITIES_FILE_FILETRIGRAMINDEX_H_
+#define JQOPENCLAW_CAPABILITIES_FILE_FILETRIGRAMINDEX_H_
+
+// Qt lib import
+#include <QString>
+#include <QStringList>
+
+// JQOpenClaw import
+#include "capabilities/file/filesearchengine.h"
+
+struct FileTrigramQueryStats
+{
+    qint64 indexedFileCount = 0;
+    qint64 updatedFileCount = 0;
+    qint64 removedFileCount = 0;
+    qint64 candidateFileCount = 0;
+    // false when the pattern yields no usable trigram and every file stays a candidate.
+    bool narrowed = false;
+};
+
+// Opt-in persistent trigram index per search root, stored under AppDataLocation.
+// Every query first re-validates the tree by size + mtime, re-indexes changed files
+// (old entries become tombstones until compaction) and then intersects posting lists
+// of the trigrams that any match must contain.
+class FileTrigramIndex
+{
+public:
+    static bool queryCandidates(
+        const QString &rootPath,
+        const FileSearchOptions &options,
+        QStringList *candidateFiles,
+        FileTrigramQueryStats *stats,
+        QString *error
+    );
+};
+
+#endif // JQOPENCLAW_CAPABILITIES_FILE_FILETRIGRAMINDEX_H_
@@ -0,0 +1,273 @@
+// .h include
+#include "capabilities/file/fileuploadsession.h"
+
+// Qt lib import
+#include <QCryptographicHash>
+#include <QDateTime>
+#include <QFileInfo>
+#include <QHash>
+#include <QMutex>
+#include <QMutexLocker>
+#include <QSaveFile>
+#include <QSharedPointer>
+#include <QUuid>
+
+// JQOpenClaw import
+#include "capabilities/file/filedurability.h"
+
+namespace
+{
+const int uploadMaxSessions = 16;
+
+struct UploadSession
+{
+    FileUploadInfo info;
+    // Writes go to a temporary file beside the target; commit() renames it into place
+    // and destroying an uncommitted QSaveFile removes it.
+    QSaveFile file;
+    QCryptographicHash hash { QCryptographicHash::Sha256 };
+    qint64 expiresAtMs = 0;
+};
+
+struct UploadState
+{
+    QMutex mutex;
+    QHash<QString, QSharedPointer<UploadSession>> sessions;
+};
+
+UploadState &uploadState()
+{
+    static UploadState value;
+    return value;
+}
+
+// Caller holds state.mutex.
+void pruneExpired(UploadState &state, qint64 nowMs)
+{
+    for ( auto it = state.sessions.begin(); it != state.sessions.end(); )
+    {
+        if ( ( *it )->expiresAtMs <= nowMs )
+        {
+            it = state.sessions.erase(it);
+        }
+        else
+        {
+            ++it;
+        }
+    }
+}
+
+// Caller holds state.mutex. Looks the session up and extends its lifetime.
+QSharedPointer<UploadSession> touchSession(
+    UploadState &state,
+    const QString &uploadId,
+    qint64 nowMs,
+    QString *error
+)
+{
+    pruneExpired(state, nowMs);
+    const QSharedPointer<UploadSession> session = state.sessions.value(uploadId);
+    if ( session.isNull() )
+    {
+        *error = QStringLiteral("upload %1 does not exist or has expired").arg(uploadId);
+        return session;
+    }
+    session->expiresAtMs = nowMs + session->info.ttlMs;
+    return session;
+}
+
+FileUploadInfo snapshotInfo(const UploadSession &session, qint64 nowMs)
+{
+    FileUploadInfo info = session.info;
+    info.expiresInMs = qMax<qint64>(0, session.expiresAtMs - nowMs);
+    return info;
+}
+}
+
+bool FileUploadSession::begin(
+    const QString &absolutePath,
+    qint64 sizeBytes,
+    const QString &expectedSha256,
+    qint64 ttlMs,
+    FileDurabilityLevel durability,
+    bool preallocate,
+    FileUploadInfo *info,
+    QString *error
+)
+{
+    if ( QFileInfo(absolutePath).isDir() )
+    {
+        *error = QStringLiteral("target is a directory");
+        return false;
+    }
+
+    const qint64 nowMs = QDateTime::currentMSecsSinceEpoch();
+    UploadState &state = uploadState();
+    QMutexLocker locker(&state.mutex);
+    pruneExpired(state, nowMs);
+    if ( state.sessions.size() >= uploadMaxSessions )
+    {
+        *error = QStringLiteral("too many open uploads (max %1); commit or abort finished ones first")
+            .arg(uploadMaxSessions);
+        return false;
+    }
+
+    QSharedPointer<UploadSession> session(new UploadSession);
+    session->file.setFileName(absolutePath);
+    if ( !session->file.open(QIODevice::WriteOnly) )
+    {
+        *error = QStringLiteral("failed to create temporary file: %1").arg(session->file.errorString().trimmed());
+        return false;
+    }
+
+    session->info.uploadId = QUuid::createUuid().toString(QUuid::WithoutBraces);
+    session->info.path = absolutePath;
+    session->info.sizeBytes = sizeBytes;
+    session->info.expectedSha256 = expectedSha256.toLower();
+    session->info.ttlMs = ttlMs;
+    session->info.durability = durability;
+    if ( preallocate )
+    {
+        session->info.preallocated = FileDurability::preallocate(&session->file, sizeBytes);
+    }
+    session->expiresAtMs = nowMs + ttlMs;
+
+    state.sessions.insert(session->info.uploadId, session);
+    *info = snapshotInfo(*session, nowMs);
+    return true;
+}
+
+bool FileUploadSession::append(
+    const QString &uploadId,
+    qint64 offsetBytes,
+    const QByteArray &data,
+    FileUploadInfo *info,
+    bool *duplicate,
+    QString *error
+)
+{
+    const qint64 nowMs = QDateTime::currentMSecsSinceEpoch();
+    UploadState &state = uploadState();
+    QMutexLocker locker(&state.mutex);
+    const QSharedPointer<UploadSession> session = touchSession(state, uploadId, nowMs, error);
+    if ( session.isNull() )
+    {
+        return false;
+    }
+
+    const qint64 receivedBytes = session->info.receivedBytes;
+    *duplicate = false;
+    if ( ( offsetBytes < receivedBytes ) && ( ( offsetBytes + data.size() ) <= receivedBytes ) )
+    {
+        // A retry of a chunk whose reply was lost.
+        *duplicate = true;
+        *info = snapshotInfo(*session, nowMs);
+        return true;
+    }
+    if ( offsetBytes != receivedBytes )
+    {
+        *error = QStringLiteral("offsetBytes must be %1 (bytes received so far)").arg(receivedBytes);
+        return false;
+    }
+    if ( ( receivedBytes + data.size() ) > session->info.sizeBytes )
+    {
+        *error = QStringLiteral("chunk ends at %1, past the announced size %2")
+            .arg(receivedBytes + data.size())
+            .arg(session->info.sizeBytes);
+        return false;
+    }
+
+    if ( session->file.write(data) != data.size() )
+    {
+        // QSaveFile keeps the error and would refuse to commit; nothing left to save.
+        *error = QStringLiteral("write failed: %1").arg(session->file.errorString().trimmed());
+        state.sessions.remove(uploadId);
+        return false;
+    }
+    session->hash.addData(data);
+    session->info.receivedBytes += data.size();
+
+    *info = snapshotInfo(*session, nowMs);
+    return true;
+}
+
+bool FileUploadSession::status(const QString &uploadId, FileUploadInfo *info, QString *error)
+{
+    const qint64 nowMs = QDateTime::currentMSecsSinceEpoch();
+    UploadState &state = uploadState();
+    QMutexLocker locker(&state.mutex);
+    const QSharedPointer<UploadSession> session = touchSession(state, uploadId, nowMs, error);
+    if ( session.isNull() )
+    {
+        return false;
+    }
+    *info = snapshotInfo(*session, nowMs);
+    return true;
+}
+
+bool FileUploadSession::commit(const QString &uploadId, FileUploadInfo *info, QString *error)
+{
+    const qint64 nowMs = QDateTime::currentMSecsSinceEpoch();
+    UploadState &state = uploadState();
+    QMutexLocker locker(&state.mutex);
+    const QSharedPointer<UploadSession> session = touchSession(state, uploadId, nowMs, error);
+    if ( session.isNull() )
+    {
+        return false;
+    }
+    if ( session->info.receivedBytes != session->info.sizeBytes )
+    {
+        *error = QStringLiteral("upload incomplete: %1 of %2 bytes received")
+            .arg(session->info.receivedBytes)
+            .arg(session->info.sizeBytes);
+        return false;
+    }
+
+    state.sessions.remove(uploadId);
+    session->info.sha256 = QString::fromLatin1(session->hash.result().toHex());
+    *info = snapshotInfo(*session, nowMs);
+    info->expiresInMs = 0;
+    if ( !session->info.expectedSha256.isEmpty() &&
+         ( session->info.sha256 != session->info.expectedSha256 ) )
+    {
+        *error = QStringLiteral("sha256 mismatch: expected %1, received %2; upload discarded")
+            .arg(session->info.expectedSha256, session->info.sha256);
+        return false;
+    }
+    QString syncError;
+    if ( !FileDurability::syncFile(&session->file, session->info.durability, &syncError) )
+    {
+        *error = syncError;
+        return false;
+    }
+    if ( !session->file.commit() )
+    {
+        *error = QStringLiteral("failed to replace target: %1").arg(session->file.errorString().trimmed());
+        return false;
+    }
+    if ( ( session->info.durability == FileDurabilityLevel::Full ) &&
+         !FileDurability::syncDirectory(QFileInfo(session->info.path).absolutePath(), &syncError) )
+    {
+        *error = syncError;
+        return false;
+    }
+    return true;
+}
+
+bool FileUploadSession::abort(const QString &uploadId, FileUploadInfo *info, QString *error)
+{
+    const qint64 nowMs = QDateTime::currentMSecsSinceEpoch();
+    UploadState &state = uploadState();
+    QMutexLocker locker(&state.mutex);
+    pruneExpired(state, nowMs);
+    const QSharedPointer<UploadSession> session = state.sessions.take(uploadId);
+    if ( session.isNull() )
+    {
+        *error = QStringLiteral("upload %1 does not exist or has expired").arg(uploadId);
+        return false;
+    }
+    session->file.cancelWriting();
+    *info = snapshotInfo(*session, nowMs);
+    info->expiresInMs = 0;
+    return true;
+}
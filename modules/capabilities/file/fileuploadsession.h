@@ -0,0 +1,70 @@
+#ifndef JQOPENCLAW_CAPABILITIES_FILE_FILEUPLOADSESSION_H_
+#define JQOPENCLAW_CAPABILITIES_FILE_FILEUPLOADSESSION_H_
+
+// Qt lib import
+#include <QByteArray>
+#include <QString>
+
+// JQOpenClaw import
+#include "capabilities/file/filedurability.h"
+
+struct FileUploadInfo
+{
+    QString uploadId;
+    QString path;
+    qint64 sizeBytes = 0;
+    // Bytes [0, receivedBytes) are on disk; a resumed upload continues there.
+    qint64 receivedBytes = 0;
+    // Expected lowercase sha256; empty when begin was called without one.
+    QString expectedSha256;
+    // Set by commit.
+    QString sha256;
+    FileDurabilityLevel durability = FileDurabilityLevel::None;
+    bool preallocated = false;
+    qint64 ttlMs = 0;
+    qint64 expiresInMs = 0;
+};
+
+// Write-side counterpart of FileTransferSession: a file arrives as a sequence of
+// appended chunks, each written straight to a temporary file next to the target and fed
+// into a running sha256, so memory use does not depend on the file size. commit checks
+// size and hash and renames the temporary file over the target in one step; until then
+// the target is untouched. Sessions live in the node process, survive a gateway
+// reconnect, and are discarded (temporary file included) after ttlMs without any call.
+class FileUploadSession
+{
+public:
+    // durability applies at commit; preallocate reserves sizeBytes up front.
+    static bool begin(
+        const QString &absolutePath,
+        qint64 sizeBytes,
+        const QString &expectedSha256,
+        qint64 ttlMs,
+        FileDurabilityLevel durability,
+        bool preallocate,
+        FileUploadInfo *info,
+        QString *error
+    );
+
+    // offsetBytes must equal receivedBytes. A chunk that lies entirely below
+    // receivedBytes is a retransmission and is acknowledged without writing
+    // (*duplicate = true); partial overlaps and gaps are errors.
+    static bool append(
+        const QString &uploadId,
+        qint64 offsetBytes,
+        const QByteArray &data,
+        FileUploadInfo *info,
+        bool *duplicate,
+        QString *error
+    );
+
+    static bool status(const QString &uploadId, FileUploadInfo *info, QString *error);
+
+    // Fails without discarding the session when bytes are still missing; a hash mismatch
+    // discards it, since no further append can repair it.
+    static bool commit(const QString &uploadId, FileUploadInfo *info, QString *error);
+
+    static bool abort(const QString &uploadId, FileUploadInfo *info, QString *error);
+};
+
+#endif // JQOPENCLAW_CAPABILITIES_FILE_FILEUPLOADSESSION_H_
@@ -0,0 +1,163 @@
+#ifndef JQOPENCLAW_CAPABILITIES_FILE_FILEWORKQUEUE_H_
+#define JQOPENCLAW_CAPABILITIES_FILE_FILEWORKQUEUE_H_
+
+// Qt lib import
+#include <QAtomicInteger>
+#include <QMutex>
+#include <QMutexLocker>
+#include <QWaitCondition>
+
+// C++ lib import
+#include <deque>
+#include <memory>
+#include <vector>
+
+// Work-stealing task queue for the parallel tree walkers. Each worker has its own deque:
+// it pushes and pops at the back (LIFO, for locality) and steals from the front of the
+// others (the oldest, usually largest, subtree). Tasks may push further tasks; a worker
+// that finds nothing sleeps until a task is pushed, everything is finished or stop() is
+// called, instead of spinning.
+//
+//     while ( queue.take(workerIndex, &task) )
+//     {
+//         run(task);            // may call queue.push(workerIndex, ...)
+//         queue.finish();
+//     }
+template <typename Task>
+class FileWorkQueue
+{
+public:
+    explicit FileWorkQueue(int workerCount)
+    {
+        for ( int index = 0; index < workerCount; ++index )
+        {
+            queues_.push_back(std::make_unique<WorkerQueue>());
+        }
+    }
+
+    int workerCount() const
+    {
+        return static_cast<int>(queues_.size());
+    }
+
+    void push(int workerIndex, Task task)
+    {
+        pendingTasks_.fetchAndAddOrdered(1);
+        {
+            WorkerQueue *queue = queues_.at(static_cast<size_t>(workerIndex)).get();
+            QMutexLocker locker(&queue->mutex);
+            queue->tasks.push_back(std::move(task));
+        }
+        queuedTasks_.fetchAndAddOrdered(1);
+        if ( idleWorkers_.loadAcquire() > 0 )
+        {
+            QMutexLocker locker(&idleMutex_);
+            idleCondition_.wakeOne();
+        }
+    }
+
+    // Returns false once every pushed task has finished or stop() was called.
+    bool take(int workerIndex, Task *task)
+    {
+        for ( ;; )
+        {
+            if ( stopped_.loadAcquire() != 0 )
+            {
+                return false;
+            }
+            if ( tryTake(workerIndex, task) )
+            {
+                return true;
+            }
+
+            QMutexLocker locker(&idleMutex_);
+            // Registering as idle before looking again pairs with push(): either the
+            // pusher sees an idle worker and wakes it, or this sees the queued task.
+            idleWorkers_.fetchAndAddOrdered(1);
+            const bool finished = ( pendingTasks_.loadAcquire() == 0 );
+            if ( !finished && ( stopped_.loadAcquire() == 0 ) && ( queuedTasks_.loadAcquire() == 0 ) )
+            {
+                // Bounded so that even a missed wakeup only costs latency.
+                idleCondition_.wait(&idleMutex_, idleWaitMs);
+            }
+            idleWorkers_.fetchAndSubOrdered(1);
+            if ( finished )
+            {
+                return false;
+            }
+        }
+    }
+
+    // Marks a task returned by take() as done.
+    void finish()
+    {
+        if ( pendingTasks_.fetchAndSubOrdered(1) == 1 )
+        {
+            wakeAll();
+        }
+    }
+
+    // Makes every take() return false, including those already waiting.
+    void stop()
+    {
+        stopped_.storeRelease(1);
+        wakeAll();
+    }
+
+private:
+    static constexpr unsigned long idleWaitMs = 50;
+
+    struct WorkerQueue
+    {
+        QMutex mutex;
+        std::deque<Task> tasks;
+    };
+
+    bool tryTake(int workerIndex, Task *task)
+    {
+        {
+            WorkerQueue *queue = queues_.at(static_cast<size_t>(workerIndex)).get();
+            QMutexLocker locker(&queue->mutex);
+            if ( !queue->tasks.empty() )
+            {
+                *task = std::move(queue->tasks.back());
+                queue->tasks.pop_back();
+                queuedTasks_.fetchAndSubOrdered(1);
+                return true;
+            }
+        }
+
+        const int queueCount = workerCount();
+        for ( int offset = 1; offset < queueCount; ++offset )
+        {
+            WorkerQueue *queue = queues_.at(static_cast<size_t>(( workerIndex + offset ) % queueCount)).get();
+            QMutexLocker locker(&queue->mutex);
+            if ( !queue->tasks.empty() )
+            {
+                *task = std::move(queue->tasks.front());
+                queue->tasks.pop_front();
+                queuedTasks_.fetchAndSubOrdered(1);
+                return true;
+            }
+        }
+        return false;
+    }
+
+    void wakeAll()
+    {
+        QMutexLocker locker(&idleMutex_);
+        idleCondition_.wakeAll();
+    }
+
+    std::vector<std::unique_ptr<WorkerQueue>> queues_;
+    // Pushed and not yet finished; a running task counts until finish().
+    QAtomicInteger<qint64> pendingTasks_ = 0;
+    // Sitting in a deque, not taken yet.
+    QAtomicInteger<qint64> queuedTasks_ = 0;
+    QAtomicInt idleWorkers_ = 0;
+    QAtomicInt stopped_ = 0;
+    QMutex idleMutex_;
+    QWaitCondition idleCondition_;
+};
+
+#endif // JQOPENCLAW_CAPABILITIES_FILE_FILEWORKQUEUE_H_
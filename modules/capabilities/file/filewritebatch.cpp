@@ -0,0 +1,527 @@
+// .h include
+#include "capabilities/file/filewritebatch.h"
+
+// Qt lib import
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QSet>
+#include <QThreadPool>
+#include <QUuid>
+#include <QVector>
+#include <QtGlobal>
+
+// JQOpenClaw import
+#include "capabilities/file/fileremover.h"
+
+namespace
+{
+const int batchMaxWorkers = 8;
+
+struct StagedItem
+{
+    FileWriteBatchItemResult result;
+    // Write: the new content, renamed over the target on commit.
+    QString tempPath;
+    bool tempExists = false;
+    // Existing entry renamed aside on commit (replaced or permanently deleted); removed
+    // once the whole batch committed, renamed back on rollback.
+    QString backupPath;
+    bool backupIsDirectory = false;
+    // Delete to trash: where the entry ended up.
+    QString trashPath;
+    QString stageError;
+};
+
+// Hidden sibling of path, so renames between the two never cross a volume.
+QString siblingPath(const QString &path, const QString &tag, const QString &suffix)
+{
+    const QFileInfo info(path);
+    return QStringLiteral("%1/.%2.%3%4").arg(info.absolutePath(), info.fileName(), tag, suffix);
+}
+
+bool entryExists(const QString &path)
+{
+    const QFileInfo info(path);
+    return info.exists() || info.isSymLink();
+}
+
+bool isRealDirectory(const QString &path)
+{
+    const QFileInfo info(path);
+    return info.isDir() && !info.isSymLink();
+}
+
+bool renameEntry(const QString &fromPath, const QString &toPath)
+{
+    // QDir::rename, unlike QFile::rename, never falls back to copying.
+    return QDir().rename(fromPath, toPath);
+}
+
+// Creates directoryPath and any missing parents, recording each directory created so a
+// rollback can remove them again.
+bool createDirectories(const QString &directoryPath, QStringList *createdDirectories, QString *error)
+{
+    QStringList missingDirectories;
+    QString currentPath = QDir::cleanPath(directoryPath);
+    while ( !entryExists(currentPath) )
+    {
+        missingDirectories.prepend(currentPath);
+        const QString parentPath = QFileInfo(currentPath).absolutePath();
+        if ( parentPath == currentPath )
+        {
+            break;
+        }
+        currentPath = parentPath;
+    }
+
+    for ( const QString &missingDirectory : missingDirectories )
+    {
+        if ( !QDir().mkdir(missingDirectory) )
+        {
+            *error = QStringLiteral("create directory %1 failed").arg(missingDirectory);
+            return false;
+        }
+        createdDirectories->append(missingDirectory);
+    }
+    return true;
+}
+
+bool prepareParent(
+    const QString &path,
+    bool createDirs,
+    QStringList *createdDirectories,
+    QString *error
+)
+{
+    const QString parentPath = QFileInfo(path).absolutePath();
+    if ( isRealDirectory(parentPath) )
+    {
+        return true;
+    }
+    if ( !createDirs )
+    {
+        *error = QStringLiteral("parent directory does not exist");
+        return false;
+    }
+    return createDirectories(parentPath, createdDirectories, error);
+}
+
+bool reserveSibling(const QString &path, const QString &tag, const QString &suffix, QString *siblingOut, QString *error)
+{
+    *siblingOut = siblingPath(path, tag, suffix);
+    if ( entryExists(*siblingOut) )
+    {
+        *error = QStringLiteral("staging path %1 already exists").arg(*siblingOut);
+        return false;
+    }
+    return true;
+}
+
+bool prepareItem(
+    const FileWriteBatchItem &item,
+    const QString &tag,
+    StagedItem *staged,
+    QStringList *createdDirectories,
+    QString *error
+)
+{
+    switch ( item.operation )
+    {
+    case FileWriteBatchOperation::Write:
+    {
+        if ( isRealDirectory(item.path) )
+        {
+            *error = QStringLiteral("target is a directory");
+            return false;
+        }
+        // The commit renames a new file into place, which would replace the link itself
+        // rather than write through it; resolving it here could also land on a path that
+        // another item touches, so leave that choice to the caller.
+        const QFileInfo targetInfo(item.path);
+        if ( targetInfo.isSymLink() )
+        {
+            *error = QStringLiteral("target is a symbolic link to %1; write to the link target instead")
+                .arg(targetInfo.symLinkTarget());
+            return false;
+        }
+        if ( !prepareParent(item.path, item.createDirs, createdDirectories, error) ||
+             !reserveSibling(item.path, tag, QStringLiteral(".tmp"), &staged->tempPath, error) )
+        {
+            return false;
+        }
+        staged->result.overwritten = entryExists(item.path);
+        if ( staged->result.overwritten )
+        {
+            return reserveSibling(item.path, tag, QStringLiteral(".bak"), &staged->backupPath, error);
+        }
+        return true;
+    }
+    case FileWriteBatchOperation::Move:
+    {
+        if ( !entryExists(item.path) )
+        {
+            *error = QStringLiteral("source does not exist");
+            return false;
+        }
+        staged->result.targetType = isRealDirectory(item.path) ? QStringLiteral("directory") : QStringLiteral("file");
+        if ( !prepareParent(item.destinationPath, item.createDirs, createdDirectories, error) )
+        {
+            return false;
+        }
+        staged->result.overwritten = entryExists(item.destinationPath);
+        if ( staged->result.overwritten )
+        {
+            if ( !item.overwrite )
+            {
+                *error = QStringLiteral("destination already exists");
+                return false;
+            }
+            staged->backupIsDirectory = isRealDirectory(item.destinationPath);
+            return reserveSibling(item.destinationPath, tag, QStringLiteral(".bak"), &staged->backupPath, error);
+        }
+        return true;
+    }
+    case FileWriteBatchOperation::Delete:
+    {
+        if ( !entryExists(item.path) )
+        {
+            *error = QStringLiteral("target does not exist");
+            return false;
+        }
+        staged->backupIsDirectory = isRealDirectory(item.path);
+        staged->result.targetType = staged->backupIsDirectory ? QStringLiteral("directory") : QStringLiteral("file");
+        if ( item.permanent )
+        {
+            return reserveSibling(item.path, tag, QStringLiteral(".bak"), &staged->backupPath, error);
+        }
+        return true;
+    }
+    case FileWriteBatchOperation::MakeDir:
+    {
+        staged->result.targetType = QStringLiteral("directory");
+        if ( entryExists(item.path) )
+        {
+            if ( !isRealDirectory(item.path) )
+            {
+                *error = QStringLiteral("target exists and is not a directory");
+                return false;
+            }
+            return true;
+        }
+        if ( !item.createDirs && !isRealDirectory(QFileInfo(item.path).absolutePath()) )
+        {
+            *error = QStringLiteral("parent directory does not exist");
+            return false;
+        }
+        staged->result.created = true;
+        return createDirectories(item.path, createdDirectories, error);
+    }
+    }
+    return true;
+}
+
+void stageWrite(const FileWriteBatchItem &item, FileDurabilityLevel durability, StagedItem *staged)
+{
+    QFile file(staged->tempPath);
+    if ( !file.open(QIODevice::WriteOnly | QIODevice::NewOnly) )
+    {
+        staged->stageError = QStringLiteral("create temporary file failed: %1").arg(file.errorString().trimmed());
+        return;
+    }
+    staged->tempExists = true;
+
+    // A replaced file keeps its permissions, as it does when written in place.
+    if ( staged->result.overwritten )
+    {
+        file.setPermissions(QFileInfo(item.path).permissions());
+    }
+    if ( file.write(item.content) != item.content.size() )
+    {
+        staged->stageError = QStringLiteral("write temporary file failed: %1").arg(file.errorString().trimmed());
+        return;
+    }
+    QString syncError;
+    if ( !FileDurability::syncFile(&file, durability, &syncError) )
+    {
+        staged->stageError = QStringLiteral("temporary file %1").arg(syncError);
+        return;
+    }
+    file.close();
+    staged->result.bytesWritten = item.content.size();
+}
+
+// Puts a backup back at path after the rename that was to take its place failed.
+void restoreBackup(const StagedItem &staged, const QString &path, QStringList *rollbackErrors)
+{
+    if ( !staged.backupPath.isEmpty() && !renameEntry(staged.backupPath, path) )
+    {
+        rollbackErrors->append(QStringLiteral("restore %1 failed; previous entry kept at %2").arg(path, staged.backupPath));
+    }
+}
+
+bool commitItem(
+    const FileWriteBatchItem &item,
+    StagedItem *staged,
+    QStringList *rollbackErrors,
+    QString *error
+)
+{
+    switch ( item.operation )
+    {
+    case FileWriteBatchOperation::Write:
+        if ( !staged->backupPath.isEmpty() && !renameEntry(item.path, staged->backupPath) )
+        {
+            *error = QStringLiteral("move existing file aside failed");
+            return false;
+        }
+        if ( !renameEntry(staged->tempPath, item.path) )
+        {
+            restoreBackup(*staged, item.path, rollbackErrors);
+            *error = QStringLiteral("rename temporary file over target failed");
+            return false;
+        }
+        staged->tempExists = false;
+        return true;
+    case FileWriteBatchOperation::Move:
+        if ( !staged->backupPath.isEmpty() && !renameEntry(item.destinationPath, staged->backupPath) )
+        {
+            *error = QStringLiteral("move existing destination aside failed");
+            return false;
+        }
+        if ( !renameEntry(item.path, item.destinationPath) )
+        {
+            restoreBackup(*staged, item.destinationPath, rollbackErrors);
+            *error = QStringLiteral("rename failed (source and destination must be on the same volume)");
+            return false;
+        }
+        return true;
+    case FileWriteBatchOperation::Delete:
+        if ( item.permanent )
+        {
+            if ( !renameEntry(item.path, staged->backupPath) )
+            {
+                *error = QStringLiteral("move target aside failed");
+                return false;
+            }
+            return true;
+        }
+        if ( !QFile::moveToTrash(item.path, &staged->trashPath) )
+        {
+            *error = QStringLiteral("move target to trash failed");
+            return false;
+        }
+        return true;
+    case FileWriteBatchOperation::MakeDir:
+        // Created while preparing; removed with the other created directories on rollback.
+        return true;
+    }
+    return true;
+}
+
+void rollbackItem(const FileWriteBatchItem &item, const StagedItem &staged, QStringList *rollbackErrors)
+{
+    switch ( item.operation )
+    {
+    case FileWriteBatchOperation::Write:
+        if ( !QFile::remove(item.path) )
+        {
+            rollbackErrors->append(QStringLiteral("remove written file %1 failed").arg(item.path));
+            if ( !staged.backupPath.isEmpty() )
+            {
+                rollbackErrors->append(QStringLiteral("previous content of %1 kept at %2").arg(item.path, staged.backupPath));
+            }
+            return;
+        }
+        restoreBackup(staged, item.path, rollbackErrors);
+        return;
+    case FileWriteBatchOperation::Move:
+        if ( !renameEntry(item.destinationPath, item.path) )
+        {
+            rollbackErrors->append(QStringLiteral("move %1 back to %2 failed").arg(item.destinationPath, item.path));
+            return;
+        }
+        restoreBackup(staged, item.destinationPath, rollbackErrors);
+        return;
+    case FileWriteBatchOperation::Delete:
+        if ( item.permanent )
+        {
+            restoreBackup(staged, item.path, rollbackErrors);
+        }
+        else if ( !renameEntry(staged.trashPath, item.path) )
+        {
+            rollbackErrors->append(QStringLiteral("restore %1 from trash failed; it is at %2").arg(item.path, staged.trashPath));
+        }
+        return;
+    case FileWriteBatchOperation::MakeDir:
+        return;
+    }
+}
+
+void discardStaged(
+    const QVector<StagedItem> &stagedItems,
+    const QStringList &createdDirectories,
+    QStringList *rollbackErrors
+)
+{
+    for ( const StagedItem &staged : stagedItems )
+    {
+        if ( staged.tempExists && !QFile::remove(staged.tempPath) )
+        {
+            rollbackErrors->append(QStringLiteral("remove temporary file %1 failed").arg(staged.tempPath));
+        }
+    }
+    // Deepest first; a directory that is no longer empty is left alone.
+    for ( int index = createdDirectories.size() - 1; index >= 0; --index )
+    {
+        if ( !QDir().rmdir(createdDirectories.at(index)) )
+        {
+            rollbackErrors->append(QStringLiteral("remove created directory %1 failed").arg(createdDirectories.at(index)));
+        }
+    }
+}
+
+void removeBackup(const StagedItem &staged, QStringList *warnings)
+{
+    if ( !staged.backupIsDirectory )
+    {
+        if ( !QFile::remove(staged.backupPath) )
+        {
+            warnings->append(QStringLiteral("remove replaced entry %1 failed").arg(staged.backupPath));
+        }
+        return;
+    }
+
+    FileRemoveSummary removeSummary;
+    QString removeError;
+    if ( !FileRemover::removeTree(staged.backupPath, FileRemoveOptions(), &removeSummary, &removeError) ||
+         !removeSummary.errors.isEmpty() )
+    {
+        warnings->append(QStringLiteral("remove replaced directory %1 failed").arg(staged.backupPath));
+    }
+}
+}
+
+bool FileWriteBatch::commit(
+    const QList<FileWriteBatchItem> &items,
+    FileDurabilityLevel durability,
+    FileWriteBatchSummary *summary,
+    QString *error
+)
+{
+    *summary = FileWriteBatchSummary();
+    const QString tag = QStringLiteral("jqbatch-%1").arg(
+        QUuid::createUuid().toString(QUuid::Id128).left(12)
+    );
+    QVector<StagedItem> stagedItems(items.size());
+    QStringList createdDirectories;
+    QString stepError;
+    int failedIndex = -1;
+
+    for ( int index = 0; index < items.size(); ++index )
+    {
+        if ( !prepareItem(items.at(index), tag, &stagedItems[index], &createdDirectories, &stepError) )
+        {
+            failedIndex = index;
+            break;
+        }
+    }
+
+    if ( failedIndex < 0 )
+    {
+        int writeCount = 0;
+        QThreadPool pool;
+        pool.setMaxThreadCount(batchMaxWorkers);
+        for ( int index = 0; index < items.size(); ++index )
+        {
+            if ( items.at(index).operation != FileWriteBatchOperation::Write )
+            {
+                continue;
+            }
+            ++writeCount;
+            const FileWriteBatchItem *item = &items.at(index);
+            StagedItem *staged = &stagedItems[index];
+            pool.start(
+                [item, staged, durability]()
+                {
+                    stageWrite(*item, durability, staged);
+                }
+            );
+        }
+        pool.waitForDone();
+        summary->workerCount = qMin(writeCount, batchMaxWorkers);
+
+        for ( int index = 0; index < items.size(); ++index )
+        {
+            if ( !stagedItems.at(index).stageError.isEmpty() )
+            {
+                failedIndex = index;
+                stepError = stagedItems.at(index).stageError;
+                break;
+            }
+        }
+    }
+
+    // Commit point: renames only, in item order.
+    int committedCount = 0;
+    if ( failedIndex < 0 )
+    {
+        for ( ; committedCount < items.size(); ++committedCount )
+        {
+            if ( !commitItem(items.at(committedCount), &stagedItems[committedCount], &summary->rollbackErrors, &stepError) )
+            {
+                failedIndex = committedCount;
+                break;
+            }
+        }
+    }
+
+    if ( failedIndex >= 0 )
+    {
+        for ( int index = committedCount - 1; index >= 0; --index )
+        {
+            rollbackItem(items.at(index), stagedItems.at(index), &summary->rollbackErrors);
+        }
+        discardStaged(stagedItems, createdDirectories, &summary->rollbackErrors);
+        summary->failedIndex = failedIndex;
+        *error = QStringLiteral("operations[%1] failed: %2").arg(failedIndex).arg(stepError);
+        return false;
+    }
+
+    if ( durability == FileDurabilityLevel::Full )
+    {
+        QSet<QString> directories;
+        for ( const FileWriteBatchItem &item : items )
+        {
+            directories.insert(QFileInfo(item.path).absolutePath());
+            if ( item.operation == FileWriteBatchOperation::Move )
+            {
+                directories.insert(QFileInfo(item.destinationPath).absolutePath());
+            }
+        }
+        for ( const QString &createdDirectory : createdDirectories )
+        {
+            directories.insert(QFileInfo(createdDirectory).absolutePath());
+        }
+        for ( const QString &directory : directories )
+        {
+            QString syncError;
+            if ( !FileDurability::syncDirectory(directory, &syncError) )
+            {
+                summary->warnings.append(syncError);
+            }
+        }
+        summary->syncedDirectoryCount = directories.size();
+    }
+
+    for ( int index = 0; index < items.size(); ++index )
+    {
+        const StagedItem &staged = stagedItems.at(index);
+        if ( !staged.backupPath.isEmpty() )
+        {
+            removeBackup(staged, &summary->warnings);
+        }
+        summary->results.append(staged.result);
+    }
+    return true;
+}
@@ -0,0 +1,83 @@
+#ifndef JQOPENCLAW_CAPABILITIES_FILE_FILEWRITEBATCH_H_
+#define JQOPENCLAW_CAPABILITIES_FILE_FILEWRITEBATCH_H_
+
+// Qt lib import
+#include <QByteArray>
+#include <QList>
+#include <QString>
+#include <QStringList>
+
+// JQOpenClaw import
+#include "capabilities/file/filedurability.h"
+
+enum class FileWriteBatchOperation
+{
+    Write,
+    Move,
+    Delete,
+    MakeDir,
+};
+
+struct FileWriteBatchItem
+{
+    FileWriteBatchOperation operation = FileWriteBatchOperation::Write;
+    // Absolute paths.
+    QString path;
+    QString destinationPath;
+    QByteArray content;
+    bool createDirs = true;
+    // Move only; a write always replaces an existing file.
+    bool overwrite = false;
+    // Delete only: remove for good instead of moving to the trash.
+    bool permanent = false;
+};
+
+struct FileWriteBatchItemResult
+{
+    // file or directory; empty for writes, which always produce a file.
+    QString targetType;
+    // An existing entry was replaced (write, move).
+    bool overwritten = false;
+    // mkdir: the directory did not exist yet.
+    bool created = false;
+    qint64 bytesWritten = 0;
+};
+
+struct FileWriteBatchSummary
+{
+    // Same order as the items; only filled when the batch committed.
+    QList<FileWriteBatchItemResult> results;
+    int workerCount = 0;
+    int syncedDirectoryCount = 0;
+    // Problems after the commit point (directory sync, removing replaced entries); the
+    // batch stays committed.
+    QStringList warnings;
+    // On failure: the item that failed (-1 if none in particular) and anything the
+    // rollback could not restore.
+    int failedIndex = -1;
+    QStringList rollbackErrors;
+};
+
+// Applies write/move/delete/mkdir items as one unit. Items are prepared first (parents
+// created, new contents written to temporary files next to their targets, concurrently
+// and synced per durability), then committed in order with renames only; existing
+// entries that get replaced or deleted are renamed aside, not removed. A failure at any
+// point undoes the committed renames in reverse order and removes what was staged, so
+// the tree is left as it was. Replaced entries are removed once every item committed,
+// and with Full durability each touched directory is synced once at the end.
+//
+// Items must not touch the same path, or a path inside a directory that another item
+// moves or deletes; the caller checks that. Moves are renames only, so both ends must
+// be on the same volume. Writes to a symbolic link are rejected instead of replacing it.
+class FileWriteBatch
+{
+public:
+    static bool commit(
+        const QList<FileWriteBatchItem> &items,
+        FileDurabilityLevel durability,
+        FileWriteBatchSummary *summary,
+        QString *error
+    );
+};
+
+#endif // JQOPENCLAW_CAPABILITIES_FILE_FILEWRITEBATCH_H_
@@ -17,6 +17,7 @@
 #include <QUrl>
 
 // JQOpenClaw import
+#include "capabilities/file/filehasher.h"
 #include "common/common.h"
 
 namespace
@@ -365,21 +366,23 @@ bool NodeSelfUpdate::execute(
         return false;
     }
 
-    QString currentMd5;
-    QString currentMd5Error;
-    if ( !Common::calculateFileMd5Hex(
-            appPath,
-            &currentMd5,
-            &currentMd5Error,
-            QStringLiteral("node.selfUpdate")
-        ) )
+    // The running binary rarely changes between update checks, so its digest is cached.
+    const QList<FileHashResult> currentMd5Results = FileHasher::hashFiles(
+        QStringList() << appPath,
+        FileHashAlgorithm::Md5,
+        true,
+        -1
+    );
+    if ( !currentMd5Results.first().ok )
     {
         if ( error != nullptr )
         {
-            *error = currentMd5Error;
+            *error = QStringLiteral("node.selfUpdate failed to calculate md5: %1")
+                .arg(currentMd5Results.first().error);
         }
         return false;
     }
+    const QString currentMd5 = currentMd5Results.first().digestHex;
 
     if ( currentMd5 == expectedMd5 )
     {
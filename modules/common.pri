@@ -1,6 +1,10 @@
 HEADERS *= \
-    $$PWD/common/common.h
+    $$PWD/common/base64codec.h \
+    $$PWD/common/common.h \
+    $$PWD/common/gzipcodec.h
 
 SOURCES *= \
-    $$PWD/common/common.cpp
+    $$PWD/common/base64codec.cpp \
+    $$PWD/common/common.cpp \
+    $$PWD/common/gzipcodec.cpp
 
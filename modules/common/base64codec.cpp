@@ -0,0 +1,673 @@
+// .h include
+#include "common/base64codec.h"
+
+// C++ lib import
+#include <cstring>
+
+#if defined(Q_PROCESSOR_X86)
+#define JQOPENCLAW_BASE64_X86
+#include <immintrin.h>
+#if defined(_MSC_VER) && !defined(__clang__)
+#include <intrin.h>
+#define JQOPENCLAW_BASE64_TARGET_SSE41
+#define JQOPENCLAW_BASE64_TARGET_AVX2
+#else
+#define JQOPENCLAW_BASE64_TARGET_SSE41 __attribute__((target("sse4.1")))
+#define JQOPENCLAW_BASE64_TARGET_AVX2 __attribute__((target("avx2")))
+#endif
+#elif defined(Q_PROCESSOR_ARM_64)
+#define JQOPENCLAW_BASE64_NEON
+#include <arm_neon.h>
+#endif
+
+namespace
+{
+// Conversions between UTF-16 and the byte kernels go through stack blocks of this many
+// characters (a multiple of 4), so no heap temporaries are needed.
+constexpr qint64 base64WideBlockChars = 4096;
+constexpr qint64 base64WideBlockBytes = base64WideBlockChars / 4 * 3;
+
+constexpr char base64Alphabet[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+
+struct Base64DecodeTable
+{
+    // 0xFF marks characters outside the alphabet (including '=').
+    quint8 values[256];
+
+    constexpr Base64DecodeTable() :
+        values()
+    {
+        for ( int index = 0; index < 256; ++index )
+        {
+            values[index] = 0xFF;
+        }
+        for ( int index = 0; index < 64; ++index )
+        {
+            values[static_cast<quint8>(base64Alphabet[index])] = static_cast<quint8>(index);
+        }
+    }
+};
+
+constexpr Base64DecodeTable base64DecodeTable;
+
+// Bulk kernels handle a prefix of the input and return how much of it they consumed;
+// the scalar code finishes the rest. Decode kernels only ever see whole quads without
+// padding, and return -1 on an invalid character.
+using EncodeBulkFunction = qint64 (*)(const quint8 *data, qint64 size, char *out);
+using DecodeBulkFunction = qint64 (*)(const char *text, qint64 size, quint8 *out);
+
+struct Base64Kernels
+{
+    const char *name;
+    EncodeBulkFunction encodeBulk;
+    DecodeBulkFunction decodeBulk;
+};
+
+qint64 encodeBulkScalar(const quint8 *, qint64, char *)
+{
+    return 0;
+}
+
+qint64 decodeBulkScalar(const char *, qint64, quint8 *)
+{
+    return 0;
+}
+
+void encodeTriplesScalar(const quint8 *data, qint64 size, char *out)
+{
+    for ( qint64 offset = 0; offset + 3 <= size; offset += 3 )
+    {
+        const quint32 value = ( static_cast<quint32>(data[offset]) << 16 ) |
+            ( static_cast<quint32>(data[offset + 1]) << 8 ) |
+            static_cast<quint32>(data[offset + 2]);
+        *out++ = base64Alphabet[( value >> 18 ) & 0x3F];
+        *out++ = base64Alphabet[( value >> 12 ) & 0x3F];
+        *out++ = base64Alphabet[( value >> 6 ) & 0x3F];
+        *out++ = base64Alphabet[value & 0x3F];
+    }
+}
+
+bool decodeQuadsScalar(const char *text, qint64 size, quint8 *out)
+{
+    for ( qint64 offset = 0; offset + 4 <= size; offset += 4 )
+    {
+        const quint32 a = base64DecodeTable.values[static_cast<quint8>(text[offset])];
+        const quint32 b = base64DecodeTable.values[static_cast<quint8>(text[offset + 1])];
+        const quint32 c = base64DecodeTable.values[static_cast<quint8>(text[offset + 2])];
+        const quint32 d = base64DecodeTable.values[static_cast<quint8>(text[offset + 3])];
+        if ( ( a | b | c | d ) & 0x80 )
+        {
+            return false;
+        }
+        const quint32 value = ( a << 18 ) | ( b << 12 ) | ( c << 6 ) | d;
+        *out++ = static_cast<quint8>(value >> 16);
+        *out++ = static_cast<quint8>(value >> 8);
+        *out++ = static_cast<quint8>(value);
+    }
+    return true;
+}
+
+#ifdef JQOPENCLAW_BASE64_X86
+// The x86 kernels follow Wojciech Muła's pshufb/multiply-shift formulation: 12 input
+// bytes are spread over 16 lanes, the sextets isolated with two 16-bit multiplies, and
+// the alphabet offset picked by a 16-entry shuffle table.
+JQOPENCLAW_BASE64_TARGET_SSE41 inline __m128i encodeLanesSse41(__m128i input)
+{
+    const __m128i spread = _mm_shuffle_epi8(
+        input,
+        _mm_set_epi8(10, 11, 9, 10, 7, 8, 6, 7, 4, 5, 3, 4, 1, 2, 0, 1)
+    );
+    const __m128i t0 = _mm_and_si128(spread, _mm_set1_epi32(0x0FC0FC00));
+    const __m128i t1 = _mm_mulhi_epu16(t0, _mm_set1_epi32(0x04000040));
+    const __m128i t2 = _mm_and_si128(spread, _mm_set1_epi32(0x003F03F0));
+    const __m128i t3 = _mm_mullo_epi16(t2, _mm_set1_epi32(0x01000010));
+    const __m128i indices = _mm_or_si128(t1, t3);
+
+    // 0..25 -> 13 ('A'), 26..51 -> 0 ('a' - 26), 52..61 -> 1..10 ('0' - 52), 62 -> 11, 63 -> 12.
+    __m128i reduced = _mm_subs_epu8(indices, _mm_set1_epi8(51));
+    const __m128i isUpper = _mm_cmpgt_epi8(_mm_set1_epi8(26), indices);
+    reduced = _mm_or_si128(reduced, _mm_and_si128(isUpper, _mm_set1_epi8(13)));
+    const __m128i shiftTable = _mm_setr_epi8(
+        'a' - 26, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52,
+        '0' - 52, '0' - 52, '0' - 52, '+' - 62, '/' - 63, 'A', 0, 0
+    );
+    return _mm_add_epi8(_mm_shuffle_epi8(shiftTable, reduced), indices);
+}
+
+// Returns the sextet values, or sets *invalid when any lane is outside the alphabet.
+JQOPENCLAW_BASE64_TARGET_SSE41 inline __m128i decodeLanesSse41(__m128i input, __m128i *invalid)
+{
+    const __m128i highNibbles = _mm_and_si128(_mm_srli_epi32(input, 4), _mm_set1_epi8(0x0F));
+    const __m128i lowNibbles = _mm_and_si128(input, _mm_set1_epi8(0x0F));
+
+    // Bit h of maskTable[l] is set when the character 0xhl is in the alphabet.
+    const __m128i maskTable = _mm_setr_epi8(
+        static_cast<char>(0xA8), static_cast<char>(0xF8), static_cast<char>(0xF8), static_cast<char>(0xF8),
+        static_cast<char>(0xF8), static_cast<char>(0xF8), static_cast<char>(0xF8), static_cast<char>(0xF8),
+        static_cast<char>(0xF8), static_cast<char>(0xF8), static_cast<char>(0xF0), 0x54,
+        0x50, 0x50, 0x50, 0x54
+    );
+    const __m128i bitTable = _mm_setr_epi8(
+        0x01, 0x02, 0x04, 0x08, 0x10, 0x20, 0x40, static_cast<char>(0x80),
+        0, 0, 0, 0, 0, 0, 0, 0
+    );
+    const __m128i shiftTable = _mm_setr_epi8(
+        0, 0, 19, 4, -65, -65, -71, -71,
+        0, 0, 0, 0, 0, 0, 0, 0
+    );
+
+    const __m128i mask = _mm_shuffle_epi8(maskTable, lowNibbles);
+    const __m128i bit = _mm_shuffle_epi8(bitTable, highNibbles);
+    *invalid = _mm_or_si128(
+        *invalid,
+        _mm_cmpeq_epi8(_mm_and_si128(mask, bit), _mm_setzero_si128())
+    );
+
+    // '+' and '/' share a high nibble, so '/' gets its own shift.
+    const __m128i shift = _mm_blendv_epi8(
+        _mm_shuffle_epi8(shiftTable, highNibbles),
+        _mm_set1_epi8(16),
+        _mm_cmpeq_epi8(input, _mm_set1_epi8('/'))
+    );
+    return _mm_add_epi8(input, shift);
+}
+
+// Packs 16 sextets into 12 bytes in the low lanes.
+JQOPENCLAW_BASE64_TARGET_SSE41 inline __m128i packSextetsSse41(__m128i values)
+{
+    const __m128i pairs = _mm_maddubs_epi16(values, _mm_set1_epi32(0x01400140));
+    const __m128i words = _mm_madd_epi16(pairs, _mm_set1_epi32(0x00011000));
+    return _mm_shuffle_epi8(
+        words,
+        _mm_setr_epi8(2, 1, 0, 6, 5, 4, 10, 9, 8, 14, 13, 12, -1, -1, -1, -1)
+    );
+}
+
+JQOPENCLAW_BASE64_TARGET_SSE41 qint64 encodeBulkSse41(const quint8 *data, qint64 size, char *out)
+{
+    qint64 consumed = 0;
+    // Each step loads 16 bytes but only consumes 12.
+    while ( size - consumed >= 16 )
+    {
+        const __m128i input = _mm_loadu_si128(reinterpret_cast<const __m128i *>(data + consumed));
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(out), encodeLanesSse41(input));
+        consumed += 12;
+        out += 16;
+    }
+    return consumed;
+}
+
+JQOPENCLAW_BASE64_TARGET_SSE41 qint64 decodeBulkSse41(const char *text, qint64 size, quint8 *out)
+{
+    qint64 consumed = 0;
+    __m128i invalid = _mm_setzero_si128();
+    // Each step stores 16 bytes of which 12 are valid; the spare 4 land on output that
+    // later quads overwrite, which is why 8 characters are kept in reserve.
+    while ( size - consumed >= 24 )
+    {
+        const __m128i input = _mm_loadu_si128(reinterpret_cast<const __m128i *>(text + consumed));
+        const __m128i values = decodeLanesSse41(input, &invalid);
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(out), packSextetsSse41(values));
+        consumed += 16;
+        out += 12;
+    }
+    return ( _mm_movemask_epi8(invalid) != 0 ) ? -1 : consumed;
+}
+
+JQOPENCLAW_BASE64_TARGET_AVX2 qint64 encodeBulkAvx2(const quint8 *data, qint64 size, char *out)
+{
+    const __m256i spreadTable = _mm256_setr_epi8(
+        1, 0, 2, 1, 4, 3, 5, 4, 7, 6, 8, 7, 10, 9, 11, 10,
+        1, 0, 2, 1, 4, 3, 5, 4, 7, 6, 8, 7, 10, 9, 11, 10
+    );
+    const __m256i shiftTable = _mm256_setr_epi8(
+        'a' - 26, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52,
+        '0' - 52, '0' - 52, '0' - 52, '+' - 62, '/' - 63, 'A', 0, 0,
+        'a' - 26, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52,
+        '0' - 52, '0' - 52, '0' - 52, '+' - 62, '/' - 63, 'A', 0, 0
+    );
+
+    qint64 consumed = 0;
+    // 24 bytes per step, one 12-byte group per 128-bit lane; the upper load reads to +28.
+    while ( size - consumed >= 28 )
+    {
+        const __m128i low = _mm_loadu_si128(reinterpret_cast<const __m128i *>(data + consumed));
+        const __m128i high = _mm_loadu_si128(reinterpret_cast<const __m128i *>(data + consumed + 12));
+        const __m256i input = _mm256_inserti128_si256(_mm256_castsi128_si256(low), high, 1);
+
+        const __m256i spread = _mm256_shuffle_epi8(input, spreadTable);
+        const __m256i t0 = _mm256_and_si256(spread, _mm256_set1_epi32(0x0FC0FC00));
+        const __m256i t1 = _mm256_mulhi_epu16(t0, _mm256_set1_epi32(0x04000040));
+        const __m256i t2 = _mm256_and_si256(spread, _mm256_set1_epi32(0x003F03F0));
+        const __m256i t3 = _mm256_mullo_epi16(t2, _mm256_set1_epi32(0x01000010));
+        const __m256i indices = _mm256_or_si256(t1, t3);
+
+        __m256i reduced = _mm256_subs_epu8(indices, _mm256_set1_epi8(51));
+        const __m256i isUpper = _mm256_cmpgt_epi8(_mm256_set1_epi8(26), indices);
+        reduced = _mm256_or_si256(reduced, _mm256_and_si256(isUpper, _mm256_set1_epi8(13)));
+        const __m256i encoded = _mm256_add_epi8(_mm256_shuffle_epi8(shiftTable, reduced), indices);
+
+        _mm256_storeu_si256(reinterpret_cast<__m256i *>(out), encoded);
+        consumed += 24;
+        out += 32;
+    }
+    return consumed;
+}
+
+JQOPENCLAW_BASE64_TARGET_AVX2 qint64 decodeBulkAvx2(const char *text, qint64 size, quint8 *out)
+{
+    const __m256i maskTable = _mm256_setr_epi8(
+        static_cast<char>(0xA8), static_cast<char>(0xF8), static_cast<char>(0xF8), static_cast<char>(0xF8),
+        static_cast<char>(0xF8), static_cast<char>(0xF8), static_cast<char>(0xF8), static_cast<char>(0xF8),
+        static_cast<char>(0xF8), static_cast<char>(0xF8), static_cast<char>(0xF0), 0x54,
+        0x50, 0x50, 0x50, 0x54,
+        static_cast<char>(0xA8), static_cast<char>(0xF8), static_cast<char>(0xF8), static_cast<char>(0xF8),
+        static_cast<char>(0xF8), static_cast<char>(0xF8), static_cast<char>(0xF8), static_cast<char>(0xF8),
+        static_cast<char>(0xF8), static_cast<char>(0xF8), static_cast<char>(0xF0), 0x54,
+        0x50, 0x50, 0x50, 0x54
+    );
+    const __m256i bitTable = _mm256_setr_epi8(
+        0x01, 0x02, 0x04, 0x08, 0x10, 0x20, 0x40, static_cast<char>(0x80),
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0x01, 0x02, 0x04, 0x08, 0x10, 0x20, 0x40, static_cast<char>(0x80),
+        0, 0, 0, 0, 0, 0, 0, 0
+    );
+    const __m256i shiftTable = _mm256_setr_epi8(
+        0, 0, 19, 4, -65, -65, -71, -71, 0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 19, 4, -65, -65, -71, -71, 0, 0, 0, 0, 0, 0, 0, 0
+    );
+    const __m256i packTable = _mm256_setr_epi8(
+        2, 1, 0, 6, 5, 4, 10, 9, 8, 14, 13, 12, -1, -1, -1, -1,
+        2, 1, 0, 6, 5, 4, 10, 9, 8, 14, 13, 12, -1, -1, -1, -1
+    );
+
+    qint64 consumed = 0;
+    __m256i invalid = _mm256_setzero_si256();
+    // Stores 32 bytes per step of which 24 are valid; keep 16 characters in reserve.
+    while ( size - consumed >= 48 )
+    {
+        const __m256i input = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(text + consumed));
+        const __m256i highNibbles = _mm256_and_si256(_mm256_srli_epi32(input, 4), _mm256_set1_epi8(0x0F));
+        const __m256i lowNibbles = _mm256_and_si256(input, _mm256_set1_epi8(0x0F));
+
+        const __m256i mask = _mm256_shuffle_epi8(maskTable, lowNibbles);
+        const __m256i bit = _mm256_shuffle_epi8(bitTable, highNibbles);
+        invalid = _mm256_or_si256(
+            invalid,
+            _mm256_cmpeq_epi8(_mm256_and_si256(mask, bit), _mm256_setzero_si256())
+        );
+
+        const __m256i shift = _mm256_blendv_epi8(
+            _mm256_shuffle_epi8(shiftTable, highNibbles),
+            _mm256_set1_epi8(16),
+            _mm256_cmpeq_epi8(input, _mm256_set1_epi8('/'))
+        );
+        const __m256i values = _mm256_add_epi8(input, shift);
+
+        const __m256i pairs = _mm256_maddubs_epi16(values, _mm256_set1_epi32(0x01400140));
+        const __m256i words = _mm256_madd_epi16(pairs, _mm256_set1_epi32(0x00011000));
+        const __m256i lanes = _mm256_shuffle_epi8(words, packTable);
+        // Close the 4-byte gap between the two 12-byte lane results.
+        const __m256i packed = _mm256_permutevar8x32_epi32(lanes, _mm256_setr_epi32(0, 1, 2, 4, 5, 6, 3, 7));
+        _mm256_storeu_si256(reinterpret_cast<__m256i *>(out), packed);
+        consumed += 32;
+        out += 24;
+    }
+    return ( _mm256_movemask_epi8(invalid) != 0 ) ? -1 : consumed;
+}
+
+struct X86Features
+{
+    bool sse41 = false;
+    bool avx2 = false;
+};
+
+X86Features detectX86Features()
+{
+    X86Features features;
+#if defined(_MSC_VER) && !defined(__clang__)
+    int info[4] = {};
+    __cpuid(info, 0);
+    const int maxLeaf = info[0];
+    __cpuid(info, 1);
+    features.sse41 = ( info[2] & ( 1 << 19 ) ) != 0;
+    const bool osSavesYmm = ( ( info[2] & ( 1 << 27 ) ) != 0 ) &&
+        ( ( info[2] & ( 1 << 28 ) ) != 0 ) &&
+        ( ( _xgetbv(0) & 0x6 ) == 0x6 );
+    if ( osSavesYmm && ( maxLeaf >= 7 ) )
+    {
+        __cpuidex(info, 7, 0);
+        features.avx2 = ( info[1] & ( 1 << 5 ) ) != 0;
+    }
+#else
+    __builtin_cpu_init();
+    features.sse41 = __builtin_cpu_supports("sse4.1") != 0;
+    features.avx2 = __builtin_cpu_supports("avx2") != 0;
+#endif
+    return features;
+}
+#endif
+
+#ifdef JQOPENCLAW_BASE64_NEON
+// 48 bytes -> 64 characters: de-interleaving loads split the byte triples, and a
+// 64-entry table lookup maps the four sextet vectors straight to the alphabet.
+qint64 encodeBulkNeon(const quint8 *data, qint64 size, char *out)
+{
+    uint8x16x4_t alphabet;
+    alphabet.val[0] = vld1q_u8(reinterpret_cast<const quint8 *>(base64Alphabet));
+    alphabet.val[1] = vld1q_u8(reinterpret_cast<const quint8 *>(base64Alphabet) + 16);
+    alphabet.val[2] = vld1q_u8(reinterpret_cast<const quint8 *>(base64Alphabet) + 32);
+    alphabet.val[3] = vld1q_u8(reinterpret_cast<const quint8 *>(base64Alphabet) + 48);
+    const uint8x16_t sextetMask = vdupq_n_u8(0x3F);
+
+    qint64 consumed = 0;
+    while ( size - consumed >= 48 )
+    {
+        const uint8x16x3_t input = vld3q_u8(data + consumed);
+        uint8x16x4_t indices;
+        indices.val[0] = vshrq_n_u8(input.val[0], 2);
+        indices.val[1] = vandq_u8(
+            vorrq_u8(vshlq_n_u8(input.val[0], 4), vshrq_n_u8(input.val[1], 4)),
+            sextetMask
+        );
+        indices.val[2] = vandq_u8(
+            vorrq_u8(vshlq_n_u8(input.val[1], 2), vshrq_n_u8(input.val[2], 6)),
+            sextetMask
+        );
+        indices.val[3] = vandq_u8(input.val[2], sextetMask);
+
+        uint8x16x4_t encoded;
+        for ( int index = 0; index < 4; ++index )
+        {
+            encoded.val[index] = vqtbl4q_u8(alphabet, indices.val[index]);
+        }
+        vst4q_u8(reinterpret_cast<quint8 *>(out), encoded);
+        consumed += 48;
+        out += 64;
+    }
+    return consumed;
+}
+
+qint64 decodeBulkNeon(const char *text, qint64 size, quint8 *out)
+{
+    // Characters 0..63 and 64..127 each get a 64-entry lookup; anything above 127 is
+    // caught by its high bit.
+    uint8x16x4_t lowTable;
+    uint8x16x4_t highTable;
+    for ( int index = 0; index < 4; ++index )
+    {
+        lowTable.val[index] = vld1q_u8(base64DecodeTable.values + ( 16 * index ));
+        highTable.val[index] = vld1q_u8(base64DecodeTable.values + 64 + ( 16 * index ));
+    }
+    const uint8x16_t highOffset = vdupq_n_u8(64);
+
+    qint64 consumed = 0;
+    uint8x16_t invalid = vdupq_n_u8(0);
+    while ( size - consumed >= 64 )
+    {
+        const uint8x16x4_t input = vld4q_u8(reinterpret_cast<const quint8 *>(text + consumed));
+        uint8x16_t values[4];
+        for ( int index = 0; index < 4; ++index )
+        {
+            const uint8x16_t character = input.val[index];
+            values[index] = vqtbx4q_u8(
+                vqtbl4q_u8(lowTable, character),
+                highTable,
+                vsubq_u8(character, highOffset)
+            );
+            invalid = vorrq_u8(invalid, vorrq_u8(values[index], character));
+        }
+
+        uint8x16x3_t decoded;
+        decoded.val[0] = vorrq_u8(vshlq_n_u8(values[0], 2), vshrq_n_u8(values[1], 4));
+        decoded.val[1] = vorrq_u8(vshlq_n_u8(values[1], 4), vshrq_n_u8(values[2], 2));
+        decoded.val[2] = vorrq_u8(vshlq_n_u8(values[2], 6), values[3]);
+        vst3q_u8(out, decoded);
+        consumed += 64;
+        out += 48;
+    }
+    // Valid sextets stay below 0x40 and valid characters below 0x80, so bit 7 of the
+    // combined value is only set by 0xFF table entries or non-ASCII input.
+    return ( vmaxvq_u8(invalid) & 0x80 ) ? -1 : consumed;
+}
+#endif
+
+Base64Kernels selectKernels()
+{
+#ifdef JQOPENCLAW_BASE64_X86
+    const X86Features features = detectX86Features();
+    if ( features.avx2 )
+    {
+        return { "avx2", &encodeBulkAvx2, &decodeBulkAvx2 };
+    }
+    if ( features.sse41 )
+    {
+        return { "sse4.1", &encodeBulkSse41, &decodeBulkSse41 };
+    }
+#endif
+#ifdef JQOPENCLAW_BASE64_NEON
+    return { "neon", &encodeBulkNeon, &decodeBulkNeon };
+#else
+    return { "scalar", &encodeBulkScalar, &decodeBulkScalar };
+#endif
+}
+
+const Base64Kernels &base64Kernels()
+{
+    static const Base64Kernels kernels = selectKernels();
+    return kernels;
+}
+
+void encodeBytes(const quint8 *data, qint64 size, char *out)
+{
+    const qint64 bulkBytes = base64Kernels().encodeBulk(data, size, out);
+    const qint64 tripleBytes = size - ( size % 3 );
+    encodeTriplesScalar(data + bulkBytes, tripleBytes - bulkBytes, out + ( bulkBytes / 3 * 4 ));
+
+    const qint64 tailBytes = size - tripleBytes;
+    if ( tailBytes == 0 )
+    {
+        return;
+    }
+    char *tail = out + ( tripleBytes / 3 * 4 );
+    const quint32 value = ( static_cast<quint32>(data[tripleBytes]) << 16 ) |
+        ( ( tailBytes == 2 ) ? ( static_cast<quint32>(data[tripleBytes + 1]) << 8 ) : 0U );
+    tail[0] = base64Alphabet[( value >> 18 ) & 0x3F];
+    tail[1] = base64Alphabet[( value >> 12 ) & 0x3F];
+    tail[2] = ( tailBytes == 2 ) ? base64Alphabet[( value >> 6 ) & 0x3F] : '=';
+    tail[3] = '=';
+}
+
+bool decodeQuads(const char *text, qint64 size, quint8 *out)
+{
+    const qint64 bulkChars = base64Kernels().decodeBulk(text, size, out);
+    if ( bulkChars < 0 )
+    {
+        return false;
+    }
+    return decodeQuadsScalar(text + bulkChars, size - bulkChars, out + ( bulkChars / 4 * 3 ));
+}
+
+// Decodes the last 2 or 3 significant characters of the input into 1 or 2 bytes.
+bool decodePartialQuad(const char *text, qint64 size, quint8 *out, qint64 *outSize)
+{
+    *outSize = 0;
+    if ( size == 0 )
+    {
+        return true;
+    }
+    if ( size == 1 )
+    {
+        return false;
+    }
+
+    const quint32 a = base64DecodeTable.values[static_cast<quint8>(text[0])];
+    const quint32 b = base64DecodeTable.values[static_cast<quint8>(text[1])];
+    const quint32 c = ( size == 3 ) ? base64DecodeTable.values[static_cast<quint8>(text[2])] : 0U;
+    if ( ( a | b | c ) & 0x80 )
+    {
+        return false;
+    }
+    const quint32 value = ( a << 18 ) | ( b << 12 ) | ( c << 6 );
+    out[0] = static_cast<quint8>(value >> 16);
+    *outSize = 1;
+    if ( size == 3 )
+    {
+        out[1] = static_cast<quint8>(value >> 8);
+        *outSize = 2;
+    }
+    return true;
+}
+
+// Splits the input into whole quads and a 0/2/3-character tail after validating the
+// padding. Padded input must be a multiple of 4 characters long.
+template<typename Char>
+bool splitEncoded(const Char *text, qint64 size, qint64 *quadChars, qint64 *tailChars)
+{
+    qint64 padding = 0;
+    if ( ( size > 0 ) && ( text[size - 1] == Char('=') ) )
+    {
+        if ( ( size % 4 ) != 0 )
+        {
+            return false;
+        }
+        padding = ( text[size - 2] == Char('=') ) ? 2 : 1;
+    }
+
+    const qint64 significantChars = size - padding;
+    *tailChars = significantChars % 4;
+    *quadChars = significantChars - *tailChars;
+    return *tailChars != 1;
+}
+
+// Narrows UTF-16 code units into a byte block; anything outside ASCII becomes 0x80,
+// which no kernel accepts.
+void narrowBlock(const char16_t *text, qint64 size, char *out)
+{
+    for ( qint64 index = 0; index < size; ++index )
+    {
+        out[index] = ( text[index] < 0x80 ) ? static_cast<char>(text[index]) : static_cast<char>(0x80);
+    }
+}
+}
+
+qint64 Base64Codec::encodedSize(qint64 size)
+{
+    return ( qMax<qint64>(0, size) + 2 ) / 3 * 4;
+}
+
+qint64 Base64Codec::maxDecodedSize(qint64 encodedSize)
+{
+    return ( qMax<qint64>(0, encodedSize) + 3 ) / 4 * 3;
+}
+
+void Base64Codec::encode(const void *data, qint64 size, char *out)
+{
+    if ( size <= 0 )
+    {
+        return;
+    }
+    encodeBytes(static_cast<const quint8 *>(data), size, out);
+}
+
+void Base64Codec::encode(const void *data, qint64 size, char16_t *out)
+{
+    const quint8 *input = static_cast<const quint8 *>(data);
+    char block[base64WideBlockChars];
+    for ( qint64 offset = 0; offset < size; offset += base64WideBlockBytes )
+    {
+        const qint64 blockBytes = qMin(base64WideBlockBytes, size - offset);
+        const qint64 blockChars = encodedSize(blockBytes);
+        encodeBytes(input + offset, blockBytes, block);
+        for ( qint64 index = 0; index < blockChars; ++index )
+        {
+            out[index] = static_cast<char16_t>(static_cast<quint8>(block[index]));
+        }
+        out += blockChars;
+    }
+}
+
+bool Base64Codec::decode(const char *text, qint64 size, void *out, qint64 *outSize)
+{
+    qint64 quadChars = 0;
+    qint64 tailChars = 0;
+    if ( ( outSize == nullptr ) || !splitEncoded(text, size, &quadChars, &tailChars) )
+    {
+        return false;
+    }
+
+    quint8 *output = static_cast<quint8 *>(out);
+    if ( !decodeQuads(text, quadChars, output) )
+    {
+        return false;
+    }
+    qint64 tailBytes = 0;
+    if ( !decodePartialQuad(text + quadChars, tailChars, output + ( quadChars / 4 * 3 ), &tailBytes) )
+    {
+        return false;
+    }
+    *outSize = ( quadChars / 4 * 3 ) + tailBytes;
+    return true;
+}
+
+bool Base64Codec::decode(const char16_t *text, qint64 size, void *out, qint64 *outSize)
+{
+    qint64 quadChars = 0;
+    qint64 tailChars = 0;
+    if ( ( outSize == nullptr ) || !splitEncoded(text, size, &quadChars, &tailChars) )
+    {
+        return false;
+    }
+
+    quint8 *output = static_cast<quint8 *>(out);
+    char block[base64WideBlockChars];
+    for ( qint64 offset = 0; offset < quadChars; offset += base64WideBlockChars )
+    {
+        const qint64 blockChars = qMin(base64WideBlockChars, quadChars - offset);
+        narrowBlock(text + offset, blockChars, block);
+        if ( !decodeQuads(block, blockChars, output + ( offset / 4 * 3 )) )
+        {
+            return false;
+        }
+    }
+
+    char tail[3] = {};
+    narrowBlock(text + quadChars, tailChars, tail);
+    qint64 tailBytes = 0;
+    if ( !decodePartialQuad(tail, tailChars, output + ( quadChars / 4 * 3 ), &tailBytes) )
+    {
+        return false;
+    }
+    *outSize = ( quadChars / 4 * 3 ) + tailBytes;
+    return true;
+}
+
+QString Base64Codec::toBase64String(const void *data, qint64 size)
+{
+    QString out(static_cast<qsizetype>(encodedSize(size)), Qt::Uninitialized);
+    encode(data, size, reinterpret_cast<char16_t *>(out.data()));
+    return out;
+}
+
+bool Base64Codec::fromBase64String(const QString &text, QByteArray *bytes)
+{
+    if ( bytes == nullptr )
+    {
+        return false;
+    }
+
+    QByteArray out(static_cast<qsizetype>(maxDecodedSize(text.size())), Qt::Uninitialized);
+    qint64 decodedSize = 0;
+    if ( !decode(reinterpret_cast<const char16_t *>(text.utf16()), text.size(), out.data(), &decodedSize) )
+    {
+        return false;
+    }
+    out.truncate(static_cast<qsizetype>(decodedSize));
+    *bytes = out;
+    return true;
+}
+
+const char *Base64Codec::kernelName()
+{
+    return base64Kernels().name;
+}
@@ -0,0 +1,40 @@
+#ifndef JQOPENCLAW_COMMON_BASE64CODEC_H_
+#define JQOPENCLAW_COMMON_BASE64CODEC_H_
+
+// Qt lib import
+#include <QByteArray>
+#include <QString>
+#include <QtGlobal>
+
+// Standard-alphabet base64 that reads and writes caller-provided buffers. The bulk of
+// the data goes through an AVX2, SSE4.1 or NEON kernel chosen once at runtime, with a
+// scalar fallback; the output is byte-identical to QByteArray::toBase64().
+class Base64Codec
+{
+public:
+    static qint64 encodedSize(qint64 size);
+
+    // Upper bound for decode(); the exact size is only known after padding is seen.
+    static qint64 maxDecodedSize(qint64 encodedSize);
+
+    // Writes exactly encodedSize(size) characters, '=' padded, without a terminator.
+    static void encode(const void *data, qint64 size, char *out);
+
+    static void encode(const void *data, qint64 size, char16_t *out);
+
+    // Strict decoding, matching QByteArray::AbortOnBase64DecodingErrors: only the
+    // standard alphabet, no whitespace, and '=' padding (optional) only at the end.
+    // out needs maxDecodedSize(size) bytes; *outSize receives the decoded length.
+    static bool decode(const char *text, qint64 size, void *out, qint64 *outSize);
+
+    static bool decode(const char16_t *text, qint64 size, void *out, qint64 *outSize);
+
+    static QString toBase64String(const void *data, qint64 size);
+
+    static bool fromBase64String(const QString &text, QByteArray *bytes);
+
+    // "avx2", "sse4.1", "neon" or "scalar".
+    static const char *kernelName();
+};
+
+#endif // JQOPENCLAW_COMMON_BASE64CODEC_H_
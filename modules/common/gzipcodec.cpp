@@ -0,0 +1,146 @@
+// .h include
+#include "common/gzipcodec.h"
+
+// C++ lib import
+#include <limits>
+
+namespace
+{
+// Slicing-by-8: eight derived tables let the loop fold in eight bytes per step.
+struct Crc32Tables
+{
+    quint32 values[8][256];
+
+    Crc32Tables() :
+        values()
+    {
+        for ( quint32 index = 0; index < 256; ++index )
+        {
+            quint32 crc = index;
+            for ( int bit = 0; bit < 8; ++bit )
+            {
+                crc = ( crc & 1U ) ? ( ( crc >> 1 ) ^ 0xEDB88320U ) : ( crc >> 1 );
+            }
+            values[0][index] = crc;
+        }
+        for ( quint32 index = 0; index < 256; ++index )
+        {
+            for ( int table = 1; table < 8; ++table )
+            {
+                const quint32 previous = values[table - 1][index];
+                values[table][index] = ( previous >> 8 ) ^ values[0][previous & 0xFFU];
+            }
+        }
+    }
+};
+
+const Crc32Tables &crc32Tables()
+{
+    static const Crc32Tables tables;
+    return tables;
+}
+
+// Size prefix written by qCompress(), then the 2-byte zlib header; the zlib stream ends
+// with a 4-byte Adler-32.
+const qsizetype qCompressPrefixBytes = 4;
+const qsizetype zlibHeaderBytes = 2;
+const qsizetype zlibTrailerBytes = 4;
+
+void appendLittleEndian32(QByteArray *out, quint32 value)
+{
+    for ( int shift = 0; shift < 32; shift += 8 )
+    {
+        out->append(static_cast<char>(( value >> shift ) & 0xFFU));
+    }
+}
+}
+
+bool GzipCodec::compress(const void *data, qint64 size, int level, QByteArray *out)
+{
+    if ( level < 0 )
+    {
+        level = levelForSize(size);
+    }
+    QByteArray deflated;
+    if ( ( out == nullptr ) || !deflateRaw(data, size, level, &deflated) )
+    {
+        return false;
+    }
+
+    out->clear();
+    out->reserve(10 + deflated.size() + 8);
+    // ID1 ID2 CM=deflate FLG=0 MTIME=0, XFL=2 for maximum / 4 for fastest, OS=unknown.
+    const char header[10] = {
+        '\x1F', '\x8B', '\x08', '\x00', '\x00', '\x00', '\x00', '\x00',
+        ( level >= 9 ) ? '\x02' : ( ( level <= 1 ) ? '\x04' : '\x00' ),
+        '\xFF'
+    };
+    out->append(header, sizeof(header));
+    out->append(deflated);
+    appendLittleEndian32(out, crc32(data, size));
+    appendLittleEndian32(out, static_cast<quint32>(size & 0xFFFFFFFF));
+    return true;
+}
+
+bool GzipCodec::deflateRaw(const void *data, qint64 size, int level, QByteArray *out)
+{
+    if ( ( out == nullptr ) || ( size < 0 ) ||
+         ( size > static_cast<qint64>(std::numeric_limits<qsizetype>::max()) ) )
+    {
+        return false;
+    }
+    if ( level < 0 )
+    {
+        level = levelForSize(size);
+    }
+
+    const QByteArray zlib = qCompress(
+        static_cast<const uchar *>(data),
+        static_cast<qsizetype>(size),
+        qBound(1, level, 9)
+    );
+    const qsizetype deflateOffset = qCompressPrefixBytes + zlibHeaderBytes;
+    if ( zlib.size() < ( deflateOffset + zlibTrailerBytes ) )
+    {
+        return false;
+    }
+    *out = zlib.mid(deflateOffset, zlib.size() - deflateOffset - zlibTrailerBytes);
+    return true;
+}
+
+int GzipCodec::levelForSize(qint64 size)
+{
+    if ( size <= ( 128 * 1024 ) )
+    {
+        return 9;
+    }
+    if ( size <= ( 1024 * 1024 ) )
+    {
+        return 6;
+    }
+    return 1;
+}
+
+quint32 GzipCodec::crc32(const void *data, qint64 size, quint32 crc)
+{
+    const quint8 *bytes = static_cast<const quint8 *>(data);
+    const auto &t = crc32Tables().values;
+    crc = ~crc;
+    while ( size >= 8 )
+    {
+        const quint32 low = crc ^ ( static_cast<quint32>(bytes[0]) |
+            ( static_cast<quint32>(bytes[1]) << 8 ) |
+            ( static_cast<quint32>(bytes[2]) << 16 ) |
+            ( static_cast<quint32>(bytes[3]) << 24 ) );
+        crc = t[7][low & 0xFFU] ^ t[6][( low >> 8 ) & 0xFFU] ^
+            t[5][( low >> 16 ) & 0xFFU] ^ t[4][low >> 24] ^
+            t[3][bytes[4]] ^ t[2][bytes[5]] ^ t[1][bytes[6]] ^ t[0][bytes[7]];
+        bytes += 8;
+        size -= 8;
+    }
+    while ( size-- > 0 )
+    {
+        crc = ( crc >> 8 ) ^ t[0][( crc ^ *bytes++ ) & 0xFFU];
+    }
+    return ~crc;
+}
@@ -0,0 +1,28 @@
+#ifndef JQOPENCLAW_COMMON_GZIPCODEC_H_
+#define JQOPENCLAW_COMMON_GZIPCODEC_H_
+
+// Qt lib import
+#include <QByteArray>
+#include <QtGlobal>
+
+// gzip (RFC 1952) members built around Qt's bundled deflate: qCompress() output is a
+// zlib stream, so its header and Adler-32 trailer are swapped for the gzip header and
+// a CRC-32 / length trailer. No separate zlib dependency is needed.
+class GzipCodec
+{
+public:
+    // level < 0 picks one from the input size (see levelForSize()).
+    static bool compress(const void *data, qint64 size, int level, QByteArray *out);
+
+    // Bare deflate stream (RFC 1951) without any wrapper, as stored in zip entries.
+    static bool deflateRaw(const void *data, qint64 size, int level, QByteArray *out);
+
+    // Smaller inputs get the stronger (slower) levels; deflate time grows with the input
+    // while the saving per byte barely changes, so large inputs use a fast level.
+    static int levelForSize(qint64 size);
+
+    // CRC-32 (IEEE 802.3, as used by gzip and zip), continuing from crc.
+    static quint32 crc32(const void *data, qint64 size, quint32 crc = 0);
+};
+
+#endif // JQOPENCLAW_COMMON_GZIPCODEC_H_
@@ -1,12 +1,16 @@
 HEADERS *= \
     $$PWD/crypto/cryptoencoding.h \
     $$PWD/crypto/deviceidentity/deviceidentity.h \
+    $$PWD/crypto/digest/blake3digest.h \
+    $$PWD/crypto/digest/xxh3digest.h \
     $$PWD/crypto/secretbox/secretboxcrypto.h \
     $$PWD/crypto/signing/deviceauth.h
 
 SOURCES *= \
     $$PWD/crypto/cryptoencoding.cpp \
     $$PWD/crypto/deviceidentity/deviceidentity.cpp \
+    $$PWD/crypto/digest/blake3digest.cpp \
+    $$PWD/crypto/digest/xxh3digest.cpp \
     $$PWD/crypto/secretbox/secretboxcrypto.cpp \
     $$PWD/crypto/signing/deviceauth.cpp
 
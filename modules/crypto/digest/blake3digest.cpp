@@ -0,0 +1,292 @@
+// .h include
+#include "crypto/digest/blake3digest.h"
+
+// Qt lib import
+#include <QThreadPool>
+#include <QtGlobal>
+
+// C++ lib import
+#include <array>
+#include <cstring>
+#include <vector>
+
+namespace
+{
+constexpr qint64 blake3ChunkBytes = 1024;
+constexpr int blake3BlockBytes = 64;
+constexpr int blake3OutBytes = 32;
+// Below this a subtree is not worth a thread hand-off.
+constexpr qint64 blake3MinParallelPieceBytes = 1024 * 1024;
+
+constexpr quint32 blake3FlagChunkStart = 1U << 0;
+constexpr quint32 blake3FlagChunkEnd = 1U << 1;
+constexpr quint32 blake3FlagParent = 1U << 2;
+constexpr quint32 blake3FlagRoot = 1U << 3;
+
+constexpr quint32 blake3Iv[8] = {
+    0x6A09E667U, 0xBB67AE85U, 0x3C6EF372U, 0xA54FF53AU,
+    0x510E527FU, 0x9B05688CU, 0x1F83D9ABU, 0x5BE0CD19U,
+};
+
+constexpr int blake3MessageSchedule[7][16] = {
+    { 0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15 },
+    { 2, 6, 3, 10, 7, 0, 4, 13, 1, 11, 12, 5, 9, 14, 15, 8 },
+    { 3, 4, 10, 12, 13, 2, 7, 14, 6, 5, 9, 0, 11, 15, 8, 1 },
+    { 10, 7, 12, 9, 14, 3, 13, 15, 4, 0, 11, 2, 5, 8, 1, 6 },
+    { 12, 13, 9, 11, 15, 10, 14, 8, 7, 2, 5, 3, 0, 1, 6, 4 },
+    { 9, 14, 11, 5, 8, 12, 15, 1, 13, 3, 0, 10, 2, 6, 4, 7 },
+    { 11, 15, 5, 0, 1, 9, 8, 6, 14, 10, 2, 12, 3, 4, 7, 13 },
+};
+
+using ChainingValue = std::array<quint32, 8>;
+
+inline quint32 rotr32(quint32 value, int bits)
+{
+    return ( value >> bits ) | ( value << ( 32 - bits ) );
+}
+
+inline quint32 readLe32(const quint8 *data)
+{
+    return static_cast<quint32>(data[0]) |
+        ( static_cast<quint32>(data[1]) << 8 ) |
+        ( static_cast<quint32>(data[2]) << 16 ) |
+        ( static_cast<quint32>(data[3]) << 24 );
+}
+
+inline void mixG(quint32 *state, int a, int b, int c, int d, quint32 x, quint32 y)
+{
+    state[a] = state[a] + state[b] + x;
+    state[d] = rotr32(state[d] ^ state[a], 16);
+    state[c] = state[c] + state[d];
+    state[b] = rotr32(state[b] ^ state[c], 12);
+    state[a] = state[a] + state[b] + y;
+    state[d] = rotr32(state[d] ^ state[a], 8);
+    state[c] = state[c] + state[d];
+    state[b] = rotr32(state[b] ^ state[c], 7);
+}
+
+ChainingValue compress(
+    const ChainingValue &chainingValue,
+    const quint32 *blockWords,
+    quint64 counter,
+    quint32 blockLength,
+    quint32 flags
+)
+{
+    quint32 state[16] = {
+        chainingValue[0], chainingValue[1], chainingValue[2], chainingValue[3],
+        chainingValue[4], chainingValue[5], chainingValue[6], chainingValue[7],
+        blake3Iv[0], blake3Iv[1], blake3Iv[2], blake3Iv[3],
+        static_cast<quint32>(counter), static_cast<quint32>(counter >> 32), blockLength, flags,
+    };
+
+    for ( const int *schedule : blake3MessageSchedule )
+    {
+        mixG(state, 0, 4, 8, 12, blockWords[schedule[0]], blockWords[schedule[1]]);
+        mixG(state, 1, 5, 9, 13, blockWords[schedule[2]], blockWords[schedule[3]]);
+        mixG(state, 2, 6, 10, 14, blockWords[schedule[4]], blockWords[schedule[5]]);
+        mixG(state, 3, 7, 11, 15, blockWords[schedule[6]], blockWords[schedule[7]]);
+        mixG(state, 0, 5, 10, 15, blockWords[schedule[8]], blockWords[schedule[9]]);
+        mixG(state, 1, 6, 11, 12, blockWords[schedule[10]], blockWords[schedule[11]]);
+        mixG(state, 2, 7, 8, 13, blockWords[schedule[12]], blockWords[schedule[13]]);
+        mixG(state, 3, 4, 9, 14, blockWords[schedule[14]], blockWords[schedule[15]]);
+    }
+
+    ChainingValue out;
+    for ( int index = 0; index < 8; ++index )
+    {
+        out[index] = state[index] ^ state[index + 8];
+    }
+    return out;
+}
+
+ChainingValue chunkChainingValue(
+    const quint8 *input,
+    qint64 length,
+    quint64 chunkCounter,
+    quint32 extraFlags
+)
+{
+    ChainingValue chainingValue;
+    std::copy(std::begin(blake3Iv), std::end(blake3Iv), chainingValue.begin());
+
+    // An empty input is still one (empty) block.
+    const qint64 blockCount = qMax<qint64>(1, ( length + blake3BlockBytes - 1 ) / blake3BlockBytes);
+    for ( qint64 block = 0; block < blockCount; ++block )
+    {
+        const qint64 offset = block * blake3BlockBytes;
+        const qint64 blockLength = qMin<qint64>(blake3BlockBytes, length - offset);
+        quint8 blockBytes[blake3BlockBytes] = {};
+        if ( blockLength > 0 )
+        {
+            std::memcpy(blockBytes, input + offset, static_cast<size_t>(blockLength));
+        }
+        quint32 blockWords[16];
+        for ( int index = 0; index < 16; ++index )
+        {
+            blockWords[index] = readLe32(blockBytes + ( 4 * index ));
+        }
+
+        quint32 flags = 0;
+        if ( block == 0 )
+        {
+            flags |= blake3FlagChunkStart;
+        }
+        if ( block == ( blockCount - 1 ) )
+        {
+            flags |= blake3FlagChunkEnd | extraFlags;
+        }
+        chainingValue = compress(
+            chainingValue,
+            blockWords,
+            chunkCounter,
+            static_cast<quint32>(blockLength),
+            flags
+        );
+    }
+    return chainingValue;
+}
+
+ChainingValue parentChainingValue(
+    const ChainingValue &left,
+    const ChainingValue &right,
+    quint32 extraFlags
+)
+{
+    quint32 blockWords[16];
+    std::copy(left.begin(), left.end(), blockWords);
+    std::copy(right.begin(), right.end(), blockWords + 8);
+
+    ChainingValue key;
+    std::copy(std::begin(blake3Iv), std::end(blake3Iv), key.begin());
+    return compress(key, blockWords, 0, blake3BlockBytes, blake3FlagParent | extraFlags);
+}
+
+// Size of the left subtree: the largest power-of-two number of whole chunks that
+// still leaves at least one byte for the right subtree.
+qint64 leftSubtreeBytes(qint64 length)
+{
+    const quint64 fullChunks = static_cast<quint64>(( length - 1 ) / blake3ChunkBytes);
+    quint64 chunks = 1;
+    while ( ( chunks << 1 ) <= fullChunks )
+    {
+        chunks <<= 1;
+    }
+    return static_cast<qint64>(chunks) * blake3ChunkBytes;
+}
+
+ChainingValue subtreeChainingValue(const quint8 *input, qint64 length, quint64 chunkCounter)
+{
+    if ( length <= blake3ChunkBytes )
+    {
+        return chunkChainingValue(input, length, chunkCounter, 0);
+    }
+
+    const qint64 leftBytes = leftSubtreeBytes(length);
+    const ChainingValue left = subtreeChainingValue(input, leftBytes, chunkCounter);
+    const ChainingValue right = subtreeChainingValue(
+        input + leftBytes,
+        length - leftBytes,
+        chunkCounter + static_cast<quint64>(leftBytes / blake3ChunkBytes)
+    );
+    return parentChainingValue(left, right, 0);
+}
+
+// Rebuilds the upper tree from precomputed piece values. Every split point above the
+// piece size is a multiple of it, so pieces are exactly the subtrees a serial pass visits.
+ChainingValue mergePieces(
+    const std::vector<ChainingValue> &pieces,
+    qint64 pieceBytes,
+    qint64 offset,
+    qint64 length,
+    quint32 extraFlags
+)
+{
+    if ( length <= pieceBytes )
+    {
+        return pieces.at(static_cast<size_t>(offset / pieceBytes));
+    }
+
+    const qint64 leftBytes = leftSubtreeBytes(length);
+    return parentChainingValue(
+        mergePieces(pieces, pieceBytes, offset, leftBytes, 0),
+        mergePieces(pieces, pieceBytes, offset + leftBytes, length - leftBytes, 0),
+        extraFlags
+    );
+}
+
+qint64 choosePieceBytes(qint64 length, int maxThreads)
+{
+    // Roughly four pieces per thread for balance, never below blake3MinParallelPieceBytes.
+    const qint64 targetBytes = length / ( static_cast<qint64>(maxThreads) * 4 );
+    qint64 pieceBytes = blake3MinParallelPieceBytes;
+    while ( pieceBytes < targetBytes )
+    {
+        pieceBytes <<= 1;
+    }
+    return pieceBytes;
+}
+
+QByteArray serializeChainingValue(const ChainingValue &chainingValue)
+{
+    QByteArray out(blake3OutBytes, Qt::Uninitialized);
+    for ( int index = 0; index < 8; ++index )
+    {
+        out[( 4 * index ) + 0] = static_cast<char>(chainingValue[index] & 0xff);
+        out[( 4 * index ) + 1] = static_cast<char>(( chainingValue[index] >> 8 ) & 0xff);
+        out[( 4 * index ) + 2] = static_cast<char>(( chainingValue[index] >> 16 ) & 0xff);
+        out[( 4 * index ) + 3] = static_cast<char>(( chainingValue[index] >> 24 ) & 0xff);
+    }
+    return out;
+}
+}
+
+QByteArray Blake3Digest::hash(const void *data, qint64 size, int maxThreads)
+{
+    const quint8 *input = static_cast<const quint8 *>(data);
+    const qint64 length = qMax<qint64>(0, size);
+    if ( length <= blake3ChunkBytes )
+    {
+        return serializeChainingValue(chunkChainingValue(input, length, 0, blake3FlagRoot));
+    }
+
+    const qint64 pieceBytes = choosePieceBytes(length, qMax(1, maxThreads));
+    if ( ( maxThreads <= 1 ) || ( length <= pieceBytes ) )
+    {
+        const qint64 leftBytes = leftSubtreeBytes(length);
+        return serializeChainingValue(
+            parentChainingValue(
+                subtreeChainingValue(input, leftBytes, 0),
+                subtreeChainingValue(
+                    input + leftBytes,
+                    length - leftBytes,
+                    static_cast<quint64>(leftBytes / blake3ChunkBytes)
+                ),
+                blake3FlagRoot
+            )
+        );
+    }
+
+    const qint64 pieceCount = ( length + pieceBytes - 1 ) / pieceBytes;
+    std::vector<ChainingValue> pieces(static_cast<size_t>(pieceCount));
+    {
+        QThreadPool pool;
+        pool.setMaxThreadCount(maxThreads);
+        for ( qint64 piece = 0; piece < pieceCount; ++piece )
+        {
+            pool.start(
+                [input, length, pieceBytes, piece, &pieces]()
+                {
+                    const qint64 offset = piece * pieceBytes;
+                    pieces[static_cast<size_t>(piece)] = subtreeChainingValue(
+                        input + offset,
+                        qMin(pieceBytes, length - offset),
+                        static_cast<quint64>(offset / blake3ChunkBytes)
+                    );
+                }
+            );
+        }
+        pool.waitForDone();
+    }
+    return serializeChainingValue(mergePieces(pieces, pieceBytes, 0, length, blake3FlagRoot));
+}
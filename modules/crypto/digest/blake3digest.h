@@ -0,0 +1,17 @@
+#ifndef JQOPENCLAW_CRYPTO_DIGEST_BLAKE3DIGEST_H_
+#define JQOPENCLAW_CRYPTO_DIGEST_BLAKE3DIGEST_H_
+
+// Qt lib import
+#include <QByteArray>
+
+// BLAKE3 (default hash mode, 32-byte output). The input is a Merkle tree of 1 KiB
+// chunks, so with maxThreads > 1 large inputs are split into power-of-two subtrees
+// that are hashed concurrently and merged with the same parent nodes a serial pass
+// would produce.
+class Blake3Digest
+{
+public:
+    static QByteArray hash(const void *data, qint64 size, int maxThreads = 1);
+};
+
+#endif // JQOPENCLAW_CRYPTO_DIGEST_BLAKE3DIGEST_H_
@@ -0,0 +1,313 @@
+// .h include
+#include "crypto/digest/xxh3digest.h"
+
+// C++ lib import
+#include <cstring>
+
+#if defined(_MSC_VER) && defined(_M_X64)
+#include <intrin.h>
+#endif
+
+namespace
+{
+constexpr quint32 xxhPrime32_1 = 0x9E3779B1U;
+constexpr quint32 xxhPrime32_2 = 0x85EBCA77U;
+constexpr quint32 xxhPrime32_3 = 0xC2B2AE3DU;
+constexpr quint64 xxhPrime64_1 = 0x9E3779B185EBCA87ULL;
+constexpr quint64 xxhPrime64_2 = 0xC2B2AE3D27D4EB4FULL;
+constexpr quint64 xxhPrime64_3 = 0x165667B19E3779F9ULL;
+constexpr quint64 xxhPrime64_4 = 0x85EBCA77C2B2AE63ULL;
+constexpr quint64 xxhPrime64_5 = 0x27D4EB2F165667C5ULL;
+constexpr quint64 xxhPrimeMx1 = 0x165667919E3779F9ULL;
+constexpr quint64 xxhPrimeMx2 = 0x9FB21C651E98DF25ULL;
+
+constexpr int xxh3StripeBytes = 64;
+constexpr int xxh3SecretConsumeRate = 8;
+constexpr int xxh3AccumulatorCount = 8;
+constexpr int xxh3SecretBytes = 192;
+constexpr int xxh3MidSizeMax = 240;
+constexpr int xxh3SecretSizeMin = 136;
+constexpr int xxh3MidSizeStartOffset = 3;
+constexpr int xxh3MidSizeLastOffset = 17;
+constexpr int xxh3SecretLastAccStart = 7;
+constexpr int xxh3SecretMergeAccsStart = 11;
+
+alignas(64) const quint8 xxh3DefaultSecret[xxh3SecretBytes] = {
+    0xb8, 0xfe, 0x6c, 0x39, 0x23, 0xa4, 0x4b, 0xbe, 0x7c, 0x01, 0x81, 0x2c, 0xf7, 0x21, 0xad, 0x1c,
+    0xde, 0xd4, 0x6d, 0xe9, 0x83, 0x90, 0x97, 0xdb, 0x72, 0x40, 0xa4, 0xa4, 0xb7, 0xb3, 0x67, 0x1f,
+    0xcb, 0x79, 0xe6, 0x4e, 0xcc, 0xc0, 0xe5, 0x78, 0x82, 0x5a, 0xd0, 0x7d, 0xcc, 0xff, 0x72, 0x21,
+    0xb8, 0x08, 0x46, 0x74, 0xf7, 0x43, 0x24, 0x8e, 0xe0, 0x35, 0x90, 0xe6, 0x81, 0x3a, 0x26, 0x4c,
+    0x3c, 0x28, 0x52, 0xbb, 0x91, 0xc3, 0x00, 0xcb, 0x88, 0xd0, 0x65, 0x8b, 0x1b, 0x53, 0x2e, 0xa3,
+    0x71, 0x64, 0x48, 0x97, 0xa2, 0x0d, 0xf9, 0x4e, 0x38, 0x19, 0xef, 0x46, 0xa9, 0xde, 0xac, 0xd8,
+    0xa8, 0xfa, 0x76, 0x3f, 0xe3, 0x9c, 0x34, 0x3f, 0xf9, 0xdc, 0xbb, 0xc7, 0xc7, 0x0b, 0x4f, 0x1d,
+    0x8a, 0x51, 0xe0, 0x4b, 0xcd, 0xb4, 0x59, 0x31, 0xc8, 0x9f, 0x7e, 0xc9, 0xd9, 0x78, 0x73, 0x64,
+    0xea, 0xc5, 0xac, 0x83, 0x34, 0xd3, 0xeb, 0xc3, 0xc5, 0x81, 0xa0, 0xff, 0xfa, 0x13, 0x63, 0xeb,
+    0x17, 0x0d, 0xdd, 0x51, 0xb7, 0xf0, 0xda, 0x49, 0xd3, 0x16, 0x55, 0x26, 0x29, 0xd4, 0x68, 0x9e,
+    0x2b, 0x16, 0xbe, 0x58, 0x7d, 0x47, 0xa1, 0xfc, 0x8f, 0xf8, 0xb8, 0xd1, 0x7a, 0xd0, 0x31, 0xce,
+    0x45, 0xcb, 0x3a, 0x8f, 0x95, 0x16, 0x04, 0x28, 0xaf, 0xd7, 0xfb, 0xca, 0xbb, 0x4b, 0x40, 0x7e,
+};
+
+inline quint32 readLe32(const quint8 *data)
+{
+    quint32 value;
+    std::memcpy(&value, data, sizeof(value));
+#if Q_BYTE_ORDER == Q_BIG_ENDIAN
+    value = qbswap(value);
+#endif
+    return value;
+}
+
+inline quint64 readLe64(const quint8 *data)
+{
+    quint64 value;
+    std::memcpy(&value, data, sizeof(value));
+#if Q_BYTE_ORDER == Q_BIG_ENDIAN
+    value = qbswap(value);
+#endif
+    return value;
+}
+
+inline quint64 rotl64(quint64 value, int bits)
+{
+    return ( value << bits ) | ( value >> ( 64 - bits ) );
+}
+
+inline quint32 swap32(quint32 value)
+{
+    return ( ( value << 24 ) & 0xff000000U ) |
+        ( ( value << 8 ) & 0x00ff0000U ) |
+        ( ( value >> 8 ) & 0x0000ff00U ) |
+        ( ( value >> 24 ) & 0x000000ffU );
+}
+
+inline quint64 swap64(quint64 value)
+{
+    return ( static_cast<quint64>(swap32(static_cast<quint32>(value))) << 32 ) |
+        swap32(static_cast<quint32>(value >> 32));
+}
+
+inline quint64 mul128Fold64(quint64 left, quint64 right)
+{
+#if defined(__SIZEOF_INT128__)
+    const unsigned __int128 product = static_cast<unsigned __int128>(left) * right;
+    return static_cast<quint64>(product) ^ static_cast<quint64>(product >> 64);
+#elif defined(_MSC_VER) && defined(_M_X64)
+    quint64 high = 0;
+    const quint64 low = _umul128(left, right, &high);
+    return low ^ high;
+#else
+    const quint64 loLo = ( left & 0xFFFFFFFFULL ) * ( right & 0xFFFFFFFFULL );
+    const quint64 hiLo = ( left >> 32 ) * ( right & 0xFFFFFFFFULL );
+    const quint64 loHi = ( left & 0xFFFFFFFFULL ) * ( right >> 32 );
+    const quint64 hiHi = ( left >> 32 ) * ( right >> 32 );
+    const quint64 cross = ( loLo >> 32 ) + ( hiLo & 0xFFFFFFFFULL ) + loHi;
+    const quint64 high = ( hiLo >> 32 ) + ( cross >> 32 ) + hiHi;
+    const quint64 low = ( cross << 32 ) | ( loLo & 0xFFFFFFFFULL );
+    return low ^ high;
+#endif
+}
+
+inline quint64 xxh64Avalanche(quint64 hash)
+{
+    hash ^= hash >> 33;
+    hash *= xxhPrime64_2;
+    hash ^= hash >> 29;
+    hash *= xxhPrime64_3;
+    hash ^= hash >> 32;
+    return hash;
+}
+
+inline quint64 xxh3Avalanche(quint64 hash)
+{
+    hash ^= hash >> 37;
+    hash *= xxhPrimeMx1;
+    hash ^= hash >> 32;
+    return hash;
+}
+
+inline quint64 xxh3Rrmxmx(quint64 hash, quint64 length)
+{
+    hash ^= rotl64(hash, 49) ^ rotl64(hash, 24);
+    hash *= xxhPrimeMx2;
+    hash ^= ( hash >> 35 ) + length;
+    hash *= xxhPrimeMx2;
+    return hash ^ ( hash >> 28 );
+}
+
+inline quint64 xxh3Mix16(const quint8 *input, const quint8 *secret)
+{
+    return mul128Fold64(
+        readLe64(input) ^ readLe64(secret),
+        readLe64(input + 8) ^ readLe64(secret + 8)
+    );
+}
+
+quint64 hashLength0To16(const quint8 *input, quint64 length, const quint8 *secret)
+{
+    if ( length > 8 )
+    {
+        const quint64 inputLow = readLe64(input) ^ ( readLe64(secret + 24) ^ readLe64(secret + 32) );
+        const quint64 inputHigh = readLe64(input + length - 8) ^ ( readLe64(secret + 40) ^ readLe64(secret + 48) );
+        const quint64 accumulator = length + swap64(inputLow) + inputHigh + mul128Fold64(inputLow, inputHigh);
+        return xxh3Avalanche(accumulator);
+    }
+    if ( length >= 4 )
+    {
+        const quint32 input1 = readLe32(input);
+        const quint32 input2 = readLe32(input + length - 4);
+        const quint64 bitflip = readLe64(secret + 8) ^ readLe64(secret + 16);
+        const quint64 input64 = input2 + ( static_cast<quint64>(input1) << 32 );
+        return xxh3Rrmxmx(input64 ^ bitflip, length);
+    }
+    if ( length > 0 )
+    {
+        const quint32 combined = ( static_cast<quint32>(input[0]) << 16 ) |
+            ( static_cast<quint32>(input[length >> 1]) << 24 ) |
+            static_cast<quint32>(input[length - 1]) |
+            ( static_cast<quint32>(length) << 8 );
+        const quint64 bitflip = readLe32(secret) ^ readLe32(secret + 4);
+        return xxh64Avalanche(combined ^ bitflip);
+    }
+    return xxh64Avalanche(readLe64(secret + 56) ^ readLe64(secret + 64));
+}
+
+quint64 hashLength17To128(const quint8 *input, quint64 length, const quint8 *secret)
+{
+    quint64 accumulator = length * xxhPrime64_1;
+    if ( length > 32 )
+    {
+        if ( length > 64 )
+        {
+            if ( length > 96 )
+            {
+                accumulator += xxh3Mix16(input + 48, secret + 96);
+                accumulator += xxh3Mix16(input + length - 64, secret + 112);
+            }
+            accumulator += xxh3Mix16(input + 32, secret + 64);
+            accumulator += xxh3Mix16(input + length - 48, secret + 80);
+        }
+        accumulator += xxh3Mix16(input + 16, secret + 32);
+        accumulator += xxh3Mix16(input + length - 32, secret + 48);
+    }
+    accumulator += xxh3Mix16(input, secret);
+    accumulator += xxh3Mix16(input + length - 16, secret + 16);
+    return xxh3Avalanche(accumulator);
+}
+
+quint64 hashLength129To240(const quint8 *input, quint64 length, const quint8 *secret)
+{
+    quint64 accumulator = length * xxhPrime64_1;
+    const int roundCount = static_cast<int>(length / 16);
+    for ( int index = 0; index < 8; ++index )
+    {
+        accumulator += xxh3Mix16(input + ( 16 * index ), secret + ( 16 * index ));
+    }
+    accumulator = xxh3Avalanche(accumulator);
+    for ( int index = 8; index < roundCount; ++index )
+    {
+        accumulator += xxh3Mix16(
+            input + ( 16 * index ),
+            secret + ( 16 * ( index - 8 ) ) + xxh3MidSizeStartOffset
+        );
+    }
+    accumulator += xxh3Mix16(
+        input + length - 16,
+        secret + xxh3SecretSizeMin - xxh3MidSizeLastOffset
+    );
+    return xxh3Avalanche(accumulator);
+}
+
+inline void accumulateStripe(quint64 *accumulators, const quint8 *input, const quint8 *secret)
+{
+    for ( int index = 0; index < xxh3AccumulatorCount; ++index )
+    {
+        const quint64 dataValue = readLe64(input + ( 8 * index ));
+        const quint64 dataKey = dataValue ^ readLe64(secret + ( 8 * index ));
+        accumulators[index ^ 1] += dataValue;
+        accumulators[index] += ( dataKey & 0xFFFFFFFFULL ) * ( dataKey >> 32 );
+    }
+}
+
+inline void scrambleAccumulators(quint64 *accumulators, const quint8 *secret)
+{
+    for ( int index = 0; index < xxh3AccumulatorCount; ++index )
+    {
+        quint64 accumulator = accumulators[index];
+        accumulator ^= accumulator >> 47;
+        accumulator ^= readLe64(secret + ( 8 * index ));
+        accumulator *= xxhPrime32_1;
+        accumulators[index] = accumulator;
+    }
+}
+
+quint64 hashLong(const quint8 *input, quint64 length, const quint8 *secret)
+{
+    quint64 accumulators[xxh3AccumulatorCount] = {
+        xxhPrime32_3, xxhPrime64_1, xxhPrime64_2, xxhPrime64_3,
+        xxhPrime64_4, xxhPrime32_2, xxhPrime64_5, xxhPrime32_1,
+    };
+
+    const quint64 stripesPerBlock = ( xxh3SecretBytes - xxh3StripeBytes ) / xxh3SecretConsumeRate;
+    const quint64 blockBytes = xxh3StripeBytes * stripesPerBlock;
+    const quint64 blockCount = ( length - 1 ) / blockBytes;
+    for ( quint64 block = 0; block < blockCount; ++block )
+    {
+        const quint8 *blockInput = input + ( block * blockBytes );
+        for ( quint64 stripe = 0; stripe < stripesPerBlock; ++stripe )
+        {
+            accumulateStripe(
+                accumulators,
+                blockInput + ( stripe * xxh3StripeBytes ),
+                secret + ( stripe * xxh3SecretConsumeRate )
+            );
+        }
+        scrambleAccumulators(accumulators, secret + xxh3SecretBytes - xxh3StripeBytes);
+    }
+
+    const quint64 lastStripeCount = ( ( length - 1 ) - ( blockBytes * blockCount ) ) / xxh3StripeBytes;
+    const quint8 *lastBlockInput = input + ( blockCount * blockBytes );
+    for ( quint64 stripe = 0; stripe < lastStripeCount; ++stripe )
+    {
+        accumulateStripe(
+            accumulators,
+            lastBlockInput + ( stripe * xxh3StripeBytes ),
+            secret + ( stripe * xxh3SecretConsumeRate )
+        );
+    }
+    accumulateStripe(
+        accumulators,
+        input + length - xxh3StripeBytes,
+        secret + xxh3SecretBytes - xxh3StripeBytes - xxh3SecretLastAccStart
+    );
+
+    quint64 result = length * xxhPrime64_1;
+    for ( int index = 0; index < 4; ++index )
+    {
+        const quint8 *mergeSecret = secret + xxh3SecretMergeAccsStart + ( 16 * index );
+        result += mul128Fold64(
+            accumulators[2 * index] ^ readLe64(mergeSecret),
+            accumulators[( 2 * index ) + 1] ^ readLe64(mergeSecret + 8)
+        );
+    }
+    return xxh3Avalanche(result);
+}
+}
+
+quint64 Xxh3Digest::hash64(const void *data, qint64 size)
+{
+    const quint8 *input = static_cast<const quint8 *>(data);
+    const quint64 length = static_cast<quint64>(qMax<qint64>(0, size));
+    if ( length <= 16 )
+    {
+        return hashLength0To16(input, length, xxh3DefaultSecret);
+    }
+    if ( length <= 128 )
+    {
+        return hashLength17To128(input, length, xxh3DefaultSecret);
+    }
+    if ( length <= xxh3MidSizeMax )
+    {
+        return hashLength129To240(input, length, xxh3DefaultSecret);
+    }
+    return hashLong(input, length, xxh3DefaultSecret);
+}
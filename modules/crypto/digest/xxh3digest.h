@@ -0,0 +1,15 @@
+#ifndef JQOPENCLAW_CRYPTO_DIGEST_XXH3DIGEST_H_
+#define JQOPENCLAW_CRYPTO_DIGEST_XXH3DIGEST_H_
+
+// Qt lib import
+#include <QtGlobal>
+
+// XXH3 64-bit (seed 0, default secret), bit-compatible with XXH3_64bits() of the
+// reference xxHash library. Not cryptographic: meant for fast change detection.
+class Xxh3Digest
+{
+public:
+    static quint64 hash64(const void *data, qint64 size);
+};
+
+#endif // JQOPENCLAW_CRYPTO_DIGEST_XXH3DIGEST_H_
@@ -1,10 +1,12 @@
 HEADERS *= \
     $$PWD/openclawprotocol/gatewayclient.h \
+    $$PWD/openclawprotocol/gatewayendpointselector.h \
     $$PWD/openclawprotocol/nodeprofile.h \
     $$PWD/openclawprotocol/noderegistrar.h \
     $$PWD/openclawprotocol/nodeoptions.h
 
 SOURCES *= \
     $$PWD/openclawprotocol/gatewayclient.cpp \
+    $$PWD/openclawprotocol/gatewayendpointselector.cpp \
     $$PWD/openclawprotocol/nodeprofile.cpp \
     $$PWD/openclawprotocol/noderegistrar.cpp
@@ -3,6 +3,7 @@
 
 // Qt lib import
 #include <QDebug>
+#include <QJsonArray>
 #include <QJsonDocument>
 #include <QJsonObject>
 #include <QJsonValue>
@@ -15,12 +16,35 @@
 
 namespace
 {
+constexpr int failbackProbeIntervalMs = 30000;
+constexpr int failbackRequiredHealthyProbes = 3;
+constexpr qint64 invokeResultCoalesceWindowNs = 500000;
+constexpr int invokeResultBatchMaxCount = 64;
+constexpr qint64 invokeResultBatchMaxBytes = 256 * 1024;
+const char invokeResultBatchMethod[] = "node.invoke.result.batch";
+
 bool shouldHandleNodeEvent(const QString &eventName)
 {
     return eventName == QStringLiteral("connect.challenge") ||
         eventName == QStringLiteral("node.invoke.request");
 }
 
+bool gatewaySupportsMethod(const QJsonObject &helloPayload, const QString &method)
+{
+    const QJsonArray methods = helloPayload.value(QStringLiteral("features"))
+                                   .toObject()
+                                   .value(QStringLiteral("methods"))
+                                   .toArray();
+    for ( const QJsonValue &item : methods )
+    {
+        if ( item.toString() == method )
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
 }
 
 GatewayClient::GatewayClient(QObject *parent) :
@@ -36,27 +60,66 @@ GatewayClient::GatewayClient(QObject *parent) :
         &GatewayClient::onTextMessageReceived
     );
     connect(&socket_, &QWebSocket::sslErrors, this, &GatewayClient::onSslErrors);
+    connect(
+        &endpointSelector_,
+        &GatewayEndpointSelector::probeFinished,
+        this,
+        &GatewayClient::onEndpointProbeFinished
+    );
+    connect(
+        &endpointSelector_,
+        &GatewayEndpointSelector::primaryProbeFinished,
+        this,
+        &GatewayClient::onPrimaryProbeFinished
+    );
+
+    failbackTimer_.setInterval(failbackProbeIntervalMs);
+    connect(&failbackTimer_, &QTimer::timeout, this, &GatewayClient::onFailbackTimeout);
+
+    // Zero interval: flush after every frame already queued in this event loop pass is handled.
+    invokeResultFlushTimer_.setSingleShot(true);
+    invokeResultFlushTimer_.setInterval(0);
+    connect(&invokeResultFlushTimer_, &QTimer::timeout, this, &GatewayClient::flushInvokeResults);
 }
 
 void GatewayClient::setOptions(const NodeOptions &options)
 {
     options_ = options;
+
+    QStringList urls = options_.gatewayUrls;
+    if ( urls.isEmpty() )
+    {
+        urls.append(options_.gatewayUrl);
+    }
+    endpointSelector_.setUrls(urls);
+    currentEndpointIndex_ = -1;
+    openPending_ = false;
+    failbackTimer_.stop();
 }
 
 void GatewayClient::open()
 {
-    const QString urlText = gatewayUrl();
-    const QUrl url(urlText);
-    if ( !url.isValid() )
+    closeRequested_ = false;
+    if ( endpointSelector_.endpointCount() <= 1 )
     {
-        emit transportError(QStringLiteral("invalid gateway url: %1").arg(urlText));
+        openEndpoint(0);
         return;
     }
-    socket_.open(url);
+
+    // Pick the endpoint once every probe has answered (or timed out).
+    openPending_ = true;
+    if ( !endpointSelector_.isProbing() )
+    {
+        endpointSelector_.probeAll();
+    }
 }
 
 void GatewayClient::close()
 {
+    flushInvokeResults();
+    closeRequested_ = true;
+    openPending_ = false;
+    failbackTimer_.stop();
     if ( ( socket_.state() == QAbstractSocket::ConnectedState ) ||
          ( socket_.state() == QAbstractSocket::ConnectingState ) )
     {
@@ -69,6 +132,16 @@ bool GatewayClient::isOpen() const
     return socket_.state() == QAbstractSocket::ConnectedState;
 }
 
+QString GatewayClient::currentGatewayUrl() const
+{
+    const QString url = endpointSelector_.url(currentEndpointIndex_);
+    if ( url.isEmpty() )
+    {
+        return options_.gatewayUrl.trimmed();
+    }
+    return url;
+}
+
 void GatewayClient::sendConnect(const QJsonObject &params)
 {
     if ( !isOpen() )
@@ -99,29 +172,63 @@ void GatewayClient::sendInvokeResult(const QJsonObject &params)
         return;
     }
 
-    QJsonObject request;
-    request.insert(QStringLiteral("type"), QStringLiteral("req"));
-    request.insert(
-        QStringLiteral("id"),
-        QUuid::createUuid().toString(QUuid::WithoutBraces)
-    );
-    request.insert(QStringLiteral("method"), QStringLiteral("node.invoke.result"));
-    request.insert(QStringLiteral("params"), params);
+    const QByteArray paramsJson = QJsonDocument(params).toJson(QJsonDocument::Compact);
+    const bool idle = pendingInvokeResults_.isEmpty() &&
+        ( !lastInvokeResultSentTimer_.isValid() ||
+          ( lastInvokeResultSentTimer_.nsecsElapsed() >= invokeResultCoalesceWindowNs ) );
+    if ( !resultBatchingEnabled_ ||
+         idle ||
+         ( paramsJson.size() >= invokeResultBatchMaxBytes ) )
+    {
+        flushInvokeResults();
+        sendRequestFrame(QStringLiteral("node.invoke.result"), paramsJson);
+        lastInvokeResultSentTimer_.start();
+        return;
+    }
 
-    const QString payload = QString::fromUtf8(
-        QJsonDocument(request).toJson(QJsonDocument::Compact)
-    );
-    socket_.sendTextMessage(payload);
+    pendingInvokeResults_.append(paramsJson);
+    pendingInvokeResultBytes_ += paramsJson.size();
+    if ( ( pendingInvokeResults_.size() >= invokeResultBatchMaxCount ) ||
+         ( pendingInvokeResultBytes_ >= invokeResultBatchMaxBytes ) )
+    {
+        flushInvokeResults();
+        return;
+    }
+    if ( !invokeResultFlushTimer_.isActive() )
+    {
+        invokeResultFlushTimer_.start();
+    }
 }
 
 void GatewayClient::onConnected()
 {
+    endpointSelector_.markHealthy(currentEndpointIndex_);
+    failbackHealthyStreak_ = 0;
+    if ( currentEndpointIndex_ > 0 )
+    {
+        failbackTimer_.start();
+    }
     emit opened();
 }
 
 void GatewayClient::onDisconnected()
 {
     pendingConnectRequestId_.clear();
+    resultBatchingEnabled_ = false;
+    invokeResultFlushTimer_.stop();
+    if ( !pendingInvokeResults_.isEmpty() )
+    {
+        qWarning().noquote() << QStringLiteral("[gateway] dropped %1 batched invoke result(s) on disconnect")
+                                    .arg(pendingInvokeResults_.size());
+        pendingInvokeResults_.clear();
+        pendingInvokeResultBytes_ = 0;
+    }
+    failbackTimer_.stop();
+    if ( !closeRequested_ )
+    {
+        reportEndpointFailure();
+    }
+    closeRequested_ = false;
     emit closed();
 }
 
@@ -129,6 +236,11 @@ void GatewayClient::onErrorOccurred(QAbstractSocket::SocketError socketError)
 {
     Q_UNUSED(socketError);
 
+    if ( !closeRequested_ )
+    {
+        reportEndpointFailure();
+    }
+
     const QString message = socket_.errorString().trimmed();
     if ( message.isEmpty() )
     {
@@ -204,7 +316,16 @@ void GatewayClient::onTextMessageReceived(const QString &message)
                              .arg(responseId, ok ? QStringLiteral("true") : QStringLiteral("false"));
     if ( ok )
     {
-        emit connectAccepted(root.value("payload").toObject());
+        const QJsonObject payload = root.value("payload").toObject();
+        resultBatchingEnabled_ = gatewaySupportsMethod(
+            payload,
+            QString::fromLatin1(invokeResultBatchMethod)
+        );
+        if ( resultBatchingEnabled_ )
+        {
+            qInfo().noquote() << QStringLiteral("[gateway] invoke result batching enabled");
+        }
+        emit connectAccepted(payload);
     }
     else
     {
@@ -222,8 +343,145 @@ void GatewayClient::onSslErrors(const QList<QSslError> &errors)
     emit transportError(QStringLiteral("tls validation failed: %1").arg(errorTexts.join("; ")));
 }
 
-QString GatewayClient::gatewayUrl() const
+void GatewayClient::onEndpointProbeFinished()
+{
+    if ( !openPending_ )
+    {
+        return;
+    }
+    openPending_ = false;
+    openEndpoint(endpointSelector_.selectEndpoint());
+}
+
+void GatewayClient::onPrimaryProbeFinished(bool reachable, qint64 rttMs)
+{
+    if ( ( currentEndpointIndex_ <= 0 ) || !isOpen() )
+    {
+        failbackHealthyStreak_ = 0;
+        return;
+    }
+
+    // Only move back when the primary is not meaningfully slower than the current backup.
+    const qint64 currentRttMs = endpointSelector_.rttMs(currentEndpointIndex_);
+    const bool healthy = reachable &&
+        ( ( currentRttMs < 0 ) ||
+          ( rttMs <= ( currentRttMs + GatewayEndpointSelector::preferenceMarginMs() ) ) );
+    if ( !healthy )
+    {
+        failbackHealthyStreak_ = 0;
+        return;
+    }
+
+    ++failbackHealthyStreak_;
+    if ( failbackHealthyStreak_ < failbackRequiredHealthyProbes )
+    {
+        return;
+    }
+
+    failbackHealthyStreak_ = 0;
+    failbackTimer_.stop();
+    endpointSelector_.markHealthy(0);
+    qInfo().noquote() << QStringLiteral("[gateway] primary endpoint recovered, failback from %1 to %2")
+                             .arg(currentGatewayUrl(), endpointSelector_.url(0));
+    emit failbackRequested();
+}
+
+void GatewayClient::onFailbackTimeout()
+{
+    if ( ( currentEndpointIndex_ <= 0 ) || !isOpen() )
+    {
+        failbackTimer_.stop();
+        return;
+    }
+    endpointSelector_.probePrimary();
+}
+
+void GatewayClient::flushInvokeResults()
 {
-    return options_.gatewayUrl.trimmed();
+    invokeResultFlushTimer_.stop();
+    if ( pendingInvokeResults_.isEmpty() )
+    {
+        return;
+    }
+
+    const QList<QByteArray> results = pendingInvokeResults_;
+    const qint64 resultBytes = pendingInvokeResultBytes_;
+    pendingInvokeResults_.clear();
+    pendingInvokeResultBytes_ = 0;
+    lastInvokeResultSentTimer_.start();
+    if ( !isOpen() )
+    {
+        return;
+    }
+
+    if ( results.size() == 1 )
+    {
+        sendRequestFrame(QStringLiteral("node.invoke.result"), results.first());
+        return;
+    }
+
+    // Splice the already serialized results instead of re-encoding them.
+    QByteArray paramsJson;
+    paramsJson.reserve(resultBytes + results.size() + 16);
+    paramsJson.append("{\"results\":[");
+    for ( int index = 0; index < results.size(); ++index )
+    {
+        if ( index > 0 )
+        {
+            paramsJson.append(',');
+        }
+        paramsJson.append(results.at(index));
+    }
+    paramsJson.append("]}");
+    sendRequestFrame(QString::fromLatin1(invokeResultBatchMethod), paramsJson);
+}
+
+void GatewayClient::openEndpoint(int index)
+{
+    currentEndpointIndex_ = index;
+    endpointFailureReported_ = false;
+
+    const QString urlText = currentGatewayUrl();
+    const QUrl url(urlText);
+    if ( !url.isValid() )
+    {
+        emit transportError(QStringLiteral("invalid gateway url: %1").arg(urlText));
+        return;
+    }
+
+    if ( endpointSelector_.endpointCount() > 1 )
+    {
+        const qint64 rttMs = endpointSelector_.rttMs(index);
+        qInfo().noquote() << QStringLiteral("[gateway] open endpoint=%1/%2 url=%3 rttMs=%4")
+                                 .arg(index + 1)
+                                 .arg(endpointSelector_.endpointCount())
+                                 .arg(urlText)
+                                 .arg(rttMs);
+    }
+    socket_.open(url);
+}
+
+void GatewayClient::sendRequestFrame(const QString &method, const QByteArray &paramsJson)
+{
+    QByteArray frame;
+    frame.reserve(paramsJson.size() + 128);
+    frame.append("{\"type\":\"req\",\"id\":\"");
+    frame.append(QUuid::createUuid().toString(QUuid::WithoutBraces).toLatin1());
+    frame.append("\",\"method\":\"");
+    frame.append(method.toUtf8());
+    frame.append("\",\"params\":");
+    frame.append(paramsJson);
+    frame.append('}');
+    socket_.sendTextMessage(QString::fromUtf8(frame));
+}
+
+void GatewayClient::reportEndpointFailure()
+{
+    if ( endpointFailureReported_ || ( currentEndpointIndex_ < 0 ) )
+    {
+        return;
+    }
+    endpointFailureReported_ = true;
+    endpointSelector_.markFailed(currentEndpointIndex_);
 }
 
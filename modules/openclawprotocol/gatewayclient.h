@@ -3,12 +3,17 @@
 
 // Qt lib import
 #include <QAbstractSocket>
+#include <QByteArray>
+#include <QElapsedTimer>
 #include <QJsonObject>
+#include <QList>
 #include <QObject>
 #include <QSslError>
+#include <QTimer>
 #include <QWebSocket>
 
 // JQOpenClaw import
+#include "openclawprotocol/gatewayendpointselector.h"
 #include "openclawprotocol/nodeoptions.h"
 
 class GatewayClient : public QObject
@@ -22,7 +27,10 @@ public:
     void open();
     void close();
     bool isOpen() const;
+    QString currentGatewayUrl() const;
     void sendConnect(const QJsonObject &params);
+    // Results finishing back-to-back are packed into one node.invoke.result.batch frame
+    // when the gateway advertises that method; an idle client still sends immediately.
     void sendInvokeResult(const QJsonObject &params);
 
 signals:
@@ -33,6 +41,8 @@ signals:
     void connectAccepted(const QJsonObject &payload);
     void connectRejected(const QJsonObject &error);
     void transportError(const QString &message);
+    // Connected to a backup endpoint and the primary has been healthy long enough to move back.
+    void failbackRequested();
 
 private:
     void onConnected();
@@ -40,12 +50,30 @@ private:
     void onErrorOccurred(QAbstractSocket::SocketError socketError);
     void onTextMessageReceived(const QString &message);
     void onSslErrors(const QList<QSslError> &errors);
+    void onEndpointProbeFinished();
+    void onPrimaryProbeFinished(bool reachable, qint64 rttMs);
+    void onFailbackTimeout();
+    void flushInvokeResults();
 
-    QString gatewayUrl() const;
+    void openEndpoint(int index);
+    void reportEndpointFailure();
+    void sendRequestFrame(const QString &method, const QByteArray &paramsJson);
 
     NodeOptions options_;
     QWebSocket socket_;
     QString pendingConnectRequestId_;
+    GatewayEndpointSelector endpointSelector_;
+    QTimer failbackTimer_;
+    int currentEndpointIndex_ = -1;
+    int failbackHealthyStreak_ = 0;
+    bool openPending_ = false;
+    bool closeRequested_ = false;
+    bool endpointFailureReported_ = false;
+    bool resultBatchingEnabled_ = false;
+    QList<QByteArray> pendingInvokeResults_;
+    qint64 pendingInvokeResultBytes_ = 0;
+    QTimer invokeResultFlushTimer_;
+    QElapsedTimer lastInvokeResultSentTimer_;
 };
 
 #endif // JQOPENCLAW_GATEWAY_GATEWAYCLIENT_H_
@@ -0,0 +1,310 @@
+// .h include
+#include "openclawprotocol/gatewayendpointselector.h"
+
+// Qt lib import
+#include <QDateTime>
+#include <QDebug>
+#include <QElapsedTimer>
+#include <QTcpSocket>
+#include <QTimer>
+#include <QUrl>
+#include <memory>
+
+namespace
+{
+constexpr int endpointProbeTimeoutMs = 3000;
+constexpr qint64 endpointFailoverCooldownMs = 30000;
+constexpr int endpointFailoverCooldownMaxSteps = 4;
+constexpr qint64 endpointPreferenceMarginMs = 30;
+}
+
+GatewayEndpointSelector::GatewayEndpointSelector(QObject *parent) :
+    QObject(parent)
+{
+}
+
+void GatewayEndpointSelector::setUrls(const QStringList &urls)
+{
+    QList<Endpoint> nextEndpoints;
+    for ( const QString &url : urls )
+    {
+        const QString normalizedUrl = url.trimmed();
+        if ( normalizedUrl.isEmpty() )
+        {
+            continue;
+        }
+
+        Endpoint endpoint;
+        endpoint.url = normalizedUrl;
+        for ( const Endpoint &previous : endpoints_ )
+        {
+            if ( previous.url == normalizedUrl )
+            {
+                endpoint = previous;
+                break;
+            }
+        }
+        nextEndpoints.append(endpoint);
+    }
+
+    endpoints_ = nextEndpoints;
+    ++probeGeneration_;
+    pendingProbeCount_ = 0;
+    primaryProbePending_ = false;
+    lastFailedIndex_ = -1;
+}
+
+int GatewayEndpointSelector::endpointCount() const
+{
+    return endpoints_.size();
+}
+
+QString GatewayEndpointSelector::url(int index) const
+{
+    if ( ( index < 0 ) || ( index >= endpoints_.size() ) )
+    {
+        return QString();
+    }
+    return endpoints_.at(index).url;
+}
+
+qint64 GatewayEndpointSelector::rttMs(int index) const
+{
+    if ( ( index < 0 ) || ( index >= endpoints_.size() ) )
+    {
+        return -1;
+    }
+    return endpoints_.at(index).rttMs;
+}
+
+qint64 GatewayEndpointSelector::preferenceMarginMs()
+{
+    return endpointPreferenceMarginMs;
+}
+
+bool GatewayEndpointSelector::isProbing() const
+{
+    return pendingProbeCount_ > 0;
+}
+
+void GatewayEndpointSelector::probeAll()
+{
+    ++probeGeneration_;
+    primaryProbePending_ = false;
+    pendingProbeCount_ = endpoints_.size();
+    if ( pendingProbeCount_ == 0 )
+    {
+        emit probeFinished();
+        return;
+    }
+
+    for ( int index = 0; index < endpoints_.size(); ++index )
+    {
+        startProbe(index, probeGeneration_, false);
+    }
+}
+
+void GatewayEndpointSelector::probePrimary()
+{
+    if ( endpoints_.isEmpty() || isProbing() || primaryProbePending_ )
+    {
+        return;
+    }
+
+    primaryProbePending_ = true;
+    startProbe(0, probeGeneration_, true);
+}
+
+int GatewayEndpointSelector::selectEndpoint() const
+{
+    if ( endpoints_.isEmpty() )
+    {
+        return -1;
+    }
+
+    const qint64 nowMs = QDateTime::currentMSecsSinceEpoch();
+    for ( int pass = 0; pass < 2; ++pass )
+    {
+        const bool honorCooldown = ( pass == 0 );
+        qint64 bestRttMs = -1;
+        for ( const Endpoint &endpoint : endpoints_ )
+        {
+            if ( ( endpoint.rttMs < 0 ) ||
+                 ( honorCooldown && isCoolingDown(endpoint, nowMs) ) )
+            {
+                continue;
+            }
+            if ( ( bestRttMs < 0 ) || ( endpoint.rttMs < bestRttMs ) )
+            {
+                bestRttMs = endpoint.rttMs;
+            }
+        }
+        if ( bestRttMs < 0 )
+        {
+            continue;
+        }
+
+        // Prefer the earliest endpoint in configured order whose RTT is close to the best one.
+        for ( int index = 0; index < endpoints_.size(); ++index )
+        {
+            const Endpoint &endpoint = endpoints_.at(index);
+            if ( ( endpoint.rttMs < 0 ) ||
+                 ( honorCooldown && isCoolingDown(endpoint, nowMs) ) )
+            {
+                continue;
+            }
+            if ( endpoint.rttMs <= ( bestRttMs + endpointPreferenceMarginMs ) )
+            {
+                return index;
+            }
+        }
+    }
+
+    return ( lastFailedIndex_ + 1 ) % endpoints_.size();
+}
+
+void GatewayEndpointSelector::markHealthy(int index)
+{
+    if ( ( index < 0 ) || ( index >= endpoints_.size() ) )
+    {
+        return;
+    }
+    endpoints_[index].consecutiveFailures = 0;
+    endpoints_[index].lastFailureAtMs = 0;
+}
+
+void GatewayEndpointSelector::markFailed(int index)
+{
+    if ( ( index < 0 ) || ( index >= endpoints_.size() ) )
+    {
+        return;
+    }
+    Endpoint &endpoint = endpoints_[index];
+    ++endpoint.consecutiveFailures;
+    endpoint.lastFailureAtMs = QDateTime::currentMSecsSinceEpoch();
+    lastFailedIndex_ = index;
+}
+
+void GatewayEndpointSelector::startProbe(int index, quint64 generation, bool primaryOnly)
+{
+    const QUrl url(endpoints_.at(index).url);
+    const bool tls = ( url.scheme().trimmed().toLower() == QStringLiteral("wss") );
+    const int port = url.port(tls ? 443 : 80);
+    if ( !url.isValid() || url.host().trimmed().isEmpty() )
+    {
+        QTimer::singleShot(
+            0,
+            this,
+            [this, index, generation, primaryOnly]()
+            {
+                finishProbe(index, generation, primaryOnly, -1);
+            }
+        );
+        return;
+    }
+
+    auto socket = new QTcpSocket(this);
+    auto timeoutTimer = new QTimer(socket);
+    auto elapsedTimer = std::make_shared<QElapsedTimer>();
+    auto finished = std::make_shared<bool>(false);
+    auto finish = [this, socket, index, generation, primaryOnly, finished](qint64 rttMs)
+    {
+        if ( *finished )
+        {
+            return;
+        }
+        *finished = true;
+        socket->abort();
+        socket->deleteLater();
+        finishProbe(index, generation, primaryOnly, rttMs);
+    };
+
+    connect(
+        socket,
+        &QTcpSocket::connected,
+        this,
+        [elapsedTimer, finish]()
+        {
+            finish(elapsedTimer->elapsed());
+        }
+    );
+    connect(
+        socket,
+        &QTcpSocket::errorOccurred,
+        this,
+        [finish](QAbstractSocket::SocketError)
+        {
+            finish(-1);
+        }
+    );
+    timeoutTimer->setSingleShot(true);
+    connect(
+        timeoutTimer,
+        &QTimer::timeout,
+        this,
+        [finish]()
+        {
+            finish(-1);
+        }
+    );
+
+    elapsedTimer->start();
+    timeoutTimer->start(endpointProbeTimeoutMs);
+    socket->connectToHost(url.host(), static_cast<quint16>(port));
+}
+
+void GatewayEndpointSelector::finishProbe(
+    int index,
+    quint64 generation,
+    bool primaryOnly,
+    qint64 rttMs
+)
+{
+    if ( ( generation != probeGeneration_ ) ||
+         ( index < 0 ) ||
+         ( index >= endpoints_.size() ) )
+    {
+        return;
+    }
+
+    endpoints_[index].rttMs = rttMs;
+    if ( primaryOnly )
+    {
+        primaryProbePending_ = false;
+        emit primaryProbeFinished(rttMs >= 0, rttMs);
+        return;
+    }
+
+    --pendingProbeCount_;
+    if ( pendingProbeCount_ > 0 )
+    {
+        return;
+    }
+
+    QStringList summary;
+    for ( const Endpoint &endpoint : endpoints_ )
+    {
+        summary.append(
+            QStringLiteral("%1=%2").arg(
+                endpoint.url,
+                ( endpoint.rttMs >= 0 )
+                    ? QStringLiteral("%1ms").arg(endpoint.rttMs)
+                    : QStringLiteral("unreachable")
+            )
+        );
+    }
+    qInfo().noquote() << QStringLiteral("[gateway.probe] %1").arg(summary.join(QStringLiteral(", ")));
+    emit probeFinished();
+}
+
+bool GatewayEndpointSelector::isCoolingDown(const Endpoint &endpoint, qint64 nowMs) const
+{
+    if ( endpoint.consecutiveFailures <= 0 )
+    {
+        return false;
+    }
+
+    const qint64 cooldownMs = endpointFailoverCooldownMs *
+        qMin(endpoint.consecutiveFailures, endpointFailoverCooldownMaxSteps);
+    return ( nowMs - endpoint.lastFailureAtMs ) < cooldownMs;
+}
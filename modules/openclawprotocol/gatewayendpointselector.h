@@ -0,0 +1,59 @@
+#ifndef JQOPENCLAW_GATEWAY_GATEWAYENDPOINTSELECTOR_H_
+#define JQOPENCLAW_GATEWAY_GATEWAYENDPOINTSELECTOR_H_
+
+// Qt lib import
+#include <QList>
+#include <QObject>
+#include <QString>
+#include <QStringList>
+
+class GatewayEndpointSelector : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit GatewayEndpointSelector(QObject *parent = nullptr);
+
+    void setUrls(const QStringList &urls);
+    int endpointCount() const;
+    QString url(int index) const;
+    qint64 rttMs(int index) const;
+    bool isProbing() const;
+
+    // RTT slack within which an earlier endpoint is still preferred over the fastest one.
+    static qint64 preferenceMarginMs();
+
+    // Probes every endpoint with a TCP connect and emits probeFinished() once all have answered.
+    void probeAll();
+    // Probes the primary endpoint only and emits primaryProbeFinished().
+    void probePrimary();
+
+    int selectEndpoint() const;
+    void markHealthy(int index);
+    void markFailed(int index);
+
+signals:
+    void probeFinished();
+    void primaryProbeFinished(bool reachable, qint64 rttMs);
+
+private:
+    struct Endpoint
+    {
+        QString url;
+        qint64 rttMs = -1;
+        int consecutiveFailures = 0;
+        qint64 lastFailureAtMs = 0;
+    };
+
+    void startProbe(int index, quint64 generation, bool primaryOnly);
+    void finishProbe(int index, quint64 generation, bool primaryOnly, qint64 rttMs);
+    bool isCoolingDown(const Endpoint &endpoint, qint64 nowMs) const;
+
+    QList<Endpoint> endpoints_;
+    quint64 probeGeneration_ = 0;
+    int pendingProbeCount_ = 0;
+    bool primaryProbePending_ = false;
+    int lastFailedIndex_ = -1;
+};
+
+#endif // JQOPENCLAW_GATEWAY_GATEWAYENDPOINTSELECTOR_H_
@@ -4,10 +4,13 @@
 // Qt lib import
 #include <QJsonObject>
 #include <QString>
+#include <QStringList>
 
 struct NodeOptions
 {
     QString gatewayUrl;
+    // Primary gateway first, followed by backup endpoints; empty means gatewayUrl only.
+    QStringList gatewayUrls;
     QString token;
     bool tls = false;
     QString displayName;